@@ -0,0 +1,144 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "base/MD5.h"
+
+#include <cstring>
+
+namespace cc {
+
+namespace {
+
+// per round shift amounts
+const uint32_t S[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+// floor(abs(sin(i + 1)) * 2^32)
+const uint32_t K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+inline uint32_t rotateLeft(uint32_t x, uint32_t n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+} // namespace
+
+MD5::MD5() {
+    _state[0] = 0x67452301;
+    _state[1] = 0xefcdab89;
+    _state[2] = 0x98badcfe;
+    _state[3] = 0x10325476;
+}
+
+void MD5::update(const void *data, size_t length) {
+    auto *bytes = static_cast<const uint8_t *>(data);
+    size_t used = static_cast<size_t>(_length & 63);
+    _length += length;
+
+    if (used) {
+        size_t fill = 64 - used;
+        if (length < fill) {
+            memcpy(_buffer + used, bytes, length);
+            return;
+        }
+        memcpy(_buffer + used, bytes, fill);
+        transform(_buffer);
+        bytes += fill;
+        length -= fill;
+    }
+    for (; length >= 64; bytes += 64, length -= 64) {
+        transform(bytes);
+    }
+    memcpy(_buffer, bytes, length);
+}
+
+std::string MD5::hexDigest() {
+    uint64_t bits = _length * 8;
+    uint8_t padding[72] = {0x80};
+    size_t used = static_cast<size_t>(_length & 63);
+    size_t padLength = (used < 56 ? 56 : 120) - used;
+    for (int i = 0; i < 8; ++i) {
+        padding[padLength + i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+    update(padding, padLength + 8);
+
+    static const char HEX[] = "0123456789abcdef";
+    std::string digest(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        uint8_t byte = static_cast<uint8_t>(_state[i / 4] >> (8 * (i % 4)));
+        digest[i * 2] = HEX[byte >> 4];
+        digest[i * 2 + 1] = HEX[byte & 15];
+    }
+    return digest;
+}
+
+void MD5::transform(const uint8_t *block) {
+    uint32_t m[16];
+    for (int i = 0; i < 16; ++i) {
+        m[i] = static_cast<uint32_t>(block[i * 4]) |
+               static_cast<uint32_t>(block[i * 4 + 1]) << 8 |
+               static_cast<uint32_t>(block[i * 4 + 2]) << 16 |
+               static_cast<uint32_t>(block[i * 4 + 3]) << 24;
+    }
+
+    uint32_t a = _state[0];
+    uint32_t b = _state[1];
+    uint32_t c = _state[2];
+    uint32_t d = _state[3];
+    auto step = [&](uint32_t f, uint32_t i, uint32_t g) {
+        uint32_t tmp = d;
+        d = c;
+        c = b;
+        b = b + rotateLeft(a + f + K[i] + m[g], S[i]);
+        a = tmp;
+    };
+    // one loop per round keeps the round function out of the inner branch
+    for (uint32_t i = 0; i < 16; ++i) {
+        step(d ^ (b & (c ^ d)), i, i);
+    }
+    for (uint32_t i = 16; i < 32; ++i) {
+        step(c ^ (d & (b ^ c)), i, (5 * i + 1) & 15);
+    }
+    for (uint32_t i = 32; i < 48; ++i) {
+        step(b ^ c ^ d, i, (3 * i + 5) & 15);
+    }
+    for (uint32_t i = 48; i < 64; ++i) {
+        step(c ^ (b | ~d), i, (7 * i) & 15);
+    }
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+}
+
+} // namespace cc
@@ -26,43 +26,23 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "base/Scheduler.h"
+#include <algorithm>
+#include <cmath>
 #include "base/Macros.h"
-#include "base/Array.h"
 
-#define CC_REPEAT_FOREVER (UINT_MAX - 1)
+#define CC_REPEAT_FOREVER (Scheduler::REPEAT_FOREVER)
 
 namespace cc {
 
-// data structures
-
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry {
-    struct _listEntry *prev, *next;
-    ccSchedulerFunc callback;
-    void *target;
-    int priority;
-    bool paused;
-    bool markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry {
-    tListEntry **list; // Which list does it belong to ?
-    tListEntry *entry; // entry in the list
-    void *target;
-    ccSchedulerFunc callback;
-    UT_hash_handle hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry {
-    ccArray *timers;
-    void *target;
-    int timerIndex;
-    Timer *currentTimer;
-    bool currentTimerSalvaged;
-    bool paused;
-    UT_hash_handle hh;
-} tHashTimerEntry;
+namespace {
+constexpr double TICK_SECONDS = 0.001;
+// accumulated frame times may miss an exact due time by a rounding error
+constexpr double TIME_EPSILON = 1e-6;
+
+CC_INLINE int64_t toTick(double time) {
+    return static_cast<int64_t>(std::floor(time / TICK_SECONDS));
+}
+} // namespace
 
 // implementation Timer
 
@@ -152,143 +132,489 @@ void TimerTargetCallback::cancel() {
 
 // implementation of Scheduler
 
+constexpr Scheduler::TimerHandle Scheduler::INVALID_TIMER;
+constexpr unsigned int Scheduler::REPEAT_FOREVER;
+constexpr uint32_t Scheduler::INVALID_INDEX;
+
 Scheduler::Scheduler() {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    std::fill(std::begin(_listHeads), std::end(_listHeads), INVALID_INDEX);
+    std::fill(std::begin(_listTails), std::end(_listTails), INVALID_INDEX);
+    _functionsHead.store(&_functionsStub);
+    _functionsTail = &_functionsStub;
 }
 
 Scheduler::~Scheduler(void) {
     unscheduleAll();
+    while (FunctionNode *node = popFunction()) {
+        delete node;
+    }
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element) {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+Scheduler::TimerHandle Scheduler::makeHandle(uint32_t index) const {
+    return (static_cast<TimerHandle>(_timers[index].generation) << 32) | index;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc &callback, void *target, float interval, bool paused, const std::string &key) {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+Scheduler::TimerEntry *Scheduler::getTimer(TimerHandle handle) {
+    return const_cast<TimerEntry *>(static_cast<const Scheduler *>(this)->getTimer(handle));
 }
 
-void Scheduler::schedule(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string &key) {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
+const Scheduler::TimerEntry *Scheduler::getTimer(TimerHandle handle) const {
+    const auto index = static_cast<uint32_t>(handle & 0xffffffff);
+    if (handle == INVALID_TIMER || index >= _timers.size()) return nullptr;
+    const TimerEntry &timer = _timers[index];
+    if (timer.generation != static_cast<uint32_t>(handle >> 32) ||
+        timer.state == TimerState::FREE || timer.state == TimerState::CANCELLED) {
+        return nullptr;
+    }
+    return &timer;
+}
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+uint32_t Scheduler::allocateTimer() {
+    if (_freeTimers != INVALID_INDEX) {
+        const uint32_t index = _freeTimers;
+        _freeTimers = _timers[index].next;
+        _timers[index].next = INVALID_INDEX;
+        return index;
+    }
+    _timers.emplace_back();
+    return static_cast<uint32_t>(_timers.size() - 1);
+}
 
-    if (!element) {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+void Scheduler::releaseTimer(uint32_t index) {
+    unlinkTimer(index);
+    TimerEntry &timer = _timers[index];
+    timer.callback = nullptr;
+    timer.target = nullptr;
+    timer.key.clear();
+    timer.state = TimerState::FREE;
+    if (++timer.generation == 0) timer.generation = 1;
+    timer.next = _freeTimers;
+    _freeTimers = index;
+}
+
+uint32_t Scheduler::findKeyedTimer(void *target, const std::string &key) const {
+    auto iter = _targets.find(target);
+    if (iter == _targets.end()) return INVALID_INDEX;
+    for (const uint32_t index : iter->second.timers) {
+        if (_timers[index].key == key) return index;
+    }
+    return INVALID_INDEX;
+}
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+void Scheduler::detachFromTarget(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    if (!timer.target) return;
+
+    auto iter = _targets.find(timer.target);
+    if (iter != _targets.end()) {
+        auto &timers = iter->second.timers;
+        auto found = std::find(timers.begin(), timers.end(), index);
+        if (found != timers.end()) {
+            *found = timers.back();
+            timers.pop_back();
+        }
+        if (timers.empty()) _targets.erase(iter);
+    }
+    timer.target = nullptr;
+}
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+void Scheduler::cancelTimer(uint32_t index) {
+    if (index == _firingTimer) {
+        // the callback is still running, it is released once it returns
+        unlinkTimer(index);
+        _timers[index].state = TimerState::CANCELLED;
     } else {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
+        releaseTimer(index);
     }
+}
 
-    if (element->timers == nullptr) {
-        element->timers = ccArrayNew(10);
+// intrusive lists
+
+void Scheduler::linkTimer(uint32_t index, uint32_t list) {
+    TimerEntry &timer = _timers[index];
+    timer.list = list;
+    timer.next = INVALID_INDEX;
+    timer.prev = _listTails[list];
+    if (timer.prev != INVALID_INDEX) {
+        _timers[timer.prev].next = index;
+    } else {
+        _listHeads[list] = index;
+    }
+    _listTails[list] = index;
+}
+
+void Scheduler::unlinkTimer(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    if (timer.list == INVALID_INDEX) return;
+
+    if (timer.prev != INVALID_INDEX) {
+        _timers[timer.prev].next = timer.next;
+    } else {
+        _listHeads[timer.list] = timer.next;
+    }
+    if (timer.next != INVALID_INDEX) {
+        _timers[timer.next].prev = timer.prev;
     } else {
-        for (int i = 0; i < element->timers->num; ++i) {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback *>(element->timers->arr[i]);
+        _listTails[timer.list] = timer.prev;
+    }
+    timer.list = timer.prev = timer.next = INVALID_INDEX;
+}
+
+// timing wheel
+
+void Scheduler::insertIntoWheel(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    timer.state = TimerState::ARMED;
+
+    int64_t tick = std::max(toTick(timer.dueTime), _wheelTick);
+    int64_t delta = tick - _wheelTick;
+    uint32_t level = 0;
+    while (level + 1 < WHEEL_LEVELS && delta >= (static_cast<int64_t>(1) << (WHEEL_BITS * (level + 1)))) {
+        ++level;
+    }
+    // further than the wheel reaches, parked in the last slot and cascaded down later
+    const int64_t maxDelta = (static_cast<int64_t>(1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    if (delta > maxDelta) tick = _wheelTick + maxDelta;
+
+    const auto slot = static_cast<uint32_t>((tick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1));
+    linkTimer(index, level * WHEEL_SIZE + slot);
+}
+
+void Scheduler::cascade(uint32_t level) {
+    const auto list = level * WHEEL_SIZE + static_cast<uint32_t>((_wheelTick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1));
+    uint32_t index = _listHeads[list];
+    _listHeads[list] = _listTails[list] = INVALID_INDEX;
+    while (index != INVALID_INDEX) {
+        TimerEntry &timer = _timers[index];
+        const uint32_t next = timer.next;
+        timer.list = timer.prev = timer.next = INVALID_INDEX;
+        insertIntoWheel(index);
+        index = next;
+    }
+}
+
+void Scheduler::advanceWheel() {
+    const int64_t targetTick = toTick(_time);
 
-            if (timer && key == timer->getKey()) {
-                CC_LOG_DEBUG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
-                return;
+    if (targetTick - _wheelTick > static_cast<int64_t>(WHEEL_SIZE * WHEEL_SIZE)) {
+        // a long stall, rebuilding is cheaper than walking every tick
+        std::vector<uint32_t> timers;
+        for (uint32_t list = 0; list < PER_FRAME_LIST; ++list) {
+            for (uint32_t index = _listHeads[list]; index != INVALID_INDEX; index = _timers[index].next) {
+                timers.push_back(index);
             }
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
+        for (const uint32_t index : timers) unlinkTimer(index);
+        _wheelTick = targetTick;
+        for (const uint32_t index : timers) insertIntoWheel(index);
     }
 
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
-    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    while (true) {
+        if ((_wheelTick & (WHEEL_SIZE - 1)) == 0) {
+            for (uint32_t level = 1; level < WHEEL_LEVELS; ++level) {
+                cascade(level);
+                if (((_wheelTick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1)) != 0) break;
+            }
+        }
+
+        const auto list = static_cast<uint32_t>(_wheelTick & (WHEEL_SIZE - 1));
+        for (uint32_t index = _listHeads[list]; index != INVALID_INDEX;) {
+            TimerEntry &timer = _timers[index];
+            const uint32_t next = timer.next;
+            if (timer.dueTime <= _time + TIME_EPSILON) {
+                unlinkTimer(index);
+                timer.state = TimerState::DUE;
+                _dueTimers.push_back(index);
+            }
+            index = next;
+        }
+
+        // the current tick is only partially elapsed, it is visited again next frame
+        if (_wheelTick >= targetTick) break;
+        ++_wheelTick;
+    }
 }
 
-void Scheduler::unschedule(const std::string &key, void *target) {
-    // explicit handle nil arguments when removing an object
-    if (target == nullptr || key.empty()) {
-        return;
+void Scheduler::armTimer(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    if (timer.interval <= 0.f && !timer.useDelay) {
+        timer.state = TimerState::PER_FRAME;
+        linkTimer(index, PER_FRAME_LIST);
+    } else {
+        timer.dueTime = _time + (timer.useDelay ? timer.delay : timer.interval);
+        insertIntoWheel(index);
     }
+}
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
+void Scheduler::armPendingTimers() {
+    uint32_t index = _listHeads[PENDING_LIST];
+    _listHeads[PENDING_LIST] = _listTails[PENDING_LIST] = INVALID_INDEX;
+    while (index != INVALID_INDEX) {
+        TimerEntry &timer = _timers[index];
+        const uint32_t next = timer.next;
+        timer.list = timer.prev = timer.next = INVALID_INDEX;
+        armTimer(index);
+        index = next;
+    }
+}
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+void Scheduler::pauseTimer(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    switch (timer.state) {
+        case TimerState::PENDING:
+            unlinkTimer(index);
+            // never started counting, goes back to pending on resume
+            timer.dueTime = -1.0;
+            break;
+        case TimerState::ARMED:
+        case TimerState::DUE:
+            unlinkTimer(index);
+            timer.dueTime = std::max(0.0, timer.dueTime - _time);
+            break;
+        case TimerState::PER_FRAME:
+            unlinkTimer(index);
+            timer.dueTime = 0.0;
+            break;
+        case TimerState::FIRING:
+            // remaining time is worked out once the callback returns
+            break;
+        default:
+            return;
+    }
+    timer.state = TimerState::PAUSED;
+}
+
+void Scheduler::resumeTimer(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    if (timer.state != TimerState::PAUSED) return;
+
+    if (index == _firingTimer) {
+        timer.state = TimerState::FIRING;
+    } else if (timer.dueTime < 0.0) {
+        timer.state = TimerState::PENDING;
+        linkTimer(index, PENDING_LIST);
+    } else if (timer.interval <= 0.f && !timer.useDelay) {
+        timer.state = TimerState::PER_FRAME;
+        linkTimer(index, PER_FRAME_LIST);
+    } else {
+        timer.dueTime += _time;
+        insertIntoWheel(index);
+    }
+}
 
-    if (element) {
-        for (int i = 0; i < element->timers->num; ++i) {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback *>(element->timers->arr[i]);
+void Scheduler::setTimerInterval(uint32_t index, float interval) {
+    TimerEntry &timer = _timers[index];
+    const float oldInterval = timer.interval;
+    timer.interval = interval;
+
+    if (timer.state == TimerState::ARMED && !timer.useDelay) {
+        unlinkTimer(index);
+        if (interval <= 0.f) {
+            timer.state = TimerState::PER_FRAME;
+            linkTimer(index, PER_FRAME_LIST);
+        } else {
+            // keep the time already elapsed since the last trigger
+            timer.dueTime += interval - oldInterval;
+            insertIntoWheel(index);
+        }
+    } else if (timer.state == TimerState::PER_FRAME && interval > 0.f) {
+        unlinkTimer(index);
+        timer.dueTime = _time + interval;
+        insertIntoWheel(index);
+    }
+}
 
-            if (timer && key == timer->getKey()) {
-                if (timer == element->currentTimer && (!element->currentTimerSalvaged)) {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
+// triggering
 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
+void Scheduler::fireFrameTimer(uint32_t index, float dt) {
+    TimerEntry &timer = _timers[index];
+    timer.state = TimerState::FIRING;
+    _firingTimer = index;
+    timer.callback(dt);
+    _firingTimer = INVALID_INDEX;
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i) {
-                    element->timerIndex--;
-                }
+    if (timer.state == TimerState::CANCELLED) {
+        releaseTimer(index);
+        return;
+    }
+    ++timer.timesExecuted;
+    if (timer.repeat != CC_REPEAT_FOREVER && timer.timesExecuted > timer.repeat) {
+        detachFromTarget(index);
+        releaseTimer(index);
+        return;
+    }
 
-                if (element->timers->num == 0) {
-                    if (_currentTarget == element) {
-                        _currentTargetSalvaged = true;
-                    } else {
-                        removeHashElement(element);
-                    }
-                }
+    if (timer.state == TimerState::PAUSED) {
+        unlinkTimer(index);
+        timer.dueTime = 0.0;
+    } else if (timer.interval > 0.f) {
+        // the interval was changed from inside the callback
+        unlinkTimer(index);
+        timer.dueTime = _time + timer.interval;
+        insertIntoWheel(index);
+    } else {
+        timer.state = TimerState::PER_FRAME;
+    }
+}
 
-                return;
+void Scheduler::fireDueTimer(uint32_t index) {
+    TimerEntry &timer = _timers[index];
+    _firingTimer = index;
+
+    // a long frame may cover several intervals, trigger once for each like the per target timers used to
+    float dt = timer.useDelay ? timer.delay : timer.interval;
+    bool delayed = timer.useDelay;
+    while (true) {
+        timer.state = TimerState::FIRING;
+        timer.useDelay = false;
+        timer.callback(dt);
+
+        if (timer.state == TimerState::CANCELLED) {
+            _firingTimer = INVALID_INDEX;
+            releaseTimer(index);
+            return;
+        }
+        ++timer.timesExecuted;
+        if (timer.repeat != CC_REPEAT_FOREVER && timer.timesExecuted > timer.repeat) {
+            _firingTimer = INVALID_INDEX;
+            detachFromTarget(index);
+            releaseTimer(index);
+            return;
+        }
+
+        const bool paused = timer.state == TimerState::PAUSED;
+        if (timer.interval <= 0.f) {
+            // delayed timer continuing every frame, the rest of this frame is triggered right away
+            if (paused) {
+                timer.dueTime = 0.0;
+            } else if (delayed) {
+                dt = static_cast<float>(std::max(0.0, _time - timer.dueTime));
+                delayed = false;
+                continue;
+            } else {
+                timer.state = TimerState::PER_FRAME;
+                linkTimer(index, PER_FRAME_LIST);
             }
+            break;
+        }
+
+        delayed = false;
+        dt = timer.interval;
+        timer.dueTime += timer.interval;
+        if (paused) {
+            timer.dueTime = std::max(0.0, timer.dueTime - _time);
+            break;
+        }
+        if (timer.dueTime > _time + TIME_EPSILON) {
+            insertIntoWheel(index);
+            break;
         }
     }
+    _firingTimer = INVALID_INDEX;
 }
 
-bool Scheduler::isScheduled(const std::string &key, void *target) {
-    CCASSERT(!key.empty(), "Argument key must not be empty");
+// schedule
+
+void Scheduler::schedule(const ccSchedulerFunc &callback, void *target, float interval, bool paused, const std::string &key) {
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string &key) {
     CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    auto iter = _targets.find(target);
+    if (iter != _targets.end()) {
+        CCASSERT(iter->second.paused == paused, "element's paused should be paused!");
 
-    if (!element) {
-        return false;
+        const uint32_t index = findKeyedTimer(target, key);
+        if (index != INVALID_INDEX) {
+            CC_LOG_DEBUG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", _timers[index].interval, interval);
+            setTimerInterval(index, interval);
+            return;
+        }
     }
 
-    if (element->timers == nullptr) {
-        return false;
+    scheduleTimerImpl(callback, target, interval, repeat, delay, paused, key);
+}
+
+Scheduler::TimerHandle Scheduler::scheduleTimer(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused) {
+    CCASSERT(target || !paused, "A timer without target can't be resumed");
+    return scheduleTimerImpl(callback, target, interval, repeat, delay, paused, std::string());
+}
+
+Scheduler::TimerHandle Scheduler::scheduleTimerImpl(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string &key) {
+    const uint32_t index = allocateTimer();
+    TimerEntry &timer = _timers[index];
+    timer.callback = callback;
+    timer.target = target;
+    timer.key = key;
+    timer.interval = interval;
+    timer.delay = delay;
+    timer.useDelay = delay > 0.f;
+    timer.repeat = repeat;
+    timer.timesExecuted = 0;
+
+    if (target) {
+        TargetEntry &entry = _targets[target];
+        // the first timer decides whether the target starts paused
+        if (entry.timers.empty()) entry.paused = paused;
+        entry.timers.push_back(index);
+        paused = entry.paused;
+    }
+
+    if (paused) {
+        timer.state = TimerState::PAUSED;
+        timer.dueTime = -1.0;
     } else {
-        for (int i = 0; i < element->timers->num; ++i) {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback *>(element->timers->arr[i]);
+        timer.state = TimerState::PENDING;
+        linkTimer(index, PENDING_LIST);
+    }
+    return makeHandle(index);
+}
 
-            if (timer && key == timer->getKey()) {
-                return true;
-            }
-        }
+void Scheduler::unscheduleTimer(TimerHandle handle) {
+    if (!getTimer(handle)) return;
+    const auto index = static_cast<uint32_t>(handle & 0xffffffff);
+    detachFromTarget(index);
+    cancelTimer(index);
+}
+
+bool Scheduler::isCurrentTargetSalvaged() const {
+    return _firingTimer != INVALID_INDEX && _timers[_firingTimer].state == TimerState::CANCELLED;
+}
+
+bool Scheduler::isTimerScheduled(TimerHandle handle) const {
+    return getTimer(handle) != nullptr;
+}
 
-        return false;
+void Scheduler::unschedule(const std::string &key, void *target) {
+    // explicit handle nil arguments when removing an object
+    if (target == nullptr || key.empty()) {
+        return;
     }
 
-    return false; // should never get here
+    const uint32_t index = findKeyedTimer(target, key);
+    if (index != INVALID_INDEX) {
+        detachFromTarget(index);
+        cancelTimer(index);
+    }
 }
 
-void Scheduler::unscheduleAll() {
-    for (tHashTimerEntry *element = _hashForTimers, *nextElement = nullptr; element != nullptr;) {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
+bool Scheduler::isScheduled(const std::string &key, void *target) {
+    CCASSERT(!key.empty(), "Argument key must not be empty");
+    CCASSERT(target, "Argument target must be non-nullptr");
+
+    return findKeyedTimer(target, key) != INVALID_INDEX;
+}
 
-        element = nextElement;
+void Scheduler::unscheduleAll() {
+    _targets.clear();
+    for (uint32_t index = 0; index < _timers.size(); ++index) {
+        TimerEntry &timer = _timers[index];
+        if (timer.state == TimerState::FREE || timer.state == TimerState::CANCELLED) continue;
+        timer.target = nullptr;
+        cancelTimer(index);
     }
 }
 
@@ -298,55 +624,47 @@ void Scheduler::unscheduleAllForTarget(void *target) {
         return;
     }
 
-    // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element) {
-        if (ccArrayContainsObject(element->timers, element->currentTimer) && (!element->currentTimerSalvaged)) {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
+    auto iter = _targets.find(target);
+    if (iter == _targets.end()) return;
 
-        if (_currentTarget == element) {
-            _currentTargetSalvaged = true;
-        } else {
-            removeHashElement(element);
-        }
+    const std::vector<uint32_t> timers = std::move(iter->second.timers);
+    _targets.erase(iter);
+    for (const uint32_t index : timers) {
+        _timers[index].target = nullptr;
+        cancelTimer(index);
     }
 }
 
 void Scheduler::resumeTarget(void *target) {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element) {
-        element->paused = false;
+    auto iter = _targets.find(target);
+    if (iter != _targets.end() && iter->second.paused) {
+        iter->second.paused = false;
+        for (const uint32_t index : iter->second.timers) {
+            resumeTimer(index);
+        }
     }
 }
 
 void Scheduler::pauseTarget(void *target) {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element) {
-        element->paused = true;
+    auto iter = _targets.find(target);
+    if (iter != _targets.end() && !iter->second.paused) {
+        iter->second.paused = true;
+        for (const uint32_t index : iter->second.timers) {
+            pauseTimer(index);
+        }
     }
 }
 
 bool Scheduler::isTargetPaused(void *target) {
     CCASSERT(target != nullptr, "target must be non nil");
 
-    // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element) {
-        return element->paused;
+    auto iter = _targets.find(target);
+    if (iter != _targets.end()) {
+        return iter->second.paused;
     }
 
     return false; // should never get here
@@ -355,11 +673,14 @@ bool Scheduler::isTargetPaused(void *target) {
 std::set<void *> Scheduler::pauseAllTargets() {
     std::set<void *> idsWithSelectors;
 
-    // Custom Selectors
-    for (tHashTimerEntry *element = _hashForTimers; element != nullptr;
-         element = (tHashTimerEntry *)element->hh.next) {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+    for (auto &iter : _targets) {
+        if (!iter.second.paused) {
+            iter.second.paused = true;
+            for (const uint32_t index : iter.second.timers) {
+                pauseTimer(index);
+            }
+        }
+        idsWithSelectors.insert(iter.first);
     }
 
     return idsWithSelectors;
@@ -371,74 +692,98 @@ void Scheduler::resumeTargets(const std::set<void *> &targetsToResume) {
     }
 }
 
-void Scheduler::performFunctionInCocosThread(const std::function<void()> &function) {
-    _performMutex.lock();
-    _functionsToPerform.push_back(function);
-    _performMutex.unlock();
-}
+// functions performed in cocos thread
 
-void Scheduler::removeAllFunctionsToBePerformedInCocosThread() {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+void Scheduler::pushFunction(FunctionNode *node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    FunctionNode *prev = _functionsHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
 }
 
-// main loop
-void Scheduler::update(float dt) {
-    _updateHashLocked = true;
-
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr;) {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (!_currentTarget->paused) {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex)) {
-                elt->currentTimer = (Timer *)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+Scheduler::FunctionNode *Scheduler::popFunction() {
+    FunctionNode *tail = _functionsTail;
+    FunctionNode *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_functionsStub) {
+        if (!next) return nullptr;
+        _functionsTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        _functionsTail = next;
+        return tail;
+    }
+    // a producer swapped the head but hasn't linked its node yet
+    if (tail != _functionsHead.load(std::memory_order_acquire)) return nullptr;
+
+    pushFunction(&_functionsStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        _functionsTail = next;
+        return tail;
+    }
+    return nullptr;
+}
 
-                elt->currentTimer->update(dt);
+void Scheduler::performFunctionInCocosThread(const std::function<void()> &function) {
+    auto *node = new FunctionNode();
+    node->function = function;
+    node->sequence = _functionSequence.fetch_add(1, std::memory_order_relaxed);
+    _pendingFunctionCount.fetch_add(1, std::memory_order_relaxed);
+    pushFunction(node);
+}
 
-                if (elt->currentTimerSalvaged) {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+void Scheduler::removeAllFunctionsToBePerformedInCocosThread() {
+    // only the cocos thread pops the queue, other threads just move the discard mark forward
+    const uint64_t sequence = _functionSequence.load(std::memory_order_relaxed);
+    uint64_t discarded = _discardedFunctionSequence.load(std::memory_order_relaxed);
+    while (discarded < sequence &&
+           !_discardedFunctionSequence.compare_exchange_weak(discarded, sequence, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
 
-                elt->currentTimer = nullptr;
-            }
+void Scheduler::performFunctions() {
+    // Testing the counter is faster than touching the queue, and almost never
+    // there will be functions scheduled to be called. Functions posted while
+    // these run are left for the next frame.
+    int count = _pendingFunctionCount.load(std::memory_order_acquire);
+    for (; count > 0; --count) {
+        FunctionNode *node = popFunction();
+        if (!node) break;
+        _pendingFunctionCount.fetch_sub(1, std::memory_order_relaxed);
+        if (node->sequence >= _discardedFunctionSequence.load(std::memory_order_acquire)) {
+            node->function();
         }
+        delete node;
+    }
+}
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+// main loop
+void Scheduler::update(float dt) {
+    _time += dt;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0) {
-            removeHashElement(_currentTarget);
-        }
+    // timers armed below start counting from this frame on and are not triggered yet
+    _frameTimers.clear();
+    for (uint32_t index = _listHeads[PER_FRAME_LIST]; index != INVALID_INDEX; index = _timers[index].next) {
+        _frameTimers.push_back(index);
     }
+    armPendingTimers();
 
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
-
-    //
-    // Functions allocated from another thread
-    //
+    _dueTimers.clear();
+    advanceWheel();
+    std::stable_sort(_dueTimers.begin(), _dueTimers.end(), [this](uint32_t lhs, uint32_t rhs) {
+        return _timers[lhs].dueTime < _timers[rhs].dueTime;
+    });
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if (!_functionsToPerform.empty()) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for (const auto &function : temp) {
-            function();
-        }
+    // callbacks may unschedule or pause anything, the states are checked right before triggering
+    for (const uint32_t index : _frameTimers) {
+        if (_timers[index].state == TimerState::PER_FRAME) fireFrameTimer(index, dt);
     }
+    for (const uint32_t index : _dueTimers) {
+        if (_timers[index].state == TimerState::DUE) fireDueTimer(index);
+    }
+
+    performFunctions();
 }
 
 } // namespace cc
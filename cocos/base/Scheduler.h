@@ -27,13 +27,19 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/Ref.h"
 #include "base/Vector.h"
-#include "base/uthash.h"
 
 namespace cc {
 
@@ -44,6 +50,7 @@ typedef std::function<void(float)> ccSchedulerFunc;
 /**
  * @cond
  */
+// Kept for code that drives its own timers, the Scheduler doesn't use these classes internally any more.
 class CC_DLL Timer : public Ref {
 public:
     /** get interval in seconds */
@@ -101,10 +108,6 @@ protected:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 /** @brief Scheduler is responsible for triggering the scheduled callbacks.
 You should not use system timer for your game logic. Instead, use this class.
 
@@ -115,9 +118,18 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+Timers are addressed by integer handles. Timers firing every frame live in a plain list, all others sit in
+a hierarchical timing wheel with millisecond ticks, so a frame only touches the timers that are due.
+The string keys of the target based API are looked up once when scheduling or unscheduling.
+
 */
 class CC_DLL Scheduler final {
 public:
+    // 0 never refers to a timer
+    typedef uint64_t TimerHandle;
+    static constexpr TimerHandle INVALID_TIMER = 0;
+    static constexpr unsigned int REPEAT_FOREVER = UINT_MAX - 1;
+
     /**
      * Constructor
      *
@@ -171,6 +183,19 @@ public:
      */
     void schedule(const ccSchedulerFunc &callback, void *target, float interval, bool paused, const std::string &key);
 
+    /** Schedules a callback without a key and returns a handle to it.
+     The arguments have the same meaning as in schedule(), target may be null
+     when the timer doesn't need to be paused or unscheduled together with other timers.
+     The timer starts counting on the frame after it is scheduled, like keyed timers do.
+     */
+    TimerHandle scheduleTimer(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused);
+
+    /** Unschedules a timer returned by scheduleTimer. Stale handles are ignored. */
+    void unscheduleTimer(TimerHandle handle);
+
+    /** Checks whether the timer is still scheduled, a timer is unscheduled once it ran out of repeats. */
+    bool isTimerScheduled(TimerHandle handle) const;
+
     /////////////////////////////////////
 
     // unschedule
@@ -265,7 +290,7 @@ public:
     void resumeTargets(const std::set<void *> &targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and lock free, functions run in the order they were posted.
      @param function The function to be run in cocos2d thread.
      @since v3.0
      @js NA
@@ -281,24 +306,107 @@ public:
      */
     void removeAllFunctionsToBePerformedInCocosThread();
 
-    bool isCurrentTargetSalvaged() const { return _currentTargetSalvaged; };
+    /** Whether the timer being triggered right now was unscheduled from inside its own callback. */
+    bool isCurrentTargetSalvaged() const;
 
 private:
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
-
-    // update specific
-
-    // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers = nullptr;
-    struct _hashSelectorEntry *_currentTarget = nullptr;
-    bool _currentTargetSalvaged = false;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked = false;
-
-    // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    static constexpr uint32_t WHEEL_BITS = 8;
+    static constexpr uint32_t WHEEL_SIZE = 1 << WHEEL_BITS;
+    static constexpr uint32_t WHEEL_LEVELS = 4;
+    // intrusive lists, the wheel slots come first
+    static constexpr uint32_t PER_FRAME_LIST = WHEEL_SIZE * WHEEL_LEVELS;
+    static constexpr uint32_t PENDING_LIST = PER_FRAME_LIST + 1;
+    static constexpr uint32_t LIST_COUNT = PENDING_LIST + 1;
+
+    enum class TimerState : uint8_t {
+        FREE,
+        PENDING,   // scheduled since the last update, starts counting on the next one
+        ARMED,     // waiting in the wheel
+        PER_FRAME, // waiting in the per frame list
+        DUE,       // collected to be triggered in this update
+        FIRING,
+        PAUSED,
+        CANCELLED, // unscheduled while firing, freed once the callback returns
+    };
+
+    struct TimerEntry {
+        ccSchedulerFunc callback;
+        void *target = nullptr;
+        std::string key;
+        // absolute scheduler time of the next trigger, remaining time while paused
+        double dueTime = 0.0;
+        float interval = 0.f;
+        float delay = 0.f;
+        unsigned int repeat = 0;
+        unsigned int timesExecuted = 0;
+        uint32_t generation = 1;
+        uint32_t list = INVALID_INDEX;
+        uint32_t prev = INVALID_INDEX;
+        uint32_t next = INVALID_INDEX;
+        TimerState state = TimerState::FREE;
+        bool useDelay = false;
+    };
+
+    struct TargetEntry {
+        std::vector<uint32_t> timers;
+        bool paused = false;
+    };
+
+    // Intrusive node of the cross thread function queue (Vyukov MPSC).
+    struct FunctionNode {
+        std::atomic<FunctionNode *> next{nullptr};
+        uint64_t sequence = 0;
+        std::function<void()> function;
+    };
+
+    TimerEntry *getTimer(TimerHandle handle);
+    const TimerEntry *getTimer(TimerHandle handle) const;
+    TimerHandle makeHandle(uint32_t index) const;
+    uint32_t findKeyedTimer(void *target, const std::string &key) const;
+    uint32_t allocateTimer();
+    void releaseTimer(uint32_t index);
+    TimerHandle scheduleTimerImpl(const ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string &key);
+    void setTimerInterval(uint32_t index, float interval);
+    void cancelTimer(uint32_t index);
+    void detachFromTarget(uint32_t index);
+
+    void linkTimer(uint32_t index, uint32_t list);
+    void unlinkTimer(uint32_t index);
+    void insertIntoWheel(uint32_t index);
+    void cascade(uint32_t level);
+    void advanceWheel();
+    void armPendingTimers();
+    void armTimer(uint32_t index);
+    void pauseTimer(uint32_t index);
+    void resumeTimer(uint32_t index);
+    void fireFrameTimer(uint32_t index, float dt);
+    void fireDueTimer(uint32_t index);
+
+    void pushFunction(FunctionNode *node);
+    FunctionNode *popFunction();
+    void performFunctions();
+
+    // Entries never move, callbacks may schedule new timers while they run.
+    std::deque<TimerEntry> _timers;
+    uint32_t _freeTimers = INVALID_INDEX;
+    uint32_t _listHeads[LIST_COUNT];
+    uint32_t _listTails[LIST_COUNT];
+    std::unordered_map<void *, TargetEntry> _targets;
+    std::vector<uint32_t> _frameTimers;
+    std::vector<uint32_t> _dueTimers;
+    uint32_t _firingTimer = INVALID_INDEX;
+
+    double _time = 0.0;
+    int64_t _wheelTick = 0;
+
+    std::atomic<FunctionNode *> _functionsHead{nullptr};
+    FunctionNode *_functionsTail = nullptr;
+    FunctionNode _functionsStub;
+    std::atomic<int> _pendingFunctionCount{0};
+    std::atomic<uint64_t> _functionSequence{0};
+    // functions posted before this sequence number are dropped instead of performed
+    std::atomic<uint64_t> _discardedFunctionSequence{0};
 };
 
 // end of base group
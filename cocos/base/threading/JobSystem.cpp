@@ -0,0 +1,374 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "JobSystem.h"
+
+namespace cc {
+
+namespace {
+
+constexpr uint JOBS_PER_CHUNK = 256;
+constexpr uint FREE_BATCH_SIZE = 64;
+constexpr int64_t DEQUE_CAPACITY = 4096;
+
+std::atomic<uint> generationCounter{0};
+
+struct ThreadContext {
+    uint generation = 0;
+    int workerIndex = -1;
+    Job *freeJobs = nullptr;
+    uint freeJobCount = 0;
+};
+
+thread_local ThreadContext tlsContext;
+
+} // namespace
+
+// Chase-Lev deque with a fixed ring, see "Correct and Efficient Work-Stealing
+// for Weak Memory Models" (Le et al. 2013). Only the owner pushes and pops at
+// the bottom, any thread may steal from the top.
+struct JobSystem::Worker {
+    // keep thieves and the owner on separate cache lines
+    std::atomic<int64_t> top{0};
+    uint8_t padding[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom{0};
+    std::atomic<Job *> ring[DEQUE_CAPACITY];
+
+    bool push(Job *job) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= DEQUE_CAPACITY) return false;
+        ring[b & (DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Job *pop() {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job *job = ring[b & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last element, race against thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job *steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job *job = ring[t & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return job;
+    }
+};
+
+struct JobSystem::JobChunk {
+    JobChunk *next = nullptr;
+    Job jobs[JOBS_PER_CHUNK];
+};
+
+JobSystem *JobSystem::_instance = nullptr;
+
+JobSystem *JobSystem::getInstance() {
+    if (!_instance) {
+        // the thread submitting work always helps while it waits
+        const auto workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        _instance = new JobSystem(static_cast<uint>(workerCount));
+    }
+    return _instance;
+}
+
+void JobSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+JobSystem::JobSystem(uint workerCount)
+: _generation(++generationCounter) {
+    _workers.reserve(workerCount);
+    for (uint i = 0; i < workerCount; ++i) {
+        _workers.push_back(new Worker());
+    }
+    _threads.reserve(workerCount);
+    for (uint i = 0; i < workerCount; ++i) {
+        _threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit.store(true);
+        _sleepCondition.notify_all();
+    }
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+
+    // workers drain every queue before quitting, leftovers only exist without workers
+    for (Job *job : _injectionQueue) {
+        execute(job);
+    }
+    _injectionQueue.clear();
+
+    for (Worker *worker : _workers) {
+        delete worker;
+    }
+    _workers.clear();
+
+    while (_chunks) {
+        JobChunk *next = _chunks->next;
+        delete _chunks;
+        _chunks = next;
+    }
+    if (tlsContext.generation == _generation) {
+        tlsContext = ThreadContext();
+    }
+}
+
+int JobSystem::getCurrentWorkerIndex() const {
+    return tlsContext.generation == _generation ? tlsContext.workerIndex : -1;
+}
+
+Job *JobSystem::allocateJob() {
+    ThreadContext &context = tlsContext;
+    if (context.generation != _generation) {
+        context = ThreadContext();
+        context.generation = _generation;
+    }
+
+    if (!context.freeJobs) {
+        std::lock_guard<std::mutex> lock(_chunkMutex);
+        if (_sharedFreeJobs) {
+            for (uint i = 0; i < FREE_BATCH_SIZE && _sharedFreeJobs; ++i) {
+                Job *job = _sharedFreeJobs;
+                _sharedFreeJobs = job->_nextFree;
+                job->_nextFree = context.freeJobs;
+                context.freeJobs = job;
+                ++context.freeJobCount;
+            }
+        } else {
+            auto *chunk = new JobChunk();
+            chunk->next = _chunks;
+            _chunks = chunk;
+            for (Job &job : chunk->jobs) {
+                job._nextFree = context.freeJobs;
+                context.freeJobs = &job;
+            }
+            context.freeJobCount += JOBS_PER_CHUNK;
+        }
+    }
+
+    Job *job = context.freeJobs;
+    context.freeJobs = job->_nextFree;
+    --context.freeJobCount;
+
+    job->_nextFree = nullptr;
+    job->_continuationsClosed = false;
+    job->_continuationCount = 0;
+    return job;
+}
+
+void JobSystem::freeJob(Job *job) {
+    ThreadContext &context = tlsContext;
+    if (context.generation != _generation) {
+        context = ThreadContext();
+        context.generation = _generation;
+    }
+
+    job->_nextFree = context.freeJobs;
+    context.freeJobs = job;
+    ++context.freeJobCount;
+
+    // jobs are usually created on one thread and finished on another,
+    // give the surplus back so the creating thread doesn't keep growing the pool
+    if (context.freeJobCount >= FREE_BATCH_SIZE * 2) {
+        Job *batchHead = context.freeJobs;
+        Job *batchTail = batchHead;
+        for (uint i = 1; i < FREE_BATCH_SIZE; ++i) {
+            batchTail = batchTail->_nextFree;
+        }
+        context.freeJobs = batchTail->_nextFree;
+        context.freeJobCount -= FREE_BATCH_SIZE;
+
+        std::lock_guard<std::mutex> lock(_chunkMutex);
+        batchTail->_nextFree = _sharedFreeJobs;
+        _sharedFreeJobs = batchHead;
+    }
+}
+
+void JobSystem::addDependency(Job *job, Job *dependency) {
+    while (dependency->_continuationLock.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    if (!dependency->_continuationsClosed) {
+        CCASSERT(dependency->_continuationCount < Job::MAX_CONTINUATIONS, "Too many jobs depend on a single job");
+        job->_pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+        dependency->_continuations[dependency->_continuationCount++] = job;
+    }
+    dependency->_continuationLock.clear(std::memory_order_release);
+}
+
+void JobSystem::run(Job *job) {
+    if (job->_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        schedule(job);
+    }
+}
+
+void JobSystem::wait(Job *job) {
+    const int workerIndex = getCurrentWorkerIndex();
+    while (!job->isFinished()) {
+        Job *other = fetchJob(workerIndex);
+        if (other) {
+            execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    release(job);
+}
+
+void JobSystem::release(Job *job) {
+    if (job->_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        freeJob(job);
+    }
+}
+
+void JobSystem::schedule(Job *job) {
+    _queuedJobCount.fetch_add(1);
+
+    const int workerIndex = getCurrentWorkerIndex();
+    if (workerIndex >= 0) {
+        if (!_workers[workerIndex]->push(job)) {
+            // deque is full, running inline keeps the ordering guarantees
+            _queuedJobCount.fetch_sub(1);
+            execute(job);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        _injectionQueue.push_back(job);
+    }
+
+    if (_sleepingWorkerCount.load() > 0) {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondition.notify_one();
+    }
+}
+
+void JobSystem::execute(Job *job) {
+    job->_invoke(job);
+    job->_destroy(job);
+    finish(job);
+}
+
+void JobSystem::finish(Job *job) {
+    if (job->_unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    while (job->_continuationLock.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    job->_continuationsClosed = true;
+    const uint continuationCount = job->_continuationCount;
+    job->_continuationLock.clear(std::memory_order_release);
+
+    for (uint i = 0; i < continuationCount; ++i) {
+        run(job->_continuations[i]);
+    }
+
+    Job *parent = job->_parent;
+    release(job);
+    if (parent) finish(parent);
+}
+
+Job *JobSystem::fetchJob(int workerIndex) {
+    Job *job = nullptr;
+    if (workerIndex >= 0) {
+        job = _workers[workerIndex]->pop();
+    }
+
+    if (!job) {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        if (!_injectionQueue.empty()) {
+            job = _injectionQueue.front();
+            _injectionQueue.pop_front();
+        }
+    }
+
+    if (!job) {
+        const uint workerCount = getWorkerCount();
+        const uint start = workerIndex >= 0 ? workerIndex + 1 : 0;
+        for (uint i = 0; i < workerCount && !job; ++i) {
+            const uint victim = (start + i) % workerCount;
+            if (static_cast<int>(victim) != workerIndex) {
+                job = _workers[victim]->steal();
+            }
+        }
+    }
+
+    if (job) _queuedJobCount.fetch_sub(1);
+    return job;
+}
+
+void JobSystem::workerLoop(uint index) {
+    tlsContext = ThreadContext();
+    tlsContext.generation = _generation;
+    tlsContext.workerIndex = static_cast<int>(index);
+
+    while (true) {
+        Job *job = fetchJob(static_cast<int>(index));
+        if (job) {
+            execute(job);
+            continue;
+        }
+
+        if (_queuedJobCount.load() > 0) {
+            // queued on a busy worker that hasn't popped it yet, keep trying to steal
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        if (_quit.load() && _queuedJobCount.load() == 0) break;
+        _sleepingWorkerCount.fetch_add(1);
+        _sleepCondition.wait(lock, [this] { return _quit.load() || _queuedJobCount.load() > 0; });
+        _sleepingWorkerCount.fetch_sub(1);
+    }
+}
+
+} // namespace cc
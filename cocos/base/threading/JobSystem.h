@@ -0,0 +1,241 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "base/Macros.h"
+
+namespace cc {
+
+class JobSystem;
+
+// A unit of work scheduled on the JobSystem.
+//
+// The callable is stored inline when it fits in STORAGE_SIZE bytes, otherwise it
+// is moved to the heap. A job is finished once its callable and all of its
+// children have returned; continuations registered with addDependency() are
+// scheduled at that point.
+class CC_DLL Job final {
+public:
+    static constexpr size_t STORAGE_SIZE = 64;
+    static constexpr uint MAX_CONTINUATIONS = 8;
+
+    CC_INLINE bool isFinished() const { return _unfinished.load(std::memory_order_acquire) == 0; }
+
+private:
+    using InvokeFunc = void (*)(Job *);
+    using DestroyFunc = void (*)(Job *);
+
+    Job() = default;
+    Job(const Job &) = delete;
+    Job &operator=(const Job &) = delete;
+
+    template <typename F>
+    void setCallable(F &&fn) {
+        using Callable = typename std::decay<F>::type;
+        if (sizeof(Callable) <= STORAGE_SIZE && alignof(Callable) <= alignof(std::max_align_t)) {
+            new (_storage) Callable(std::forward<F>(fn));
+            _invoke = [](Job *job) { (*reinterpret_cast<Callable *>(job->_storage))(); };
+            _destroy = [](Job *job) { reinterpret_cast<Callable *>(job->_storage)->~Callable(); };
+        } else {
+            *reinterpret_cast<Callable **>(_storage) = new Callable(std::forward<F>(fn));
+            _invoke = [](Job *job) { (**reinterpret_cast<Callable **>(job->_storage))(); };
+            _destroy = [](Job *job) { delete *reinterpret_cast<Callable **>(job->_storage); };
+        }
+    }
+
+    alignas(std::max_align_t) uint8_t _storage[STORAGE_SIZE];
+    InvokeFunc _invoke = nullptr;
+    DestroyFunc _destroy = nullptr;
+    Job *_parent = nullptr;
+    Job *_nextFree = nullptr;
+
+    // 1 for the job itself plus one per unfinished child
+    std::atomic<int> _unfinished{0};
+    // 1 until run() is called plus one per unfinished dependency
+    std::atomic<int> _pendingDependencies{0};
+    // one for the scheduler and one for the handle returned by createJob()
+    std::atomic<int> _refCount{0};
+
+    std::atomic_flag _continuationLock = ATOMIC_FLAG_INIT;
+    bool _continuationsClosed = false;
+    uint _continuationCount = 0;
+    Job *_continuations[MAX_CONTINUATIONS] = {};
+
+    friend class JobSystem;
+};
+
+// Engine wide fork/join job scheduler.
+//
+// Every worker owns a lock-free work-stealing deque: it pushes and pops its own
+// jobs LIFO and steals from other workers FIFO when it runs dry. Jobs submitted
+// from any other thread go through a shared injection queue. Threads waiting on
+// a job keep executing other jobs instead of blocking, so nested parallelism
+// does not deadlock.
+//
+// Jobs are meant for short, CPU bound work. Anything that blocks on I/O should
+// stay on a ThreadPool, it would otherwise stall a worker and everyone stealing
+// from it.
+//
+// Every handle returned by createJob() has to be passed to exactly one of wait()
+// or release(). dispatch() and parallelFor() manage their jobs internally.
+class CC_DLL JobSystem final {
+public:
+    static JobSystem *getInstance();
+    static void destroyInstance();
+
+    explicit JobSystem(uint workerCount);
+    ~JobSystem();
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Creates a job that is not scheduled until run() is called. A job created
+    // with a parent keeps the parent unfinished until it finishes itself, the
+    // parent must not be finished yet, which holds when called from inside it.
+    template <typename F>
+    Job *createJob(F &&fn, Job *parent = nullptr) {
+        Job *job = allocateJob();
+        job->setCallable(std::forward<F>(fn));
+        job->_parent = parent;
+        job->_unfinished.store(1, std::memory_order_relaxed);
+        job->_pendingDependencies.store(1, std::memory_order_relaxed);
+        job->_refCount.store(2, std::memory_order_relaxed);
+        if (parent) parent->_unfinished.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    // Delays job until dependency has finished; must be called before run(job).
+    void addDependency(Job *job, Job *dependency);
+
+    // Schedules the job once all its dependencies have finished.
+    void run(Job *job);
+
+    // Executes other jobs until job has finished, then releases the handle.
+    void wait(Job *job);
+
+    // Gives up the handle without waiting.
+    void release(Job *job);
+
+    // Fire-and-forget.
+    template <typename F>
+    void dispatch(F &&fn) {
+        Job *job = createJob(std::forward<F>(fn));
+        run(job);
+        release(job);
+    }
+
+    // Calls fn(i) for every i in [0, count) and returns when all calls have
+    // finished. The range is split recursively down to grainSize so idle workers
+    // can steal the larger halves; the calling thread takes part in the work.
+    template <typename F>
+    void parallelFor(uint count, uint grainSize, const F &fn) {
+        if (!count) return;
+        grainSize = std::max(1u, grainSize);
+        if (count <= grainSize || _workers.empty()) {
+            for (uint i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        Job *root = createJob([] {});
+        Job *range = createJob(ParallelForJob<F>{this, &fn, root, 0, count, grainSize}, root);
+        run(range);
+        release(range);
+        run(root);
+        wait(root);
+    }
+
+    CC_INLINE uint getWorkerCount() const { return static_cast<uint>(_workers.size()); }
+
+    // Index of the worker running on the calling thread, -1 on any other thread.
+    int getCurrentWorkerIndex() const;
+
+private:
+    struct Worker;
+    struct JobChunk;
+
+    template <typename F>
+    struct ParallelForJob {
+        JobSystem *system;
+        const F *fn;
+        Job *root;
+        uint begin;
+        uint end;
+        uint grainSize;
+
+        void operator()() const {
+            uint last = end;
+            while (last - begin > grainSize) {
+                const uint mid = begin + (last - begin) / 2;
+                Job *half = system->createJob(ParallelForJob{system, fn, root, mid, last, grainSize}, root);
+                system->run(half);
+                system->release(half);
+                last = mid;
+            }
+            for (uint i = begin; i < last; ++i) (*fn)(i);
+        }
+    };
+
+    Job *allocateJob();
+    void freeJob(Job *job);
+    void schedule(Job *job);
+    void execute(Job *job);
+    void finish(Job *job);
+    Job *fetchJob(int workerIndex);
+    void workerLoop(uint index);
+
+    static JobSystem *_instance;
+
+    std::vector<Worker *> _workers;
+    std::vector<std::thread> _threads;
+
+    std::mutex _injectionMutex;
+    std::deque<Job *> _injectionQueue;
+
+    // queued jobs nobody has picked up yet, used to park idle workers
+    std::atomic<int> _queuedJobCount{0};
+    std::atomic<int> _sleepingWorkerCount{0};
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<bool> _quit{false};
+
+    // jobs are carved out of chunks and recycled through thread local free lists,
+    // surplus free jobs are handed back to a shared list in batches
+    std::mutex _chunkMutex;
+    JobChunk *_chunks = nullptr;
+    Job *_sharedFreeJobs = nullptr;
+    uint _generation = 0;
+};
+
+} // namespace cc
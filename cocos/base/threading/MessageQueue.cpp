@@ -0,0 +1,201 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "MessageQueue.h"
+#include "base/memory/Memory.h"
+
+namespace cc {
+
+namespace {
+
+constexpr size_t CHUNK_HEADER_SIZE = 64; // keeps the first message cache line aligned
+
+CC_INLINE size_t alignUp(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+class DummyMessage final : public Message {
+public:
+    virtual void execute() override {}
+};
+
+} // namespace
+
+constexpr size_t MessageQueue::MEMORY_CHUNK_SIZE;
+
+class MemoryFreeMessage final : public Message {
+public:
+    MemoryFreeMessage(MessageQueue *queue, MessageQueue::Chunk *chunks) : _queue(queue), _chunks(chunks) {}
+    virtual void execute() override { _queue->releaseChunks(_chunks); }
+
+private:
+    MessageQueue *_queue = nullptr;
+    MessageQueue::Chunk *_chunks = nullptr;
+};
+
+MessageQueue::MessageQueue() {
+    switchChunk(0);
+}
+
+MessageQueue::~MessageQueue() {
+    terminateConsumerThread();
+
+    releaseChunks(_writer.retiredChunks);
+    releaseChunks(_writer.chunk);
+}
+
+uint8_t *MessageQueue::allocateImpl(size_t size, size_t alignment) {
+    size_t offset = alignUp(_writer.offset, alignment);
+    if (offset + size > _writer.chunkSize) {
+        switchChunk(size + alignment);
+        offset = alignUp(_writer.offset, alignment);
+    }
+    _writer.offset = offset + size;
+    return reinterpret_cast<uint8_t *>(_writer.chunk) + offset;
+}
+
+void MessageQueue::switchChunk(size_t minSize) {
+    // The old chunk may still hold payloads of the message being recorded,
+    // so it is only scheduled for release after the next message is pushed.
+    if (_writer.chunk) {
+        _writer.chunk->next = _writer.retiredChunks;
+        _writer.retiredChunks = _writer.chunk;
+    }
+
+    _writer.chunkSize = std::max(MEMORY_CHUNK_SIZE, CHUNK_HEADER_SIZE + minSize);
+    _writer.chunk = new (CC_MALLOC(_writer.chunkSize)) Chunk;
+    _writer.offset = CHUNK_HEADER_SIZE;
+}
+
+void MessageQueue::pushMessage(Message *msg) {
+    if (_immediateMode) {
+        msg->execute();
+        msg->~Message();
+
+        // everything recorded so far has been consumed, rewind the chunk
+        releaseChunks(_writer.retiredChunks);
+        _writer.retiredChunks = nullptr;
+        _writer.offset = CHUNK_HEADER_SIZE;
+        return;
+    }
+
+    _writer.lastMessage->_next = msg;
+    _writer.lastMessage = msg;
+    ++_writer.pendingMessageCount;
+
+    if (_writer.retiredChunks) {
+        Chunk *chunks = _writer.retiredChunks;
+        _writer.retiredChunks = nullptr;
+
+        Message *freeMsg = new (allocateImpl(sizeof(MemoryFreeMessage), alignof(MemoryFreeMessage))) MemoryFreeMessage(this, chunks);
+        _writer.lastMessage->_next = freeMsg;
+        _writer.lastMessage = freeMsg;
+        ++_writer.pendingMessageCount;
+    }
+}
+
+void MessageQueue::releaseChunks(Chunk *chunks) {
+    while (chunks) {
+        Chunk *next = chunks->next;
+        CC_FREE(chunks);
+        chunks = next;
+    }
+}
+
+void MessageQueue::kick() {
+    if (_immediateMode || !_writer.pendingMessageCount) return;
+
+    _lastPublished.store(_writer.lastMessage, std::memory_order_release);
+    _writer.pendingMessageCount = 0;
+    _event.signal();
+}
+
+void MessageQueue::kickAndWait() {
+    if (_immediateMode) return;
+
+    Semaphore semaphore;
+    ENQUEUE_MESSAGE_1(this, MessageQueueFence,
+                      semaphore, &semaphore,
+                      {
+                          semaphore->signal();
+                      });
+    kick();
+    semaphore.wait();
+}
+
+void MessageQueue::runConsumerThread() {
+    if (_consumerThread) return;
+
+    _reader.terminated = false;
+    _consumerThread = CC_NEW(std::thread(&MessageQueue::consumerThreadLoop, this));
+}
+
+void MessageQueue::terminateConsumerThread() {
+    if (!_consumerThread) return;
+
+    ENQUEUE_MESSAGE_1(this, MessageQueueTerminate,
+                      reader, &_reader,
+                      {
+                          reader->terminated = true;
+                      });
+    kick();
+
+    _consumerThread->join();
+    CC_DELETE(_consumerThread);
+    _consumerThread = nullptr;
+}
+
+void MessageQueue::setImmediateMode(bool immediateMode) {
+    CCASSERT(!_consumerThread, "Switching immediate mode while the consumer thread is running.");
+    if (_immediateMode == immediateMode) return;
+    _immediateMode = immediateMode;
+
+    if (!immediateMode) {
+        // immediate mode rewinds the chunks, so restart the message list from a fresh head
+        Message *dummy = new (allocateImpl(sizeof(DummyMessage), alignof(DummyMessage))) DummyMessage;
+        _writer.lastMessage = dummy;
+        _writer.pendingMessageCount = 0;
+        _reader.cursor = dummy;
+        _lastPublished.store(dummy, std::memory_order_relaxed);
+    }
+}
+
+void MessageQueue::consumerThreadLoop() {
+    while (!_reader.terminated) {
+        _event.wait();
+        flushMessages();
+    }
+}
+
+void MessageQueue::flushMessages() {
+    Message *lastPublished = _lastPublished.load(std::memory_order_acquire);
+    while (_reader.cursor != lastPublished && !_reader.terminated) {
+        Message *msg = _reader.cursor->_next;
+        // destruct before executing: a MemoryFreeMessage may release the chunk holding the cursor
+        _reader.cursor->~Message();
+        msg->execute();
+        _reader.cursor = msg;
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,338 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "base/Macros.h"
+#include "base/threading/Semaphore.h"
+
+namespace cc {
+
+// A command recorded on the producer thread and replayed on the consumer thread.
+// Messages live in the queue's own memory chunks and are never freed individually.
+class CC_DLL Message {
+public:
+    Message() = default;
+    virtual ~Message() = default;
+    Message(const Message &) = delete;
+    Message &operator=(const Message &) = delete;
+
+    virtual void execute() = 0;
+
+    CC_INLINE Message *getNext() const { return _next; }
+
+private:
+    Message *_next = nullptr;
+
+    friend class MessageQueue;
+};
+
+// Single-producer single-consumer command stream.
+//
+// The producer appends messages (and any payload they reference) into large
+// linearly allocated chunks and publishes them in batches with kick(). The
+// consumer thread replays everything up to the last published message. Retired
+// chunks are released by a message of their own, so no per-command allocation
+// or locking happens on either side.
+//
+// In immediate mode every message is executed as soon as it is enqueued, on the
+// producer thread, which makes single-threaded rendering go through the exact
+// same code path.
+class CC_DLL MessageQueue final {
+public:
+    static constexpr size_t MEMORY_CHUNK_SIZE = 4 * 1024 * 1024;
+
+    MessageQueue();
+    ~MessageQueue();
+    MessageQueue(const MessageQueue &) = delete;
+    MessageQueue &operator=(const MessageQueue &) = delete;
+
+    // Scratch memory that stays valid until every message enqueued after it has been executed.
+    template <typename T>
+    CC_INLINE T *allocate(size_t count) {
+        return reinterpret_cast<T *>(allocateImpl(sizeof(T) * count, alignof(T)));
+    }
+
+    template <typename T>
+    CC_INLINE T *allocateAndCopy(const T *src, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "payload must be trivially copyable");
+        if (!src || !count) return nullptr;
+        T *dst = allocate<T>(count);
+        memcpy(dst, src, sizeof(T) * count);
+        return dst;
+    }
+
+    template <typename T, typename... Args>
+    CC_INLINE void enqueue(Args &&... args) {
+        uint8_t *memory = allocateImpl(sizeof(T), alignof(T));
+        pushMessage(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    // Makes everything enqueued so far visible to the consumer thread.
+    void kick();
+    // Kicks and blocks until the consumer has executed everything enqueued so far.
+    void kickAndWait();
+
+    void runConsumerThread();
+    void terminateConsumerThread();
+
+    // Only valid to switch while no consumer thread is running.
+    void setImmediateMode(bool immediateMode);
+    CC_INLINE bool isImmediateMode() const { return _immediateMode; }
+
+private:
+    struct Chunk {
+        Chunk *next = nullptr;
+    };
+
+    uint8_t *allocateImpl(size_t size, size_t alignment);
+    void switchChunk(size_t minSize);
+    void pushMessage(Message *msg);
+    void releaseChunks(Chunk *chunks);
+    void consumerThreadLoop();
+    void flushMessages();
+
+    struct Writer {
+        Chunk *chunk = nullptr;
+        size_t chunkSize = 0;
+        size_t offset = 0;
+        Chunk *retiredChunks = nullptr;
+        Message *lastMessage = nullptr;
+        uint pendingMessageCount = 0;
+    };
+
+    struct Reader {
+        Message *cursor = nullptr;
+        bool terminated = false;
+    };
+
+    Writer _writer;
+    Reader _reader;
+    std::atomic<Message *> _lastPublished{nullptr};
+    Semaphore _event;
+    std::thread *_consumerThread = nullptr;
+    bool _immediateMode = true;
+
+    friend class MemoryFreeMessage;
+};
+
+} // namespace cc
+
+// Helpers to record a piece of code as a message. Every ParamN is captured by
+// value (decayed type of ValueN) and is accessible by name inside the code block.
+//
+// ENQUEUE_MESSAGE_2(queue, BufferResize,
+//                   actor, getActor(),
+//                   size, size,
+//                   { actor->resize(size); });
+#define ENQUEUE_MESSAGE_0(queue, MessageName, ...)                                                            \
+    {                                                                                                         \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            virtual void execute() override __VA_ARGS__                                                       \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>();                                                             \
+    }
+
+#define ENQUEUE_MESSAGE_1(queue, MessageName, Param1, Value1, ...)                                            \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            explicit MessageName##Message(const Type1 &In##Param1)                                            \
+            : Param1(In##Param1) {}                                                                           \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1);                                                       \
+    }
+
+#define ENQUEUE_MESSAGE_2(queue, MessageName, Param1, Value1, Param2, Value2, ...)                            \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2)                            \
+            : Param1(In##Param1), Param2(In##Param2) {}                                                       \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2);                                               \
+    }
+
+#define ENQUEUE_MESSAGE_3(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, ...)            \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3)   \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3) {}                                   \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3);                                       \
+    }
+
+#define ENQUEUE_MESSAGE_4(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, Param4, Value4, ...) \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        using Type4 = typename std::decay<decltype(Value4)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3, const Type4 &In##Param4) \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3), Param4(In##Param4) {}               \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+            Type4 Param4;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3, Value4);                               \
+    }
+
+#define ENQUEUE_MESSAGE_5(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, Param4, Value4, Param5, Value5, ...) \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        using Type4 = typename std::decay<decltype(Value4)>::type;                                            \
+        using Type5 = typename std::decay<decltype(Value5)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3, const Type4 &In##Param4, const Type5 &In##Param5) \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3), Param4(In##Param4), Param5(In##Param5) {} \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+            Type4 Param4;                                                                                     \
+            Type5 Param5;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3, Value4, Value5);                       \
+    }
+
+#define ENQUEUE_MESSAGE_6(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, Param4, Value4, Param5, Value5, Param6, Value6, ...) \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        using Type4 = typename std::decay<decltype(Value4)>::type;                                            \
+        using Type5 = typename std::decay<decltype(Value5)>::type;                                            \
+        using Type6 = typename std::decay<decltype(Value6)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3, const Type4 &In##Param4, const Type5 &In##Param5, const Type6 &In##Param6) \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3), Param4(In##Param4), Param5(In##Param5), Param6(In##Param6) {} \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+            Type4 Param4;                                                                                     \
+            Type5 Param5;                                                                                     \
+            Type6 Param6;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3, Value4, Value5, Value6);               \
+    }
+
+#define ENQUEUE_MESSAGE_7(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, Param4, Value4, Param5, Value5, Param6, Value6, Param7, Value7, ...) \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        using Type4 = typename std::decay<decltype(Value4)>::type;                                            \
+        using Type5 = typename std::decay<decltype(Value5)>::type;                                            \
+        using Type6 = typename std::decay<decltype(Value6)>::type;                                            \
+        using Type7 = typename std::decay<decltype(Value7)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3, const Type4 &In##Param4, const Type5 &In##Param5, const Type6 &In##Param6, const Type7 &In##Param7) \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3), Param4(In##Param4), Param5(In##Param5), Param6(In##Param6), Param7(In##Param7) {} \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+            Type4 Param4;                                                                                     \
+            Type5 Param5;                                                                                     \
+            Type6 Param6;                                                                                     \
+            Type7 Param7;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3, Value4, Value5, Value6, Value7);       \
+    }
+
+#define ENQUEUE_MESSAGE_8(queue, MessageName, Param1, Value1, Param2, Value2, Param3, Value3, Param4, Value4, Param5, Value5, Param6, Value6, Param7, Value7, Param8, Value8, ...) \
+    {                                                                                                         \
+        using Type1 = typename std::decay<decltype(Value1)>::type;                                            \
+        using Type2 = typename std::decay<decltype(Value2)>::type;                                            \
+        using Type3 = typename std::decay<decltype(Value3)>::type;                                            \
+        using Type4 = typename std::decay<decltype(Value4)>::type;                                            \
+        using Type5 = typename std::decay<decltype(Value5)>::type;                                            \
+        using Type6 = typename std::decay<decltype(Value6)>::type;                                            \
+        using Type7 = typename std::decay<decltype(Value7)>::type;                                            \
+        using Type8 = typename std::decay<decltype(Value8)>::type;                                            \
+        class MessageName##Message final : public ::cc::Message {                                             \
+        public:                                                                                               \
+            MessageName##Message(const Type1 &In##Param1, const Type2 &In##Param2, const Type3 &In##Param3, const Type4 &In##Param4, const Type5 &In##Param5, const Type6 &In##Param6, const Type7 &In##Param7, const Type8 &In##Param8) \
+            : Param1(In##Param1), Param2(In##Param2), Param3(In##Param3), Param4(In##Param4), Param5(In##Param5), Param6(In##Param6), Param7(In##Param7), Param8(In##Param8) {} \
+            virtual void execute() override __VA_ARGS__                                                       \
+                                                                                                              \
+        private:                                                                                              \
+            Type1 Param1;                                                                                     \
+            Type2 Param2;                                                                                     \
+            Type3 Param3;                                                                                     \
+            Type4 Param4;                                                                                     \
+            Type5 Param5;                                                                                     \
+            Type6 Param6;                                                                                     \
+            Type7 Param7;                                                                                     \
+            Type8 Param8;                                                                                     \
+        };                                                                                                    \
+        (queue)->enqueue<MessageName##Message>(Value1, Value2, Value3, Value4, Value5, Value6, Value7, Value8); \
+    }
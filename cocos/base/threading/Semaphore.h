@@ -0,0 +1,62 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace cc {
+
+// Counting semaphore, used to hand frame boundaries and fences
+// between the recording thread and the render thread.
+class Semaphore final {
+public:
+    explicit Semaphore(int initialCount = 0) : _count(initialCount) {}
+    Semaphore(const Semaphore &) = delete;
+    Semaphore &operator=(const Semaphore &) = delete;
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return _count > 0; });
+        --_count;
+    }
+
+    void signal(int count = 1) {
+        // notify under the lock: waiters may destroy the semaphore as soon as they wake up
+        std::lock_guard<std::mutex> lock(_mutex);
+        _count += count;
+        if (count == 1) {
+            _condition.notify_one();
+        } else {
+            _condition.notify_all();
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    int _count = 0;
+};
+
+} // namespace cc
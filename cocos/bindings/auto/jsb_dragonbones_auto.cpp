@@ -6090,6 +6090,44 @@ static bool js_dragonbones_ArmatureCacheMgr_buildArmatureCache(se::State& s)
 }
 SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_buildArmatureCache)
 
+static bool js_dragonbones_ArmatureCacheMgr_getMemoryBudget(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_dragonbones_ArmatureCacheMgr_getMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_dragonbones_ArmatureCacheMgr_getMemoryBudget : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_getMemoryBudget)
+
+static bool js_dragonbones_ArmatureCacheMgr_getMemoryUsage(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_dragonbones_ArmatureCacheMgr_getMemoryUsage : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryUsage();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_dragonbones_ArmatureCacheMgr_getMemoryUsage : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_getMemoryUsage)
+
 static bool js_dragonbones_ArmatureCacheMgr_removeArmatureCache(se::State& s)
 {
     dragonBones::ArmatureCacheMgr* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
@@ -6109,6 +6147,25 @@ static bool js_dragonbones_ArmatureCacheMgr_removeArmatureCache(se::State& s)
 }
 SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_removeArmatureCache)
 
+static bool js_dragonbones_ArmatureCacheMgr_setMemoryBudget(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = SE_THIS_OBJECT<dragonBones::ArmatureCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_dragonbones_ArmatureCacheMgr_setMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<size_t, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_dragonbones_ArmatureCacheMgr_setMemoryBudget : Error processing arguments");
+        cobj->setMemoryBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_dragonbones_ArmatureCacheMgr_setMemoryBudget)
+
 static bool js_dragonbones_ArmatureCacheMgr_destroyInstance(se::State& s)
 {
     const auto& args = s.args();
@@ -6159,7 +6216,10 @@ bool js_register_dragonbones_ArmatureCacheMgr(se::Object* obj)
     auto cls = se::Class::create("ArmatureCacheMgr", obj, nullptr, nullptr);
 
     cls->defineFunction("buildArmatureCache", _SE(js_dragonbones_ArmatureCacheMgr_buildArmatureCache));
+    cls->defineFunction("getMemoryBudget", _SE(js_dragonbones_ArmatureCacheMgr_getMemoryBudget));
+    cls->defineFunction("getMemoryUsage", _SE(js_dragonbones_ArmatureCacheMgr_getMemoryUsage));
     cls->defineFunction("removeArmatureCache", _SE(js_dragonbones_ArmatureCacheMgr_removeArmatureCache));
+    cls->defineFunction("setMemoryBudget", _SE(js_dragonbones_ArmatureCacheMgr_setMemoryBudget));
     cls->defineStaticFunction("destroyInstance", _SE(js_dragonbones_ArmatureCacheMgr_destroyInstance));
     cls->defineStaticFunction("getInstance", _SE(js_dragonbones_ArmatureCacheMgr_getInstance));
     cls->defineFinalizeFunction(_SE(js_dragonBones_ArmatureCacheMgr_finalize));
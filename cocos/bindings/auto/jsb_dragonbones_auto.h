@@ -388,7 +388,10 @@ bool register_all_dragonbones(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(dragonBones::ArmatureCacheMgr);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_buildArmatureCache);
+SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_getMemoryBudget);
+SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_getMemoryUsage);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_removeArmatureCache);
+SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_setMemoryBudget);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_destroyInstance);
 SE_DECLARE_FUNC(js_dragonbones_ArmatureCacheMgr_getInstance);
 
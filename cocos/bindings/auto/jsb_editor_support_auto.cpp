@@ -518,6 +518,25 @@ static bool js_editor_support_MiddlewareManager_getVBTypedArrayLength(se::State&
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_getVBTypedArrayLength)
 
+static bool js_editor_support_MiddlewareManager_isParallel(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_isParallel : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isParallel();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_isParallel : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_isParallel)
+
 static bool js_editor_support_MiddlewareManager_render(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -537,6 +556,25 @@ static bool js_editor_support_MiddlewareManager_render(se::State& s)
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_render)
 
+static bool js_editor_support_MiddlewareManager_setParallel(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_setParallel : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_setParallel : Error processing arguments");
+        cobj->setParallel(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_setParallel)
+
 static bool js_editor_support_MiddlewareManager_update(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -641,7 +679,9 @@ bool js_register_editor_support_MiddlewareManager(se::Object* obj)
     cls->defineFunction("getRenderInfoMgr", _SE(js_editor_support_MiddlewareManager_getRenderInfoMgr));
     cls->defineFunction("getVBTypedArray", _SE(js_editor_support_MiddlewareManager_getVBTypedArray));
     cls->defineFunction("getVBTypedArrayLength", _SE(js_editor_support_MiddlewareManager_getVBTypedArrayLength));
+    cls->defineFunction("isParallel", _SE(js_editor_support_MiddlewareManager_isParallel));
     cls->defineFunction("render", _SE(js_editor_support_MiddlewareManager_render));
+    cls->defineFunction("setParallel", _SE(js_editor_support_MiddlewareManager_setParallel));
     cls->defineFunction("update", _SE(js_editor_support_MiddlewareManager_update));
     cls->defineStaticFunction("destroyInstance", _SE(js_editor_support_MiddlewareManager_destroyInstance));
     cls->defineStaticFunction("generateModuleID", _SE(js_editor_support_MiddlewareManager_generateModuleID));
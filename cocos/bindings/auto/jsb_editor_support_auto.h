@@ -49,7 +49,9 @@ SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getIBTypedArrayLength);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getRenderInfoMgr);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getVBTypedArray);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getVBTypedArrayLength);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_isParallel);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_render);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_setParallel);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_update);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_destroyInstance);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_generateModuleID);
@@ -835,6 +835,25 @@ static bool js_extension_AssetsManagerEx_getTotalFiles(se::State& s)
 }
 SE_BIND_FUNC(js_extension_AssetsManagerEx_getTotalFiles)
 
+static bool js_extension_AssetsManagerEx_isNativeVerifyEnabled(se::State& s)
+{
+    cc::extension::AssetsManagerEx* cobj = SE_THIS_OBJECT<cc::extension::AssetsManagerEx>(s);
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_isNativeVerifyEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isNativeVerifyEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_isNativeVerifyEnabled : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_isNativeVerifyEnabled)
+
 static bool js_extension_AssetsManagerEx_isResuming(se::State& s)
 {
     cc::extension::AssetsManagerEx* cobj = SE_THIS_OBJECT<cc::extension::AssetsManagerEx>(s);
@@ -1001,6 +1020,25 @@ static bool js_extension_AssetsManagerEx_setMaxConcurrentTask(se::State& s)
 }
 SE_BIND_FUNC(js_extension_AssetsManagerEx_setMaxConcurrentTask)
 
+static bool js_extension_AssetsManagerEx_setNativeVerifyEnabled(se::State& s)
+{
+    cc::extension::AssetsManagerEx* cobj = SE_THIS_OBJECT<cc::extension::AssetsManagerEx>(s);
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_setNativeVerifyEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_setNativeVerifyEnabled : Error processing arguments");
+        cobj->setNativeVerifyEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_setNativeVerifyEnabled)
+
 static bool js_extension_AssetsManagerEx_setVerifyCallback(se::State& s)
 {
     cc::extension::AssetsManagerEx* cobj = SE_THIS_OBJECT<cc::extension::AssetsManagerEx>(s);
@@ -1246,12 +1284,14 @@ bool js_register_extension_AssetsManagerEx(se::Object* obj)
     cls->defineFunction("getStoragePath", _SE(js_extension_AssetsManagerEx_getStoragePath));
     cls->defineFunction("getTotalBytes", _SE(js_extension_AssetsManagerEx_getTotalBytes));
     cls->defineFunction("getTotalFiles", _SE(js_extension_AssetsManagerEx_getTotalFiles));
+    cls->defineFunction("isNativeVerifyEnabled", _SE(js_extension_AssetsManagerEx_isNativeVerifyEnabled));
     cls->defineFunction("isResuming", _SE(js_extension_AssetsManagerEx_isResuming));
     cls->defineFunction("loadLocalManifest", _SE(js_extension_AssetsManagerEx_loadLocalManifest));
     cls->defineFunction("loadRemoteManifest", _SE(js_extension_AssetsManagerEx_loadRemoteManifest));
     cls->defineFunction("prepareUpdate", _SE(js_extension_AssetsManagerEx_prepareUpdate));
     cls->defineFunction("setEventCallback", _SE(js_extension_AssetsManagerEx_setEventCallback));
     cls->defineFunction("setMaxConcurrentTask", _SE(js_extension_AssetsManagerEx_setMaxConcurrentTask));
+    cls->defineFunction("setNativeVerifyEnabled", _SE(js_extension_AssetsManagerEx_setNativeVerifyEnabled));
     cls->defineFunction("setVerifyCallback", _SE(js_extension_AssetsManagerEx_setVerifyCallback));
     cls->defineFunction("setVersionCompareHandle", _SE(js_extension_AssetsManagerEx_setVersionCompareHandle));
     cls->defineFunction("update", _SE(js_extension_AssetsManagerEx_update));
@@ -66,12 +66,14 @@ SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getState);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getStoragePath);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getTotalBytes);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getTotalFiles);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_isNativeVerifyEnabled);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_isResuming);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_loadLocalManifest);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_loadRemoteManifest);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_prepareUpdate);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setEventCallback);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setMaxConcurrentTask);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setNativeVerifyEnabled);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setVerifyCallback);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setVersionCompareHandle);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_update);
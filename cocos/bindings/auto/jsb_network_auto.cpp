@@ -94,6 +94,60 @@ static bool js_network_DownloaderHints_set_tempFileNameSuffix(se::State& s)
 }
 SE_BIND_PROP_SET(js_network_DownloaderHints_set_tempFileNameSuffix)
 
+static bool js_network_DownloaderHints_get_countOfSegmentsPerTask(se::State& s)
+{
+    cc::network::DownloaderHints* cobj = SE_THIS_OBJECT<cc::network::DownloaderHints>(s);
+    SE_PRECONDITION2(cobj, false, "js_network_DownloaderHints_get_countOfSegmentsPerTask : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->countOfSegmentsPerTask, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    SE_HOLD_RETURN_VALUE(cobj->countOfSegmentsPerTask, s.thisObject(), s.rval());
+    return true;
+}
+SE_BIND_PROP_GET(js_network_DownloaderHints_get_countOfSegmentsPerTask)
+
+static bool js_network_DownloaderHints_set_countOfSegmentsPerTask(se::State& s)
+{
+    const auto& args = s.args();
+    cc::network::DownloaderHints* cobj = SE_THIS_OBJECT<cc::network::DownloaderHints>(s);
+    SE_PRECONDITION2(cobj, false, "js_network_DownloaderHints_set_countOfSegmentsPerTask : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->countOfSegmentsPerTask, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_network_DownloaderHints_set_countOfSegmentsPerTask : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_network_DownloaderHints_set_countOfSegmentsPerTask)
+
+static bool js_network_DownloaderHints_get_minSegmentSize(se::State& s)
+{
+    cc::network::DownloaderHints* cobj = SE_THIS_OBJECT<cc::network::DownloaderHints>(s);
+    SE_PRECONDITION2(cobj, false, "js_network_DownloaderHints_get_minSegmentSize : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->minSegmentSize, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    SE_HOLD_RETURN_VALUE(cobj->minSegmentSize, s.thisObject(), s.rval());
+    return true;
+}
+SE_BIND_PROP_GET(js_network_DownloaderHints_get_minSegmentSize)
+
+static bool js_network_DownloaderHints_set_minSegmentSize(se::State& s)
+{
+    const auto& args = s.args();
+    cc::network::DownloaderHints* cobj = SE_THIS_OBJECT<cc::network::DownloaderHints>(s);
+    SE_PRECONDITION2(cobj, false, "js_network_DownloaderHints_set_minSegmentSize : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->minSegmentSize, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_network_DownloaderHints_set_minSegmentSize : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_network_DownloaderHints_set_minSegmentSize)
+
 
 template<>
 bool sevalue_to_native(const se::Value &from, cc::network::DownloaderHints * to, se::Object *ctx)
@@ -119,6 +173,14 @@ bool sevalue_to_native(const se::Value &from, cc::network::DownloaderHints * to,
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->tempFileNameSuffix), ctx);
     }
+    json->getProperty("countOfSegmentsPerTask", &field);
+    if(!field.isNullOrUndefined()) {
+        ok &= sevalue_to_native(field, &(to->countOfSegmentsPerTask), ctx);
+    }
+    json->getProperty("minSegmentSize", &field);
+    if(!field.isNullOrUndefined()) {
+        ok &= sevalue_to_native(field, &(to->minSegmentSize), ctx);
+    }
     return ok;
 }
 
@@ -166,6 +228,12 @@ static bool js_network_DownloaderHints_constructor(se::State& s)
         if (argc > 2 && !args[2].isUndefined()) {
             ok &= sevalue_to_native(args[2], &(cobj->tempFileNameSuffix), nullptr);
         }
+        if (argc > 3 && !args[3].isUndefined()) {
+            ok &= sevalue_to_native(args[3], &(cobj->countOfSegmentsPerTask), nullptr);
+        }
+        if (argc > 4 && !args[4].isUndefined()) {
+            ok &= sevalue_to_native(args[4], &(cobj->minSegmentSize), nullptr);
+        }
 
         if(!ok) {
             JSB_FREE(cobj);
@@ -206,6 +274,8 @@ bool js_register_network_DownloaderHints(se::Object* obj)
     cls->defineProperty("countOfMaxProcessingTasks", _SE(js_network_DownloaderHints_get_countOfMaxProcessingTasks), _SE(js_network_DownloaderHints_set_countOfMaxProcessingTasks));
     cls->defineProperty("timeoutInSeconds", _SE(js_network_DownloaderHints_get_timeoutInSeconds), _SE(js_network_DownloaderHints_set_timeoutInSeconds));
     cls->defineProperty("tempFileNameSuffix", _SE(js_network_DownloaderHints_get_tempFileNameSuffix), _SE(js_network_DownloaderHints_set_tempFileNameSuffix));
+    cls->defineProperty("countOfSegmentsPerTask", _SE(js_network_DownloaderHints_get_countOfSegmentsPerTask), _SE(js_network_DownloaderHints_set_countOfSegmentsPerTask));
+    cls->defineProperty("minSegmentSize", _SE(js_network_DownloaderHints_get_minSegmentSize), _SE(js_network_DownloaderHints_set_minSegmentSize));
     cls->defineFinalizeFunction(_SE(js_cc_network_DownloaderHints_finalize));
     cls->install();
     JSBClassType::registerClass<cc::network::DownloaderHints>(cls);
@@ -2164,6 +2164,25 @@ bool js_register_pipeline_RenderPipeline(se::Object* obj)
 se::Object* __jsb_cc_pipeline_ForwardPipeline_proto = nullptr;
 se::Class* __jsb_cc_pipeline_ForwardPipeline_class = nullptr;
 
+static bool js_pipeline_ForwardPipeline_destroyModelBVH(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_destroyModelBVH : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_destroyModelBVH : Error processing arguments");
+        cobj->destroyModelBVH(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_destroyModelBVH)
+
 static bool js_pipeline_ForwardPipeline_getSphere(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
@@ -2183,6 +2202,82 @@ static bool js_pipeline_ForwardPipeline_getSphere(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_getSphere)
 
+static bool js_pipeline_ForwardPipeline_isClusteredLighting(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isClusteredLighting : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isClusteredLighting();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isClusteredLighting : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isClusteredLighting)
+
+static bool js_pipeline_ForwardPipeline_isParallelCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isParallelCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isParallelCulling();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isParallelCulling : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isParallelCulling)
+
+static bool js_pipeline_ForwardPipeline_isParallelRecording(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isParallelRecording : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isParallelRecording();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isParallelRecording : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isParallelRecording)
+
+static bool js_pipeline_ForwardPipeline_isSpatialCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isSpatialCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isSpatialCulling();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isSpatialCulling : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isSpatialCulling)
+
 static bool js_pipeline_ForwardPipeline_setAmbient(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
@@ -2202,6 +2297,25 @@ static bool js_pipeline_ForwardPipeline_setAmbient(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_setAmbient)
 
+static bool js_pipeline_ForwardPipeline_setClusteredLighting(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setClusteredLighting : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setClusteredLighting : Error processing arguments");
+        cobj->setClusteredLighting(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setClusteredLighting)
+
 static bool js_pipeline_ForwardPipeline_setFog(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
@@ -2221,6 +2335,44 @@ static bool js_pipeline_ForwardPipeline_setFog(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_setFog)
 
+static bool js_pipeline_ForwardPipeline_setParallelCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setParallelCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setParallelCulling : Error processing arguments");
+        cobj->setParallelCulling(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setParallelCulling)
+
+static bool js_pipeline_ForwardPipeline_setParallelRecording(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setParallelRecording : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setParallelRecording : Error processing arguments");
+        cobj->setParallelRecording(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setParallelRecording)
+
 static bool js_pipeline_ForwardPipeline_setShadows(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
@@ -2259,6 +2411,25 @@ static bool js_pipeline_ForwardPipeline_setSkybox(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_setSkybox)
 
+static bool js_pipeline_ForwardPipeline_setSpatialCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setSpatialCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setSpatialCulling : Error processing arguments");
+        cobj->setSpatialCulling(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setSpatialCulling)
+
 SE_DECLARE_FINALIZE_FUNC(js_cc_pipeline_ForwardPipeline_finalize)
 
 static bool js_pipeline_ForwardPipeline_constructor(se::State& s) // constructor.c
@@ -2291,11 +2462,20 @@ bool js_register_pipeline_ForwardPipeline(se::Object* obj)
 {
     auto cls = se::Class::create("ForwardPipeline", obj, __jsb_cc_pipeline_RenderPipeline_proto, _SE(js_pipeline_ForwardPipeline_constructor));
 
+    cls->defineFunction("destroyModelBVH", _SE(js_pipeline_ForwardPipeline_destroyModelBVH));
     cls->defineFunction("getSphere", _SE(js_pipeline_ForwardPipeline_getSphere));
+    cls->defineFunction("isClusteredLighting", _SE(js_pipeline_ForwardPipeline_isClusteredLighting));
+    cls->defineFunction("isParallelCulling", _SE(js_pipeline_ForwardPipeline_isParallelCulling));
+    cls->defineFunction("isParallelRecording", _SE(js_pipeline_ForwardPipeline_isParallelRecording));
+    cls->defineFunction("isSpatialCulling", _SE(js_pipeline_ForwardPipeline_isSpatialCulling));
     cls->defineFunction("setAmbient", _SE(js_pipeline_ForwardPipeline_setAmbient));
+    cls->defineFunction("setClusteredLighting", _SE(js_pipeline_ForwardPipeline_setClusteredLighting));
     cls->defineFunction("setFog", _SE(js_pipeline_ForwardPipeline_setFog));
+    cls->defineFunction("setParallelCulling", _SE(js_pipeline_ForwardPipeline_setParallelCulling));
+    cls->defineFunction("setParallelRecording", _SE(js_pipeline_ForwardPipeline_setParallelRecording));
     cls->defineFunction("setShadows", _SE(js_pipeline_ForwardPipeline_setShadows));
     cls->defineFunction("setSkybox", _SE(js_pipeline_ForwardPipeline_setSkybox));
+    cls->defineFunction("setSpatialCulling", _SE(js_pipeline_ForwardPipeline_setSpatialCulling));
     cls->defineFinalizeFunction(_SE(js_cc_pipeline_ForwardPipeline_finalize));
     cls->install();
     JSBClassType::registerClass<cc::pipeline::ForwardPipeline>(cls);
@@ -100,11 +100,20 @@ bool js_register_cc_pipeline_ForwardPipeline(se::Object* obj);
 bool register_all_pipeline(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(cc::pipeline::ForwardPipeline);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_destroyModelBVH);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getSphere);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isClusteredLighting);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isParallelCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isParallelRecording);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isSpatialCulling);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setAmbient);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setClusteredLighting);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setFog);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setParallelCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setParallelRecording);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setShadows);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setSkybox);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setSpatialCulling);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_ForwardPipeline);
 
 extern se::Object* __jsb_cc_pipeline_RenderFlowInfo_proto;
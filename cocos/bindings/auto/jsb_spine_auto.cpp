@@ -16086,6 +16086,86 @@ static bool js_spine_SkeletonCacheMgr_buildSkeletonCache(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache)
 
+static bool js_spine_SkeletonCacheMgr_flushDiskCache(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_flushDiskCache : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cobj->flushDiskCache();
+        return true;
+    }
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_flushDiskCache : Error processing arguments");
+        cobj->flushDiskCache(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_flushDiskCache)
+
+static bool js_spine_SkeletonCacheMgr_getMemoryBudget(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_getMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_getMemoryBudget : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_getMemoryBudget)
+
+static bool js_spine_SkeletonCacheMgr_getMemoryUsage(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_getMemoryUsage : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryUsage();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_getMemoryUsage : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_getMemoryUsage)
+
+static bool js_spine_SkeletonCacheMgr_isDiskCacheEnabled(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_isDiskCacheEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isDiskCacheEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_isDiskCacheEnabled : Error processing arguments");
+        SE_HOLD_RETURN_VALUE(result, s.thisObject(), s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_isDiskCacheEnabled)
+
 static bool js_spine_SkeletonCacheMgr_removeSkeletonCache(se::State& s)
 {
     spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
@@ -16105,6 +16185,44 @@ static bool js_spine_SkeletonCacheMgr_removeSkeletonCache(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheMgr_removeSkeletonCache)
 
+static bool js_spine_SkeletonCacheMgr_setDiskCacheEnabled(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_setDiskCacheEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_setDiskCacheEnabled : Error processing arguments");
+        cobj->setDiskCacheEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_setDiskCacheEnabled)
+
+static bool js_spine_SkeletonCacheMgr_setMemoryBudget(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_setMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<size_t, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_setMemoryBudget : Error processing arguments");
+        cobj->setMemoryBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_setMemoryBudget)
+
 static bool js_spine_SkeletonCacheMgr_destroyInstance(se::State& s)
 {
     const auto& args = s.args();
@@ -16155,7 +16273,13 @@ bool js_register_spine_SkeletonCacheMgr(se::Object* obj)
     auto cls = se::Class::create("SkeletonCacheMgr", obj, nullptr, nullptr);
 
     cls->defineFunction("buildSkeletonCache", _SE(js_spine_SkeletonCacheMgr_buildSkeletonCache));
+    cls->defineFunction("flushDiskCache", _SE(js_spine_SkeletonCacheMgr_flushDiskCache));
+    cls->defineFunction("getMemoryBudget", _SE(js_spine_SkeletonCacheMgr_getMemoryBudget));
+    cls->defineFunction("getMemoryUsage", _SE(js_spine_SkeletonCacheMgr_getMemoryUsage));
+    cls->defineFunction("isDiskCacheEnabled", _SE(js_spine_SkeletonCacheMgr_isDiskCacheEnabled));
     cls->defineFunction("removeSkeletonCache", _SE(js_spine_SkeletonCacheMgr_removeSkeletonCache));
+    cls->defineFunction("setDiskCacheEnabled", _SE(js_spine_SkeletonCacheMgr_setDiskCacheEnabled));
+    cls->defineFunction("setMemoryBudget", _SE(js_spine_SkeletonCacheMgr_setMemoryBudget));
     cls->defineStaticFunction("destroyInstance", _SE(js_spine_SkeletonCacheMgr_destroyInstance));
     cls->defineStaticFunction("getInstance", _SE(js_spine_SkeletonCacheMgr_getInstance));
     cls->defineFinalizeFunction(_SE(js_spine_SkeletonCacheMgr_finalize));
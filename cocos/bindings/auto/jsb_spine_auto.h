@@ -1136,7 +1136,13 @@ bool register_all_spine(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(spine::SkeletonCacheMgr);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_flushDiskCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getMemoryBudget);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getMemoryUsage);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_isDiskCacheEnabled);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_removeSkeletonCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_setDiskCacheEnabled);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_setMemoryBudget);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_destroyInstance);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getInstance);
 
@@ -4,38 +4,44 @@
 
 namespace se {
 
-cc::map<PoolType, BufferAllocator *> BufferAllocator::_pools;
+BufferAllocator *BufferAllocator::_pools[POOL_TYPE_COUNT] = {};
 
 BufferAllocator::BufferAllocator(PoolType type)
 : _type(type) {
-    BufferAllocator::_pools[_type] = this;
+    BufferAllocator::_pools[static_cast<int>(_type)] = this;
 }
 
 BufferAllocator::~BufferAllocator() {
-    for (auto buffer : _buffers) {
-        buffer.second->decRef();
+    for (auto &buffer : _buffers) {
+        if (buffer.obj) buffer.obj->decRef();
     }
     _buffers.clear();
-    BufferAllocator::_pools.erase(_type);
+    BufferAllocator::_pools[static_cast<int>(_type)] = nullptr;
 }
 
 Object *BufferAllocator::alloc(uint index, uint bytes) {
-    if (_buffers.count(index)) {
-        Object *oldObj = _buffers[index];
-        oldObj->decRef();
+    if (index >= _buffers.size()) {
+        _buffers.resize(index + 1);
+    }
+    Buffer &buffer = _buffers[index];
+    if (buffer.obj) {
+        buffer.obj->decRef();
     }
     Object *obj = Object::createArrayBufferObject(nullptr, bytes);
     obj->incRef();
-    _buffers[index] = obj;
+
+    size_t len = 0;
+    buffer.obj = obj;
+    obj->getArrayBufferData(&buffer.data, &len);
+    buffer.size = (uint)len;
 
     return obj;
 }
 
 void BufferAllocator::free(uint index) {
-    if (_buffers.count(index)) {
-        Object *oldObj = _buffers[index];
-        oldObj->decRef();
-        _buffers.erase(index);
+    if (index < _buffers.size() && _buffers[index].obj) {
+        _buffers[index].obj->decRef();
+        _buffers[index] = Buffer();
     }
 }
 
@@ -20,20 +20,13 @@ public:
     template <class T>
     static T *getBuffer(PoolType type, uint index, uint *size) {
         index &= _bufferMask;
-        if (BufferAllocator::_pools.count(type) != 0) {
-            const auto pool = BufferAllocator::_pools[type];
-            if (pool->_buffers.count(index) != 0) {
-                T *ret = nullptr;
-                size_t len;
-                pool->_buffers[index]->getArrayBufferData((uint8_t **)&ret, &len);
-                *size = (uint)len;
-                return ret;
-            } else {
-                return nullptr;
-            }
-        } else {
+        const BufferAllocator *pool = BufferAllocator::_pools[static_cast<int>(type)];
+        if (!pool || index >= pool->_buffers.size() || !pool->_buffers[index].obj) {
             return nullptr;
         }
+        const Buffer &buffer = pool->_buffers[index];
+        *size = buffer.size;
+        return reinterpret_cast<T *>(buffer.data);
     }
 
     BufferAllocator(PoolType type);
@@ -43,10 +36,17 @@ public:
     void free(uint index);
 
 private:
-    static cc::map<PoolType, BufferAllocator *> _pools;
+    // backing store of array buffer is cached, it is stable until the buffer is freed
+    struct Buffer {
+        Object *obj = nullptr;
+        uint8_t *data = nullptr;
+        uint size = 0;
+    };
+
+    static BufferAllocator *_pools[POOL_TYPE_COUNT];
     static constexpr uint _bufferMask = ~(1 << 30);
 
-    cc::map<uint, Object *> _buffers;
+    cc::vector<Buffer> _buffers;
     PoolType _type = PoolType::UNKNOWN;
 };
 
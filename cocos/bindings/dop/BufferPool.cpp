@@ -28,14 +28,14 @@ THE SOFTWARE.
 
 using namespace se;
 
-cc::map<PoolType, BufferPool *> BufferPool::_poolMap;
+BufferPool *BufferPool::_pools[POOL_TYPE_COUNT] = {};
 
 BufferPool::BufferPool(PoolType type, uint entryBits, uint bytesPerEntry)
 : _allocator(type),
   _entryBits(entryBits),
   _bytesPerEntry(bytesPerEntry),
   _type(type) {
-    CCASSERT(BufferPool::_poolMap.count(type) == 0, "The type of pool is already exist");
+    CCASSERT(BufferPool::_pools[static_cast<int>(type)] == nullptr, "The type of pool is already exist");
 
     _entriesPerChunk = 1 << entryBits;
     _entryMask = _entriesPerChunk - 1;
@@ -43,11 +43,11 @@ BufferPool::BufferPool(PoolType type, uint entryBits, uint bytesPerEntry)
 
     _bytesPerChunk = _bytesPerEntry * _entriesPerChunk;
 
-    BufferPool::_poolMap[type] = this;
+    BufferPool::_pools[static_cast<int>(type)] = this;
 }
 
 BufferPool::~BufferPool() {
-    BufferPool::_poolMap.erase(_type);
+    BufferPool::_pools[static_cast<int>(_type)] = nullptr;
 }
 
 Object *BufferPool::allocateNewChunk() {
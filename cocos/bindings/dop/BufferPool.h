@@ -38,7 +38,7 @@ class CC_DLL BufferPool final : public cc::Object {
 public:
     using Chunk = uint8_t *;
 
-    CC_INLINE static const cc::map<PoolType, BufferPool *> &getPoolMap() { return BufferPool::_poolMap; }
+    CC_INLINE static BufferPool *getPool(PoolType type) { return BufferPool::_pools[static_cast<int>(type)]; }
     CC_INLINE static const uint getPoolFlag() { return _poolFlag; }
 
     BufferPool(PoolType type, uint entryBits, uint bytesPerEntry);
@@ -55,7 +55,7 @@ public:
     Object *allocateNewChunk();
 
 private:
-    static cc::map<PoolType, BufferPool *> _poolMap;
+    static BufferPool *_pools[POOL_TYPE_COUNT];
     static constexpr uint _poolFlag = 1 << 30;
 
     BufferAllocator _allocator;
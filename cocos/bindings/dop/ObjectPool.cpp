@@ -26,20 +26,38 @@ THE SOFTWARE.
 
 using namespace se;
 
-cc::map<PoolType, ObjectPool *> ObjectPool::_poolMap;
+ObjectPool *ObjectPool::_pools[POOL_TYPE_COUNT] = {};
 
 ObjectPool::ObjectPool(PoolType type, Object *jsArr)
 : _type(type),
   _jsArr(jsArr) {
     CCASSERT(jsArr->isArray(), "ObjectPool: It must be initialized with a JavaScript array");
-    CCASSERT(ObjectPool::_poolMap.count(type) == 0, "This type of ObjectPool already exists.");
+    CCASSERT(ObjectPool::_pools[static_cast<int>(type)] == nullptr, "This type of ObjectPool already exists.");
 
     _jsArr->incRef();
-    _indexMask = 0xffffffff & ~_poolFlag;
-    ObjectPool::_poolMap.emplace(type, this);
+#ifdef CC_DEBUG
+    _jsThreadID = std::this_thread::get_id();
+#endif
+    ObjectPool::_pools[static_cast<int>(type)] = this;
 }
 
 ObjectPool::~ObjectPool() {
     _jsArr->decRef();
-    ObjectPool::_poolMap.erase(_type);
+    ObjectPool::_pools[static_cast<int>(_type)] = nullptr;
+}
+
+uint ObjectPool::setEntry(uint id, Object *jsEntry) {
+    id = INDEX_MASK & id;
+    if (id >= _slots.size()) {
+        _slots.resize(id + 1);
+    }
+    Slot &slot = _slots[id];
+    slot.object = jsEntry ? jsEntry->getPrivateData() : nullptr;
+    // 0 is reserved for entries never registered
+    slot.generation = slot.generation % GENERATION_MASK + 1;
+    return _poolFlag | (slot.generation << INDEX_BITS) | id;
+}
+
+void ObjectPool::clearEntry(uint id) {
+    setEntry(id, nullptr);
 }
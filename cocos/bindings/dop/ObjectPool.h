@@ -30,21 +30,40 @@ THE SOFTWARE.
 #include "cocos/base/Macros.h"
 #include "cocos/base/TypeDef.h"
 #include "PoolType.h"
+#include <thread>
 
 namespace se {
 
 class CC_DLL ObjectPool final : public cc::Object {
 public:
-    CC_INLINE static const cc::map<PoolType, ObjectPool *> &getPoolMap() { return ObjectPool::_poolMap; }
+    CC_INLINE static ObjectPool *getPool(PoolType type) { return ObjectPool::_pools[static_cast<int>(type)]; }
 
     ObjectPool(PoolType type, Object *jsArr);
     ~ObjectPool();
 
+    // Handles returned by setEntry are |pool flag|generation|index|.
+    static constexpr uint INDEX_BITS = 20;
+    static constexpr uint INDEX_MASK = (1 << INDEX_BITS) - 1;
+    static constexpr uint GENERATION_BITS = 9;
+    static constexpr uint GENERATION_MASK = (1 << GENERATION_BITS) - 1;
+
     template <class Type>
-    Type *getTypedObject(uint id) const {
-        id = _indexMask & id;
+    Type *getTypedObject(uint handle) const {
+        uint id = INDEX_MASK & handle;
+        // entries registered through setEntry are read from the native table,
+        // which doesn't touch the JS VM and is safe on worker threads while JS is not running
+        if (id < _slots.size() && _slots[id].generation) {
+            const Slot &slot = _slots[id];
+            if (slot.generation != getGeneration(handle)) {
+                CCASSERT(false, "ObjectPool: Stale handle, the entry has been reassigned or cleared");
+                return nullptr;
+            }
+            return static_cast<Type *>(slot.object);
+        }
+
         bool ok = true;
 #ifdef CC_DEBUG
+        CCASSERT(std::this_thread::get_id() == _jsThreadID, "ObjectPool: Entries not registered through setEntry can only be read on the JS thread");
         uint len = 0;
         ok = _jsArr->getArrayLength(&len);
         CCASSERT(ok && id < len, "ObjectPool: Invalid buffer pool entry id");
@@ -59,13 +78,27 @@ public:
         return entry;
     }
 
+    // Mirror an assignment to the JS array in the native table, returns the handle JS should store from now on.
+    uint setEntry(uint id, Object *jsEntry);
+    void clearEntry(uint id);
+    // Generation encoded in a handle, a registered entry changes it whenever it is reassigned or cleared.
+    CC_INLINE static uint getGeneration(uint handle) { return (handle >> INDEX_BITS) & GENERATION_MASK; }
+
 private:
-    static cc::map<PoolType, ObjectPool *> _poolMap;
+    static ObjectPool *_pools[POOL_TYPE_COUNT];
 
     PoolType _type = PoolType::SHADER;
     Object *_jsArr = nullptr;
     uint _poolFlag = 1 << 29;
-    uint _indexMask = 0;
+#ifdef CC_DEBUG
+    std::thread::id _jsThreadID;
+#endif
+
+    struct Slot {
+        void *object = nullptr;
+        uint generation = 0;
+    };
+    cc::vector<Slot> _slots;
 };
 
 } // namespace se
@@ -50,4 +50,7 @@ enum class PoolType {
     RAW_BUFFER = 300,
     UNKNOWN
 };
+
+// Pools are registered in dense tables indexed by type.
+constexpr int POOL_TYPE_COUNT = static_cast<int>(PoolType::UNKNOWN) + 1;
 }
@@ -141,8 +141,47 @@ static bool jsb_ObjectPool_finalize(se::State &s) {
 }
 SE_BIND_FINALIZE_FUNC(jsb_ObjectPool_finalize)
 
+static bool jsb_ObjectPool_setEntry(se::State &s) {
+    se::ObjectPool *pool = (se::ObjectPool *)s.nativeThisObject();
+    SE_PRECONDITION2(pool, false, "jsb_ObjectPool_setEntry : Invalid Native Object");
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        uint id = 0;
+        bool ok = seval_to_uint(args[0], &id);
+        SE_PRECONDITION2(ok, false, "jsb_ObjectPool_setEntry : Invalid entry id");
+        uint handle = pool->setEntry(id, args[1].isObject() ? args[1].toObject() : nullptr);
+        s.rval().setUint32(handle);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(jsb_ObjectPool_setEntry);
+
+static bool jsb_ObjectPool_clearEntry(se::State &s) {
+    se::ObjectPool *pool = (se::ObjectPool *)s.nativeThisObject();
+    SE_PRECONDITION2(pool, false, "jsb_ObjectPool_clearEntry : Invalid Native Object");
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint id = 0;
+        bool ok = seval_to_uint(args[0], &id);
+        SE_PRECONDITION2(ok, false, "jsb_ObjectPool_clearEntry : Invalid entry id");
+        pool->clearEntry(id);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(jsb_ObjectPool_clearEntry);
+
 static bool js_register_se_ObjectPool(se::Object *obj) {
     se::Class *cls = se::Class::create("NativeObjectPool", obj, nullptr, _SE(jsb_ObjectPool_constructor));
+    cls->defineFunction("setEntry", _SE(jsb_ObjectPool_setEntry));
+    cls->defineFunction("clearEntry", _SE(jsb_ObjectPool_clearEntry));
     cls->install();
     JSBClassType::registerClass<se::ObjectPool>(cls);
 
@@ -79,6 +79,15 @@ Object *Object::createArrayBufferObject(void *data, size_t byteLength) {
     return obj;
 }
 
+Object *Object::createExternalArrayBufferObject(void *contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void *userData) {
+    // no external backing store support here, fall back to a copy
+    Object *obj = Object::createArrayBufferObject(contents, byteLength);
+    if (freeFunc) {
+        freeFunc(contents, byteLength, userData);
+    }
+    return obj;
+}
+
 Object *Object::createTypedArray(TypedArrayType type, void *data, size_t byteLength) {
     if (type == TypedArrayType::NONE) {
         SE_LOGE("Don't pass se::Object::TypedArrayType::NONE to createTypedArray API!");
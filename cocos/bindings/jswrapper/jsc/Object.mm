@@ -136,6 +136,45 @@ Object *Object::createArrayBufferObject(void *data, size_t byteLength) {
     return obj;
 }
 
+Object *Object::createExternalArrayBufferObject(void *contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void *userData) {
+    #if (__MAC_OS_X_VERSION_MAX_ALLOWED >= 101200 || __IPHONE_OS_VERSION_MAX_ALLOWED >= 100000)
+    if (isSupportTypedArrayAPI()) {
+        struct ExternalContents {
+            size_t byteLength;
+            BufferContentsFreeFunc freeFunc;
+            void *userData;
+        };
+        auto *external = new ExternalContents{byteLength, freeFunc, userData};
+        auto deallocator = [](void *bytes, void *deallocatorContext) {
+            auto *external = static_cast<ExternalContents *>(deallocatorContext);
+            if (external->freeFunc) {
+                external->freeFunc(bytes, external->byteLength, external->userData);
+            }
+            delete external;
+        };
+
+        JSValueRef exception = nullptr;
+        JSObjectRef jsobj = JSObjectMakeArrayBufferWithBytesNoCopy(__cx, contents, byteLength, deallocator, external, &exception);
+        if (exception != nullptr) {
+            ScriptEngine::getInstance()->_clearException(exception);
+            deallocator(contents, external);
+            return nullptr;
+        }
+
+        Object *obj = Object::_createJSObject(nullptr, jsobj);
+        if (obj != nullptr)
+            obj->_type = Type::ARRAY_BUFFER;
+        return obj;
+    }
+    #endif
+    // no external backing store support here, fall back to a copy
+    Object *obj = Object::createArrayBufferObject(contents, byteLength);
+    if (freeFunc) {
+        freeFunc(contents, byteLength, userData);
+    }
+    return obj;
+}
+
 Object *Object::createTypedArray(TypedArrayType type, void *data, size_t byteLength) {
     if (type == TypedArrayType::NONE) {
         SE_LOGE("Don't pass se::Object::TypedArrayType::NONE to createTypedArray API!");
@@ -99,6 +99,20 @@ public:
          */
     static Object *createArrayBufferObject(void *data, size_t byteLength);
 
+    using BufferContentsFreeFunc = void (*)(void *contents, size_t byteLength, void *userData);
+
+    /**
+         *  @brief Creates a JavaScript Array Buffer object that takes ownership of an existing buffer instead of copying it.
+         *  @param[in] contents A pointer to the byte buffer to be used as the backing store of the Array Buffer object.
+         *  @param[in] byteLength The number of bytes pointed to by the parameter contents.
+         *  @param[in] freeFunc Called with contents, byteLength and userData once the Array Buffer object is garbage collected.
+         *  @param[in] userData Passed to freeFunc.
+         *  @return A Array Buffer Object whose backing store is contents, or nullptr if there is an error.
+         *  @note The return value (non-null) has to be released manually. freeFunc may run on any thread, it also runs
+         *        right away if creating the object fails or the engine has to copy the contents.
+         */
+    static Object *createExternalArrayBufferObject(void *contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void *userData = nullptr);
+
     /**
          *  @brief Creates a JavaScript Object from a JSON formatted string.
          *  @param[in] jsonStr The utf-8 string containing the JSON string to be parsed.
@@ -210,10 +210,28 @@ bool seval_to_std_string(const se::Value &v, std::string *ret) {
     return true;
 }
 
+namespace {
+// Fast path of math conversions, reads components from a Float32Array directly.
+bool seval_to_floats(se::Object *obj, float *out, size_t count) {
+    if (!obj->isTypedArray() || obj->getTypedArrayType() != se::Object::TypedArrayType::FLOAT32) {
+        return false;
+    }
+    uint8_t *ptr = nullptr;
+    size_t length = 0;
+    obj->getTypedArrayData(&ptr, &length);
+    if (length < count * sizeof(float)) {
+        return false;
+    }
+    memcpy(out, ptr, count * sizeof(float));
+    return true;
+}
+} // namespace
+
 bool seval_to_Vec2(const se::Value &v, cc::Vec2 *pt) {
     assert(pt != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec2 failed!");
     se::Object *obj = v.toObject();
+    if (seval_to_floats(obj, &pt->x, 2)) return true;
     se::Value x;
     se::Value y;
     bool ok = obj->getProperty("x", &x);
@@ -229,6 +247,7 @@ bool seval_to_Vec3(const se::Value &v, cc::Vec3 *pt) {
     assert(pt != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec3 failed!");
     se::Object *obj = v.toObject();
+    if (seval_to_floats(obj, &pt->x, 3)) return true;
     se::Value x;
     se::Value y;
     se::Value z;
@@ -249,6 +268,7 @@ bool seval_to_Vec4(const se::Value &v, cc::Vec4 *pt) {
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec4 failed!");
     pt->x = pt->y = pt->z = pt->w = 0.0f;
     se::Object *obj = v.toObject();
+    if (seval_to_floats(obj, &pt->x, 4)) return true;
     se::Value x;
     se::Value y;
     se::Value z;
@@ -291,13 +311,7 @@ bool seval_to_Mat4(const se::Value &v, cc::Mat4 *mat) {
 
     if (obj->isTypedArray()) {
         // typed array
-        SE_PRECONDITION2(obj->isTypedArray(), false, "Convert parameter to Matrix4 failed!");
-
-        size_t length = 0;
-        uint8_t *ptr = nullptr;
-        obj->getTypedArrayData(&ptr, &length);
-
-        memcpy(mat->m, ptr, length);
+        SE_PRECONDITION3(seval_to_floats(obj, mat->m, 16), false, *mat = cc::Mat4::IDENTITY);
     } else {
         bool ok = false;
         se::Value tmp;
@@ -363,6 +377,7 @@ bool seval_to_Size(const se::Value &v, cc::Size *size) {
     assert(size != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Size failed!");
     se::Object *obj = v.toObject();
+    if (seval_to_floats(obj, &size->width, 2)) return true;
     se::Value width;
     se::Value height;
 
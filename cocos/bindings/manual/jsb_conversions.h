@@ -1070,6 +1070,33 @@ inline bool sevalue_to_native(const se::Value &from, cc::ValueMap *to, se::Objec
     return seval_to_ccvaluemap(from, to);
 }
 
+// Math types accept a Float32Array (or a view into a shared scratch one) besides plain objects,
+// which is read directly instead of one property lookup per component.
+template <>
+inline bool sevalue_to_native(const se::Value &from, cc::Vec2 *to, se::Object *) {
+    return seval_to_Vec2(from, to);
+}
+
+template <>
+inline bool sevalue_to_native(const se::Value &from, cc::Vec3 *to, se::Object *) {
+    return seval_to_Vec3(from, to);
+}
+
+template <>
+inline bool sevalue_to_native(const se::Value &from, cc::Vec4 *to, se::Object *) {
+    return seval_to_Vec4(from, to);
+}
+
+template <>
+inline bool sevalue_to_native(const se::Value &from, cc::Mat4 *to, se::Object *) {
+    return seval_to_Mat4(from, to);
+}
+
+template <>
+inline bool sevalue_to_native(const se::Value &from, cc::Size *to, se::Object *) {
+    return seval_to_Size(from, to);
+}
+
 template <>
 inline bool sevalue_to_native(const se::Value &from, std::vector<unsigned char> *to, se::Object *) {
     assert(from.isObject());
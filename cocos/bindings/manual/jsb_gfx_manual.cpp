@@ -3,6 +3,7 @@
 #include "bindings/jswrapper/SeApi.h"
 #include "bindings/manual/jsb_conversions.h"
 #include "bindings/manual/jsb_global.h"
+#include "renderer/gfx-agent/GFXAgent.h"
 
 #if !(defined(CC_USE_GLES2) || defined(CC_USE_GLES3) || defined(CC_USE_VULKAN) || defined(CC_USE_METAL))
     #error "gfx backend is not defined!"
@@ -426,6 +427,48 @@ static bool js_gfx_CommandBuffer_copyBuffersToTexture(se::State &s) {
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_copyBuffersToTexture)
 
+static bool js_gfx_CommandBuffer_executeStream(se::State &s) {
+    cc::gfx::CommandBuffer *cobj = (cc::gfx::CommandBuffer *)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_gfx_CommandBuffer_executeStream : Invalid Native Object");
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 3) {
+        // commands are packed in a Uint32Array shared with script, see gfx::CommandStream
+        SE_PRECONDITION2(args[0].isObject() && args[0].toObject()->isTypedArray() &&
+                             args[0].toObject()->getTypedArrayType() == se::Object::TypedArrayType::UINT32,
+                         false, "js_gfx_CommandBuffer_executeStream : Invalid stream, expecting Uint32Array");
+        uint8_t *words = nullptr;
+        size_t byteLength = 0;
+        args[0].toObject()->getTypedArrayData(&words, &byteLength);
+        SE_PRECONDITION2(reinterpret_cast<uintptr_t>(words) % alignof(uint) == 0, false, "js_gfx_CommandBuffer_executeStream : Misaligned stream");
+
+        uint32_t wordCount = 0;
+        ok &= seval_to_uint32(args[1], &wordCount);
+        SE_PRECONDITION2(ok && wordCount <= byteLength / sizeof(uint), false, "js_gfx_CommandBuffer_executeStream : Invalid word count");
+
+        // objects referenced by the stream, resolved once per batch
+        auto &objects = cobj->getStreamObjectsForJS();
+        SE_PRECONDITION2(args[2].isObject() && args[2].toObject()->isArray(), false, "js_gfx_CommandBuffer_executeStream : Invalid object table");
+        se::Object *jsarr = args[2].toObject();
+        uint32_t objectCount = 0;
+        jsarr->getArrayLength(&objectCount);
+        objects.resize(objectCount);
+        se::Value tmp;
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            jsarr->getArrayElement(i, &tmp);
+            objects[i] = tmp.isObject() ? (cc::gfx::GFXObject *)tmp.toObject()->getPrivateData() : nullptr;
+        }
+
+        ok = cc::gfx::CommandStream::execute(cobj, (const uint *)words, wordCount, objects.data(), objectCount);
+        s.rval().setBoolean(ok);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_CommandBuffer_executeStream)
+
 static bool js_gfx_InputAssembler_extractDrawInfo(se::State &s) {
     cc::gfx::InputAssembler *cobj = (cc::gfx::InputAssembler *)s.nativeThisObject();
     SE_PRECONDITION2(cobj, false, "js_gfx_InputAssembler_extractDrawInfo : Invalid Native Object");
@@ -464,6 +507,54 @@ static bool js_gfx_InputAssembler_extractDrawInfo(se::State &s) {
 }
 SE_BIND_FUNC(js_gfx_InputAssembler_extractDrawInfo)
 
+se::Object *__jsb_cc_gfx_DeviceAgent_proto = nullptr;
+se::Class *__jsb_cc_gfx_DeviceAgent_class = nullptr;
+
+static bool js_gfx_DeviceAgent_finalize(se::State &s) {
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(s.nativeThisObject());
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end()) {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::gfx::DeviceAgent *cobj = (cc::gfx::DeviceAgent *)s.nativeThisObject();
+        CC_DELETE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_gfx_DeviceAgent_finalize)
+
+static bool js_gfx_DeviceAgent_constructor(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        cc::gfx::Device *actor = nullptr;
+        ok &= sevalue_to_native(args[0], &actor, s.thisObject());
+        SE_PRECONDITION2(ok && actor, false, "js_gfx_DeviceAgent_constructor : Error processing arguments");
+        // the agent takes over the ownership of the wrapped device
+        se::NonRefNativePtrCreatedByCtorMap::erase(actor);
+        cc::gfx::DeviceAgent *cobj = CC_NEW(cc::gfx::DeviceAgent(actor));
+        s.thisObject()->setPrivateData(cobj);
+        se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_CTOR(js_gfx_DeviceAgent_constructor, __jsb_cc_gfx_DeviceAgent_class, js_gfx_DeviceAgent_finalize)
+
+static bool js_register_gfx_DeviceAgent(se::Object *obj) {
+    auto cls = se::Class::create("DeviceAgent", obj, __jsb_cc_gfx_Device_proto, _SE(js_gfx_DeviceAgent_constructor));
+
+    cls->defineFinalizeFunction(_SE(js_gfx_DeviceAgent_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::gfx::DeviceAgent>(cls);
+
+    __jsb_cc_gfx_DeviceAgent_proto = cls->getProto();
+    __jsb_cc_gfx_DeviceAgent_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
 bool register_all_gfx_manual(se::Object *obj) {
     __jsb_cc_gfx_Device_proto->defineFunction("copyBuffersToTexture", _SE(js_gfx_Device_copyBuffersToTexture));
     __jsb_cc_gfx_Device_proto->defineFunction("copyTexImagesToTexture", _SE(js_gfx_Device_copyTexImagesToTexture));
@@ -476,6 +567,7 @@ bool register_all_gfx_manual(se::Object *obj) {
     __jsb_cc_gfx_CommandBuffer_proto->defineFunction("execute", _SE(js_gfx_CommandBuffer_execute));
     __jsb_cc_gfx_CommandBuffer_proto->defineFunction("updateBuffer", _SE(js_gfx_CommandBuffer_updateBuffer));
     __jsb_cc_gfx_CommandBuffer_proto->defineFunction("copyBuffersToTexture", _SE(js_gfx_CommandBuffer_copyBuffersToTexture));
+    __jsb_cc_gfx_CommandBuffer_proto->defineFunction("executeStream", _SE(js_gfx_CommandBuffer_executeStream));
 
     __jsb_cc_gfx_InputAssembler_proto->defineFunction("extractDrawInfo", _SE(js_gfx_InputAssembler_extractDrawInfo));
 
@@ -493,6 +585,8 @@ bool register_all_gfx_manual(se::Object *obj) {
 
     //    js_register_gfx_SubPass(ns);
 
+    js_register_gfx_DeviceAgent(ns);
+
 #ifdef CC_USE_VULKAN
     register_all_vk(obj);
 #endif
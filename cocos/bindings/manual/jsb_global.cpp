@@ -1012,6 +1012,11 @@ bool jsb_register_global_variables(se::Object *global) {
     global->defineFunction("__restartVM", _SE(JSB_core_restartVM));
     global->defineFunction("__isObjectValid", _SE(JSB_isObjectValid));
 
+    // Scratch storage for math arguments, JS fills persistent subarray views of it and passes them
+    // to native functions instead of plain objects, see seval_to_Vec3 and seval_to_Mat4.
+    se::HandleObject mathScratch(se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT32, nullptr, 64 * sizeof(float)));
+    __jsbObj->setProperty("mathScratch", se::Value(mathScratch));
+
     se::HandleObject performanceObj(se::Object::createPlainObject());
     performanceObj->defineFunction("now", _SE(js_performance_now));
     global->setProperty("performance", se::Value(performanceObj));
@@ -44,6 +44,34 @@ static bool JSB_getOrCreatePipelineState(se::State &s) {
 }
 SE_BIND_FUNC(JSB_getOrCreatePipelineState);
 
+static bool JSB_setAsyncCreation(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        bool ok = true;
+        bool enabled = false;
+        ok &= seval_to_boolean(args[0], &enabled);
+        SE_PRECONDITION2(ok, false, "JSB_setAsyncCreation : Error processing arguments.");
+        cc::pipeline::PipelineStateManager::setAsyncCreation(enabled);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setAsyncCreation);
+
+static bool JSB_isAsyncCreation(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        s.rval().setBoolean(cc::pipeline::PipelineStateManager::isAsyncCreation());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_isAsyncCreation);
+
 bool register_all_pipeline_manual(se::Object *obj) {
     // Get the ns
     se::Value nrVal;
@@ -59,6 +87,8 @@ bool register_all_pipeline_manual(se::Object *obj) {
     psmVal.setObject(jsobj);
     nr->setProperty("PipelineStateManager", psmVal);
     psmVal.toObject()->defineFunction("getOrCreatePipelineState", _SE(JSB_getOrCreatePipelineState));
+    psmVal.toObject()->defineFunction("setAsyncCreation", _SE(JSB_setAsyncCreation));
+    psmVal.toObject()->defineFunction("isAsyncCreation", _SE(JSB_isAsyncCreation));
 
     __jsb_cc_pipeline_RenderPipeline_proto->defineProperty("macros", _SE(js_pipeline_RenderPipeline_getMacros), nullptr);
     return true;
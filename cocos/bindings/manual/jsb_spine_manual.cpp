@@ -100,6 +100,9 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
 
     spine::AttachmentLoader *attachmentLoader = new (__FILE__, __LINE__) spine::Cocos2dAtlasAttachmentLoader(atlas);
     spine::SkeletonData *skeletonData = nullptr;
+    // identify the source content, so baked caches on disk are invalidated when it changes
+    uint64_t dataHash = spine::SkeletonDataMgr::hashData(atlasText.data(), atlasText.size());
+    dataHash = spine::SkeletonDataMgr::hashData(&scale, sizeof(scale), dataHash);
 
     std::size_t length = skeletonDataFile.length();
     auto binPos = skeletonDataFile.find(".skel", length - 5);
@@ -111,6 +114,7 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
             cc::Data cocos2dData;
             const auto fullpath = fileUtils->fullPathForFilename(skeletonDataFile);
             fileUtils->getContents(fullpath, &cocos2dData);
+            dataHash = spine::SkeletonDataMgr::hashData(cocos2dData.getBytes(), (std::size_t)cocos2dData.getSize(), dataHash);
 
             spine::SkeletonBinary binary(attachmentLoader);
             binary.setScale(scale);
@@ -118,6 +122,7 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
             CCASSERT(skeletonData, !binary.getError().isEmpty() ? binary.getError().buffer() : "Error reading binary skeleton data.");
         }
     } else {
+        dataHash = spine::SkeletonDataMgr::hashData(skeletonDataFile.data(), skeletonDataFile.size(), dataHash);
         spine::SkeletonJson json(attachmentLoader);
         json.setScale(scale);
         skeletonData = json.readSkeletonData(skeletonDataFile.c_str());
@@ -129,7 +134,7 @@ static bool js_register_spine_initSkeletonData(se::State &s) {
         for (auto it = textures.begin(); it != textures.end(); it++) {
             texturesIndex.push_back(it->second->getRealTextureIndex());
         }
-        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex);
+        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex, dataHash);
         native_ptr_to_seval<spine::SkeletonData>(skeletonData, &s.rval());
     } else {
         if (atlas) {
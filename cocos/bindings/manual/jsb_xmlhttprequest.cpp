@@ -36,6 +36,7 @@
 #include <string>
 #include <functional>
 #include <algorithm>
+#include <memory>
 #include <sstream>
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "cocos/bindings/manual/jsb_conversions.h"
@@ -113,6 +114,33 @@ std::unordered_map<int, std::string> _httpStatusCodeMap = {
     {599, "Network Connect Timeout Error"}};
 }
 
+// Receives the body of an arraybuffer response on the network thread. The buffer is sized from
+// Content-Length up front and later given to JS as is, it's shared with the HttpRequest so it
+// outlives the XMLHttpRequest when the request is still running.
+struct XMLHttpResponseBuffer {
+    unsigned char *bytes = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    ~XMLHttpResponseBuffer() { free(bytes); }
+
+    bool append(HttpResponse *response, const char *data, size_t len) {
+        if (size + len > capacity) {
+            const size_t contentLength = response->getContentLength() > 0 ? static_cast<size_t>(response->getContentLength()) : 0;
+            const size_t newCapacity = std::max({size + len, capacity * 2, contentLength});
+            auto *newBytes = static_cast<unsigned char *>(realloc(bytes, newCapacity));
+            if (!newBytes) {
+                return false;
+            }
+            bytes = newBytes;
+            capacity = newCapacity;
+        }
+        memcpy(bytes + size, data, len);
+        size += len;
+        return true;
+    }
+};
+
 class XMLHttpRequest : public Ref {
 public:
     // Ready States: https://developer.mozilla.org/en-US/docs/Web/API/XMLHttpRequest/readyState
@@ -156,6 +184,11 @@ public:
     const std::string &getStatusText() const { return _statusText; }
     const std::string &getResponseText() const { return _responseText; }
     const cc::Data &getResponseData() const { return _responseData; }
+    // Hands the arraybuffer body over to the caller, once per response.
+    bool takeResponseData(unsigned char **bytes, ssize_t *size);
+    // The ArrayBuffer made from the body, rooted until the next open() or response.
+    se::Object *getResponseObject() const { return _responseObject; }
+    void setResponseObject(se::Object *obj);
     ResponseType getResponseType() const { return _responseType; }
     void setResponseType(ResponseType type) { _responseType = type; }
 
@@ -191,6 +224,8 @@ private:
     std::string _overrideMimeType;
 
     cc::Data _responseData;
+    std::shared_ptr<XMLHttpResponseBuffer> _responseBuffer;
+    se::Object *_responseObject = nullptr;
 
     cc::network::HttpRequest *_httpRequest;
     //    cc::EventListenerCustom* _resetDirectorListener;
@@ -209,6 +244,7 @@ private:
     bool _isDiscardedByReset;
     bool _isTimeout;
     bool _isSending;
+    bool _hasResponseData;
 };
 
 XMLHttpRequest::XMLHttpRequest()
@@ -231,7 +267,8 @@ XMLHttpRequest::XMLHttpRequest()
   _isLoadEnd(false),
   _isDiscardedByReset(false),
   _isTimeout(false),
-  _isSending(false) {
+  _isSending(false),
+  _hasResponseData(false) {
 }
 
 XMLHttpRequest::~XMLHttpRequest() {
@@ -239,6 +276,10 @@ XMLHttpRequest::~XMLHttpRequest() {
     // Avoid HttpClient response call a released object!
     _httpRequest->setResponseCallback(nullptr);
     CC_SAFE_RELEASE(_httpRequest);
+    // the script engine cleans up the objects it still holds itself
+    if (se::ScriptEngine::getInstance()->isValid()) {
+        setResponseObject(nullptr);
+    }
 }
 
 bool XMLHttpRequest::open(const std::string &method, const std::string &url) {
@@ -269,6 +310,7 @@ bool XMLHttpRequest::open(const std::string &method, const std::string &url) {
     _status = 0;
     _isAborted = false;
     _isTimeout = false;
+    setResponseObject(nullptr);
 
     setReadyState(ReadyState::OPENED);
 
@@ -405,6 +447,8 @@ void XMLHttpRequest::onResponse(HttpClient *client, HttpResponse *response) {
 
     _responseText.clear();
     _responseData.clear();
+    _hasResponseData = false;
+    setResponseObject(nullptr);
 
     if (!response->isSucceed()) {
         std::string errorBuffer = response->getErrorBuffer();
@@ -437,12 +481,25 @@ void XMLHttpRequest::onResponse(HttpClient *client, HttpResponse *response) {
     }
 
     /** get the response data **/
-    std::vector<char> *buffer = response->getResponseData();
-
-    if (_responseType == ResponseType::STRING || _responseType == ResponseType::JSON) {
-        _responseText.append(buffer->data(), buffer->size());
+    if (_responseBuffer) {
+        // the body was streamed into _responseBuffer, take it over instead of copying it
+        if (_responseType == ResponseType::STRING || _responseType == ResponseType::JSON) {
+            _responseText.assign(reinterpret_cast<char *>(_responseBuffer->bytes), _responseBuffer->size);
+        } else {
+            _responseData.fastSet(_responseBuffer->bytes, _responseBuffer->size);
+            _responseBuffer->bytes = nullptr;
+            _hasResponseData = true;
+        }
+        _responseBuffer.reset();
     } else {
-        _responseData.copy((unsigned char *)buffer->data(), buffer->size());
+        std::vector<char> *buffer = response->getResponseData();
+
+        if (_responseType == ResponseType::STRING || _responseType == ResponseType::JSON) {
+            _responseText.append(buffer->data(), buffer->size());
+        } else {
+            _responseData.copy((unsigned char *)buffer->data(), buffer->size());
+            _hasResponseData = true;
+        }
     }
 
     _status = statusCode;
@@ -459,6 +516,27 @@ void XMLHttpRequest::onResponse(HttpClient *client, HttpResponse *response) {
     }
 }
 
+bool XMLHttpRequest::takeResponseData(unsigned char **bytes, ssize_t *size) {
+    if (!_hasResponseData) {
+        return false;
+    }
+    _hasResponseData = false;
+    *bytes = _responseData.takeBuffer(size);
+    return true;
+}
+
+void XMLHttpRequest::setResponseObject(se::Object *obj) {
+    if (_responseObject) {
+        _responseObject->unroot();
+        _responseObject->decRef();
+    }
+    _responseObject = obj;
+    if (_responseObject) {
+        _responseObject->incRef();
+        _responseObject->root();
+    }
+}
+
 void XMLHttpRequest::overrideMimeType(const std::string &mimeType) {
     _overrideMimeType = mimeType;
 }
@@ -490,6 +568,17 @@ void XMLHttpRequest::sendRequest() {
     }
     setHttpRequestHeader();
 
+    if (_responseType == ResponseType::ARRAY_BUFFER) {
+        auto buffer = std::make_shared<XMLHttpResponseBuffer>();
+        _responseBuffer = buffer;
+        _httpRequest->setResponseDataCallback([buffer](HttpResponse *response, const char *data, size_t len) {
+            return buffer->append(response, data, len);
+        });
+    } else {
+        _responseBuffer.reset();
+        _httpRequest->setResponseDataCallback(nullptr);
+    }
+
     _httpRequest->setResponseCallback(CC_CALLBACK_2(XMLHttpRequest::onResponse, this));
     cc::network::HttpClient::getInstance()->sendImmediate(_httpRequest);
 
@@ -860,10 +949,17 @@ static bool XMLHttpRequest_getResponse(se::State &s) {
                     s.rval().setNull();
                 }
             } else if (xhr->getResponseType() == XMLHttpRequest::ResponseType::ARRAY_BUFFER) {
-                const Data &data = xhr->getResponseData();
-                se::HandleObject seObj(se::Object::createArrayBufferObject(data.getBytes(), data.getSize()));
-                if (!seObj.isEmpty()) {
-                    s.rval().setObject(seObj);
+                // The body moves into the ArrayBuffer on first access and the object is kept on
+                // the native XMLHttpRequest, later accesses return the same ArrayBuffer.
+                unsigned char *bytes = nullptr;
+                ssize_t size = 0;
+                if (xhr->takeResponseData(&bytes, &size)) {
+                    se::HandleObject seObj(bytes ? se::Object::createExternalArrayBufferObject(bytes, size, [](void *contents, size_t /*byteLength*/, void * /*userData*/) { free(contents); })
+                                                 : se::Object::createArrayBufferObject(nullptr, 0));
+                    xhr->setResponseObject(seObj.isEmpty() ? nullptr : seObj.get());
+                }
+                if (xhr->getResponseObject()) {
+                    s.rval().setObject(xhr->getResponseObject());
                 } else {
                     s.rval().setNull();
                 }
@@ -31,7 +31,13 @@ MeshBuffer::MeshBuffer(int vertexFormat)
 }
 
 MeshBuffer::MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize)
+: MeshBuffer(vertexFormat, indexSize, vertexSize, false) {
+}
+
+MeshBuffer::MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize, bool isLocal)
 : _vertexFormat(vertexFormat), _ib(indexSize), _vb(vertexSize * vertexFormat * sizeof(float)) {
+    if (isLocal) return;
+
     _vb.setMaxSize(MAX_VERTEX_BUFFER_SIZE * _vertexFormat * sizeof(float));
     _ib.setMaxSize(INIT_INDEX_BUFFER_SIZE);
     _vb.setFullCallback([this] {
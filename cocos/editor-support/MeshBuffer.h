@@ -33,6 +33,11 @@ class MeshBuffer {
 public:
     MeshBuffer(int vertexFormat);
     MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize);
+    /**
+     * @param[in] isLocal Local buffer has no typed arrays and no size limit,
+     * it is used as scratch space and never uploaded to script.
+     */
+    MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize, bool isLocal);
 
     virtual ~MeshBuffer();
 
@@ -72,6 +77,10 @@ public:
         return _ib;
     }
 
+    int getVertexFormat() const {
+        return _vertexFormat;
+    }
+
     void uploadVB();
     void uploadIB();
     void reset();
@@ -23,10 +23,53 @@
  ****************************************************************************/
 #include "MiddlewareManager.h"
 #include "SeApi.h"
+#include "base/threading/JobSystem.h"
 #include <algorithm>
 
 MIDDLEWARE_BEGIN
 
+namespace {
+// Segment of the middleware rendered by current thread, null outside parallel render.
+thread_local RenderSegment *tlsSegment = nullptr;
+} // namespace
+
+RenderSegment::RenderSegment()
+: renderInfo(MIN_TYPE_ARRAY_SIZE), attachInfo(MIN_TYPE_ARRAY_SIZE) {
+}
+
+RenderSegment::~RenderSegment() {
+    if (meshBuffer) {
+        delete meshBuffer;
+        meshBuffer = nullptr;
+    }
+}
+
+MeshBuffer *RenderSegment::getMeshBuffer(int vertexFormat) {
+    if (format == -1) {
+        if (meshBuffer && meshBuffer->getVertexFormat() != vertexFormat) {
+            delete meshBuffer;
+            meshBuffer = nullptr;
+        }
+        if (!meshBuffer) {
+            meshBuffer = new MeshBuffer(vertexFormat, MIN_TYPE_ARRAY_SIZE, MIN_TYPE_ARRAY_SIZE, true);
+        }
+        format = vertexFormat;
+    } else if (format != vertexFormat) {
+        isMixed = true;
+    }
+    return meshBuffer;
+}
+
+void RenderSegment::reset() {
+    renderInfo.reset();
+    attachInfo.reset();
+    if (meshBuffer) {
+        meshBuffer->reset();
+    }
+    format = -1;
+    isMixed = false;
+}
+
 MiddlewareManager *MiddlewareManager::_instance = nullptr;
 
 MiddlewareManager::MiddlewareManager() : _renderInfo(se::Object::TypedArrayType::UINT32),
@@ -34,6 +77,11 @@ MiddlewareManager::MiddlewareManager() : _renderInfo(se::Object::TypedArrayType:
 }
 
 MiddlewareManager::~MiddlewareManager() {
+    for (auto segment : _segments) {
+        delete segment;
+    }
+    _segments.clear();
+
     for (auto it : _mbMap) {
         auto buffer = it.second;
         if (buffer) {
@@ -43,7 +91,16 @@ MiddlewareManager::~MiddlewareManager() {
     _mbMap.clear();
 }
 
+void MiddlewareManager::setParallel(bool value) {
+    _isParallel = value;
+    if (_isParallel) JobSystem::getInstance();
+}
+
 MeshBuffer *MiddlewareManager::getMeshBuffer(int format) {
+    if (tlsSegment) {
+        return tlsSegment->getMeshBuffer(format);
+    }
+
     MeshBuffer *mb = _mbMap[format];
     if (!mb) {
         mb = new MeshBuffer(format);
@@ -52,6 +109,20 @@ MeshBuffer *MiddlewareManager::getMeshBuffer(int format) {
     return mb;
 }
 
+IOBuffer *MiddlewareManager::getRenderInfoBuffer() {
+    if (tlsSegment) {
+        return &tlsSegment->renderInfo;
+    }
+    return _renderInfo.getBuffer();
+}
+
+IOBuffer *MiddlewareManager::getAttachInfoBuffer() {
+    if (tlsSegment) {
+        return &tlsSegment->attachInfo;
+    }
+    return _attachInfo.getBuffer();
+}
+
 void MiddlewareManager::_clearRemoveList() {
     for (std::size_t i = 0; i < _removeList.size(); i++) {
         auto editor = _removeList[i];
@@ -79,6 +150,10 @@ void MiddlewareManager::update(float dt) {
         attachBuffer->writeUint32(0);
     }
 
+    if (_isParallel) {
+        _updateParallel(dt);
+    }
+
     auto isOrderDirty = false;
     uint32_t maxRenderOrder = 0;
     for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
@@ -87,11 +162,11 @@ void MiddlewareManager::update(float dt) {
         if (_removeList.size() > 0) {
             auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
             if (removeIt == _removeList.end()) {
-                editor->update(dt);
+                if (!_isParallel || !_parallelFlags[i]) editor->update(dt);
                 renderOrder = editor->getRenderOrder();
             }
         } else {
-            editor->update(dt);
+            if (!_isParallel || !_parallelFlags[i]) editor->update(dt);
             renderOrder = editor->getRenderOrder();
         }
 
@@ -123,15 +198,19 @@ void MiddlewareManager::render(float dt) {
 
     isRendering = true;
 
-    for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
-        auto editor = _updateList[i];
-        if (_removeList.size() > 0) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
+    if (_isParallel) {
+        _renderParallel(dt);
+    } else {
+        for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
+            auto editor = _updateList[i];
+            if (_removeList.size() > 0) {
+                auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
+                if (removeIt == _removeList.end()) {
+                    editor->render(dt);
+                }
+            } else {
                 editor->render(dt);
             }
-        } else {
-            editor->render(dt);
         }
     }
 
@@ -148,6 +227,155 @@ void MiddlewareManager::render(float dt) {
     _clearRemoveList();
 }
 
+void MiddlewareManager::_parallelFor(std::size_t count, const std::function<void(std::size_t)> &task) {
+    // skeletons differ a lot in cost, one job each lets idle workers steal the slow ones
+    JobSystem::getInstance()->parallelFor(static_cast<uint>(count), 1, [&task](uint index) {
+        task(index);
+    });
+}
+
+void MiddlewareManager::_updateParallel(float dt) {
+    auto count = _updateList.size();
+    _parallelFlags.assign(count, 0);
+    _parallelIndices.clear();
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto editor = _updateList[i];
+        if (_removeList.size() > 0 && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end()) {
+            continue;
+        }
+        if (editor->canUpdateInParallel()) {
+            _parallelFlags[i] = 1;
+            _parallelIndices.push_back(i);
+        }
+    }
+
+    // not worth dispatching, leave all to the serial loop
+    if (_parallelIndices.size() < 2) {
+        std::fill(_parallelFlags.begin(), _parallelFlags.end(), 0);
+        return;
+    }
+
+    _parallelFor(_parallelIndices.size(), [&](std::size_t index) {
+        _updateList[_parallelIndices[index]]->update(dt);
+    });
+}
+
+void MiddlewareManager::_renderParallel(float dt) {
+    auto count = _updateList.size();
+    _parallelFlags.assign(count, 0);
+    _parallelIndices.clear();
+    while (_segments.size() < count) {
+        _segments.push_back(new RenderSegment());
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        auto editor = _updateList[i];
+        if (_removeList.size() > 0 && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end()) {
+            continue;
+        }
+        if (editor->canRenderInParallel()) {
+            _parallelFlags[i] = 1;
+            _parallelIndices.push_back(i);
+            _segments[i]->reset();
+        }
+    }
+
+    if (_parallelIndices.size() < 2) {
+        std::fill(_parallelFlags.begin(), _parallelFlags.end(), 0);
+    } else {
+        _parallelFor(_parallelIndices.size(), [&](std::size_t index) {
+            auto i = _parallelIndices[index];
+            tlsSegment = _segments[i];
+            _updateList[i]->render(dt);
+            tlsSegment = nullptr;
+        });
+    }
+
+    // Merge in list order so the shared buffers match a serial render.
+    for (std::size_t i = 0; i < count; i++) {
+        auto editor = _updateList[i];
+        if (_removeList.size() > 0 && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end()) {
+            continue;
+        }
+        if (_parallelFlags[i]) {
+            _mergeSegment(editor, _segments[i], dt);
+        } else {
+            editor->render(dt);
+        }
+    }
+}
+
+void MiddlewareManager::_mergeSegment(IMiddleware *editor, RenderSegment *segment, float dt) {
+    auto &srcRenderInfo = segment->renderInfo;
+    // render returned before writing anything, offsets stay cleared
+    if (srcRenderInfo.length() < sizeof(uint32_t) * 2) return;
+
+    auto srcMB = segment->meshBuffer;
+    auto hasMesh = segment->format != -1;
+    if (segment->isMixed ||
+        (hasMesh && (srcMB->getVB().length() > MAX_VERTEX_BUFFER_SIZE * segment->format * sizeof(float) ||
+                     srcMB->getIB().length() > INIT_INDEX_BUFFER_SIZE))) {
+        // Does not fit into one shared buffer, render again and let it split.
+        editor->render(dt);
+        return;
+    }
+
+    auto renderInfo = _renderInfo.getBuffer();
+    if (!renderInfo) return;
+    auto attachInfo = _attachInfo.getBuffer();
+    if (!attachInfo) return;
+
+    if (hasMesh) {
+        MeshBuffer *mb = getMeshBuffer(segment->format);
+        IOBuffer &srcVB = srcMB->getVB();
+        IOBuffer &srcIB = srcMB->getIB();
+        IOBuffer &vb = mb->getVB();
+        IOBuffer &ib = mb->getIB();
+
+        // may switch to next buffer
+        vb.checkSpace(srcVB.length(), true);
+        ib.checkSpace(srcIB.length(), true);
+
+        auto vertexOffset = (uint32_t)(vb.getCurPos() / (segment->format * sizeof(float)));
+        auto indexOffset = (uint32_t)(ib.getCurPos() / sizeof(unsigned short));
+        auto bufferIndex = (uint32_t)mb->getBufferPos();
+
+        vb.writeBytes((const char *)srcVB.getBuffer(), srcVB.length());
+
+        auto indexCount = srcIB.length() / sizeof(unsigned short);
+        auto srcIndices = (const unsigned short *)srcIB.getBuffer();
+        auto dstIndices = (unsigned short *)ib.getCurBuffer();
+        for (std::size_t i = 0; i < indexCount; i++) {
+            dstIndices[i] = (unsigned short)(srcIndices[i] + vertexOffset);
+        }
+        ib.move((int)srcIB.length());
+
+        // render info format |0xffffffff|material len|material 0|...|
+        // material format |texture index|blend src|blend dst|buffer index|index offset|index count|
+        auto header = (uint32_t *)srcRenderInfo.getBuffer();
+        auto materialLen = std::min<std::size_t>(header[1], (srcRenderInfo.length() / sizeof(uint32_t) - 2) / 6);
+        for (std::size_t i = 0; i < materialLen; i++) {
+            uint32_t *material = header + 2 + i * 6;
+            material[3] = bufferIndex;
+            material[4] += indexOffset;
+        }
+    }
+
+    auto renderInfoOffset = (uint32_t)(renderInfo->getCurPos() / sizeof(uint32_t));
+    renderInfo->checkSpace(srcRenderInfo.length(), true);
+    renderInfo->writeBytes((const char *)srcRenderInfo.getBuffer(), srcRenderInfo.length());
+
+    auto &srcAttachInfo = segment->attachInfo;
+    auto attachInfoOffset = (uint32_t)(attachInfo->getCurPos() / sizeof(uint32_t));
+    if (srcAttachInfo.length() > 0) {
+        attachInfo->checkSpace(srcAttachInfo.length(), true);
+        attachInfo->writeBytes((const char *)srcAttachInfo.getBuffer(), srcAttachInfo.length());
+    }
+
+    editor->relocateRenderData(renderInfoOffset, attachInfoOffset);
+}
+
 void MiddlewareManager::addTimer(IMiddleware *editor) {
     auto it0 = std::find(_updateList.begin(), _updateList.end(), editor);
     if (it0 != _updateList.end()) {
@@ -42,6 +42,43 @@ public:
     virtual void update(float dt) = 0;
     virtual void render(float dt) = 0;
     virtual uint32_t getRenderOrder() const = 0;
+
+    /**
+     * Whether update may run on a worker thread this frame.
+     * Must not touch state shared with other middleware or call into script.
+     */
+    virtual bool canUpdateInParallel() const { return false; }
+    /**
+     * Whether render may run on a worker thread this frame.
+     * Middleware returning true must also implement relocateRenderData.
+     */
+    virtual bool canRenderInParallel() const { return false; }
+    /**
+     * Render data written in parallel has been merged into the shared buffers,
+     * offsets are in uint32 units like the ones written by render.
+     */
+    virtual void relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) {}
+};
+
+/**
+ * Render output of one middleware while manager renders in parallel,
+ * merged into the shared buffers afterwards in render order.
+ */
+class RenderSegment {
+public:
+    RenderSegment();
+    ~RenderSegment();
+
+    MeshBuffer *getMeshBuffer(int format);
+    void reset();
+
+    IOBuffer renderInfo;
+    IOBuffer attachInfo;
+    MeshBuffer *meshBuffer = nullptr;
+    // -1 if no mesh buffer is requested during render.
+    int format = -1;
+    // Set if more than one vertex format is requested, such output can not be merged.
+    bool isMixed = false;
 };
 
 /**
@@ -94,7 +131,17 @@ public:
      */
     void removeTimer(IMiddleware *editor);
 
+    /**
+     * @brief Enable parallel update and render, middleware which does not
+     * support it is still updated and rendered on the calling thread.
+     */
+    void setParallel(bool value);
+    bool isParallel() const { return _isParallel; }
+
     MeshBuffer *getMeshBuffer(int format);
+    // Buffers render should write into, they are per middleware while rendering in parallel.
+    IOBuffer *getRenderInfoBuffer();
+    IOBuffer *getAttachInfoBuffer();
 
     se_object_ptr getVBTypedArray(int format, int bufferPos);
     se_object_ptr getIBTypedArray(int format, int bufferPos);
@@ -114,6 +161,10 @@ public:
 
 private:
     void _clearRemoveList();
+    void _parallelFor(std::size_t count, const std::function<void(std::size_t)> &task);
+    void _updateParallel(float dt);
+    void _renderParallel(float dt);
+    void _mergeSegment(IMiddleware *editor, RenderSegment *segment, float dt);
 
 private:
     std::vector<IMiddleware *> _updateList;
@@ -123,6 +174,12 @@ private:
     SharedBufferManager _renderInfo;
     SharedBufferManager _attachInfo;
 
+    bool _isParallel = false;
+    // Indexed like _updateList, 1 if the middleware is handled by workers this frame.
+    std::vector<uint8_t> _parallelFlags;
+    std::vector<std::size_t> _parallelIndices;
+    std::vector<RenderSegment *> _segments;
+
     static MiddlewareManager *_instance;
 };
 MIDDLEWARE_END
@@ -0,0 +1,186 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "VertexKernel.h"
+
+// math/Vec4.h and math/Mat4.h #undef __SSE__, so test the target architecture instead
+#if defined(__x86_64__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define CC_VERTEX_KERNEL_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define CC_VERTEX_KERNEL_NEON
+#endif
+
+MIDDLEWARE_BEGIN
+
+namespace {
+// float offset of fields in vertex
+const int UV_OFFSET = 3;
+const int COLOR_OFFSET = 5;
+const int COLOR2_OFFSET = 9;
+} // namespace
+
+void fillVertexColors(float *verts, int count, int stride, const Color4F &light, const Color4F *dark) {
+#if defined(CC_VERTEX_KERNEL_SSE)
+    const __m128 lightV = _mm_setr_ps(light.r, light.g, light.b, light.a);
+    if (dark) {
+        const __m128 darkV = _mm_setr_ps(dark->r, dark->g, dark->b, dark->a);
+        for (int i = 0; i < count; ++i, verts += stride) {
+            _mm_storeu_ps(verts + COLOR_OFFSET, lightV);
+            _mm_storeu_ps(verts + COLOR2_OFFSET, darkV);
+        }
+    } else {
+        for (int i = 0; i < count; ++i, verts += stride) {
+            _mm_storeu_ps(verts + COLOR_OFFSET, lightV);
+        }
+    }
+#elif defined(CC_VERTEX_KERNEL_NEON)
+    const float lightF[4] = {light.r, light.g, light.b, light.a};
+    const float32x4_t lightV = vld1q_f32(lightF);
+    if (dark) {
+        const float darkF[4] = {dark->r, dark->g, dark->b, dark->a};
+        const float32x4_t darkV = vld1q_f32(darkF);
+        for (int i = 0; i < count; ++i, verts += stride) {
+            vst1q_f32(verts + COLOR_OFFSET, lightV);
+            vst1q_f32(verts + COLOR2_OFFSET, darkV);
+        }
+    } else {
+        for (int i = 0; i < count; ++i, verts += stride) {
+            vst1q_f32(verts + COLOR_OFFSET, lightV);
+        }
+    }
+#else
+    for (int i = 0; i < count; ++i, verts += stride) {
+        verts[COLOR_OFFSET] = light.r;
+        verts[COLOR_OFFSET + 1] = light.g;
+        verts[COLOR_OFFSET + 2] = light.b;
+        verts[COLOR_OFFSET + 3] = light.a;
+        if (dark) {
+            verts[COLOR2_OFFSET] = dark->r;
+            verts[COLOR2_OFFSET + 1] = dark->g;
+            verts[COLOR2_OFFSET + 2] = dark->b;
+            verts[COLOR2_OFFSET + 3] = dark->a;
+        }
+    }
+#endif
+}
+
+void copyVertexTexCoords(float *dst, int dstStride, const float *src, int srcStride, int count) {
+    dst += UV_OFFSET;
+    src += UV_OFFSET;
+#if defined(CC_VERTEX_KERNEL_SSE)
+    for (int i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+        _mm_storel_pi((__m64 *)dst, _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)src));
+    }
+#elif defined(CC_VERTEX_KERNEL_NEON)
+    for (int i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+        vst1_f32(dst, vld1_f32(src));
+    }
+#else
+    for (int i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+    }
+#endif
+}
+
+void copyClippedVertices(float *dst, int stride, const float *positions, const float *uvs, int count) {
+    int i = 0;
+#if defined(CC_VERTEX_KERNEL_SSE)
+    // two vertices per iteration
+    for (; i + 2 <= count; i += 2, positions += 4, uvs += 4) {
+        const __m128 pos = _mm_loadu_ps(positions);
+        const __m128 uv = _mm_loadu_ps(uvs);
+        _mm_storel_pi((__m64 *)dst, pos);
+        _mm_storel_pi((__m64 *)(dst + UV_OFFSET), uv);
+        dst += stride;
+        _mm_storeh_pi((__m64 *)dst, pos);
+        _mm_storeh_pi((__m64 *)(dst + UV_OFFSET), uv);
+        dst += stride;
+    }
+#elif defined(CC_VERTEX_KERNEL_NEON)
+    for (; i + 2 <= count; i += 2, positions += 4, uvs += 4) {
+        const float32x4_t pos = vld1q_f32(positions);
+        const float32x4_t uv = vld1q_f32(uvs);
+        vst1_f32(dst, vget_low_f32(pos));
+        vst1_f32(dst + UV_OFFSET, vget_low_f32(uv));
+        dst += stride;
+        vst1_f32(dst, vget_high_f32(pos));
+        vst1_f32(dst + UV_OFFSET, vget_high_f32(uv));
+        dst += stride;
+    }
+#endif
+    for (; i < count; ++i, positions += 2, uvs += 2, dst += stride) {
+        dst[0] = positions[0];
+        dst[1] = positions[1];
+        dst[UV_OFFSET] = uvs[0];
+        dst[UV_OFFSET + 1] = uvs[1];
+    }
+}
+
+void transformVertices(float *verts, int count, int stride, const cc::Mat4 &mat) {
+    const float *m = mat.m;
+    int i = 0;
+#if defined(CC_VERTEX_KERNEL_SSE)
+    const __m128 col0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 col1 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128 col3 = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    // two vertices per iteration, |x0|y0|x1|y1|
+    for (; i + 2 <= count; i += 2) {
+        float *v0 = verts;
+        float *v1 = verts + stride;
+        __m128 pos = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)v0);
+        pos = _mm_loadh_pi(pos, (const __m64 *)v1);
+        const __m128 xs = _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 ys = _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, col0), _mm_mul_ps(ys, col1)), col3);
+        _mm_storel_pi((__m64 *)v0, result);
+        _mm_storeh_pi((__m64 *)v1, result);
+        v0[2] = 0;
+        v1[2] = 0;
+        verts += stride * 2;
+    }
+#elif defined(CC_VERTEX_KERNEL_NEON)
+    const float32x2_t col0 = {m[0], m[1]};
+    const float32x2_t col1 = {m[4], m[5]};
+    const float32x2_t col3 = {m[12], m[13]};
+    for (; i < count; ++i, verts += stride) {
+        const float32x2_t pos = vld1_f32(verts);
+        float32x2_t result = vmla_lane_f32(col3, col0, pos, 0);
+        result = vmla_lane_f32(result, col1, pos, 1);
+        vst1_f32(verts, result);
+        verts[2] = 0;
+    }
+#endif
+    for (; i < count; ++i, verts += stride) {
+        const float x = verts[0];
+        const float y = verts[1];
+        verts[0] = x * m[0] + y * m[4] + m[12];
+        verts[1] = x * m[1] + y * m[5] + m[13];
+        verts[2] = 0;
+    }
+}
+
+MIDDLEWARE_END
@@ -0,0 +1,49 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "MiddlewareMacro.h"
+#include "math/Mat4.h"
+#include "middleware-adapter.h"
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Batch kernels for interleaved vertex buffers written by middleware render.
+ * Vertices are laid out as |x|y|z|u|v|color|(color2)|, stride is in floats.
+ */
+
+// Write light color into every vertex, and dark color too if dark is not null.
+void fillVertexColors(float *verts, int count, int stride, const Color4F &light, const Color4F *dark = nullptr);
+
+// Copy texture coords between two vertex buffers with different stride.
+void copyVertexTexCoords(float *dst, int dstStride, const float *src, int srcStride, int count);
+
+// Interleave clipped positions and uvs, both packed as |x|y|x|y|..., into vertex buffer.
+void copyClippedVertices(float *dst, int stride, const float *positions, const float *uvs, int count);
+
+// Transform vertex position by 2D affine part of node world matrix and force z to zero.
+void transformVertices(float *verts, int count, int stride, const cc::Mat4 &mat);
+
+MIDDLEWARE_END
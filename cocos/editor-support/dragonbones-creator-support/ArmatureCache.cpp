@@ -22,8 +22,10 @@
  */
 
 #include "ArmatureCache.h"
+#include "ArmatureCacheMgr.h"
 #include "CCFactory.h"
 #include "base/TypeDef.h"
+#include "platform/Application.h"
 
 USING_NS_MW;
 
@@ -31,16 +33,44 @@ using namespace cc;
 
 DRAGONBONES_NAMESPACE_BEGIN
 
+namespace {
+uint64_t hashIndices(const unsigned short *indices, std::size_t count) {
+    // FNV-1a
+    const uint8_t *bytes = (const uint8_t *)indices;
+    uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0, n = count * sizeof(unsigned short); i < n; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+} // namespace
+
 float ArmatureCache::FrameTime = 1.0f / 60.0f;
 float ArmatureCache::MaxCacheTime = 120.0f;
 
 ArmatureCache::SegmentData::SegmentData() {
 }
 
+ArmatureCache::SegmentData::SegmentData(const SegmentData &other)
+: blendMode(other.blendMode),
+  indexCount(other.indexCount),
+  vertexCount(other.vertexCount) {
+    setTexture(other._texture);
+}
+
 ArmatureCache::SegmentData::~SegmentData() {
     CC_SAFE_RELEASE_NULL(_texture);
 }
 
+ArmatureCache::SegmentData &ArmatureCache::SegmentData::operator=(const SegmentData &other) {
+    blendMode = other.blendMode;
+    indexCount = other.indexCount;
+    vertexCount = other.vertexCount;
+    setTexture(other._texture);
+    return *this;
+}
+
 void ArmatureCache::SegmentData::setTexture(cc::middleware::Texture2D *value) {
     CC_SAFE_RETAIN(value);
     CC_SAFE_RELEASE(_texture);
@@ -51,63 +81,33 @@ cc::middleware::Texture2D *ArmatureCache::SegmentData::getTexture() const {
     return _texture;
 }
 
-ArmatureCache::FrameData::FrameData() {
-}
-
-ArmatureCache::FrameData::~FrameData() {
-    for (std::size_t i = 0, c = _bones.size(); i < c; i++) {
-        delete _bones[i];
-    }
-    _bones.clear();
-
-    for (std::size_t i = 0, c = _colors.size(); i < c; i++) {
-        delete _colors[i];
-    }
-    _colors.clear();
-
-    for (std::size_t i = 0, c = _segments.size(); i < c; i++) {
-        delete _segments[i];
-    }
-    _segments.clear();
-}
-
-ArmatureCache::BoneData *ArmatureCache::FrameData::buildBoneData(std::size_t index) {
-    if (index > _bones.size()) return nullptr;
-    if (index == _bones.size()) {
-        BoneData *boneData = new BoneData;
-        _bones.push_back(boneData);
-    }
-    return _bones[index];
+void ArmatureCache::BoneData::toMat4(cc::Mat4 &out) const {
+    out.m[0] = matrix[0];
+    out.m[1] = matrix[1];
+    out.m[4] = matrix[2];
+    out.m[5] = matrix[3];
+    out.m[12] = matrix[4];
+    out.m[13] = matrix[5];
 }
 
-std::size_t ArmatureCache::FrameData::getBoneCount() const {
-    return _bones.size();
+const ArmatureCache::BoneData *ArmatureCache::FrameData::getBones() const {
+    return _animation->_bones.data() + _boneOffset;
 }
 
-ArmatureCache::ColorData *ArmatureCache::FrameData::buildColorData(std::size_t index) {
-    if (index > _colors.size()) return nullptr;
-    if (index == _colors.size()) {
-        ColorData *colorData = new ColorData;
-        _colors.push_back(colorData);
-    }
-    return _colors[index];
+const ArmatureCache::ColorData *ArmatureCache::FrameData::getColors() const {
+    return _animation->_colors.data() + _colorOffset;
 }
 
-std::size_t ArmatureCache::FrameData::getColorCount() const {
-    return _colors.size();
+const ArmatureCache::SegmentData *ArmatureCache::FrameData::getSegments() const {
+    return _animation->_segments.data() + _segmentOffset;
 }
 
-ArmatureCache::SegmentData *ArmatureCache::FrameData::buildSegmentData(std::size_t index) {
-    if (index > _segments.size()) return nullptr;
-    if (index == _segments.size()) {
-        SegmentData *segmentData = new SegmentData;
-        _segments.push_back(segmentData);
-    }
-    return _segments[index];
+const float *ArmatureCache::FrameData::getVertices() const {
+    return _animation->_vertices.data() + _vertexOffset * VERTEX_FLOATS;
 }
 
-std::size_t ArmatureCache::FrameData::getSegmentCount() const {
-    return _segments.size();
+const unsigned short *ArmatureCache::FrameData::getIndices() const {
+    return _animation->_indices.data() + _indexOffset;
 }
 
 ArmatureCache::AnimationData::AnimationData() {
@@ -118,34 +118,86 @@ ArmatureCache::AnimationData::~AnimationData() {
 }
 
 void ArmatureCache::AnimationData::reset() {
-    for (std::size_t i = 0, c = _frames.size(); i < c; i++) {
-        delete _frames[i];
-    }
     _frames.clear();
+    _bones.clear();
+    _colors.clear();
+    _segments.clear();
+    _vertices.clear();
+    _indices.clear();
+    shrink();
     _isComplete = false;
     _totalTime = 0.0f;
 }
 
+void ArmatureCache::AnimationData::shrink() {
+    _frames.shrink_to_fit();
+    _bones.shrink_to_fit();
+    _colors.shrink_to_fit();
+    _segments.shrink_to_fit();
+    _vertices.shrink_to_fit();
+    _indices.shrink_to_fit();
+    // no more frames are appended
+    std::unordered_multimap<uint64_t, uint32_t>().swap(_indexRanges);
+}
+
 bool ArmatureCache::AnimationData::needUpdate(int toFrameIdx) const {
     return !_isComplete && _totalTime <= MaxCacheTime && (toFrameIdx == -1 || _frames.size() < toFrameIdx + 1);
 }
 
+void ArmatureCache::AnimationData::touch() {
+    auto app = cc::Application::getInstance();
+    _lastUsedFrame = app ? app->getTotalFrames() : 0;
+}
+
+std::size_t ArmatureCache::AnimationData::getMemorySize() const {
+    return _frames.capacity() * sizeof(FrameData) +
+           _bones.capacity() * sizeof(BoneData) +
+           _colors.capacity() * sizeof(ColorData) +
+           _segments.capacity() * sizeof(SegmentData) +
+           _vertices.capacity() * sizeof(float) +
+           _indices.capacity() * sizeof(unsigned short);
+}
+
 ArmatureCache::FrameData *ArmatureCache::AnimationData::buildFrameData(std::size_t frameIdx) {
     if (frameIdx > _frames.size()) {
         return nullptr;
     }
     if (frameIdx == _frames.size()) {
-        auto frameData = new FrameData();
+        FrameData frameData;
+        frameData._animation = this;
+        frameData._boneOffset = (uint32_t)_bones.size();
+        frameData._colorOffset = (uint32_t)_colors.size();
+        frameData._segmentOffset = (uint32_t)_segments.size();
+        frameData._vertexOffset = (uint32_t)(_vertices.size() / VERTEX_FLOATS);
+        frameData._indexOffset = (uint32_t)_indices.size();
         _frames.push_back(frameData);
     }
-    return _frames[frameIdx];
+    return &_frames[frameIdx];
 }
 
-ArmatureCache::FrameData *ArmatureCache::AnimationData::getFrameData(std::size_t frameIdx) const {
+void ArmatureCache::AnimationData::appendIndices(FrameData *frameData, const unsigned short *indices, std::size_t count) {
+    frameData->_indexCount = (uint32_t)count;
+    // Triangles only change with draw order or displays, most frames of a loop repeat an earlier one.
+    uint64_t hash = hashIndices(indices, count);
+    auto range = _indexRanges.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const FrameData &other = _frames[it->second];
+        if (other._indexCount == count &&
+            memcmp(_indices.data() + other._indexOffset, indices, count * sizeof(unsigned short)) == 0) {
+            frameData->_indexOffset = other._indexOffset;
+            return;
+        }
+    }
+    frameData->_indexOffset = (uint32_t)_indices.size();
+    _indices.insert(_indices.end(), indices, indices + count);
+    _indexRanges.emplace(hash, (uint32_t)(frameData - _frames.data()));
+}
+
+const ArmatureCache::FrameData *ArmatureCache::AnimationData::getFrameData(std::size_t frameIdx) const {
     if (frameIdx >= _frames.size()) {
         return nullptr;
     }
-    return _frames[frameIdx];
+    return &_frames[frameIdx];
 }
 
 std::size_t ArmatureCache::AnimationData::getFrameCount() const {
@@ -165,7 +217,9 @@ ArmatureCache::~ArmatureCache() {
         _armatureDisplay = nullptr;
     }
 
+    auto mgr = ArmatureCacheMgr::getInstance();
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
+        mgr->removeAnimationData(it->second);
         delete it->second;
     }
     _animationCaches.clear();
@@ -185,6 +239,7 @@ ArmatureCache::AnimationData *ArmatureCache::buildAnimationData(const std::strin
         aniData = new AnimationData();
         aniData->_animationName = animationName;
         _animationCaches[animationName] = aniData;
+        ArmatureCacheMgr::getInstance()->addAnimationData(aniData);
     } else {
         aniData = it->second;
     }
@@ -210,9 +265,14 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
     if (!animationData || !animationData->needUpdate(toFrameIdx)) {
         return;
     }
+    animationData->touch();
 
     if (_curAnimationName != animationName) {
-        updateToFrame(_curAnimationName);
+        // finish baking previous animation, unless it has been evicted
+        auto preAnimationData = getAnimationData(_curAnimationName);
+        if (preAnimationData && preAnimationData->getFrameCount() > 0) {
+            updateToFrame(_curAnimationName);
+        }
         _curAnimationName = animationName;
     }
 
@@ -232,11 +292,18 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
             animationData->_isComplete = true;
         }
     } while (animationData->needUpdate(toFrameIdx));
+
+    if (!animationData->needUpdate(-1)) {
+        animationData->shrink();
+    }
+    ArmatureCacheMgr::getInstance()->checkMemoryBudget();
 }
 
 void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
     std::size_t frameIndex = animationData->getFrameCount();
+    _animationData = animationData;
     _frameData = animationData->buildFrameData(frameIndex);
+    _bakeIB.reset();
 
     _preColor = Color4F(-1.0f, -1.0f, -1.0f, -1.0f);
     _color = Color4F(1.0f, 1.0f, 1.0f, 1.0f);
@@ -253,23 +320,26 @@ void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
     traverseArmature(armature);
 
     if (_preISegWritePos != -1) {
-        SegmentData *preSegmentData = _frameData->buildSegmentData(_materialLen - 1);
-        preSegmentData->indexCount = _curISegLen;
-        preSegmentData->vertexFloatCount = _curVSegLen;
+        SegmentData &preSegmentData = animationData->_segments.back();
+        preSegmentData.indexCount = _curISegLen;
+        preSegmentData.vertexCount = _curVSegLen;
     }
 
-    auto colorCount = _frameData->getColorCount();
-    if (colorCount > 0) {
-        ColorData *preColorData = _frameData->buildColorData(colorCount - 1);
-        preColorData->vertexFloatOffset = (int)_frameData->vb.getCurPos() / sizeof(float);
+    if (_frameData->_colorCount > 0) {
+        animationData->_colors.back().vertexOffset = (int)_frameData->_vertexCount;
     }
 
+    animationData->appendIndices(_frameData, (const unsigned short *)_bakeIB.getBuffer(), _bakeIB.getCurPos() / sizeof(unsigned short));
+
     _frameData = nullptr;
+    _animationData = nullptr;
 }
 
 void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*= 1.0f*/) {
-    middleware::IOBuffer &vb = _frameData->vb;
-    middleware::IOBuffer &ib = _frameData->ib;
+    middleware::IOBuffer &ib = _bakeIB;
+    auto &vertices = _animationData->_vertices;
+    auto &segments = _animationData->_segments;
+    auto &colors = _animationData->_colors;
 
     auto &bones = armature->getBones();
     Bone *bone = nullptr;
@@ -283,14 +353,16 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
     auto flush = [&]() {
         // fill pre segment count field
         if (_preISegWritePos != -1) {
-            SegmentData *preSegmentData = _frameData->buildSegmentData(_materialLen - 1);
-            preSegmentData->indexCount = _curISegLen;
-            preSegmentData->vertexFloatCount = _curVSegLen;
+            SegmentData &preSegmentData = segments.back();
+            preSegmentData.indexCount = _curISegLen;
+            preSegmentData.vertexCount = _curVSegLen;
         }
 
-        SegmentData *segmentData = _frameData->buildSegmentData(_materialLen);
-        segmentData->setTexture(texture);
-        segmentData->blendMode = (int)(slot->_blendMode);
+        segments.emplace_back();
+        SegmentData &segmentData = segments.back();
+        segmentData.setTexture(texture);
+        segmentData.blendMode = (int)(slot->_blendMode);
+        _frameData->_segmentCount++;
 
         // save new segment count pos field
         _preISegWritePos = (int)ib.getCurPos() / sizeof(unsigned short);
@@ -308,16 +380,16 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
 
     for (std::size_t i = 0, len = bones.size(); i < len; i++) {
         bone = bones[i];
-        auto boneCount = _frameData->getBoneCount();
-        BoneData *boneData = _frameData->buildBoneData(boneCount);
         auto &boneOriginMat = bone->globalTransformMatrix;
-        auto &matm = boneData->globalTransformMatrix.m;
-        matm[0] = boneOriginMat.a;
-        matm[1] = boneOriginMat.b;
-        matm[4] = -boneOriginMat.c;
-        matm[5] = -boneOriginMat.d;
-        matm[12] = boneOriginMat.tx;
-        matm[13] = boneOriginMat.ty;
+        BoneData boneData;
+        boneData.matrix[0] = boneOriginMat.a;
+        boneData.matrix[1] = boneOriginMat.b;
+        boneData.matrix[2] = -boneOriginMat.c;
+        boneData.matrix[3] = -boneOriginMat.d;
+        boneData.matrix[4] = boneOriginMat.tx;
+        boneData.matrix[5] = boneOriginMat.ty;
+        _animationData->_bones.push_back(boneData);
+        _frameData->_boneCount++;
     }
 
     for (std::size_t i = 0, len = slots.size(); i < len; i++) {
@@ -341,9 +413,6 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
         if (!texture) continue;
         _curTextureIndex = texture->getRealTextureIndex();
 
-        auto vbSize = slot->triangles.vertCount * sizeof(middleware::V2F_T2F_C4F);
-        vb.checkSpace(vbSize, true);
-
         // If texture or blendMode change,will change material.
         if (_preTextureIndex != _curTextureIndex || _preBlendMode != (int)slot->_blendMode) {
             flush();
@@ -357,43 +426,35 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
 
         if (preColor != color) {
             preColor = color;
-            auto colorCount = _frameData->getColorCount();
-            if (colorCount > 0) {
-                ColorData *preColorData = _frameData->buildColorData(colorCount - 1);
-                preColorData->vertexFloatOffset = vb.getCurPos() / sizeof(float);
+            if (_frameData->_colorCount > 0) {
+                colors.back().vertexOffset = (int)_frameData->_vertexCount;
             }
-            ColorData *colorData = _frameData->buildColorData(colorCount);
-            colorData->color = color;
+            ColorData colorData;
+            colorData.color = color;
+            colors.push_back(colorData);
+            _frameData->_colorCount++;
         }
 
-        // Transform component matrix to global matrix
+        // Transform component matrix to global matrix, only position and uv are baked
         middleware::Triangles &triangles = slot->triangles;
-        middleware::V2F_T2F_C4F *worldTriangles = slot->worldVerts;
-
-        for (int v = 0, w = 0, vn = triangles.vertCount; v < vn; ++v, w += 2) {
+        for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
             middleware::V2F_T2F_C4F *vertex = triangles.verts + v;
-            middleware::V2F_T2F_C4F *worldVertex = worldTriangles + v;
-            worldVertex->vertex.x = vertex->vertex.x * worldMatrix->m[0] + vertex->vertex.y * worldMatrix->m[4] + worldMatrix->m[12];
-            worldVertex->vertex.y = vertex->vertex.x * worldMatrix->m[1] + vertex->vertex.y * worldMatrix->m[5] + worldMatrix->m[13];
-
-            worldVertex->color.r = color.r;
-            worldVertex->color.g = color.g;
-            worldVertex->color.b = color.b;
-            worldVertex->color.a = color.a;
+            vertices.push_back(vertex->vertex.x * worldMatrix->m[0] + vertex->vertex.y * worldMatrix->m[4] + worldMatrix->m[12]);
+            vertices.push_back(vertex->vertex.x * worldMatrix->m[1] + vertex->vertex.y * worldMatrix->m[5] + worldMatrix->m[13]);
+            vertices.push_back(vertex->texCoord.u);
+            vertices.push_back(vertex->texCoord.v);
         }
 
-        vb.writeBytes((char *)worldTriangles, vbSize);
-
         auto ibSize = triangles.indexCount * sizeof(unsigned short);
         ib.checkSpace(ibSize, true);
 
-        auto vertexOffset = _curVSegLen / VF_XYZUVC;
         for (int ii = 0, nn = triangles.indexCount; ii < nn; ii++) {
-            ib.writeUint16(triangles.indices[ii] + vertexOffset);
+            ib.writeUint16(triangles.indices[ii] + _curVSegLen);
         }
 
         _curISegLen += triangles.indexCount;
-        _curVSegLen += vbSize / sizeof(float);
+        _curVSegLen += triangles.vertCount;
+        _frameData->_vertexCount += triangles.vertCount;
     } // End slot traverse
 }
 
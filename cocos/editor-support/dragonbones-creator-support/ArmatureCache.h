@@ -26,98 +26,128 @@
 #include "CCArmatureDisplay.h"
 #include "IOBuffer.h"
 #include "base/Ref.h"
+#include <unordered_map>
+#include <vector>
 
 DRAGONBONES_NAMESPACE_BEGIN
 
 class ArmatureCache : public cc::Ref {
 public:
+    // Baked vertex format |x|y|u|v|, z and colors are filled when rendering.
+    static const int VERTEX_FLOATS = 4;
+
     struct SegmentData {
         friend class ArmatureCache;
 
         SegmentData();
+        SegmentData(const SegmentData &other);
         ~SegmentData();
+        SegmentData &operator=(const SegmentData &other);
 
         void setTexture(cc::middleware::Texture2D *value);
         cc::middleware::Texture2D *getTexture() const;
 
     public:
         int blendMode = 0;
-        std::size_t indexCount = 0;
-        std::size_t vertexFloatCount = 0;
+        int indexCount = 0;
+        int vertexCount = 0;
 
     private:
         cc::middleware::Texture2D *_texture = nullptr;
     };
 
+    // Affine part of bone global transform, the rest of matrix is identity.
     struct BoneData {
-        cc::Mat4 globalTransformMatrix;
+        // m[0], m[1], m[4], m[5], m[12], m[13] of global matrix
+        float matrix[6];
+
+        void toMat4(cc::Mat4 &out) const;
     };
 
     struct ColorData {
         cc::middleware::Color4F color;
-        std::size_t vertexFloatOffset = 0;
+        // vertex index where this color ends
+        int vertexOffset = 0;
     };
 
+    struct AnimationData;
+
+    /**
+     * A frame only stores ranges in arenas of its animation,
+     * returned pointers are valid until the animation bakes more frames.
+     */
     struct FrameData {
         friend class ArmatureCache;
 
-        FrameData();
-        ~FrameData();
-
-        const std::vector<BoneData *> &getBones() const {
-            return _bones;
-        }
-        std::size_t getBoneCount() const;
+        const BoneData *getBones() const;
+        std::size_t getBoneCount() const { return _boneCount; }
 
-        const std::vector<ColorData *> &getColors() const {
-            return _colors;
-        }
-        std::size_t getColorCount() const;
+        const ColorData *getColors() const;
+        std::size_t getColorCount() const { return _colorCount; }
 
-        const std::vector<SegmentData *> &getSegments() const {
-            return _segments;
-        }
-        std::size_t getSegmentCount() const;
+        const SegmentData *getSegments() const;
+        std::size_t getSegmentCount() const { return _segmentCount; }
 
-    private:
-        // if segment data is empty, it will build new one.
-        SegmentData *buildSegmentData(std::size_t index);
-        // if color data is empty, it will build new one.
-        ColorData *buildColorData(std::size_t index);
-        // if bone data is empty, it will build new one.
-        BoneData *buildBoneData(std::size_t index);
+        const float *getVertices() const;
+        std::size_t getVertexCount() const { return _vertexCount; }
 
-        std::vector<BoneData *> _bones;
-        std::vector<ColorData *> _colors;
-        std::vector<SegmentData *> _segments;
+        const unsigned short *getIndices() const;
+        std::size_t getIndexCount() const { return _indexCount; }
 
-    public:
-        cc::middleware::IOBuffer ib;
-        cc::middleware::IOBuffer vb;
+    private:
+        const AnimationData *_animation = nullptr;
+        uint32_t _boneOffset = 0;
+        uint32_t _boneCount = 0;
+        uint32_t _colorOffset = 0;
+        uint32_t _colorCount = 0;
+        uint32_t _segmentOffset = 0;
+        uint32_t _segmentCount = 0;
+        uint32_t _vertexOffset = 0;
+        uint32_t _vertexCount = 0;
+        uint32_t _indexOffset = 0;
+        uint32_t _indexCount = 0;
     };
 
     struct AnimationData {
         friend class ArmatureCache;
+        friend struct FrameData;
 
         AnimationData();
         ~AnimationData();
         void reset();
 
-        FrameData *getFrameData(std::size_t frameIdx) const;
+        const FrameData *getFrameData(std::size_t frameIdx) const;
         std::size_t getFrameCount() const;
 
         bool isComplete() const { return _isComplete; }
         bool needUpdate(int toFrameIdx) const;
 
+        // Mark animation as used in current frame, so it will not be evicted by memory budget.
+        void touch();
+        uint32_t getLastUsedFrame() const { return _lastUsedFrame; }
+        std::size_t getMemorySize() const;
+
     private:
-        // if frame is empty, it will build new one.
         FrameData *buildFrameData(std::size_t frameIdx);
+        // Append indices of a frame, share the range of any earlier frame drawing the same triangles.
+        void appendIndices(FrameData *frameData, const unsigned short *indices, std::size_t count);
+        void shrink();
 
     private:
         std::string _animationName = "";
         bool _isComplete = false;
         float _totalTime = 0.0f;
-        std::vector<FrameData *> _frames;
+        uint32_t _lastUsedFrame = 0;
+
+        // Arenas shared by all frames.
+        std::vector<FrameData> _frames;
+        std::vector<BoneData> _bones;
+        std::vector<ColorData> _colors;
+        std::vector<SegmentData> _segments;
+        std::vector<float> _vertices;
+        std::vector<unsigned short> _indices;
+        // hash of index range -> first frame storing it, only kept while baking
+        std::unordered_multimap<uint64_t, uint32_t> _indexRanges;
     };
 
     ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID);
@@ -141,6 +171,7 @@ public:
     static float MaxCacheTime;
 
 private:
+    AnimationData *_animationData = nullptr;
     FrameData *_frameData = nullptr;
     cc::middleware::Color4F _preColor = cc::middleware::Color4F(-1.0f, -1.0f, -1.0f, -1.0f);
     cc::middleware::Color4F _color = cc::middleware::Color4F(1.0f, 1.0f, 1.0f, 1.0f);
@@ -154,6 +185,8 @@ private:
     int _materialLen = 0;
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData *> _animationCaches;
+    // Scratch index buffer of the frame being baked.
+    cc::middleware::IOBuffer _bakeIB;
 };
 
 DRAGONBONES_NAMESPACE_END
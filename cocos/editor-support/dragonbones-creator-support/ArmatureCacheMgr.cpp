@@ -22,10 +22,18 @@
  */
 
 #include "ArmatureCacheMgr.h"
+#include "platform/Application.h"
+#include <algorithm>
 
 DRAGONBONES_NAMESPACE_BEGIN
 
 ArmatureCacheMgr *ArmatureCacheMgr::_instance = nullptr;
+
+ArmatureCacheMgr::~ArmatureCacheMgr() {
+    // caches unregister their animations when released
+    _caches.clear();
+}
+
 ArmatureCache *ArmatureCacheMgr::buildArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID) {
     ArmatureCache *animation = _caches.at(armatureKey);
     if (!animation) {
@@ -47,4 +55,53 @@ void ArmatureCacheMgr::removeArmatureCache(const std::string &uuid) {
     }
 }
 
+void ArmatureCacheMgr::setMemoryBudget(std::size_t bytes) {
+    _memoryBudget = bytes;
+    checkMemoryBudget();
+}
+
+std::size_t ArmatureCacheMgr::getMemoryUsage() const {
+    std::size_t usage = 0;
+    for (auto animationData : _animationDatas) {
+        usage += animationData->getMemorySize();
+    }
+    return usage;
+}
+
+void ArmatureCacheMgr::addAnimationData(ArmatureCache::AnimationData *animationData) {
+    _animationDatas.push_back(animationData);
+}
+
+void ArmatureCacheMgr::removeAnimationData(ArmatureCache::AnimationData *animationData) {
+    auto it = std::find(_animationDatas.begin(), _animationDatas.end(), animationData);
+    if (it != _animationDatas.end()) {
+        _animationDatas.erase(it);
+    }
+}
+
+void ArmatureCacheMgr::checkMemoryBudget() {
+    if (_memoryBudget == 0) return;
+
+    auto usage = getMemoryUsage();
+    if (usage <= _memoryBudget) return;
+
+    // animations used in current frame may be rendering, never evict them
+    auto app = cc::Application::getInstance();
+    uint32_t curFrame = app ? app->getTotalFrames() : 0;
+    while (usage > _memoryBudget) {
+        ArmatureCache::AnimationData *lru = nullptr;
+        for (auto animationData : _animationDatas) {
+            if (animationData->getFrameCount() == 0 || animationData->getLastUsedFrame() == curFrame) continue;
+            if (!lru || animationData->getLastUsedFrame() < lru->getLastUsedFrame()) {
+                lru = animationData;
+            }
+        }
+        if (!lru) break;
+
+        usage -= lru->getMemorySize();
+        lru->reset();
+        usage += lru->getMemorySize();
+    }
+}
+
 DRAGONBONES_NAMESPACE_END
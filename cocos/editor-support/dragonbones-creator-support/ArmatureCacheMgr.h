@@ -45,11 +45,28 @@ public:
         }
     }
 
+    ~ArmatureCacheMgr();
+
     void removeArmatureCache(const std::string &armatureKey);
     ArmatureCache *buildArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID);
 
+    /**
+     * @brief Limit memory of baked frames of all armature caches, 0 means no limit.
+     * When it is exceeded, animations not used in current frame are evicted in
+     * least recently used order, and baked again next time they are played.
+     */
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getMemoryBudget() const { return _memoryBudget; }
+    std::size_t getMemoryUsage() const;
+
+    void addAnimationData(ArmatureCache::AnimationData *animationData);
+    void removeAnimationData(ArmatureCache::AnimationData *animationData);
+    void checkMemoryBudget();
+
 private:
     static ArmatureCacheMgr *_instance;
+    std::size_t _memoryBudget = 0;
+    std::vector<ArmatureCache::AnimationData *> _animationDatas;
     cc::Map<std::string, ArmatureCache *> _caches;
 };
 
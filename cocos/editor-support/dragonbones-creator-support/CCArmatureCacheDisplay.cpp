@@ -97,6 +97,8 @@ void CCArmatureCacheDisplay::dispose() {
 }
 
 void CCArmatureCacheDisplay::update(float dt) {
+    // keep the baked data alive while the animation is displayed
+    if (_animationData) _animationData->touch();
     auto gTimeScale = dragonBones::CCFactory::getFactory()->getTimeScale();
     dt *= _timeScale * gTimeScale;
 
@@ -142,24 +144,24 @@ void CCArmatureCacheDisplay::update(float dt) {
 void CCArmatureCacheDisplay::render(float dt) {
 
     if (!_animationData) return;
-    ArmatureCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
+    const ArmatureCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
     if (!frameData) return;
 
     auto mgr = MiddlewareManager::getInstance();
     if (!mgr->isRendering) return;
 
-    auto &segments = frameData->getSegments();
-    auto &colors = frameData->getColors();
+    auto segments = frameData->getSegments();
+    auto segmentCount = frameData->getSegmentCount();
+    auto colors = frameData->getColors();
+    auto colorCount = frameData->getColorCount();
 
     _sharedBufferOffset->reset();
     _sharedBufferOffset->clear();
 
-    auto renderMgr = mgr->getRenderInfoMgr();
-    auto renderInfo = renderMgr->getBuffer();
+    auto renderInfo = mgr->getRenderInfoBuffer();
     if (!renderInfo) return;
 
-    auto attachMgr = mgr->getAttachInfoMgr();
-    auto attachInfo = attachMgr->getBuffer();
+    auto attachInfo = mgr->getAttachInfoBuffer();
     if (!attachInfo) return;
 
     //  store render info offset
@@ -173,29 +175,35 @@ void CCArmatureCacheDisplay::render(float dt) {
     renderInfo->writeUint32(0xffffffff);
 
     // matieral len
-    renderInfo->writeUint32(segments.size());
+    renderInfo->writeUint32(segmentCount);
 
-    if (segments.size() == 0 || colors.size() == 0) return;
+    if (segmentCount == 0 || colorCount == 0) return;
 
     middleware::MeshBuffer *mb = mgr->getMeshBuffer(VF_XYZUVC);
     middleware::IOBuffer &vb = mb->getVB();
     middleware::IOBuffer &ib = mb->getIB();
-    const auto &srcVB = frameData->vb;
-    const auto &srcIB = frameData->ib;
+    const float *srcVertices = frameData->getVertices();
+    const unsigned short *srcIndices = frameData->getIndices();
+    // vertex size in floats
+    const int vs = VF_XYZUVC;
+    // vertex size in bytes
+    const int vbs = vs * sizeof(float);
+    // baked vertex size in floats
+    const int srcVS = ArmatureCache::VERTEX_FLOATS;
 
     auto paramsBuffer = _paramsBuffer->getBuffer();
     const cc::Mat4 &nodeWorldMat = *(cc::Mat4 *)&paramsBuffer[4];
 
-    int colorOffset = 0;
-    ArmatureCache::ColorData *nowColor = colors[colorOffset++];
-    auto maxVFOffset = nowColor->vertexFloatOffset;
+    std::size_t colorOffset = 0;
+    const ArmatureCache::ColorData *nowColor = &colors[colorOffset++];
+    auto maxVertexOffset = nowColor->vertexOffset;
 
     Color4F color;
 
     float tempR = 0.0f, tempG = 0.0f, tempB = 0.0f, tempA = 0.0f;
     float multiplier = 1.0f;
-    std::size_t srcVertexBytesOffset = 0;
-    std::size_t srcIndexBytesOffset = 0;
+    int srcVertexOffset = 0;
+    int srcIndexOffset = 0;
     std::size_t vertexBytes = 0;
     std::size_t indexBytes = 0;
     int curTextureIndex = 0;
@@ -203,21 +211,11 @@ void CCArmatureCacheDisplay::render(float dt) {
     std::size_t dstVertexOffset = 0;
     std::size_t dstIndexOffset = 0;
     float *dstVertexBuffer = nullptr;
-    unsigned int *dstColorBuffer = nullptr;
     unsigned short *dstIndexBuffer = nullptr;
-    bool needColor = false;
     int curBlendSrc = -1;
     int curBlendDst = -1;
 
-    if (abs(_nodeColor.r - 1.0f) > 0.0001f ||
-        abs(_nodeColor.g - 1.0f) > 0.0001f ||
-        abs(_nodeColor.b - 1.0f) > 0.0001f ||
-        abs(_nodeColor.a - 1.0f) > 0.0001f ||
-        _premultipliedAlpha) {
-        needColor = true;
-    }
-
-    auto handleColor = [&](ArmatureCache::ColorData *colorData) {
+    auto handleColor = [&](const ArmatureCache::ColorData *colorData) {
         tempA = colorData->color.a * _nodeColor.a;
         multiplier = _premultipliedAlpha ? tempA / 255.0f : 1.0f;
         tempR = _nodeColor.r * multiplier;
@@ -232,9 +230,9 @@ void CCArmatureCacheDisplay::render(float dt) {
 
     handleColor(nowColor);
 
-    for (std::size_t segIndex = 0, segLen = segments.size(); segIndex < segLen; segIndex++) {
-        auto segment = segments[segIndex];
-        vertexBytes = segment->vertexFloatCount * sizeof(float);
+    for (std::size_t segIndex = 0; segIndex < segmentCount; segIndex++) {
+        auto segment = &segments[segIndex];
+        vertexBytes = segment->vertexCount * vbs;
 
         // check enough space
         renderInfo->checkSpace(sizeof(uint32_t) * 6, true);
@@ -266,52 +264,48 @@ void CCArmatureCacheDisplay::render(float dt) {
         renderInfo->writeUint32(curBlendSrc);
         renderInfo->writeUint32(curBlendDst);
 
-        // fill vertex buffer
+        // fill vertex buffer, baked vertex only has position and uv
         vb.checkSpace(vertexBytes, true);
-        dstVertexOffset = vb.getCurPos() / sizeof(V2F_T2F_C4F);
+        dstVertexOffset = vb.getCurPos() / vbs;
         dstVertexBuffer = (float *)vb.getCurBuffer();
-        dstColorBuffer = (unsigned int *)vb.getCurBuffer();
-        vb.writeBytes((char *)srcVB.getBuffer() + srcVertexBytesOffset, vertexBytes);
+        for (int v = 0; v < segment->vertexCount; v++, srcVertexOffset++) {
+            if (srcVertexOffset >= maxVertexOffset && colorOffset < colorCount) {
+                nowColor = &colors[colorOffset++];
+                handleColor(nowColor);
+                maxVertexOffset = nowColor->vertexOffset;
+            }
+            const float *src = srcVertices + srcVertexOffset * srcVS;
+            float *dst = dstVertexBuffer + v * vs;
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = 0;
+            dst[3] = src[2];
+            dst[4] = src[3];
+            memcpy(dst + 5, &color, sizeof(color));
+        }
 
         // batch handle
         if (_batch) {
             cc::Vec3 *point = nullptr;
 
-            for (auto posIndex = 0; posIndex < segment->vertexFloatCount; posIndex += VF_XYZUVC) {
+            for (auto posIndex = 0; posIndex < segment->vertexCount * vs; posIndex += vs) {
                 point = (cc::Vec3 *)(dstVertexBuffer + posIndex);
-                // force z value to zero
-                point->z = 0;
                 point->x = point->x * nodeWorldMat.m[0] + point->y * nodeWorldMat.m[4] + nodeWorldMat.m[12]; // x
                 point->y = point->y * nodeWorldMat.m[1] + point->y * nodeWorldMat.m[5] + nodeWorldMat.m[13]; // y
             }
         }
-
-        // handle vertex color
-        if (needColor) {
-            auto frameFloatOffset = srcVertexBytesOffset / sizeof(float);
-            for (auto colorIndex = 0; colorIndex < segment->vertexFloatCount; colorIndex += VF_XYZUVC, frameFloatOffset += VF_XYZUVC) {
-                if (frameFloatOffset >= maxVFOffset) {
-                    nowColor = colors[colorOffset++];
-                    handleColor(nowColor);
-                    maxVFOffset = nowColor->vertexFloatOffset;
-                }
-                memcpy(dstColorBuffer + colorIndex + 5, &color, sizeof(color));
-            }
-        }
-
-        // move src vertex buffer offset
-        srcVertexBytesOffset += vertexBytes;
+        vb.move(vertexBytes);
 
         // fill index buffer
         indexBytes = segment->indexCount * sizeof(unsigned short);
         ib.checkSpace(indexBytes, true);
         dstIndexOffset = (int)ib.getCurPos() / sizeof(unsigned short);
         dstIndexBuffer = (unsigned short *)ib.getCurBuffer();
-        ib.writeBytes((char *)srcIB.getBuffer() + srcIndexBytesOffset, indexBytes);
         for (auto indexPos = 0; indexPos < segment->indexCount; indexPos++) {
-            dstIndexBuffer[indexPos] += dstVertexOffset;
+            dstIndexBuffer[indexPos] = srcIndices[srcIndexOffset + indexPos] + dstVertexOffset;
         }
-        srcIndexBytesOffset += indexBytes;
+        ib.move(indexBytes);
+        srcIndexOffset += segment->indexCount;
 
         // fill new index and vertex buffer id
         auto bufferIndex = mb->getBufferPos();
@@ -324,13 +318,14 @@ void CCArmatureCacheDisplay::render(float dt) {
     }
 
     if (_useAttach) {
-        auto &bonesData = frameData->getBones();
+        auto bonesData = frameData->getBones();
         auto boneCount = frameData->getBoneCount();
+        cc::Mat4 boneMat = cc::Mat4::IDENTITY;
 
-        for (int i = 0, n = boneCount; i < n; i++) {
-            auto bone = bonesData[i];
+        for (std::size_t i = 0; i < boneCount; i++) {
+            bonesData[i].toMat4(boneMat);
             attachInfo->checkSpace(sizeof(cc::Mat4), true);
-            attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
+            attachInfo->writeBytes((const char *)&boneMat, sizeof(cc::Mat4));
         }
     }
 }
@@ -397,6 +392,11 @@ void CCArmatureCacheDisplay::dispatchDBEvent(const std::string &type, EventObjec
     }
 }
 
+void CCArmatureCacheDisplay::relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) {
+    _sharedBufferOffset->writeUint32(0, renderInfoOffset);
+    _sharedBufferOffset->writeUint32(sizeof(uint32_t), attachInfoOffset);
+}
+
 void CCArmatureCacheDisplay::updateAnimationCache(const std::string &animationName) {
     _armatureCache->resetAnimationData(animationName);
 }
@@ -39,6 +39,8 @@ public:
     virtual void update(float dt) override;
     virtual void render(float dt) override;
     virtual uint32_t getRenderOrder() const override;
+    virtual bool canRenderInParallel() const override { return true; }
+    virtual void relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) override;
 
     void setTimeScale(float scale) {
         _timeScale = scale;
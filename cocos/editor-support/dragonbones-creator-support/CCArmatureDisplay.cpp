@@ -108,12 +108,10 @@ void CCArmatureDisplay::dbRender() {
     auto mgr = MiddlewareManager::getInstance();
     if (!mgr->isRendering) return;
 
-    auto renderMgr = mgr->getRenderInfoMgr();
-    auto renderInfo = renderMgr->getBuffer();
+    auto renderInfo = mgr->getRenderInfoBuffer();
     if (!renderInfo) return;
 
-    auto attachMgr = mgr->getAttachInfoMgr();
-    auto attachInfo = attachMgr->getBuffer();
+    auto attachInfo = mgr->getAttachInfoBuffer();
     if (!attachInfo) return;
 
     //  store render info offset
@@ -248,12 +246,10 @@ void CCArmatureDisplay::traverseArmature(Armature *armature, float parentOpacity
     IOBuffer &ib = mb->getIB();
 
     float realOpacity = _nodeColor.a;
-    auto renderMgr = mgr->getRenderInfoMgr();
-    auto renderInfo = renderMgr->getBuffer();
+    auto renderInfo = mgr->getRenderInfoBuffer();
     if (!renderInfo) return;
 
-    auto attachMgr = mgr->getAttachInfoMgr();
-    auto attachInfo = attachMgr->getBuffer();
+    auto attachInfo = mgr->getAttachInfoBuffer();
     if (!attachInfo) return;
 
     // range [0.0, 255.0]
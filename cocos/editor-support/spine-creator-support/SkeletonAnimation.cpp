@@ -142,6 +142,23 @@ void SkeletonAnimation::update(float deltaTime) {
     }
 }
 
+bool SkeletonAnimation::canUpdateInParallel() const {
+    // Listeners call into script, skeleton not owned may be posed by others.
+    if (!_skeleton || !_ownsSkeleton) return false;
+    if (_startListener || _interruptListener || _endListener || _disposeListener || _completeListener || _eventListener) return false;
+
+    auto &tracks = _state->getTracks();
+    for (size_t i = 0; i < tracks.size(); i++) {
+        for (TrackEntry *entry = tracks[i]; entry; entry = entry->getNext()) {
+            if (entry->getRendererObject()) return false;
+        }
+        for (TrackEntry *entry = tracks[i]; entry; entry = entry->getMixingFrom()) {
+            if (entry->getRendererObject()) return false;
+        }
+    }
+    return true;
+}
+
 void SkeletonAnimation::setAnimationStateData(AnimationStateData *stateData) {
     CCASSERT(stateData, "stateData cannot be null.");
 
@@ -28,6 +28,9 @@
  *****************************************************************************/
 
 #include "SkeletonCache.h"
+#include "SkeletonCacheMgr.h"
+#include "SkeletonDataMgr.h"
+#include "platform/Application.h"
 #include "spine-creator-support/AttachmentVertices.h"
 
 USING_NS_MW;
@@ -35,16 +38,151 @@ using namespace cc;
 
 namespace spine {
 
+namespace {
+const uint32_t BAKED_DATA_MAGIC = 0x43425053; // 'SPBC'
+const uint32_t BAKED_DATA_VERSION = 1;
+
+// Every block of baked data file is 4 bytes aligned, so arrays can be used in place.
+struct BakedDataHeader {
+    uint32_t magic = BAKED_DATA_MAGIC;
+    uint32_t version = BAKED_DATA_VERSION;
+    uint64_t dataHash = 0;
+    uint64_t checksum = 0;
+    float frameTime = 0.0f;
+    float maxCacheTime = 0.0f;
+    uint32_t vertexFloats = 0;
+    uint32_t animationCount = 0;
+};
+
+struct BakedAnimationHeader {
+    uint32_t nameLength = 0;
+    uint32_t isComplete = 0;
+    float totalTime = 0.0f;
+    uint32_t frameCount = 0;
+    uint32_t boneCount = 0;
+    uint32_t colorCount = 0;
+    uint32_t segmentCount = 0;
+    uint32_t vertexFloatCount = 0;
+    uint32_t indexCount = 0;
+};
+
+struct BakedFrame {
+    uint32_t boneOffset, boneCount;
+    uint32_t colorOffset, colorCount;
+    uint32_t segmentOffset, segmentCount;
+    uint32_t vertexOffset, vertexCount;
+    uint32_t indexOffset, indexCount;
+};
+
+struct BakedSegment {
+    int32_t indexCount;
+    int32_t vertexCount;
+    int32_t blendMode;
+    // index of atlas page
+    int32_t pageIndex;
+};
+
+inline std::size_t alignedSize(std::size_t size) {
+    return (size + 3) & ~(std::size_t)3;
+}
+
+class BakedDataWriter {
+public:
+    void write(const void *data, std::size_t size) {
+        _bytes.insert(_bytes.end(), (const uint8_t *)data, (const uint8_t *)data + size);
+        _bytes.resize(alignedSize(_bytes.size()), 0);
+    }
+    std::vector<uint8_t> &getBytes() { return _bytes; }
+
+private:
+    std::vector<uint8_t> _bytes;
+};
+
+class BakedDataReader {
+public:
+    BakedDataReader(const uint8_t *data, std::size_t size) : _cursor(data), _end(data + size) {}
+
+    const uint8_t *read(std::size_t size) {
+        std::size_t aligned = alignedSize(size);
+        if ((std::size_t)(_end - _cursor) < aligned) return nullptr;
+        const uint8_t *data = _cursor;
+        _cursor += aligned;
+        return data;
+    }
+
+    template <typename T>
+    bool read(std::vector<T> &out, std::size_t count) {
+        const uint8_t *data = read(count * sizeof(T));
+        if (!data) return false;
+        out.resize(count);
+        if (count > 0) memcpy(out.data(), data, count * sizeof(T));
+        return true;
+    }
+
+    bool isEnd() const { return _cursor == _end; }
+    const uint8_t *getCursor() const { return _cursor; }
+
+private:
+    const uint8_t *_cursor = nullptr;
+    const uint8_t *_end = nullptr;
+};
+
+bool readHeader(BakedDataReader &reader, BakedDataHeader &header) {
+    const uint8_t *headerData = reader.read(sizeof(BakedDataHeader));
+    if (!headerData) return false;
+    memcpy(&header, headerData, sizeof(header));
+    return header.magic == BAKED_DATA_MAGIC && header.version == BAKED_DATA_VERSION;
+}
+
+uint64_t computeChecksum(const cc::Data &data) {
+    return SkeletonDataMgr::hashData(data.getBytes() + sizeof(BakedDataHeader), data.getSize() - sizeof(BakedDataHeader));
+}
+
+// Move reader past one animation without decoding it.
+bool skipAnimation(BakedDataReader &reader, std::string &name) {
+    const uint8_t *aniHeaderData = reader.read(sizeof(BakedAnimationHeader));
+    if (!aniHeaderData) return false;
+    BakedAnimationHeader aniHeader;
+    memcpy(&aniHeader, aniHeaderData, sizeof(aniHeader));
+
+    const uint8_t *nameData = reader.read(aniHeader.nameLength);
+    if (!nameData) return false;
+    name.assign((const char *)nameData, aniHeader.nameLength);
+
+    return reader.read(aniHeader.frameCount * sizeof(BakedFrame)) &&
+           reader.read(aniHeader.boneCount * sizeof(SkeletonCache::BoneData)) &&
+           reader.read(aniHeader.colorCount * sizeof(SkeletonCache::ColorData)) &&
+           reader.read(aniHeader.segmentCount * sizeof(BakedSegment)) &&
+           reader.read(aniHeader.vertexFloatCount * sizeof(float)) &&
+           reader.read(aniHeader.indexCount * sizeof(unsigned short));
+}
+} // namespace
+
 float SkeletonCache::FrameTime = 1.0f / 60.0f;
 float SkeletonCache::MaxCacheTime = 120.0f;
 
 SkeletonCache::SegmentData::SegmentData() {
 }
 
+SkeletonCache::SegmentData::SegmentData(const SegmentData &other)
+: indexCount(other.indexCount),
+  vertexCount(other.vertexCount),
+  blendMode(other.blendMode) {
+    setTexture(other._texture);
+}
+
 SkeletonCache::SegmentData::~SegmentData() {
     CC_SAFE_RELEASE_NULL(_texture);
 }
 
+SkeletonCache::SegmentData &SkeletonCache::SegmentData::operator=(const SegmentData &other) {
+    indexCount = other.indexCount;
+    vertexCount = other.vertexCount;
+    blendMode = other.blendMode;
+    setTexture(other._texture);
+    return *this;
+}
+
 void SkeletonCache::SegmentData::setTexture(cc::middleware::Texture2D *value) {
     CC_SAFE_RETAIN(value);
     CC_SAFE_RELEASE(_texture);
@@ -55,63 +193,33 @@ cc::middleware::Texture2D *SkeletonCache::SegmentData::getTexture() const {
     return _texture;
 }
 
-SkeletonCache::FrameData::FrameData() {
-}
-
-SkeletonCache::FrameData::~FrameData() {
-    for (std::size_t i = 0, c = _bones.size(); i < c; i++) {
-        delete _bones[i];
-    }
-    _bones.clear();
-
-    for (std::size_t i = 0, c = _colors.size(); i < c; i++) {
-        delete _colors[i];
-    }
-    _colors.clear();
-
-    for (std::size_t i = 0, c = _segments.size(); i < c; i++) {
-        delete _segments[i];
-    }
-    _segments.clear();
-}
-
-SkeletonCache::BoneData *SkeletonCache::FrameData::buildBoneData(std::size_t index) {
-    if (index > _bones.size()) return nullptr;
-    if (index == _bones.size()) {
-        BoneData *boneData = new BoneData;
-        _bones.push_back(boneData);
-    }
-    return _bones[index];
+void SkeletonCache::BoneData::toMat4(cc::Mat4 &out) const {
+    out.m[0] = matrix[0];
+    out.m[1] = matrix[1];
+    out.m[4] = matrix[2];
+    out.m[5] = matrix[3];
+    out.m[12] = matrix[4];
+    out.m[13] = matrix[5];
 }
 
-std::size_t SkeletonCache::FrameData::getBoneCount() const {
-    return _bones.size();
+const SkeletonCache::BoneData *SkeletonCache::FrameData::getBones() const {
+    return _animation->_bones.data() + _boneOffset;
 }
 
-SkeletonCache::ColorData *SkeletonCache::FrameData::buildColorData(std::size_t index) {
-    if (index > _colors.size()) return nullptr;
-    if (index == _colors.size()) {
-        ColorData *colorData = new ColorData;
-        _colors.push_back(colorData);
-    }
-    return _colors[index];
+const SkeletonCache::ColorData *SkeletonCache::FrameData::getColors() const {
+    return _animation->_colors.data() + _colorOffset;
 }
 
-std::size_t SkeletonCache::FrameData::getColorCount() const {
-    return _colors.size();
+const SkeletonCache::SegmentData *SkeletonCache::FrameData::getSegments() const {
+    return _animation->_segments.data() + _segmentOffset;
 }
 
-SkeletonCache::SegmentData *SkeletonCache::FrameData::buildSegmentData(std::size_t index) {
-    if (index > _segments.size()) return nullptr;
-    if (index == _segments.size()) {
-        SegmentData *segmentData = new SegmentData;
-        _segments.push_back(segmentData);
-    }
-    return _segments[index];
+const float *SkeletonCache::FrameData::getVertices() const {
+    return _animation->_vertices.data() + _vertexOffset * VERTEX_FLOATS;
 }
 
-std::size_t SkeletonCache::FrameData::getSegmentCount() const {
-    return _segments.size();
+const unsigned short *SkeletonCache::FrameData::getIndices() const {
+    return _animation->_indices.data() + _indexOffset;
 }
 
 SkeletonCache::AnimationData::AnimationData() {
@@ -122,34 +230,86 @@ SkeletonCache::AnimationData::~AnimationData() {
 }
 
 void SkeletonCache::AnimationData::reset() {
-    for (std::size_t i = 0, c = _frames.size(); i < c; i++) {
-        delete _frames[i];
-    }
     _frames.clear();
+    _bones.clear();
+    _colors.clear();
+    _segments.clear();
+    _vertices.clear();
+    _indices.clear();
+    shrink();
     _isComplete = false;
     _totalTime = 0.0f;
 }
 
+void SkeletonCache::AnimationData::shrink() {
+    _frames.shrink_to_fit();
+    _bones.shrink_to_fit();
+    _colors.shrink_to_fit();
+    _segments.shrink_to_fit();
+    _vertices.shrink_to_fit();
+    _indices.shrink_to_fit();
+    // no more frames are appended
+    std::unordered_multimap<uint64_t, uint32_t>().swap(_indexRanges);
+}
+
 bool SkeletonCache::AnimationData::needUpdate(int toFrameIdx) const {
     return !_isComplete && _totalTime <= MaxCacheTime && (toFrameIdx == -1 || _frames.size() < toFrameIdx + 1);
 }
 
+void SkeletonCache::AnimationData::touch() {
+    auto app = cc::Application::getInstance();
+    _lastUsedFrame = app ? app->getTotalFrames() : 0;
+}
+
+std::size_t SkeletonCache::AnimationData::getMemorySize() const {
+    return _frames.capacity() * sizeof(FrameData) +
+           _bones.capacity() * sizeof(BoneData) +
+           _colors.capacity() * sizeof(ColorData) +
+           _segments.capacity() * sizeof(SegmentData) +
+           _vertices.capacity() * sizeof(float) +
+           _indices.capacity() * sizeof(unsigned short);
+}
+
 SkeletonCache::FrameData *SkeletonCache::AnimationData::buildFrameData(std::size_t frameIdx) {
     if (frameIdx > _frames.size()) {
         return nullptr;
     }
     if (frameIdx == _frames.size()) {
-        auto frameData = new FrameData();
+        FrameData frameData;
+        frameData._animation = this;
+        frameData._boneOffset = (uint32_t)_bones.size();
+        frameData._colorOffset = (uint32_t)_colors.size();
+        frameData._segmentOffset = (uint32_t)_segments.size();
+        frameData._vertexOffset = (uint32_t)(_vertices.size() / VERTEX_FLOATS);
+        frameData._indexOffset = (uint32_t)_indices.size();
         _frames.push_back(frameData);
     }
-    return _frames[frameIdx];
+    return &_frames[frameIdx];
+}
+
+void SkeletonCache::AnimationData::appendIndices(FrameData *frameData, const unsigned short *indices, std::size_t count) {
+    frameData->_indexCount = (uint32_t)count;
+    // Triangles only change with draw order or attachments, most frames of a loop repeat an earlier one.
+    uint64_t hash = SkeletonDataMgr::hashData(indices, count * sizeof(unsigned short));
+    auto range = _indexRanges.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const FrameData &other = _frames[it->second];
+        if (other._indexCount == count &&
+            memcmp(_indices.data() + other._indexOffset, indices, count * sizeof(unsigned short)) == 0) {
+            frameData->_indexOffset = other._indexOffset;
+            return;
+        }
+    }
+    frameData->_indexOffset = (uint32_t)_indices.size();
+    _indices.insert(_indices.end(), indices, indices + count);
+    _indexRanges.emplace(hash, (uint32_t)(frameData - _frames.data()));
 }
 
-SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) const {
+const SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) const {
     if (frameIdx >= _frames.size()) {
         return nullptr;
     }
-    return _frames[frameIdx];
+    return &_frames[frameIdx];
 }
 
 std::size_t SkeletonCache::AnimationData::getFrameCount() const {
@@ -160,7 +320,9 @@ SkeletonCache::SkeletonCache() {
 }
 
 SkeletonCache::~SkeletonCache() {
+    auto mgr = SkeletonCacheMgr::getInstance();
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
+        mgr->removeAnimationData(it->second);
         delete it->second;
     }
     _animationCaches.clear();
@@ -176,6 +338,7 @@ SkeletonCache::AnimationData *SkeletonCache::buildAnimationData(const std::strin
         aniData = new AnimationData();
         aniData->_animationName = animationName;
         _animationCaches[animationName] = aniData;
+        SkeletonCacheMgr::getInstance()->addAnimationData(aniData);
     } else {
         aniData = it->second;
     }
@@ -209,9 +372,14 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
     if (!animationData || !animationData->needUpdate(toFrameIdx)) {
         return;
     }
+    animationData->touch();
 
     if (_curAnimationName != animationName) {
-        updateToFrame(_curAnimationName);
+        // finish baking previous animation, unless it has been evicted
+        auto preAnimationData = getAnimationData(_curAnimationName);
+        if (preAnimationData && preAnimationData->getFrameCount() > 0) {
+            updateToFrame(_curAnimationName);
+        }
         _curAnimationName = animationName;
     }
 
@@ -225,6 +393,12 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
         renderAnimationFrame(animationData);
         animationData->_totalTime += FrameTime;
     } while (animationData->needUpdate(toFrameIdx));
+
+    if (!animationData->needUpdate(-1)) {
+        animationData->shrink();
+        _bakedDataDirty = true;
+    }
+    SkeletonCacheMgr::getInstance()->checkMemoryBudget();
 }
 
 void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
@@ -245,16 +419,25 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     Color4F darkColor;
 
     AttachmentVertices *attachmentVertices = nullptr;
-    middleware::IOBuffer &vb = frameData->vb;
-    middleware::IOBuffer &ib = frameData->ib;
+    middleware::IOBuffer &vb = _bakeVB;
+    middleware::IOBuffer &ib = _bakeIB;
+    vb.reset();
+    ib.reset();
 
-    // vertex size int bytes with two color
-    int vbs2 = sizeof(V2F_T2F_C4F_C4F);
-    // verex size in floats with two color
-    int vs2 = vbs2 / sizeof(float);
+    auto &segments = animationData->_segments;
+    auto &colors = animationData->_colors;
+
+    // vertex size in floats
+    int vs = VERTEX_FLOATS;
+    // vertex size in bytes
+    int vbs = vs * sizeof(float);
 
     int vbSize = 0;
     int ibSize = 0;
+    int vertCount = 0;
+    int indexCount = 0;
+    float *verts = nullptr;
+    unsigned short *indices = nullptr;
 
     int preBlendMode = -1;
     int preTextureIndex = -1;
@@ -264,7 +447,6 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     int curISegLen = 0;
     int curVSegLen = 0;
 
-    int materialLen = 0;
     Slot *slot = nullptr;
 
     middleware::Texture2D *texture = nullptr;
@@ -272,14 +454,16 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     auto flush = [&]() {
         // fill pre segment count field
         if (preISegWritePos != -1) {
-            SegmentData *preSegmentData = frameData->buildSegmentData(materialLen - 1);
-            preSegmentData->indexCount = curISegLen;
-            preSegmentData->vertexFloatCount = curVSegLen;
+            SegmentData &preSegmentData = segments.back();
+            preSegmentData.indexCount = curISegLen;
+            preSegmentData.vertexCount = curVSegLen;
         }
 
-        SegmentData *segmentData = frameData->buildSegmentData(materialLen);
-        segmentData->setTexture(texture);
-        segmentData->blendMode = slot->getData().getBlendMode();
+        segments.emplace_back();
+        SegmentData &segmentData = segments.back();
+        segmentData.setTexture(texture);
+        segmentData.blendMode = slot->getData().getBlendMode();
+        frameData->_segmentCount++;
 
         // save new segment count pos field
         preISegWritePos = (int)ib.getCurPos() / sizeof(unsigned short);
@@ -291,23 +475,42 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         curISegLen = 0;
         // reset vertex segmentation count
         curVSegLen = 0;
-        // material length increased
-        materialLen++;
     };
 
     auto &bones = _skeleton->getBones();
     for (std::size_t i = 0, n = bones.size(); i < n; i++) {
         auto &bone = bones[i];
-        auto boneCount = frameData->getBoneCount();
-        BoneData *boneData = frameData->buildBoneData(boneCount);
-        auto &matm = boneData->globalTransformMatrix.m;
-        matm[0] = bone->getA();
-        matm[1] = bone->getC();
-        matm[4] = bone->getB();
-        matm[5] = bone->getD();
-        matm[12] = bone->getWorldX();
-        matm[13] = bone->getWorldY();
+        BoneData boneData;
+        boneData.matrix[0] = bone->getA();
+        boneData.matrix[1] = bone->getC();
+        boneData.matrix[2] = bone->getB();
+        boneData.matrix[3] = bone->getD();
+        boneData.matrix[4] = bone->getWorldX();
+        boneData.matrix[5] = bone->getWorldY();
+        animationData->_bones.push_back(boneData);
     }
+    frameData->_boneCount = (uint32_t)bones.size();
+
+    // copy positions of attachment vertices in setup pose and its uvs
+    auto fillAttachmentVertices = [&]() {
+        vertCount = attachmentVertices->_triangles->vertCount;
+        vbSize = vertCount * vbs;
+        vb.checkSpace(vbSize, true);
+        verts = (float *)vb.getCurBuffer();
+        auto srcVerts = attachmentVertices->_triangles->verts;
+        for (int ii = 0; ii < vertCount; ii++) {
+            verts[ii * vs + 2] = srcVerts[ii].texCoord.u;
+            verts[ii * vs + 3] = srcVerts[ii].texCoord.v;
+        }
+    };
+
+    auto fillAttachmentIndices = [&]() {
+        indexCount = attachmentVertices->_triangles->indexCount;
+        ibSize = indexCount * sizeof(unsigned short);
+        ib.checkSpace(ibSize, true);
+        indices = (unsigned short *)ib.getCurBuffer();
+        memcpy(indices, attachmentVertices->_triangles->indices, ibSize);
+    };
 
     auto &drawOrder = _skeleton->getDrawOrder();
     for (size_t i = 0, n = drawOrder.size(); i < n; ++i) {
@@ -324,8 +527,6 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
             continue;
         }
 
-        TwoColorTriangles trianglesTwoColor;
-
         if (slot->getAttachment()->getRTTI().isExactly(RegionAttachment::rtti)) {
             RegionAttachment *attachment = (RegionAttachment *)slot->getAttachment();
             attachmentVertices = (AttachmentVertices *)attachment->getRendererObject();
@@ -336,20 +537,9 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
                 continue;
             }
 
-            trianglesTwoColor.vertCount = attachmentVertices->_triangles->vertCount;
-            vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
-            vb.checkSpace(vbSize, true);
-            trianglesTwoColor.verts = (V2F_T2F_C4F_C4F *)vb.getCurBuffer();
-            for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-            }
-            attachment->computeWorldVertices(slot->getBone(), (float *)trianglesTwoColor.verts, 0, vs2);
-
-            trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
-            ibSize = trianglesTwoColor.indexCount * sizeof(unsigned short);
-            ib.checkSpace(ibSize, true);
-            trianglesTwoColor.indices = (unsigned short *)ib.getCurBuffer();
-            memcpy(trianglesTwoColor.indices, attachmentVertices->_triangles->indices, ibSize);
+            fillAttachmentVertices();
+            attachment->computeWorldVertices(slot->getBone(), verts, 0, vs);
+            fillAttachmentIndices();
 
             color.r = attachment->getColor().r;
             color.g = attachment->getColor().g;
@@ -366,20 +556,9 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
                 continue;
             }
 
-            trianglesTwoColor.vertCount = attachmentVertices->_triangles->vertCount;
-            vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
-            vb.checkSpace(vbSize, true);
-            trianglesTwoColor.verts = (V2F_T2F_C4F_C4F *)vb.getCurBuffer();
-            for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-            }
-            attachment->computeWorldVertices(*slot, 0, attachment->getWorldVerticesLength(), (float *)trianglesTwoColor.verts, 0, vs2);
-
-            trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
-            ibSize = trianglesTwoColor.indexCount * sizeof(unsigned short);
-            ib.checkSpace(ibSize, true);
-            trianglesTwoColor.indices = (unsigned short *)ib.getCurBuffer();
-            memcpy(trianglesTwoColor.indices, attachmentVertices->_triangles->indices, ibSize);
+            fillAttachmentVertices();
+            attachment->computeWorldVertices(*slot, 0, attachment->getWorldVerticesLength(), verts, 0, vs);
+            fillAttachmentIndices();
 
             color.r = attachment->getColor().r;
             color.g = attachment->getColor().g;
@@ -424,65 +603,44 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         if (preColor != color || preDarkColor != darkColor) {
             preColor = color;
             preDarkColor = darkColor;
-            auto colorCount = frameData->getColorCount();
-            if (colorCount > 0) {
-                ColorData *preColorData = frameData->buildColorData(colorCount - 1);
-                preColorData->vertexFloatOffset = (int)vb.getCurPos() / sizeof(float);
+            if (frameData->_colorCount > 0) {
+                colors.back().vertexOffset = (int)vb.getCurPos() / vbs;
             }
-            ColorData *colorData = frameData->buildColorData(colorCount);
-            colorData->finalColor = color;
-            colorData->darkColor = darkColor;
+            ColorData colorData;
+            colorData.finalColor = color;
+            colorData.darkColor = darkColor;
+            colors.push_back(colorData);
+            frameData->_colorCount++;
         }
 
-        // Two color tint logic
         if (_clipper->isClipping()) {
-            _clipper->clipTriangles((float *)&trianglesTwoColor.verts[0].vertex, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float *)&trianglesTwoColor.verts[0].texCoord, vs2);
+            _clipper->clipTriangles(verts, indices, indexCount, verts + 2, vs);
 
             if (_clipper->getClippedTriangles().size() == 0) {
                 _clipper->clipEnd(*slot);
                 continue;
             }
 
-            trianglesTwoColor.vertCount = (int)_clipper->getClippedVertices().size() >> 1;
-            vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
+            vertCount = (int)_clipper->getClippedVertices().size() >> 1;
+            vbSize = vertCount * vbs;
             vb.checkSpace(vbSize, true);
-            trianglesTwoColor.verts = (V2F_T2F_C4F_C4F *)vb.getCurBuffer();
+            verts = (float *)vb.getCurBuffer();
 
-            trianglesTwoColor.indexCount = (int)_clipper->getClippedTriangles().size();
-            ibSize = trianglesTwoColor.indexCount * sizeof(unsigned short);
+            indexCount = (int)_clipper->getClippedTriangles().size();
+            ibSize = indexCount * sizeof(unsigned short);
             ib.checkSpace(ibSize, true);
-            trianglesTwoColor.indices = (unsigned short *)ib.getCurBuffer();
-            memcpy(trianglesTwoColor.indices, _clipper->getClippedTriangles().buffer(), sizeof(unsigned short) * _clipper->getClippedTriangles().size());
+            indices = (unsigned short *)ib.getCurBuffer();
+            memcpy(indices, _clipper->getClippedTriangles().buffer(), ibSize);
 
-            float *verts = _clipper->getClippedVertices().buffer();
+            float *clippedVerts = _clipper->getClippedVertices().buffer();
             float *uvs = _clipper->getClippedUVs().buffer();
 
-            for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
-                V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                vertex->vertex.x = verts[vv];
-                vertex->vertex.y = verts[vv + 1];
-                vertex->texCoord.u = uvs[vv];
-                vertex->texCoord.v = uvs[vv + 1];
-                vertex->color.r = color.r / 255.0f;
-                vertex->color.g = color.g / 255.0f;
-                vertex->color.b = color.b / 255.0f;
-                vertex->color.a = color.a / 255.0f;
-                vertex->color2.r = darkColor.r / 255.0f;
-                vertex->color2.g = darkColor.g / 255.0f;
-                vertex->color2.b = darkColor.b / 255.0f;
-                vertex->color2.a = darkColor.a / 255.0f;
-            }
-        } else {
-            for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
-                V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                vertex->color.r = color.r / 255.0f;
-                vertex->color.g = color.g / 255.0f;
-                vertex->color.b = color.b / 255.0f;
-                vertex->color.a = color.a / 255.0f;
-                vertex->color2.r = darkColor.r / 255.0f;
-                vertex->color2.g = darkColor.g / 255.0f;
-                vertex->color2.b = darkColor.b / 255.0f;
-                vertex->color2.a = darkColor.a / 255.0f;
+            for (int v = 0, vv = 0; v < vertCount; ++v, vv += 2) {
+                float *vertex = verts + v * vs;
+                vertex[0] = clippedVerts[vv];
+                vertex[1] = clippedVerts[vv + 1];
+                vertex[2] = uvs[vv];
+                vertex[3] = uvs[vv + 1];
             }
         }
 
@@ -494,7 +652,7 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         }
 
         if (vbSize > 0 && ibSize > 0) {
-            auto vertexOffset = curVSegLen / vs2;
+            auto vertexOffset = curVSegLen;
 
             if (vertexOffset > 0) {
                 unsigned short *ibBuffer = (unsigned short *)ib.getCurBuffer();
@@ -507,7 +665,7 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
 
             // Record this turn index segmentation count,it will store in material buffer in the end.
             curISegLen += ibSize / sizeof(unsigned short);
-            curVSegLen += vbSize / sizeof(float);
+            curVSegLen += vbSize / vbs;
         }
 
         _clipper->clipEnd(*slot);
@@ -516,16 +674,21 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     _clipper->clipEnd();
 
     if (preISegWritePos != -1) {
-        SegmentData *preSegmentData = frameData->buildSegmentData(materialLen - 1);
-        preSegmentData->indexCount = curISegLen;
-        preSegmentData->vertexFloatCount = curVSegLen;
+        SegmentData &preSegmentData = segments.back();
+        preSegmentData.indexCount = curISegLen;
+        preSegmentData.vertexCount = curVSegLen;
     }
 
-    auto colorCount = frameData->getColorCount();
-    if (colorCount > 0) {
-        ColorData *preColorData = frameData->buildColorData(colorCount - 1);
-        preColorData->vertexFloatOffset = (int)vb.getCurPos() / sizeof(float);
+    if (frameData->_colorCount > 0) {
+        colors.back().vertexOffset = (int)vb.getCurPos() / vbs;
     }
+
+    // move baked frame into arenas of animation
+    auto vertexCount = vb.getCurPos() / vbs;
+    auto *srcVerts = (const float *)vb.getBuffer();
+    animationData->_vertices.insert(animationData->_vertices.end(), srcVerts, srcVerts + vertexCount * vs);
+    frameData->_vertexCount = (uint32_t)vertexCount;
+    animationData->appendIndices(frameData, (const unsigned short *)ib.getBuffer(), ib.getCurPos() / sizeof(unsigned short));
 }
 
 void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Event *event) {
@@ -556,4 +719,227 @@ void SkeletonCache::resetAnimationData(const std::string &animationName) {
         }
     }
 }
+
+cc::Data SkeletonCache::saveBakedData(uint64_t dataHash) {
+    cc::Data data;
+    _bakedDataDirty = false;
+
+    Atlas *atlas = SkeletonDataMgr::getInstance()->getAtlas(_uuid);
+    if (!atlas) return data;
+    auto &pages = atlas->getPages();
+
+    BakedDataWriter writer;
+    BakedDataHeader header;
+    header.dataHash = dataHash;
+    header.frameTime = FrameTime;
+    header.maxCacheTime = MaxCacheTime;
+    header.vertexFloats = VERTEX_FLOATS;
+    writer.write(&header, sizeof(header));
+
+    std::vector<BakedFrame> frames;
+    std::vector<BakedSegment> segments;
+    for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
+        AnimationData *aniData = it->second;
+        // partially baked animation will continue baking at runtime anyway
+        if (aniData->getFrameCount() == 0 || aniData->needUpdate(-1)) continue;
+
+        segments.clear();
+        bool hasUnknownTexture = false;
+        for (auto &segment : aniData->_segments) {
+            BakedSegment bakedSegment;
+            bakedSegment.indexCount = segment.indexCount;
+            bakedSegment.vertexCount = segment.vertexCount;
+            bakedSegment.blendMode = segment.blendMode;
+            bakedSegment.pageIndex = -1;
+            for (std::size_t i = 0, n = pages.size(); i < n; i++) {
+                if (pages[i]->getRendererObject() == segment.getTexture()) {
+                    bakedSegment.pageIndex = (int32_t)i;
+                    break;
+                }
+            }
+            if (bakedSegment.pageIndex < 0) {
+                hasUnknownTexture = true;
+                break;
+            }
+            segments.push_back(bakedSegment);
+        }
+        if (hasUnknownTexture) continue;
+
+        frames.clear();
+        for (auto &frame : aniData->_frames) {
+            frames.push_back({frame._boneOffset, frame._boneCount,
+                              frame._colorOffset, frame._colorCount,
+                              frame._segmentOffset, frame._segmentCount,
+                              frame._vertexOffset, frame._vertexCount,
+                              frame._indexOffset, frame._indexCount});
+        }
+
+        BakedAnimationHeader aniHeader;
+        aniHeader.nameLength = (uint32_t)aniData->_animationName.size();
+        aniHeader.isComplete = aniData->_isComplete ? 1 : 0;
+        aniHeader.totalTime = aniData->_totalTime;
+        aniHeader.frameCount = (uint32_t)frames.size();
+        aniHeader.boneCount = (uint32_t)aniData->_bones.size();
+        aniHeader.colorCount = (uint32_t)aniData->_colors.size();
+        aniHeader.segmentCount = (uint32_t)segments.size();
+        aniHeader.vertexFloatCount = (uint32_t)aniData->_vertices.size();
+        aniHeader.indexCount = (uint32_t)aniData->_indices.size();
+
+        writer.write(&aniHeader, sizeof(aniHeader));
+        writer.write(aniData->_animationName.data(), aniHeader.nameLength);
+        writer.write(frames.data(), frames.size() * sizeof(BakedFrame));
+        writer.write(aniData->_bones.data(), aniData->_bones.size() * sizeof(BoneData));
+        writer.write(aniData->_colors.data(), aniData->_colors.size() * sizeof(ColorData));
+        writer.write(segments.data(), segments.size() * sizeof(BakedSegment));
+        writer.write(aniData->_vertices.data(), aniData->_vertices.size() * sizeof(float));
+        writer.write(aniData->_indices.data(), aniData->_indices.size() * sizeof(unsigned short));
+        header.animationCount++;
+    }
+
+    auto &bytes = writer.getBytes();
+    header.checksum = SkeletonDataMgr::hashData(bytes.data() + sizeof(header), bytes.size() - sizeof(header));
+    memcpy(bytes.data(), &header, sizeof(header));
+    data.copy(bytes.data(), (ssize_t)bytes.size());
+    return data;
+}
+
+bool SkeletonCache::loadBakedData(const cc::Data &data, uint64_t dataHash) {
+    Atlas *atlas = SkeletonDataMgr::getInstance()->getAtlas(_uuid);
+    if (!atlas || data.isNull()) return false;
+    auto &pages = atlas->getPages();
+
+    BakedDataReader reader(data.getBytes(), (std::size_t)data.getSize());
+    BakedDataHeader header;
+    if (!readHeader(reader, header) ||
+        header.dataHash != dataHash || header.frameTime != FrameTime ||
+        header.maxCacheTime != MaxCacheTime || header.vertexFloats != VERTEX_FLOATS) {
+        return false;
+    }
+    if (header.checksum != computeChecksum(data)) {
+        CC_LOG_WARNING("Baked data of skeleton %s is corrupted, discarded.", _uuid.c_str());
+        return false;
+    }
+
+    // never keep part of rejected data
+    auto fail = [this]() {
+        resetAllAnimationData();
+        return false;
+    };
+
+    std::vector<BakedFrame> frames;
+    std::vector<BakedSegment> segments;
+    for (uint32_t aniIndex = 0; aniIndex < header.animationCount; aniIndex++) {
+        const uint8_t *aniHeaderData = reader.read(sizeof(BakedAnimationHeader));
+        if (!aniHeaderData) return fail();
+        BakedAnimationHeader aniHeader;
+        memcpy(&aniHeader, aniHeaderData, sizeof(aniHeader));
+
+        const uint8_t *nameData = reader.read(aniHeader.nameLength);
+        if (!nameData) return fail();
+        std::string animationName((const char *)nameData, aniHeader.nameLength);
+
+        AnimationData *aniData = buildAnimationData(animationName);
+        if (!aniData) return fail();
+        aniData->reset();
+
+        if (!reader.read(frames, aniHeader.frameCount) ||
+            !reader.read(aniData->_bones, aniHeader.boneCount) ||
+            !reader.read(aniData->_colors, aniHeader.colorCount) ||
+            !reader.read(segments, aniHeader.segmentCount) ||
+            !reader.read(aniData->_vertices, aniHeader.vertexFloatCount) ||
+            !reader.read(aniData->_indices, aniHeader.indexCount)) {
+            return fail();
+        }
+
+        bool valid = true;
+        aniData->_segments.resize(segments.size());
+        for (std::size_t i = 0, n = segments.size(); i < n && valid; i++) {
+            auto &bakedSegment = segments[i];
+            if (bakedSegment.pageIndex < 0 || bakedSegment.pageIndex >= (int32_t)pages.size()) {
+                valid = false;
+                break;
+            }
+            auto &segment = aniData->_segments[i];
+            segment.indexCount = bakedSegment.indexCount;
+            segment.vertexCount = bakedSegment.vertexCount;
+            segment.blendMode = bakedSegment.blendMode;
+            segment.setTexture((cc::middleware::Texture2D *)pages[bakedSegment.pageIndex]->getRendererObject());
+        }
+
+        std::size_t vertexCount = aniData->_vertices.size() / VERTEX_FLOATS;
+        aniData->_frames.resize(frames.size());
+        for (std::size_t i = 0, n = frames.size(); i < n && valid; i++) {
+            auto &bakedFrame = frames[i];
+            valid = bakedFrame.boneOffset + bakedFrame.boneCount <= aniData->_bones.size() &&
+                    bakedFrame.colorOffset + bakedFrame.colorCount <= aniData->_colors.size() &&
+                    bakedFrame.segmentOffset + bakedFrame.segmentCount <= aniData->_segments.size() &&
+                    bakedFrame.vertexOffset + bakedFrame.vertexCount <= vertexCount &&
+                    bakedFrame.indexOffset + bakedFrame.indexCount <= aniData->_indices.size();
+
+            auto &frame = aniData->_frames[i];
+            frame._animation = aniData;
+            frame._boneOffset = bakedFrame.boneOffset;
+            frame._boneCount = bakedFrame.boneCount;
+            frame._colorOffset = bakedFrame.colorOffset;
+            frame._colorCount = bakedFrame.colorCount;
+            frame._segmentOffset = bakedFrame.segmentOffset;
+            frame._segmentCount = bakedFrame.segmentCount;
+            frame._vertexOffset = bakedFrame.vertexOffset;
+            frame._vertexCount = bakedFrame.vertexCount;
+            frame._indexOffset = bakedFrame.indexOffset;
+            frame._indexCount = bakedFrame.indexCount;
+        }
+
+        if (!valid) return fail();
+        aniData->_isComplete = aniHeader.isComplete != 0;
+        aniData->_totalTime = aniHeader.totalTime;
+    }
+
+    if (!reader.isEnd()) return fail();
+
+    _bakedDataDirty = false;
+    SkeletonCacheMgr::getInstance()->checkMemoryBudget();
+    return true;
+}
+cc::Data SkeletonCache::mergeBakedData(const cc::Data &newer, const cc::Data &older) {
+    if (newer.isNull() || older.isNull()) return newer;
+
+    BakedDataReader newReader(newer.getBytes(), (std::size_t)newer.getSize());
+    BakedDataReader oldReader(older.getBytes(), (std::size_t)older.getSize());
+    BakedDataHeader header;
+    BakedDataHeader oldHeader;
+    if (!readHeader(newReader, header) || !readHeader(oldReader, oldHeader) || oldHeader.checksum != computeChecksum(older)) {
+        return newer;
+    }
+    // older data of another source skeleton or settings can not be reused
+    if (oldHeader.dataHash != header.dataHash || oldHeader.frameTime != header.frameTime ||
+        oldHeader.maxCacheTime != header.maxCacheTime || oldHeader.vertexFloats != header.vertexFloats) {
+        return newer;
+    }
+
+    std::set<std::string> names;
+    std::string name;
+    for (uint32_t aniIndex = 0; aniIndex < header.animationCount; aniIndex++) {
+        if (!skipAnimation(newReader, name)) return newer;
+        names.insert(name);
+    }
+
+    // animations are copied as is, every block stays 4 bytes aligned
+    BakedDataWriter writer;
+    writer.write(newer.getBytes(), (std::size_t)newer.getSize());
+    for (uint32_t aniIndex = 0; aniIndex < oldHeader.animationCount; aniIndex++) {
+        const uint8_t *begin = oldReader.getCursor();
+        if (!skipAnimation(oldReader, name)) break;
+        if (names.count(name)) continue;
+        writer.write(begin, oldReader.getCursor() - begin);
+        header.animationCount++;
+    }
+
+    auto &bytes = writer.getBytes();
+    header.checksum = SkeletonDataMgr::hashData(bytes.data() + sizeof(header), bytes.size() - sizeof(header));
+    memcpy(bytes.data(), &header, sizeof(header));
+    cc::Data data;
+    data.copy(bytes.data(), (ssize_t)bytes.size());
+    return data;
+}
 } // namespace spine
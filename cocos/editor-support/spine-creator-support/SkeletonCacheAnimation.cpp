@@ -31,6 +31,7 @@
 #include "MiddlewareMacro.h"
 #include "SharedBufferManager.h"
 #include "SkeletonCacheMgr.h"
+#include "VertexKernel.h"
 #include "base/TypeDef.h"
 #include "base/memory/Memory.h"
 #include "math/Math.h"
@@ -94,6 +95,8 @@ SkeletonCacheAnimation::~SkeletonCacheAnimation() {
 }
 
 void SkeletonCacheAnimation::update(float dt) {
+    // keep the baked data alive while the animation is displayed, even when paused
+    if (_animationData) _animationData->touch();
     if (_paused) return;
 
     auto gTimeScale = SkeletonAnimation::GlobalTimeScale;
@@ -161,12 +164,14 @@ void SkeletonCacheAnimation::update(float dt) {
 
 void SkeletonCacheAnimation::render(float dt) {
     if (!_animationData) return;
-    SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
+    const SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
     if (!frameData) return;
 
-    auto &segments = frameData->getSegments();
-    auto &colors = frameData->getColors();
-    if (segments.size() == 0 || colors.size() == 0) return;
+    auto segments = frameData->getSegments();
+    auto segmentCount = frameData->getSegmentCount();
+    auto colors = frameData->getColors();
+    auto colorCount = frameData->getColorCount();
+    if (segmentCount == 0 || colorCount == 0) return;
 
     auto mgr = MiddlewareManager::getInstance();
     if (!mgr->isRendering) return;
@@ -174,12 +179,10 @@ void SkeletonCacheAnimation::render(float dt) {
     _sharedBufferOffset->reset();
     _sharedBufferOffset->clear();
 
-    auto renderMgr = mgr->getRenderInfoMgr();
-    auto renderInfo = renderMgr->getBuffer();
+    auto renderInfo = mgr->getRenderInfoBuffer();
     if (!renderInfo) return;
 
-    auto attachMgr = mgr->getAttachInfoMgr();
-    auto attachInfo = attachMgr->getBuffer();
+    auto attachInfo = mgr->getAttachInfoBuffer();
     if (!attachInfo) return;
 
     //  store render info offset
@@ -193,14 +196,14 @@ void SkeletonCacheAnimation::render(float dt) {
     renderInfo->writeUint32(0xffffffff);
 
     // matieral len
-    renderInfo->writeUint32(segments.size());
+    renderInfo->writeUint32(segmentCount);
 
     auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
     middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
     middleware::IOBuffer &vb = mb->getVB();
     middleware::IOBuffer &ib = mb->getIB();
-    const auto &srcVB = frameData->vb;
-    const auto &srcIB = frameData->ib;
+    const float *srcVertices = frameData->getVertices();
+    const unsigned short *srcIndices = frameData->getIndices();
 
     // vertex size int bytes with one color
     int vbs1 = sizeof(V2F_T2F_C4F);
@@ -210,6 +213,8 @@ void SkeletonCacheAnimation::render(float dt) {
     int vbs2 = sizeof(V2F_T2F_C4F_C4F);
     // vertex size in floats with two color
     int vs2 = vbs2 / sizeof(float);
+    // baked vertex size in floats
+    const int srcVS = SkeletonCache::VERTEX_FLOATS;
 
     int vs = _useTint ? vs2 : vs1;
     int vbs = _useTint ? vbs2 : vbs1;
@@ -217,42 +222,28 @@ void SkeletonCacheAnimation::render(float dt) {
     auto paramsBuffer = _paramsBuffer->getBuffer();
     const cc::Mat4 &nodeWorldMat = *(cc::Mat4 *)&paramsBuffer[4];
 
-    int colorOffset = 0;
-    SkeletonCache::ColorData *nowColor = colors[colorOffset++];
-    auto maxVFOffset = nowColor->vertexFloatOffset;
+    std::size_t colorOffset = 0;
+    const SkeletonCache::ColorData *nowColor = &colors[colorOffset++];
+    auto maxVertexOffset = nowColor->vertexOffset;
 
     Color4F finalColor;
     Color4F darkColor;
     float tempR = 0.0f, tempG = 0.0f, tempB = 0.0f, tempA = 0.0f;
     float multiplier = 1.0f;
-    int srcVertexBytesOffset = 0;
-    int srcVertexBytes = 0;
+    int srcVertexOffset = 0;
+    int srcIndexOffset = 0;
     int vertexBytes = 0;
-    int vertexFloats = 0;
-    int tintBytes = 0;
-    int srcIndexBytesOffset = 0;
     int indexBytes = 0;
     int curTextureIndex = 0;
-    double effectHash = 0;
     int blendMode = 0;
     int dstVertexOffset = 0;
     int dstIndexOffset = 0;
     float *dstVertexBuffer = nullptr;
-    unsigned int *dstColorBuffer = nullptr;
     unsigned short *dstIndexBuffer = nullptr;
-    bool needColor = false;
     int curBlendSrc = -1;
     int curBlendDst = -1;
 
-    if (abs(_nodeColor.r - 1.0f) > 0.0001f ||
-        abs(_nodeColor.g - 1.0f) > 0.0001f ||
-        abs(_nodeColor.b - 1.0f) > 0.0001f ||
-        abs(_nodeColor.a - 1.0f) > 0.0001f ||
-        _premultipliedAlpha) {
-        needColor = true;
-    }
-
-    auto handleColor = [&](SkeletonCache::ColorData *colorData) {
+    auto handleColor = [&](const SkeletonCache::ColorData *colorData) {
         tempA = colorData->finalColor.a * _nodeColor.a;
         multiplier = _premultipliedAlpha ? tempA / 255 : 1;
         tempR = _nodeColor.r * multiplier;
@@ -272,17 +263,9 @@ void SkeletonCacheAnimation::render(float dt) {
 
     handleColor(nowColor);
 
-    for (std::size_t segIndex = 0, segLen = segments.size(); segIndex < segLen; segIndex++) {
-        auto segment = segments[segIndex];
-        srcVertexBytes = segment->vertexFloatCount * sizeof(float);
-        if (!_useTint) {
-            tintBytes = segment->vertexFloatCount / vs2 * sizeof(float);
-            vertexBytes = srcVertexBytes - tintBytes;
-            vertexFloats = vertexBytes / sizeof(float);
-        } else {
-            vertexBytes = srcVertexBytes;
-            vertexFloats = segment->vertexFloatCount;
-        }
+    for (std::size_t segIndex = 0; segIndex < segmentCount; segIndex++) {
+        auto segment = &segments[segIndex];
+        vertexBytes = segment->vertexCount * vbs;
 
         // check enough space
         renderInfo->checkSpace(sizeof(uint32_t) * 6, true);
@@ -313,70 +296,45 @@ void SkeletonCacheAnimation::render(float dt) {
         renderInfo->writeUint32(curBlendSrc);
         renderInfo->writeUint32(curBlendDst);
 
-        // fill vertex buffer
+        // fill vertex buffer, baked vertex only has position and uv
         vb.checkSpace(vertexBytes, true);
         dstVertexOffset = (int)vb.getCurPos() / vbs;
         dstVertexBuffer = (float *)vb.getCurBuffer();
-        dstColorBuffer = (unsigned int *)vb.getCurBuffer();
-        if (!_useTint) {
-            char *srcBuffer = (char *)srcVB.getBuffer() + srcVertexBytesOffset;
-            for (std::size_t srcBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vbs2) {
-                vb.writeBytes(srcBuffer + srcBufferIdx, vbs);
+        for (int v = 0; v < segment->vertexCount; v++, srcVertexOffset++) {
+            if (srcVertexOffset >= maxVertexOffset && colorOffset < colorCount) {
+                nowColor = &colors[colorOffset++];
+                handleColor(nowColor);
+                maxVertexOffset = nowColor->vertexOffset;
+            }
+            const float *src = srcVertices + srcVertexOffset * srcVS;
+            float *dst = dstVertexBuffer + v * vs;
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = 0;
+            dst[3] = src[2];
+            dst[4] = src[3];
+            memcpy(dst + 5, &finalColor, sizeof(finalColor));
+            if (_useTint) {
+                memcpy(dst + 9, &darkColor, sizeof(darkColor));
             }
-        } else {
-            vb.writeBytes((char *)srcVB.getBuffer() + srcVertexBytesOffset, vertexBytes);
         }
 
         // batch handle
         if (_batch) {
-            cc::Vec3 *point = nullptr;
-            for (auto posIndex = 0; posIndex < vertexFloats; posIndex += vs) {
-                point = (cc::Vec3 *)(dstVertexBuffer + posIndex);
-                // force z value to zero
-                point->z = 0;
-                point->x = point->x * nodeWorldMat.m[0] + point->y * nodeWorldMat.m[4] + nodeWorldMat.m[12]; // x
-                point->y = point->y * nodeWorldMat.m[1] + point->y * nodeWorldMat.m[5] + nodeWorldMat.m[13]; // y
-            }
+            transformVertices(dstVertexBuffer, segment->vertexCount, vs, nodeWorldMat);
         }
-
-        // handle vertex color
-        if (needColor) {
-            int srcVertexFloatOffset = srcVertexBytesOffset / sizeof(float);
-            if (_useTint) {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
-                        handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
-                    }
-                    memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
-                    memcpy(dstColorBuffer + colorIndex + 9, &darkColor, sizeof(darkColor));
-                }
-            } else {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
-                        handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
-                    }
-                    memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
-                }
-            }
-        }
-
-        // move src vertex buffer offset
-        srcVertexBytesOffset += srcVertexBytes;
+        vb.move(vertexBytes);
 
         // fill index buffer
         indexBytes = segment->indexCount * sizeof(unsigned short);
         ib.checkSpace(indexBytes, true);
         dstIndexOffset = (int)ib.getCurPos() / sizeof(unsigned short);
         dstIndexBuffer = (unsigned short *)ib.getCurBuffer();
-        ib.writeBytes((char *)srcIB.getBuffer() + srcIndexBytesOffset, indexBytes);
         for (auto indexPos = 0; indexPos < segment->indexCount; indexPos++) {
-            dstIndexBuffer[indexPos] += dstVertexOffset;
+            dstIndexBuffer[indexPos] = srcIndices[srcIndexOffset + indexPos] + dstVertexOffset;
         }
-        srcIndexBytesOffset += indexBytes;
+        ib.move(indexBytes);
+        srcIndexOffset += segment->indexCount;
 
         // fill new index and vertex buffer id
         auto bufferIndex = mb->getBufferPos();
@@ -389,13 +347,14 @@ void SkeletonCacheAnimation::render(float dt) {
     }
 
     if (_useAttach) {
-        auto &bonesData = frameData->getBones();
+        auto bonesData = frameData->getBones();
         auto boneCount = frameData->getBoneCount();
+        cc::Mat4 boneMat = cc::Mat4::IDENTITY;
 
-        for (int i = 0, n = boneCount; i < n; i++) {
-            auto bone = bonesData[i];
+        for (std::size_t i = 0; i < boneCount; i++) {
+            bonesData[i].toMat4(boneMat);
             attachInfo->checkSpace(sizeof(cc::Mat4), true);
-            attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
+            attachInfo->writeBytes((const char *)&boneMat, sizeof(cc::Mat4));
         }
     }
 }
@@ -534,6 +493,11 @@ void SkeletonCacheAnimation::setCompleteListener(const CacheFrameEvent &listener
     _completeListener = listener;
 }
 
+void SkeletonCacheAnimation::relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) {
+    _sharedBufferOffset->writeUint32(0, renderInfoOffset);
+    _sharedBufferOffset->writeUint32(sizeof(uint32_t), attachInfoOffset);
+}
+
 void SkeletonCacheAnimation::updateAnimationCache(const std::string &animationName) {
     _skeletonCache->resetAnimationData(animationName);
 }
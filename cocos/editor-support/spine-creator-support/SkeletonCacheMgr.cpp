@@ -28,9 +28,39 @@
  *****************************************************************************/
 
 #include "SkeletonCacheMgr.h"
+#include "SkeletonDataMgr.h"
+#include "base/Log.h"
+#include "bindings/event/CustomEventTypes.h"
+#include "bindings/event/EventDispatcher.h"
+#include "platform/Application.h"
+#include "platform/FileUtils.h"
+#include <algorithm>
 
 namespace spine {
 SkeletonCacheMgr *SkeletonCacheMgr::_instance = nullptr;
+
+SkeletonCacheMgr::SkeletonCacheMgr() {
+    // application may be killed in background without any chance to save
+    _onPauseListenerID = cc::EventDispatcher::addCustomEventListener(EVENT_COME_TO_BACKGROUND, [this](const cc::CustomEvent &) {
+        flushDiskCache();
+    });
+}
+
+SkeletonCacheMgr::~SkeletonCacheMgr() {
+    cc::EventDispatcher::removeCustomEventListener(EVENT_COME_TO_BACKGROUND, _onPauseListenerID);
+    flushDiskCache(true);
+    if (_writeThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            _writeExit = true;
+        }
+        _writeCondition.notify_one();
+        _writeThread.join();
+    }
+    // caches unregister their animations when released
+    _caches.clear();
+}
+
 SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
     SkeletonCache *animation = _caches.at(uuid);
     if (!animation) {
@@ -38,6 +68,16 @@ SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
         animation->initWithUUID(uuid);
         _caches.insert(uuid, animation);
         animation->autorelease();
+
+        uint64_t dataHash = SkeletonDataMgr::getInstance()->getDataHash(uuid);
+        if (_diskCacheEnabled && dataHash != 0) {
+            auto path = getDiskCachePath(uuid);
+            auto fileUtils = cc::FileUtils::getInstance();
+            if (fileUtils->isFileExist(path) && !animation->loadBakedData(fileUtils->getDataFromFile(path), dataHash)) {
+                CC_LOG_INFO("Baked data of skeleton %s is outdated, discarded.", uuid.c_str());
+                fileUtils->removeFile(path);
+            }
+        }
     }
     return animation;
 }
@@ -45,7 +85,131 @@ SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
 void SkeletonCacheMgr::removeSkeletonCache(const std::string &uuid) {
     auto it = _caches.find(uuid);
     if (it != _caches.end()) {
+        if (_diskCacheEnabled && it->second->isBakedDataDirty()) {
+            saveToDisk(uuid, it->second);
+        }
         _caches.erase(it);
     }
 }
+
+void SkeletonCacheMgr::flushDiskCache(bool wait) {
+    if (_diskCacheEnabled) {
+        for (auto it = _caches.begin(); it != _caches.end(); it++) {
+            if (it->second->isBakedDataDirty()) {
+                saveToDisk(it->first, it->second);
+            }
+        }
+    }
+    if (wait) {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+        _writeDoneCondition.wait(lock, [this]() { return _writeQueue.empty() && !_writing; });
+    }
+}
+
+std::string SkeletonCacheMgr::getDiskCachePath(const std::string &uuid) const {
+    auto fileUtils = cc::FileUtils::getInstance();
+    std::string folder = fileUtils->getWritablePath() + "spine-cache/";
+    if (!fileUtils->isDirectoryExist(folder)) {
+        fileUtils->createDirectory(folder);
+    }
+    // uuid may contain characters not allowed in file name
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)SkeletonDataMgr::hashData(uuid.data(), uuid.size()));
+    return folder + name + ".bin";
+}
+
+void SkeletonCacheMgr::saveToDisk(const std::string &uuid, SkeletonCache *cache) {
+    uint64_t dataHash = SkeletonDataMgr::getInstance()->getDataHash(uuid);
+    if (dataHash == 0) return;
+
+    cc::Data data = cache->saveBakedData(dataHash);
+    if (data.isNull()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _writeQueue.push_back({getDiskCachePath(uuid), std::move(data)});
+    }
+    if (!_writeThread.joinable()) {
+        _writeThread = std::thread(&SkeletonCacheMgr::writeLoop, this);
+    }
+    _writeCondition.notify_one();
+}
+
+void SkeletonCacheMgr::writeLoop() {
+    auto fileUtils = cc::FileUtils::getInstance();
+    std::unique_lock<std::mutex> lock(_writeMutex);
+    while (true) {
+        _writeCondition.wait(lock, [this]() { return _writeExit || !_writeQueue.empty(); });
+        // queued files are still written when exiting
+        if (_writeQueue.empty()) break;
+
+        DiskWrite write = std::move(_writeQueue.front());
+        _writeQueue.pop_front();
+        _writing = true;
+        lock.unlock();
+
+        // animations evicted by memory budget are missing in memory, keep them from the existing file
+        if (fileUtils->isFileExist(write.path)) {
+            write.data = SkeletonCache::mergeBakedData(write.data, fileUtils->getDataFromFile(write.path));
+        }
+        // through a temporary file so an interrupted write never leaves a torn cache behind
+        std::string tmpPath = write.path + ".tmp";
+        if (fileUtils->writeDataToFile(write.data, tmpPath)) {
+            fileUtils->renameFile(tmpPath, write.path);
+        }
+
+        lock.lock();
+        _writing = false;
+        _writeDoneCondition.notify_all();
+    }
+}
+
+void SkeletonCacheMgr::setMemoryBudget(std::size_t bytes) {
+    _memoryBudget = bytes;
+    checkMemoryBudget();
+}
+
+std::size_t SkeletonCacheMgr::getMemoryUsage() const {
+    std::size_t usage = 0;
+    for (auto animationData : _animationDatas) {
+        usage += animationData->getMemorySize();
+    }
+    return usage;
+}
+
+void SkeletonCacheMgr::addAnimationData(SkeletonCache::AnimationData *animationData) {
+    _animationDatas.push_back(animationData);
+}
+
+void SkeletonCacheMgr::removeAnimationData(SkeletonCache::AnimationData *animationData) {
+    auto it = std::find(_animationDatas.begin(), _animationDatas.end(), animationData);
+    if (it != _animationDatas.end()) {
+        _animationDatas.erase(it);
+    }
+}
+
+void SkeletonCacheMgr::checkMemoryBudget() {
+    if (_memoryBudget == 0) return;
+
+    auto usage = getMemoryUsage();
+    if (usage <= _memoryBudget) return;
+
+    // animations used in current frame may be rendering, never evict them
+    auto app = cc::Application::getInstance();
+    uint32_t curFrame = app ? app->getTotalFrames() : 0;
+    while (usage > _memoryBudget) {
+        SkeletonCache::AnimationData *lru = nullptr;
+        for (auto animationData : _animationDatas) {
+            if (animationData->getFrameCount() == 0 || animationData->getLastUsedFrame() == curFrame) continue;
+            if (!lru || animationData->getLastUsedFrame() < lru->getLastUsedFrame()) {
+                lru = animationData;
+            }
+        }
+        if (!lru) break;
+
+        usage -= lru->getMemorySize();
+        lru->reset();
+        usage += lru->getMemorySize();
+    }
+}
 } // namespace spine
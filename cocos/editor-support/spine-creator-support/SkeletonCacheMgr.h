@@ -30,6 +30,10 @@
 #pragma once
 #include "SkeletonCache.h"
 #include "base/Map.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace spine {
 
@@ -49,11 +53,58 @@ public:
         }
     }
 
+    SkeletonCacheMgr();
+    ~SkeletonCacheMgr();
+
     void removeSkeletonCache(const std::string &uuid);
     SkeletonCache *buildSkeletonCache(const std::string &uuid);
 
+    /**
+     * @brief Limit memory of baked frames of all skeleton caches, 0 means no limit.
+     * When it is exceeded, animations not used in current frame are evicted in
+     * least recently used order, and baked again next time they are played.
+     */
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getMemoryBudget() const { return _memoryBudget; }
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief Persist fully baked animations under writable path, so they are loaded
+     * instead of simulated on next launch. Files are invalidated by hash of source data.
+     * Disabled by default.
+     */
+    void setDiskCacheEnabled(bool value) { _diskCacheEnabled = value; }
+    bool isDiskCacheEnabled() const { return _diskCacheEnabled; }
+    // Write baked data of all skeleton caches which have new baked animations.
+    void flushDiskCache(bool wait = false);
+
+    void addAnimationData(SkeletonCache::AnimationData *animationData);
+    void removeAnimationData(SkeletonCache::AnimationData *animationData);
+    void checkMemoryBudget();
+
 private:
+    struct DiskWrite {
+        std::string path;
+        cc::Data data;
+    };
+
+    std::string getDiskCachePath(const std::string &uuid) const;
+    void saveToDisk(const std::string &uuid, SkeletonCache *cache);
+    void writeLoop();
+
     static SkeletonCacheMgr *_instance;
+    bool _diskCacheEnabled = false;
+    uint32_t _onPauseListenerID = 0;
+    // Files are written one at a time by a single thread, in the order they are queued.
+    std::thread _writeThread;
+    std::mutex _writeMutex;
+    std::condition_variable _writeCondition;
+    std::condition_variable _writeDoneCondition;
+    std::deque<DiskWrite> _writeQueue;
+    bool _writing = false;
+    bool _writeExit = false;
+    std::size_t _memoryBudget = 0;
+    std::vector<SkeletonCache::AnimationData *> _animationDatas;
     cc::Map<std::string, SkeletonCache *> _caches;
 };
 
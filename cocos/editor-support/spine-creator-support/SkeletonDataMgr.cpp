@@ -60,6 +60,7 @@ public:
     Atlas *atlas = nullptr;
     AttachmentLoader *attachmentLoader = nullptr;
     std::vector<int> texturesIndex;
+    uint64_t dataHash = 0;
 };
 
 } // namespace spine
@@ -71,7 +72,7 @@ bool SkeletonDataMgr::hasSkeletonData(const std::string &uuid) {
     return it != _dataMap.end();
 }
 
-void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex) {
+void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex, uint64_t dataHash) {
     auto it = _dataMap.find(uuid);
     if (it != _dataMap.end()) {
         releaseByUUID(uuid);
@@ -81,9 +82,30 @@ void SkeletonDataMgr::setSkeletonData(const std::string &uuid, SkeletonData *dat
     info->atlas = atlas;
     info->attachmentLoader = attachmentLoader;
     info->texturesIndex = texturesIndex;
+    info->dataHash = dataHash;
     _dataMap[uuid] = info;
 }
 
+Atlas *SkeletonDataMgr::getAtlas(const std::string &uuid) {
+    auto dataIt = _dataMap.find(uuid);
+    return dataIt != _dataMap.end() ? dataIt->second->atlas : nullptr;
+}
+
+uint64_t SkeletonDataMgr::getDataHash(const std::string &uuid) {
+    auto dataIt = _dataMap.find(uuid);
+    return dataIt != _dataMap.end() ? dataIt->second->dataHash : 0;
+}
+
+uint64_t SkeletonDataMgr::hashData(const void *data, std::size_t size, uint64_t seed) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 SkeletonData *SkeletonDataMgr::retainByUUID(const std::string &uuid) {
     auto dataIt = _dataMap.find(uuid);
     if (dataIt == _dataMap.end()) {
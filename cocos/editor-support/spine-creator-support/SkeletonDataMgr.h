@@ -66,9 +66,15 @@ public:
         _destroyCallback = NULL;
     }
     bool hasSkeletonData(const std::string &uuid);
-    void setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex);
+    // dataHash identifies the source skeleton and atlas content, 0 means unknown.
+    void setSkeletonData(const std::string &uuid, SkeletonData *data, Atlas *atlas, AttachmentLoader *attachmentLoader, const std::vector<int> &texturesIndex, uint64_t dataHash = 0);
     SkeletonData *retainByUUID(const std::string &uuid);
     void releaseByUUID(const std::string &uuid);
+    Atlas *getAtlas(const std::string &uuid);
+    uint64_t getDataHash(const std::string &uuid);
+
+    // 64-bit FNV-1a, stable across platforms so it can be persisted.
+    static uint64_t hashData(const void *data, std::size_t size, uint64_t seed = 14695981039346656037ULL);
 
     typedef std::function<void(int)> destroyCallback;
     void setDestroyCallback(destroyCallback callback) {
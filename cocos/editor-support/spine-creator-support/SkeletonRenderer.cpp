@@ -31,6 +31,7 @@
 #include "MiddlewareMacro.h"
 #include "SharedBufferManager.h"
 #include "SkeletonDataMgr.h"
+#include "VertexKernel.h"
 #include "base/TypeDef.h"
 #include "base/memory/Memory.h"
 #include "math/Math.h"
@@ -279,12 +280,10 @@ void SkeletonRenderer::render(float deltaTime) {
     auto mgr = MiddlewareManager::getInstance();
     if (!mgr->isRendering) return;
 
-    auto renderMgr = mgr->getRenderInfoMgr();
-    auto renderInfo = renderMgr->getBuffer();
+    auto renderInfo = mgr->getRenderInfoBuffer();
     if (!renderInfo) return;
 
-    auto attachMgr = mgr->getAttachInfoMgr();
-    auto attachInfo = attachMgr->getBuffer();
+    auto attachInfo = mgr->getAttachInfoBuffer();
     if (!attachInfo) return;
 
     //  store render info offset
@@ -482,9 +481,7 @@ void SkeletonRenderer::render(float deltaTime) {
                 vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 trianglesTwoColor.verts = (V2F_T2F_C4F_C4F *)vb.getCurBuffer();
-                for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                    trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-                }
+                copyVertexTexCoords((float *)trianglesTwoColor.verts, vs2, (float *)attachmentVertices->_triangles->verts, vs1, trianglesTwoColor.vertCount);
                 attachment->computeWorldVertices(slot->getBone(), (float *)trianglesTwoColor.verts, 0, vs2);
 
                 trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
@@ -540,9 +537,7 @@ void SkeletonRenderer::render(float deltaTime) {
                 vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4F_C4F);
                 isFull |= vb.checkSpace(vbSize, true);
                 trianglesTwoColor.verts = (V2F_T2F_C4F_C4F *)vb.getCurBuffer();
-                for (int ii = 0; ii < trianglesTwoColor.vertCount; ii++) {
-                    trianglesTwoColor.verts[ii].texCoord = attachmentVertices->_triangles->verts[ii].texCoord;
-                }
+                copyVertexTexCoords((float *)trianglesTwoColor.verts, vs2, (float *)attachmentVertices->_triangles->verts, vs1, trianglesTwoColor.vertCount);
                 attachment->computeWorldVertices(*slot, 0, attachment->getWorldVerticesLength(), (float *)trianglesTwoColor.verts, 0, vs2);
 
                 trianglesTwoColor.indexCount = attachmentVertices->_triangles->indexCount;
@@ -663,17 +658,8 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color.a = lightCopy.a;
                     }
                 } else {
-                    for (int v = 0, vn = triangles.vertCount, vv = 0; v < vn; ++v, vv += 2) {
-                        V2F_T2F_C4F *vertex = triangles.verts + v;
-                        vertex->vertex.x = verts[vv];
-                        vertex->vertex.y = verts[vv + 1];
-                        vertex->texCoord.u = uvs[vv];
-                        vertex->texCoord.v = uvs[vv + 1];
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                    }
+                    copyClippedVertices((float *)triangles.verts, vs1, verts, uvs, triangles.vertCount);
+                    fillVertexColors((float *)triangles.verts, triangles.vertCount, vs1, Color4F(light.r, light.g, light.b, light.a));
                 }
                 // No cliping logic
             } else {
@@ -698,13 +684,7 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color.a = lightCopy.a;
                     }
                 } else {
-                    for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F *vertex = triangles.verts + v;
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                    }
+                    fillVertexColors((float *)triangles.verts, triangles.vertCount, vs1, Color4F(light.r, light.g, light.b, light.a));
                 }
             }
         }
@@ -762,21 +742,9 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color2.a = dark.a;
                     }
                 } else {
-                    for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
-                        V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                        vertex->vertex.x = verts[vv];
-                        vertex->vertex.y = verts[vv + 1];
-                        vertex->texCoord.u = uvs[vv];
-                        vertex->texCoord.v = uvs[vv + 1];
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                        vertex->color2.r = dark.r;
-                        vertex->color2.g = dark.g;
-                        vertex->color2.b = dark.b;
-                        vertex->color2.a = dark.a;
-                    }
+                    Color4F darkF(dark.r, dark.g, dark.b, dark.a);
+                    copyClippedVertices((float *)trianglesTwoColor.verts, vs2, verts, uvs, trianglesTwoColor.vertCount);
+                    fillVertexColors((float *)trianglesTwoColor.verts, trianglesTwoColor.vertCount, vs2, Color4F(light.r, light.g, light.b, light.a), &darkF);
                 }
             } else {
 
@@ -807,17 +775,8 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color2.a = dark.a;
                     }
                 } else {
-                    for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                        vertex->color2.r = dark.r;
-                        vertex->color2.g = dark.g;
-                        vertex->color2.b = dark.b;
-                        vertex->color2.a = dark.a;
-                    }
+                    Color4F darkF(dark.r, dark.g, dark.b, dark.a);
+                    fillVertexColors((float *)trianglesTwoColor.verts, trianglesTwoColor.vertCount, vs2, Color4F(light.r, light.g, light.b, light.a), &darkF);
                 }
             }
         }
@@ -832,15 +791,7 @@ void SkeletonRenderer::render(float deltaTime) {
 
         if (vbSize > 0 && ibSize > 0) {
             if (_batch) {
-                uint8_t *vbBuffer = vb.getCurBuffer();
-                cc::Vec3 *point = nullptr;
-                for (int ii = 0, nn = vbSize; ii < nn; ii += vbs) {
-                    point = (cc::Vec3 *)(vbBuffer + ii);
-                    // force z value to zero
-                    point->z = 0;
-                    point->x = point->x * nodeWorldMat.m[0] + point->y * nodeWorldMat.m[4] + nodeWorldMat.m[12]; // x
-                    point->y = point->y * nodeWorldMat.m[1] + point->y * nodeWorldMat.m[5] + nodeWorldMat.m[13]; // y
-                }
+                transformVertices((float *)vb.getCurBuffer(), vbSize / vbs, vbs / sizeof(float), nodeWorldMat);
             }
 
             if (vertexOffset > 0) {
@@ -914,6 +865,16 @@ void SkeletonRenderer::render(float deltaTime) {
     }
 }
 
+bool SkeletonRenderer::canRenderInParallel() const {
+    // debug buffer is created as script typed array, vertex effect may be shared with other skeletons
+    return !_debugSlots && !_debugBones && !_debugMesh && !_effectDelegate;
+}
+
+void SkeletonRenderer::relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) {
+    _sharedBufferOffset->writeUint32(0, renderInfoOffset);
+    _sharedBufferOffset->writeUint32(sizeof(uint32_t), attachInfoOffset);
+}
+
 cc::Rect SkeletonRenderer::getBoundingBox() const {
     static IOBuffer buffer(1024);
     float *worldVertices = nullptr;
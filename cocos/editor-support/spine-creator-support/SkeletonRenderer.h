@@ -57,6 +57,8 @@ public:
     virtual void render(float deltaTime) override;
     virtual cc::Rect getBoundingBox() const;
     virtual uint32_t getRenderOrder() const override;
+    virtual bool canRenderInParallel() const override;
+    virtual void relocateRenderData(uint32_t renderInfoOffset, uint32_t attachInfoOffset) override;
 
     Skeleton *getSkeleton() const;
 
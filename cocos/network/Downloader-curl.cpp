@@ -27,12 +27,19 @@
 #include <set>
 #include <curl/curl.h>
 #include <deque>
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
 
 #include "base/Scheduler.h"
 #include "platform/FileUtils.h"
 #include "platform/Application.h"
 #include "network/Downloader.h"
 
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+    #include <unistd.h>
+#endif
+
 // **NOTE**
 // In the file:
 // member function with suffix "Proc" designed called in DownloaderCURL::_threadProc
@@ -42,6 +49,16 @@
     #define CC_CURL_POLL_TIMEOUT_MS 50
 #endif
 
+// attempts without progress before a failing segment fails its whole task
+#ifndef CC_CURL_SEGMENT_MAX_RETRIES
+    #define CC_CURL_SEGMENT_MAX_RETRIES 3
+#endif
+
+// interval between two saves of the segment journal while downloading
+#ifndef CC_CURL_SEGMENT_JOURNAL_INTERVAL_MS
+    #define CC_CURL_SEGMENT_JOURNAL_INTERVAL_MS 1000
+#endif
+
 namespace cc {
 namespace network {
 using namespace std;
@@ -49,6 +66,29 @@ using namespace std;
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloadTaskCURL
 
+// write the whole buffer at offset, independent of the current file position
+static bool writeFileAt(FILE *fp, int64_t offset, const unsigned char *buffer, size_t size) {
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    // all writes happen on the download thread, so seek + write can't interleave
+    if (0 != _fseeki64(fp, offset, SEEK_SET)) {
+        return false;
+    }
+    return size == fwrite(buffer, 1, size, fp);
+#else
+    int fd = fileno(fp);
+    while (size) {
+        ssize_t written = pwrite(fd, buffer, size, static_cast<off_t>(offset));
+        if (written <= 0) {
+            return false;
+        }
+        buffer += written;
+        offset += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+#endif
+}
+
 class DownloadTaskCURL : public IDownloadTask {
     static int _sSerialId;
 
@@ -152,6 +192,136 @@ public:
         _errDescription = desc;
     }
 
+    // byte range [begin, end) of a file task fetched by its own curl handle
+    struct Segment {
+        DownloadTaskCURL *task;
+        CURL *handle;
+        int64_t begin;
+        int64_t end;
+        int64_t received;
+        int64_t receivedAtStart; // received when the current attempt started
+        int retries;
+        bool rangeConfirmed;
+    };
+
+    string journalFileName() const {
+        return _tempFileName + ".segments";
+    }
+
+    // reopen the temp file so that writes land at their offset instead of being appended
+    bool reopenForSegmentsProc(bool truncate) {
+        lock_guard<mutex> lock(_mutex);
+        if (_fp) {
+            fclose(_fp);
+        }
+        _fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_tempFileName).c_str(), truncate ? "w+b" : "r+b");
+        return nullptr != _fp;
+    }
+
+    // split [0, total) into count segments, the last one takes the remainder
+    void createSegmentsProc(int64_t total, uint32_t count) {
+        _segments.clear();
+        _segments.reserve(count);
+        int64_t length = total / count;
+        for (uint32_t i = 0; i < count; ++i) {
+            int64_t begin = length * i;
+            int64_t end = (i + 1 == count) ? total : begin + length;
+            _segments.push_back({this, nullptr, begin, end, 0, 0, 0, false});
+        }
+        _segmentsDirty = true;
+    }
+
+    // restore the segments of an interrupted download of the same total size
+    bool loadSegmentsProc(int64_t total) {
+        FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(journalFileName()).c_str(), "rb");
+        if (nullptr == fp) {
+            return false;
+        }
+        bool ret = false;
+        do {
+            int64_t journalTotal = 0;
+            uint32_t count = 0;
+            if (2 != fscanf(fp, "%" SCNd64 " %" SCNu32, &journalTotal, &count) || journalTotal != total || 0 == count) {
+                break;
+            }
+            _segments.clear();
+            _segments.reserve(count);
+            int64_t expectedBegin = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                Segment segment = {this, nullptr, 0, 0, 0, 0, 0, false};
+                if (3 != fscanf(fp, "%" SCNd64 " %" SCNd64 " %" SCNd64, &segment.begin, &segment.end, &segment.received) ||
+                    segment.begin != expectedBegin || segment.end <= segment.begin ||
+                    segment.received < 0 || segment.received > segment.end - segment.begin) {
+                    break;
+                }
+                expectedBegin = segment.end;
+                _segments.push_back(segment);
+            }
+            ret = _segments.size() == count && expectedBegin == total;
+        } while (0);
+        fclose(fp);
+
+        if (!ret) {
+            _segments.clear();
+        }
+        return ret;
+    }
+
+    // the journal never claims bytes that are not in the temp file yet
+    void saveSegmentsProc() {
+        if (_segments.empty() || !_segmentsDirty) {
+            return;
+        }
+        {
+            lock_guard<mutex> lock(_mutex);
+            if (_fp) {
+                fflush(_fp);
+            }
+        }
+        FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(journalFileName()).c_str(), "wb");
+        if (nullptr == fp) {
+            return;
+        }
+        fprintf(fp, "%" PRId64 " %u\n", _segments.back().end, static_cast<unsigned>(_segments.size()));
+        for (const auto &segment : _segments) {
+            fprintf(fp, "%" PRId64 " %" PRId64 " %" PRId64 "\n", segment.begin, segment.end, segment.received);
+        }
+        fclose(fp);
+        _segmentsDirty = false;
+    }
+
+    int64_t segmentsReceivedProc() const {
+        int64_t received = 0;
+        for (const auto &segment : _segments) {
+            received += segment.received;
+        }
+        return received;
+    }
+
+    size_t writeSegmentProc(Segment &segment, unsigned char *buffer, size_t size, size_t count) {
+        size_t len = size * count;
+        if (!segment.rangeConfirmed) {
+            // a server answering 200 ignored the range and sends the whole file
+            long httpResponseCode = 0;
+            curl_easy_getinfo(segment.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+            if (206 != httpResponseCode) {
+                return 0;
+            }
+            segment.rangeConfirmed = true;
+        }
+
+        lock_guard<mutex> lock(_mutex);
+        int64_t offset = segment.begin + segment.received;
+        if (!_fp || offset + static_cast<int64_t>(len) > segment.end || !writeFileAt(_fp, offset, buffer, len)) {
+            return 0;
+        }
+        segment.received += len;
+        _segmentsDirty = true;
+        _bytesReceived += len;
+        _totalBytesReceived += len;
+        return len;
+    }
+
     size_t writeDataProc(unsigned char *buffer, size_t size, size_t count) {
         lock_guard<mutex> lock(_mutex);
         size_t ret = 0;
@@ -201,6 +371,10 @@ private:
     vector<unsigned char> _buf;
     FILE *_fp;
 
+    // parallel ranges of a segmented file task, only used in thread proc
+    vector<Segment> _segments;
+    bool _segmentsDirty;
+
     void _initInternal() {
         _acceptRanges = (false);
         _headerAchieved = (false);
@@ -211,6 +385,8 @@ private:
         _errCodeInternal = (CURLE_OK);
         _header.resize(0);
         _header.reserve(384); // pre alloc header string buffer
+        _segments.clear();
+        _segmentsDirty = false;
     }
 };
 int DownloadTaskCURL::_sSerialId;
@@ -295,10 +471,16 @@ private:
         return coTask->writeDataProc((unsigned char *)buffer, size, count);
     }
 
+    static size_t _outputSegmentDataCallbackProc(void *buffer, size_t size, size_t count, void *userdata) {
+        DownloadTaskCURL::Segment *segment = (DownloadTaskCURL::Segment *)userdata;
+        return segment->task->writeSegmentProc(*segment, (unsigned char *)buffer, size, count);
+    }
+
     // this function designed call in work thread
     // the curl handle destroyed in _threadProc
     // handle inited for get header
-    void _initCurlHandleProc(CURL *handle, TaskWrapper &wrapper, bool forContent = false) {
+    // handle inited with segment only downloads the remaining part of that segment
+    void _initCurlHandleProc(CURL *handle, TaskWrapper &wrapper, bool forContent = false, DownloadTaskCURL::Segment *segment = nullptr) {
         const DownloadTask &task = *wrapper.first;
         const DownloadTaskCURL *coTask = wrapper.second;
 
@@ -306,12 +488,21 @@ private:
         curl_easy_setopt(handle, CURLOPT_URL, task.requestURL.c_str());
 
         // set write func
-        if (forContent) {
+        if (segment) {
+            char range[64];
+            snprintf(range, sizeof(range), "%" PRId64 "-%" PRId64, segment->begin + segment->received, segment->end - 1);
+            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputSegmentDataCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, segment);
+            curl_easy_setopt(handle, CURLOPT_PRIVATE, segment);
+            curl_easy_setopt(handle, CURLOPT_RANGE, range);
+        } else if (forContent) {
             curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputDataCallbackProc);
         } else {
             curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputHeaderCallbackProc);
         }
-        curl_easy_setopt(handle, CURLOPT_WRITEDATA, coTask);
+        if (!segment) {
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, coTask);
+        }
 
         curl_easy_setopt(handle, CURLOPT_NOPROGRESS, true);
         //            curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, DownloaderCURL::Impl::_progressCallbackProc);
@@ -322,7 +513,7 @@ private:
 
         if (forContent) {
             /** if server acceptRanges and local has part of file, we continue to download **/
-            if (coTask->_acceptRanges && coTask->_totalBytesReceived > 0) {
+            if (!segment && coTask->_acceptRanges && coTask->_totalBytesReceived > 0) {
                 curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)coTask->_totalBytesReceived);
             }
         } else {
@@ -386,11 +577,21 @@ private:
                 fileSize = FileUtils::getInstance()->getFileSize(coTask._tempFileName);
             }
 
+            bool segmented = false;
+            if (coTask._fp && !_initSegmentsProc(coTask, acceptRanges, (int64_t)contentLen, fileSize, segmented)) {
+                string desc = "Can't reopen file: ";
+                desc.append(coTask._tempFileName);
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, desc.c_str());
+                break;
+            }
+
             // set header info to coTask
             lock_guard<mutex> lock(coTask._mutex);
             coTask._totalBytesExpected = (int64_t)contentLen;
             coTask._acceptRanges = acceptRanges;
-            if (acceptRanges && fileSize > 0) {
+            if (segmented) {
+                coTask._totalBytesReceived = coTask.segmentsReceivedProc();
+            } else if (acceptRanges && fileSize > 0) {
                 coTask._totalBytesReceived = fileSize;
             }
             coTask._headerAchieved = true;
@@ -402,6 +603,123 @@ private:
         return coTask._headerAchieved;
     }
 
+    // decide whether a file task is downloaded in segments, fileSize is reset if the temp file is dropped
+    // return false only if the temp file can't be reopened
+    bool _initSegmentsProc(DownloadTaskCURL &coTask, bool acceptRanges, int64_t total, int64_t &fileSize, bool &segmented) {
+        auto util = FileUtils::getInstance();
+        string journal = coTask.journalFileName();
+        segmented = false;
+
+        // a journal means the temp file was written out of order by an earlier run,
+        // it's only usable if the same file can still be fetched in ranges
+        if (util->isFileExist(journal)) {
+            if (acceptRanges && coTask.loadSegmentsProc(total)) {
+                segmented = true;
+                return coTask.reopenForSegmentsProc(false);
+            }
+            util->removeFile(journal);
+            fileSize = 0;
+            if (!coTask.reopenForSegmentsProc(true)) {
+                return false;
+            }
+        }
+
+        // a partial file without journal keeps resuming sequentially
+        uint32_t count = hints.countOfSegmentsPerTask;
+        int64_t minSize = std::max<int64_t>(hints.minSegmentSize, 1);
+        if (!acceptRanges || fileSize > 0 || count < 2 || total < minSize * 2) {
+            return true;
+        }
+        if (total / minSize < count) {
+            count = static_cast<uint32_t>(total / minSize);
+        }
+        if (!coTask.reopenForSegmentsProc(false)) {
+            return false;
+        }
+        coTask.createSegmentsProc(total, count);
+        coTask.saveSegmentsProc();
+        segmented = true;
+        return true;
+    }
+
+    // add a handle for every unfinished segment of the task
+    bool _startSegmentsProc(CURLM *curlmHandle, TaskWrapper &wrapper, unordered_map<CURL *, TaskWrapper> &coTaskMap) {
+        for (auto &segment : wrapper.second->_segments) {
+            if (segment.received == segment.end - segment.begin) {
+                continue;
+            }
+            if (!_addSegmentProc(curlmHandle, wrapper, segment, coTaskMap)) {
+                _abortSegmentsProc(curlmHandle, *wrapper.second, coTaskMap);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool _addSegmentProc(CURLM *curlmHandle, TaskWrapper &wrapper, DownloadTaskCURL::Segment &segment, unordered_map<CURL *, TaskWrapper> &coTaskMap) {
+        CURL *curlHandle = curl_easy_init();
+        if (nullptr == curlHandle) {
+            wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+            return false;
+        }
+        segment.handle = curlHandle;
+        segment.rangeConfirmed = false;
+        segment.receivedAtStart = segment.received;
+        _initCurlHandleProc(curlHandle, wrapper, true, &segment);
+        CURLMcode mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+        if (CURLM_OK != mcode) {
+            wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+            curl_easy_cleanup(curlHandle);
+            segment.handle = nullptr;
+            return false;
+        }
+        coTaskMap[curlHandle] = wrapper;
+        return true;
+    }
+
+    // stop the segments still downloading, used once the task has failed
+    void _abortSegmentsProc(CURLM *curlmHandle, DownloadTaskCURL &coTask, unordered_map<CURL *, TaskWrapper> &coTaskMap) {
+        for (auto &segment : coTask._segments) {
+            if (segment.handle) {
+                curl_multi_remove_handle(curlmHandle, segment.handle);
+                curl_easy_cleanup(segment.handle);
+                coTaskMap.erase(segment.handle);
+                segment.handle = nullptr;
+            }
+        }
+    }
+
+    // a segment handle is done, retry it with the remaining range if it failed
+    // return true if the handle was added again
+    bool _segmentDoneProc(CURLM *curlmHandle, CURLcode errCode, TaskWrapper &wrapper, DownloadTaskCURL::Segment &segment) {
+        DownloadTaskCURL &coTask = *wrapper.second;
+        if (CURLE_OK == errCode && segment.received != segment.end - segment.begin) {
+            // the connection closed before the range was complete
+            errCode = CURLE_PARTIAL_FILE;
+        }
+        if (CURLE_OK == errCode) {
+            coTask.saveSegmentsProc();
+            return false;
+        }
+
+        // only failures without progress count towards the limit
+        segment.retries = segment.received > segment.receivedAtStart ? 0 : segment.retries + 1;
+        if (DownloadTask::ERROR_NO_ERROR == coTask._errCode && segment.retries <= CC_CURL_SEGMENT_MAX_RETRIES) {
+            DLLOG("    _threadProc retry segment %" PRId64 "-%" PRId64 " of task %d: %s", segment.begin, segment.end, coTask.serialId, curl_easy_strerror(errCode));
+            curl_easy_reset(segment.handle);
+            segment.rangeConfirmed = false;
+            segment.receivedAtStart = segment.received;
+            _initCurlHandleProc(segment.handle, wrapper, true, &segment);
+            if (CURLM_OK == curl_multi_add_handle(curlmHandle, segment.handle)) {
+                return true;
+            }
+        }
+
+        coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+        coTask.saveSegmentsProc();
+        return false;
+    }
+
     void _threadProc() {
         DLLOG("++++DownloaderCURL::Impl::_threadProc begin %p", this);
         // the holder prevent DownloaderCURL::Impl class instance be destruct in main thread
@@ -414,6 +732,7 @@ private:
         int runningHandles = 0;
         CURLMcode mcode = CURLM_OK;
         int rc = 0; // select return code
+        auto lastJournalSave = chrono::steady_clock::now();
 
         do {
             // check the thread should exit or not
@@ -484,12 +803,26 @@ private:
                         CURL *curlHandle = m->easy_handle;
                         CURLcode errCode = m->data.result;
 
-                        TaskWrapper wrapper = coTaskMap[curlHandle];
+                        auto found = coTaskMap.find(curlHandle);
+                        if (coTaskMap.end() == found) {
+                            // an aborted segment of a failed task
+                            continue;
+                        }
+                        TaskWrapper wrapper = found->second;
 
                         // remove from multi-handle
                         curl_multi_remove_handle(curlmHandle, curlHandle);
                         bool reinited = false;
-                        do {
+                        bool segmentsStarted = false;
+
+                        DownloadTaskCURL::Segment *segment = nullptr;
+                        curl_easy_getinfo(curlHandle, CURLINFO_PRIVATE, (char **)&segment);
+                        if (segment) {
+                            reinited = _segmentDoneProc(curlmHandle, errCode, wrapper, *segment);
+                            if (!reinited) {
+                                segment->handle = nullptr;
+                            }
+                        } else do {
                             if (CURLE_OK != errCode) {
                                 wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
                                 break;
@@ -516,6 +849,13 @@ private:
                                 // break to move this task to finish queue
                                 break;
                             }
+
+                            // segmented task, the header handle is replaced by one handle per segment
+                            if (!wrapper.second->_segments.empty()) {
+                                segmentsStarted = _startSegmentsProc(curlmHandle, wrapper, coTaskMap);
+                                break;
+                            }
+
                             // reinit curl handle for download content
                             curl_easy_reset(curlHandle);
                             _initCurlHandleProc(curlHandle, wrapper, true);
@@ -536,6 +876,22 @@ private:
                         // remove from coTaskMap
                         coTaskMap.erase(curlHandle);
 
+                        if (segment) {
+                            // a failed segment takes the others down, otherwise wait for all of them
+                            if (DownloadTask::ERROR_NO_ERROR != wrapper.second->_errCode) {
+                                _abortSegmentsProc(curlmHandle, *wrapper.second, coTaskMap);
+                            }
+                            bool downloading = false;
+                            for (const auto &other : wrapper.second->_segments) {
+                                downloading = downloading || nullptr != other.handle;
+                            }
+                            if (downloading) {
+                                continue;
+                            }
+                        } else if (segmentsStarted) {
+                            continue;
+                        }
+
                         // remove from _processSet
                         {
                             lock_guard<mutex> lock(_processMutex);
@@ -551,10 +907,23 @@ private:
                         }
                     }
                 } while (m);
+
+                // keep the journals of segmented tasks close to the temp files
+                auto now = chrono::steady_clock::now();
+                if (now - lastJournalSave >= chrono::milliseconds(CC_CURL_SEGMENT_JOURNAL_INTERVAL_MS)) {
+                    lastJournalSave = now;
+                    for (auto &item : coTaskMap) {
+                        item.second.second->saveSegmentsProc();
+                    }
+                }
             }
 
-            // process tasks in _requestList
-            auto size = coTaskMap.size();
+            // process tasks in _requestList, a segmented task counts once however many handles it has
+            size_t size = 0;
+            {
+                lock_guard<mutex> lock(_processMutex);
+                size = _processSet.size();
+            }
             while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks) {
                 // get task wrapper from request queue
                 TaskWrapper wrapper;
@@ -599,6 +968,7 @@ private:
                 coTaskMap[curlHandle] = wrapper;
                 lock_guard<mutex> lock(_processMutex);
                 _processSet.insert(wrapper);
+                ++size;
             }
         } while (coTaskMap.size());
 
@@ -738,6 +1108,11 @@ void DownloaderCURL::_onSchedule(float) {
                     break;
                 }
 
+                // a failed segmented download stays in the temp file next to its journal to be resumed
+                if (!coTask._segments.empty() && DownloadTask::ERROR_NO_ERROR != coTask._errCode) {
+                    break;
+                }
+
                 auto util = FileUtils::getInstance();
                 // if file already exist, remove it
                 if (util->isFileExist(coTask._fileName)) {
@@ -754,6 +1129,9 @@ void DownloaderCURL::_onSchedule(float) {
                 if (util->renameFile(coTask._tempFileName, coTask._fileName)) {
                     // success, remove storage from set
                     DownloadTaskCURL::_sStoragePathSet.erase(coTask._tempFileName);
+                    if (!coTask._segments.empty()) {
+                        util->removeFile(coTask.journalFileName());
+                    }
                     break;
                 }
                 // failed
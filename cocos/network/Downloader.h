@@ -66,6 +66,11 @@ struct CC_DLL DownloaderHints {
     uint32_t countOfMaxProcessingTasks;
     uint32_t timeoutInSeconds;
     std::string tempFileNameSuffix;
+    // Only used by the curl implementation: file tasks on servers accepting ranges
+    // are split into up to countOfSegmentsPerTask byte ranges of at least
+    // minSegmentSize bytes, downloaded on parallel connections.
+    uint32_t countOfSegmentsPerTask = 1;
+    int64_t minSegmentSize = 1 << 20;
 };
 
 class CC_DLL Downloader final {
@@ -374,7 +374,7 @@ void HttpClient::send(HttpRequest *request) {
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    enqueueRequest(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -462,6 +462,18 @@ void HttpClient::processResponse(HttpResponse *response, char *responseMessage)
                            response->getResponseHeader(),
                            responseMessage);
 
+    // NSURLConnection collected the whole body already, pass it on as a single chunk
+    std::vector<char> *recvBuffer = response->getResponseData();
+    response->setContentLength(recvBuffer->size());
+    const ccHttpRequestDataCallback &dataCallback = request->getResponseDataCallback();
+    if (dataCallback) {
+        if (retValue != 0 && !dataCallback(response, recvBuffer->data(), recvBuffer->size())) {
+            retValue = 0;
+            strcpy(responseMessage, "aborted by the response data callback");
+        }
+        std::vector<char>().swap(*recvBuffer);
+    }
+
     // write data to HttpResponse
     response->setResponseCode(responseCode);
 
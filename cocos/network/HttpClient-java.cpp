@@ -661,9 +661,18 @@ void HttpClient::processResponse(HttpResponse *response, char *responseMessage)
     int contentLength = urlConnection.getResponseHeaderByKeyInt("Content-Length");
     char *contentInfo = urlConnection.getResponseContent(response);
     if (nullptr != contentInfo) {
-        std::vector<char> *recvBuffer = (std::vector<char> *)response->getResponseData();
-        recvBuffer->clear();
-        recvBuffer->insert(recvBuffer->begin(), (char *)contentInfo, ((char *)contentInfo) + urlConnection.getContentLength());
+        // the body arrives in one piece here, pass it on as a single chunk
+        const ccHttpRequestDataCallback &dataCallback = request->getResponseDataCallback();
+        response->setContentLength(urlConnection.getContentLength());
+        if (dataCallback) {
+            if (!dataCallback(response, contentInfo, urlConnection.getContentLength())) {
+                responseCode = -1;
+            }
+        } else {
+            std::vector<char> *recvBuffer = (std::vector<char> *)response->getResponseData();
+            recvBuffer->clear();
+            recvBuffer->insert(recvBuffer->begin(), (char *)contentInfo, ((char *)contentInfo) + urlConnection.getContentLength());
+        }
     }
     free(contentInfo);
 
@@ -858,7 +867,7 @@ void HttpClient::send(HttpRequest *request) {
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    enqueueRequest(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
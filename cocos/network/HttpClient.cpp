@@ -26,6 +26,8 @@
  ****************************************************************************/
 
 #include "network/HttpClient.h"
+#include <algorithm>
+#include <chrono>
 #include <queue>
 #include <errno.h>
 #include <curl/curl.h>
@@ -34,6 +36,10 @@
 #include "platform/StdC.h"
 #include "base/Log.h"
 
+#ifndef CC_CURL_POLL_TIMEOUT_MS
+    #define CC_CURL_POLL_TIMEOUT_MS 50
+#endif
+
 namespace cc {
 
 namespace network {
@@ -44,15 +50,64 @@ typedef int int32_t;
 
 static HttpClient *_httpClient = nullptr; // pointer to singleton
 
-typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
+// Curl handles owned by a client
+struct CurlContext {
+    // Every request runs concurrently on this handle, it owns the connection cache so
+    // keep-alive connections are reused from one request to the next.
+    CURLM *multiHandle = nullptr;
+    // DNS entries, TLS sessions and cookies are shared by every easy handle.
+    CURLSH *shareHandle = nullptr;
+    std::mutex shareMutexes[CURL_LOCK_DATA_LAST];
+};
+
+static void lockShareData(CURL * /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void *userptr) {
+    static_cast<CurlContext *>(userptr)->shareMutexes[data].lock();
+}
+
+static void unlockShareData(CURL * /*handle*/, curl_lock_data data, void *userptr) {
+    static_cast<CurlContext *>(userptr)->shareMutexes[data].unlock();
+}
+
+// State of a request while curl works on it
+struct HttpTransfer {
+    CURL *handle = nullptr;
+    HttpResponse *response = nullptr;
+    curl_slist *headers = nullptr;
+    bool receivingBody = false;
+    char errorBuffer[CURL_ERROR_SIZE] = {0};
+};
 
 // Callback function used by libcurl for collect response data
 static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream) {
-    std::vector<char> *recvBuffer = (std::vector<char> *)stream;
+    auto *transfer = static_cast<HttpTransfer *>(stream);
+    HttpResponse *response = transfer->response;
     size_t sizes = size * nmemb;
 
+    if (!transfer->receivingBody) {
+        // the headers of the final response are complete by now
+        transfer->receivingBody = true;
+#if LIBCURL_VERSION_NUM >= 0x073700
+        curl_off_t contentLength = -1;
+        curl_easy_getinfo(transfer->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength);
+#else
+        double contentLength = -1;
+        curl_easy_getinfo(transfer->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLength);
+#endif
+        response->setContentLength(static_cast<int64_t>(contentLength));
+        if (contentLength > 0 && !response->getHttpRequest()->getResponseDataCallback()) {
+            response->getResponseData()->reserve(static_cast<size_t>(contentLength));
+        }
+    }
+
+    const ccHttpRequestDataCallback &dataCallback = response->getHttpRequest()->getResponseDataCallback();
+    if (dataCallback) {
+        // returning less than sizes makes curl abort with CURLE_WRITE_ERROR
+        return dataCallback(response, static_cast<const char *>(ptr), sizes) ? sizes : 0;
+    }
+
     // add data to the end of recvBuffer
     // write data maybe called more than once in a single request
+    std::vector<char> *recvBuffer = response->getResponseData();
     recvBuffer->insert(recvBuffer->end(), (char *)ptr, (char *)ptr + sizes);
 
     return sizes;
@@ -70,91 +125,13 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
     return sizes;
 }
 
-static int processGetTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processPostTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processPutTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processDeleteTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread() {
-    increaseThreadCount();
-
-    while (true) {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty()) {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (auto sche = _scheduler.lock()) {
-            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
-    }
-
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest *request, HttpResponse *response) {
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = {0};
-    processResponse(response, responseMessage);
-
-    _schedulerMutex.lock();
-    if (auto sche = _scheduler.lock()) {
-        sche->performFunctionInCocosThread([this, response, request] {
-            const ccHttpRequestCallback &callback = request->getResponseCallback();
-
-            if (callback != nullptr) {
-                callback(this, response);
-            }
-            response->release();
-            // do not release in other thread
-            request->release();
-        });
-    }
-    _schedulerMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
+template <class T>
+static bool setOption(CURL *handle, CURLoption option, T data) {
+    return CURLE_OK == curl_easy_setopt(handle, option, data);
 }
 
 //Configure curl's timeout property
-static bool configureCURL(HttpClient *client, HttpRequest *request, CURL *handle, char *errorBuffer) {
+static bool configureCURL(HttpClient *client, CURLSH *shareHandle, HttpRequest *request, CURL *handle, char *errorBuffer) {
     if (!handle) {
         return false;
     }
@@ -164,11 +141,12 @@ static bool configureCURL(HttpClient *client, HttpRequest *request, CURL *handle
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, request->getTimeout());
+    const long timeoutMS = static_cast<long>(request->getTimeout() * 1000);
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, timeoutMS);
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, request->getTimeout());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, timeoutMS);
     if (code != CURLE_OK) {
         return false;
     }
@@ -189,117 +167,283 @@ static bool configureCURL(HttpClient *client, HttpRequest *request, CURL *handle
 
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
 
+    curl_easy_setopt(handle, CURLOPT_SHARE, shareHandle);
+
+#if LIBCURL_VERSION_NUM >= 0x072F00
+    // Negotiate HTTP/2 on https, requests to the same host then wait for the first connection
+    // and multiplex on it instead of each paying for a handshake.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
     return true;
 }
 
-class CURLRaii {
-    /// Instance of CURL
-    CURL *_curl;
-    /// Keeps custom header data
-    curl_slist *_headers;
-
-public:
-    CURLRaii()
-    : _curl(curl_easy_init()),
-      _headers(nullptr) {
+// Sets up the handle to run the request of transfer
+static bool setupTransfer(HttpClient *client, CURLSH *shareHandle, CURL *handle, HttpTransfer *transfer) {
+    HttpRequest *request = transfer->response->getHttpRequest();
+    transfer->handle = handle;
+    if (!configureCURL(client, shareHandle, request, handle, transfer->errorBuffer)) {
+        return false;
     }
 
-    ~CURLRaii() {
-        if (_curl)
-            curl_easy_cleanup(_curl);
-        /* free the linked list for header data */
-        if (_headers)
-            curl_slist_free_all(_headers);
+    /* get custom header data (if set) */
+    std::vector<std::string> headers = request->getHeaders();
+    if (!headers.empty()) {
+        /* append custom headers one by one */
+        for (auto &header : headers)
+            transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+        /* set custom headers for curl */
+        if (!setOption(handle, CURLOPT_HTTPHEADER, transfer->headers))
+            return false;
+    }
+    std::string cookieFilename = client->getCookieFilename();
+    if (!cookieFilename.empty()) {
+        if (!setOption(handle, CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
+            return false;
+        }
+        if (!setOption(handle, CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+            return false;
+        }
     }
 
-    template <class T>
-    bool setOption(CURLoption option, T data) {
-        return CURLE_OK == curl_easy_setopt(_curl, option, data);
+    bool ok = setOption(handle, CURLOPT_URL, request->getUrl()) && setOption(handle, CURLOPT_WRITEFUNCTION, writeData) && setOption(handle, CURLOPT_WRITEDATA, transfer) && setOption(handle, CURLOPT_HEADERFUNCTION, writeHeaderData) && setOption(handle, CURLOPT_HEADERDATA, transfer->response->getResponseHeader()) && setOption(handle, CURLOPT_PRIVATE, transfer);
+    if (!ok) {
+        return false;
     }
 
-    /**
-     * @brief Inits CURL instance for common usage
-     * @param request Null not allowed
-     * @param callback Response write callback
-     * @param stream Response write stream
-     */
-    bool init(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-        if (!_curl)
-            return false;
-        if (!configureCURL(client, request, _curl, errorBuffer))
+    const long requestDataSize = static_cast<long>(request->getRequestDataSize());
+    switch (request->getRequestType()) {
+        case HttpRequest::Type::GET: // HTTP GET
+            return setOption(handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+        case HttpRequest::Type::POST: // HTTP POST
+            return setOption(handle, CURLOPT_POST, 1L) && setOption(handle, CURLOPT_POSTFIELDS, request->getRequestData()) && setOption(handle, CURLOPT_POSTFIELDSIZE, requestDataSize);
+
+        case HttpRequest::Type::PUT:
+            return setOption(handle, CURLOPT_CUSTOMREQUEST, "PUT") && setOption(handle, CURLOPT_POSTFIELDS, request->getRequestData()) && setOption(handle, CURLOPT_POSTFIELDSIZE, requestDataSize);
+
+        case HttpRequest::Type::HEAD:
+            return setOption(handle, CURLOPT_NOBODY, 1L) && setOption(handle, CURLOPT_POSTFIELDS, request->getRequestData()) && setOption(handle, CURLOPT_POSTFIELDSIZE, requestDataSize);
+
+        case HttpRequest::Type::DELETE:
+            return setOption(handle, CURLOPT_CUSTOMREQUEST, "DELETE") && setOption(handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+        default:
+            CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT, HEAD or DELETE is supported");
             return false;
+    }
+}
 
-        /* get custom header data (if set) */
-        std::vector<std::string> headers = request->getHeaders();
-        if (!headers.empty()) {
-            /* append custom headers one by one */
-            for (auto &header : headers)
-                _headers = curl_slist_append(_headers, header.c_str());
-            /* set custom headers for curl */
-            if (!setOption(CURLOPT_HTTPHEADER, _headers))
-                return false;
+// Writes the outcome of the transfer to its response
+static void finishTransfer(HttpClient *client, CURL *handle, CURLcode code, HttpTransfer *transfer) {
+    long responseCode = -1;
+    bool succeed = false;
+    if (code == CURLE_OK) {
+        CURLcode infoCode = curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+        if (infoCode != CURLE_OK) {
+            CC_LOG_ERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(infoCode));
         }
-        std::string cookieFilename = client->getCookieFilename();
-        if (!cookieFilename.empty()) {
-            if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
-                return false;
+        succeed = infoCode == CURLE_OK && responseCode >= 200 && responseCode < 300;
+    }
+
+    // cookies live in the share handle, write them back for the next session
+    if (handle && !client->getCookieFilename().empty()) {
+        curl_easy_setopt(handle, CURLOPT_COOKIELIST, "FLUSH");
+    }
+
+    if (transfer->headers) {
+        curl_slist_free_all(transfer->headers);
+        transfer->headers = nullptr;
+    }
+
+    // write data to HttpResponse
+    HttpResponse *response = transfer->response;
+    response->setResponseCode(responseCode);
+    if (!succeed) {
+        response->setSucceed(false);
+        response->setErrorBuffer(transfer->errorBuffer);
+    } else {
+        response->setSucceed(true);
+    }
+}
+
+// Worker thread
+void HttpClient::networkThread() {
+    increaseThreadCount();
+
+    std::vector<HttpRequest *> requests;
+    std::vector<CURL *> activeHandles;
+    std::vector<CURL *> idleHandles;
+    int hostConnectionLimit = -1;
+    bool quit = false;
+
+    auto dispatchResponse = [this](HttpResponse *response) {
+        // add response packet into queue
+        _responseQueueMutex.lock();
+        _responseQueue.pushBack(response);
+        _responseQueueMutex.unlock();
+
+        _schedulerMutex.lock();
+        if (auto sche = _scheduler.lock()) {
+            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+        }
+        _schedulerMutex.unlock();
+    };
+
+    CURLM *multiHandle = _curl->multiHandle;
+    CURLSH *shareHandle = _curl->shareHandle;
+
+    while (true) {
+        // step 1: take as many requests as there are free slots, the queue is sorted by priority
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (_requestQueue.empty() && _immediateRequests.empty() && activeHandles.empty()) {
+                _sleepCondition.wait(_requestQueueMutex);
             }
-            if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
-                return false;
+            // destroyInstance() queues the sentinel, quit before taking anything so no request is left half started
+            quit = _requestQueue.contains(_requestSentinel);
+            if (!quit) {
+                // send() and sendImmediate() hold a reference until the callback ran, dropping the queue's one is safe
+                for (auto *request : _immediateRequests) {
+                    requests.push_back(request);
+                }
+                _immediateRequests.clear();
+
+                const size_t freeSlots = std::max(0, _maxConcurrentRequests - static_cast<int>(activeHandles.size()));
+                size_t queuedCount = 0;
+                while (!_requestQueue.empty() && queuedCount < freeSlots) {
+                    requests.push_back(_requestQueue.at(0));
+                    _requestQueue.erase(0);
+                    ++queuedCount;
+                }
             }
         }
 
-        return setOption(CURLOPT_URL, request->getUrl()) && setOption(CURLOPT_WRITEFUNCTION, callback) && setOption(CURLOPT_WRITEDATA, stream) && setOption(CURLOPT_HEADERFUNCTION, headerCallback) && setOption(CURLOPT_HEADERDATA, headerStream);
-    }
+        if (quit) {
+            break;
+        }
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode) {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CC_LOG_ERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
+        if (hostConnectionLimit != _maxConnectionsPerHost) {
+            hostConnectionLimit = _maxConnectionsPerHost;
+            curl_multi_setopt(multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(hostConnectionLimit));
         }
-        // Get some mor data.
 
-        return true;
-    }
-};
+        // step 2: hand the requests to curl, easy handles are recycled to save their allocations
+        for (auto *request : requests) {
+            // Create a HttpResponse object, the default setting is http access failed
+            auto *transfer = new HttpTransfer();
+            transfer->response = new HttpResponse(request);
+
+            CURL *handle = nullptr;
+            if (!idleHandles.empty()) {
+                handle = idleHandles.back();
+                idleHandles.pop_back();
+                curl_easy_reset(handle);
+            } else {
+                handle = curl_easy_init();
+            }
 
-//Process Get Request
-static int processGetTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_FOLLOWLOCATION, true) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+            if (handle && setupTransfer(this, shareHandle, handle, transfer) && CURLM_OK == curl_multi_add_handle(multiHandle, handle)) {
+                activeHandles.push_back(handle);
+            } else {
+                finishTransfer(this, handle, CURLE_FAILED_INIT, transfer);
+                if (handle) {
+                    curl_easy_cleanup(handle);
+                }
+                dispatchResponse(transfer->response);
+                delete transfer;
+            }
+        }
+        requests.clear();
 
-//Process POST Request
-static int processPostTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_POST, 1) && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+        // step 3: let curl make progress and collect the finished transfers
+        int runningHandles = 0;
+        CURLMcode mcode = CURLM_CALL_MULTI_PERFORM;
+        while (CURLM_CALL_MULTI_PERFORM == mcode) {
+            mcode = curl_multi_perform(multiHandle, &runningHandles);
+        }
 
-//Process PUT Request
-static int processPutTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT") && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+        int messageCount = 0;
+        bool freedSlot = false;
+        while (CURLMsg *message = curl_multi_info_read(multiHandle, &messageCount)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            freedSlot = true;
+            CURL *handle = message->easy_handle;
+            CURLcode code = message->data.result;
+            char *priv = nullptr;
+            curl_easy_getinfo(handle, CURLINFO_PRIVATE, &priv);
+            auto *transfer = reinterpret_cast<HttpTransfer *>(priv);
+
+            curl_multi_remove_handle(multiHandle, handle);
+            activeHandles.erase(std::find(activeHandles.begin(), activeHandles.end(), handle));
+
+            finishTransfer(this, handle, code, transfer);
+            // curl_easy_reset() leaks the cookie file list on older libcurl, such handles are not recycled
+            if (static_cast<int>(idleHandles.size()) < _maxConcurrentRequests && getCookieFilename().empty()) {
+                idleHandles.push_back(handle);
+            } else {
+                curl_easy_cleanup(handle);
+            }
+            dispatchResponse(transfer->response);
+            delete transfer;
+        }
 
-//Process HEAD Request
-static int processHeadTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_NOBODY, "HEAD") && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+        // step 4: wait for socket activity, send() interrupts the wait when a request is queued.
+        // A finished transfer freed a slot, go back and fill it from the queue before waiting.
+        if (!activeHandles.empty() && !freedSlot) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+            curl_multi_poll(multiHandle, nullptr, 0, 1000, nullptr);
+#else
+            int numfds = 0;
+            curl_multi_wait(multiHandle, nullptr, 0, CC_CURL_POLL_TIMEOUT_MS, &numfds);
+            if (numfds == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(CC_CURL_POLL_TIMEOUT_MS));
+            }
+#endif
+        }
+    }
+
+    // cleanup: if worker thread received quit signal, abort the transfers in flight
+    for (CURL *handle : activeHandles) {
+        char *priv = nullptr;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &priv);
+        auto *transfer = reinterpret_cast<HttpTransfer *>(priv);
+        curl_multi_remove_handle(multiHandle, handle);
+        curl_easy_cleanup(handle);
+        curl_slist_free_all(transfer->headers);
+        // drop the reference send() took, the callback never runs
+        transfer->response->getHttpRequest()->release();
+        transfer->response->release();
+        delete transfer;
+    }
+    for (CURL *handle : idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+
+    // and clean up un-completed request queue
+    _requestQueueMutex.lock();
+    for (auto *request : _requestQueue) {
+        if (request != _requestSentinel) {
+            request->release();
+        }
+    }
+    _requestQueue.clear();
+    for (auto *request : _immediateRequests) {
+        request->release();
+    }
+    _immediateRequests.clear();
+    curl_multi_cleanup(multiHandle);
+    _curl->multiHandle = nullptr;
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE") && curl.setOption(CURLOPT_FOLLOWLOCATION, true) && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    decreaseThreadCountAndMayDeleteThis();
 }
 
 // HttpClient implementation
@@ -331,6 +475,7 @@ void HttpClient::destroyInstance() {
 
     thiz->_requestQueueMutex.lock();
     thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+    thiz->wakeNetworkThread();
     thiz->_requestQueueMutex.unlock();
 
     thiz->_sleepCondition.notify_one();
@@ -363,10 +508,24 @@ HttpClient::HttpClient()
     CC_LOG_DEBUG("In the constructor of HttpClient!");
     memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
     _scheduler = Application::getInstance()->getScheduler();
+
+    _curl = new (std::nothrow) CurlContext();
+    _curl->shareHandle = curl_share_init();
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_USERDATA, _curl);
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_LOCKFUNC, lockShareData);
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_UNLOCKFUNC, unlockShareData);
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(_curl->shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+
     increaseThreadCount();
 }
 
 HttpClient::~HttpClient() {
+    // every easy handle is gone once the last thread left
+    curl_share_cleanup(_curl->shareHandle);
+    delete _curl;
+
     CC_SAFE_RELEASE(_requestSentinel);
     CC_LOG_DEBUG("HttpClient destructor");
 }
@@ -376,6 +535,14 @@ bool HttpClient::lazyInitThreadSemaphore() {
     if (_isInited) {
         return true;
     } else {
+        _curl->multiHandle = curl_multi_init();
+        if (!_curl->multiHandle) {
+            return false;
+        }
+#if LIBCURL_VERSION_NUM >= 0x072B00
+        curl_multi_setopt(_curl->multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+
         auto t = std::thread(CC_CALLBACK_0(HttpClient::networkThread, this));
         t.detach();
         _isInited = true;
@@ -397,24 +564,42 @@ void HttpClient::send(HttpRequest *request) {
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    enqueueRequest(request);
+    wakeNetworkThread();
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
     _sleepCondition.notify_one();
 }
 
+// Runs on the multi handle as well so it reuses connections, but doesn't wait for a free slot
 void HttpClient::sendImmediate(HttpRequest *request) {
+    if (false == lazyInitThreadSemaphore()) {
+        return;
+    }
+
     if (!request) {
         return;
     }
 
     request->retain();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    _requestQueueMutex.lock();
+    _immediateRequests.pushBack(request);
+    wakeNetworkThread();
+    _requestQueueMutex.unlock();
+
+    _sleepCondition.notify_one();
+}
+
+// _requestQueueMutex must be held
+void HttpClient::wakeNetworkThread() {
+#if LIBCURL_VERSION_NUM >= 0x074400
+    // the network thread may be polling the sockets of other requests
+    if (_curl->multiHandle) {
+        curl_multi_wakeup(_curl->multiHandle);
+    }
+#endif
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -444,76 +629,20 @@ void HttpClient::dispatchResponseCallbacks() {
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse *response, char *responseMessage) {
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
-
-    // Process the request -> get response packet
-    switch (request->getRequestType()) {
-        case HttpRequest::Type::GET: // HTTP GET
-            retValue = processGetTask(this, request,
-                                      writeData,
-                                      response->getResponseData(),
-                                      &responseCode,
-                                      writeHeaderData,
-                                      response->getResponseHeader(),
-                                      responseMessage);
-            break;
-
-        case HttpRequest::Type::POST: // HTTP POST
-            retValue = processPostTask(this, request,
-                                       writeData,
-                                       response->getResponseData(),
-                                       &responseCode,
-                                       writeHeaderData,
-                                       response->getResponseHeader(),
-                                       responseMessage);
-            break;
+// Process Response, runs the request synchronously on the calling thread
+void HttpClient::processResponse(HttpResponse *response, char * /*responseMessage*/) {
+    HttpTransfer transfer;
+    transfer.response = response;
 
-        case HttpRequest::Type::PUT:
-            retValue = processPutTask(this, request,
-                                      writeData,
-                                      response->getResponseData(),
-                                      &responseCode,
-                                      writeHeaderData,
-                                      response->getResponseHeader(),
-                                      responseMessage);
-            break;
-
-        case HttpRequest::Type::HEAD:
-            retValue = processHeadTask(this, request,
-                                       writeData,
-                                       response->getResponseData(),
-                                       &responseCode,
-                                       writeHeaderData,
-                                       response->getResponseHeader(),
-                                       responseMessage);
-            break;
-
-        case HttpRequest::Type::DELETE:
-            retValue = processDeleteTask(this, request,
-                                         writeData,
-                                         response->getResponseData(),
-                                         &responseCode,
-                                         writeHeaderData,
-                                         response->getResponseHeader(),
-                                         responseMessage);
-            break;
-
-        default:
-            CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT, HEAD or DELETE is supported");
-            break;
+    CURL *handle = curl_easy_init();
+    CURLcode code = CURLE_FAILED_INIT;
+    if (handle && setupTransfer(this, _curl->shareHandle, handle, &transfer)) {
+        code = curl_easy_perform(handle);
     }
+    finishTransfer(this, handle, code, &transfer);
 
-    // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0) {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    } else {
-        response->setSucceed(true);
+    if (handle) {
+        curl_easy_cleanup(handle);
     }
 }
 
@@ -28,6 +28,7 @@
 #ifndef __CCHTTPCLIENT_H__
 #define __CCHTTPCLIENT_H__
 
+#include <atomic>
 #include <thread>
 #include <condition_variable>
 #include "base/Vector.h"
@@ -45,6 +46,8 @@ namespace cc {
 
 namespace network {
 
+struct CurlContext;
+
 /** Singleton that handles asynchronous http requests.
  *
  * Once the request completed, a callback will issued in main thread when it provided during make request.
@@ -146,6 +149,36 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE int getTimeoutForRead();
 
+    /**
+     * Set how many requests queued with `send` may be in flight at the same time.
+     * Only the curl backend runs requests concurrently, the others send them one by one.
+     *
+     * @param value the maximum count of concurrent requests, 8 by default.
+     */
+    void setMaxConcurrentRequests(int value) { _maxConcurrentRequests = value > 0 ? value : 1; }
+
+    /**
+     * Get how many requests queued with `send` may be in flight at the same time.
+     *
+     * @return int the maximum count of concurrent requests.
+     */
+    int getMaxConcurrentRequests() const { return _maxConcurrentRequests; }
+
+    /**
+     * Set how many connections may be opened to a single host. Requests over the limit wait for a
+     * free connection, or share one when the server speaks HTTP/2. Only used by the curl backend.
+     *
+     * @param value the maximum count of connections per host, 0 means no limit. 6 by default.
+     */
+    void setMaxConnectionsPerHost(int value) { _maxConnectionsPerHost = value > 0 ? value : 0; }
+
+    /**
+     * Get how many connections may be opened to a single host.
+     *
+     * @return int the maximum count of connections per host.
+     */
+    int getMaxConnectionsPerHost() const { return _maxConnectionsPerHost; }
+
     HttpCookie *getCookie() const { return _cookie; }
 
     std::mutex &getCookieFileMutex() { return _cookieFileMutex; }
@@ -168,6 +201,16 @@ private:
     void dispatchResponseCallbacks();
 
     void processResponse(HttpResponse *response, char *responseMessage);
+
+    // Queues the request behind the ones with the same or a higher priority, _requestQueueMutex must be held.
+    void enqueueRequest(HttpRequest *request) {
+        ssize_t index = _requestQueue.size();
+        while (index > 0 && _requestQueue.at(index - 1) != _requestSentinel && _requestQueue.at(index - 1)->getPriority() < request->getPriority()) {
+            --index;
+        }
+        _requestQueue.insert(index, request);
+    }
+    void wakeNetworkThread();
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
 
@@ -183,10 +226,15 @@ private:
     int _threadCount;
     std::mutex _threadCountMutex;
 
+    std::atomic<int> _maxConcurrentRequests{8};
+    std::atomic<int> _maxConnectionsPerHost{6};
+
     std::weak_ptr<Scheduler> _scheduler;
     std::mutex _schedulerMutex;
 
     Vector<HttpRequest *> _requestQueue;
+    // Requests of sendImmediate(), started without waiting for a free slot, guarded by _requestQueueMutex.
+    Vector<HttpRequest *> _immediateRequests;
     std::mutex _requestQueueMutex;
 
     Vector<HttpResponse *> _responseQueue;
@@ -205,6 +253,9 @@ private:
     char _responseMessage[RESPONSE_BUFFER_SIZE];
 
     HttpRequest *_requestSentinel;
+
+    // Handles of the curl backend, every client owns its own.
+    CurlContext *_curl = nullptr;
 };
 
 } // namespace network
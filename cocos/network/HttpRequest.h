@@ -47,6 +47,7 @@ class HttpClient;
 class HttpResponse;
 
 typedef std::function<void(HttpClient *, HttpResponse *)> ccHttpRequestCallback;
+typedef std::function<bool(HttpResponse *, const char *, size_t)> ccHttpRequestDataCallback;
 
 /**
  * Defines the object which users must packed for HttpClient::send(HttpRequest*) method.
@@ -86,8 +87,10 @@ public:
     HttpRequest()
     : _requestType(Type::UNKNOWN),
       _callback(nullptr),
+      _dataCallback(nullptr),
       _userData(nullptr),
-      _timeoutInSeconds(10.0f) {
+      _timeoutInSeconds(10.0f),
+      _priority(0) {
     }
 
     /** Destructor. */
@@ -236,6 +239,27 @@ public:
         return _callback;
     }
 
+    /**
+     * Set a callback that receives the response body chunk by chunk while it is downloaded.
+     * It's called on the network thread, HttpResponse::getContentLength() tells the expected size
+     * once the first chunk arrived. While it is set the body is not collected into
+     * HttpResponse::getResponseData(). Returning false from the callback aborts the request.
+     *
+     * @param callback the ccHttpRequestDataCallback function, nullptr to collect the body again.
+     */
+    inline void setResponseDataCallback(const ccHttpRequestDataCallback &callback) {
+        _dataCallback = callback;
+    }
+
+    /**
+     * Get the callback that receives the response body chunk by chunk.
+     *
+     * @return const ccHttpRequestDataCallback& the callback, may be empty.
+     */
+    inline const ccHttpRequestDataCallback &getResponseDataCallback() const {
+        return _dataCallback;
+    }
+
     /**
      * Set custom-defined headers.
      *
@@ -262,6 +286,25 @@ public:
         return _timeoutInSeconds;
     }
 
+    /**
+     * Set the priority of the request. Queued requests with a higher priority are sent first,
+     * requests with the same priority keep the order they were sent in.
+     *
+     * @param priority the priority, 0 by default.
+     */
+    inline void setPriority(int priority) {
+        _priority = priority;
+    }
+
+    /**
+     * Get the priority of the request.
+     *
+     * @return int the priority.
+     */
+    inline int getPriority() const {
+        return _priority;
+    }
+
 protected:
     // properties
     Type _requestType;                 /// kHttpRequestGet, kHttpRequestPost or other enums
@@ -269,9 +312,11 @@ protected:
     std::vector<char> _requestData;    /// used for POST
     std::string _tag;                  /// user defined tag, to identify different requests in response callback
     ccHttpRequestCallback _callback;   /// C++11 style callbacks
+    ccHttpRequestDataCallback _dataCallback; /// receives the body as it arrives, on the network thread
     void *_userData;                   /// You can add your customed data here
     std::vector<std::string> _headers; /// custom http headers
     float _timeoutInSeconds;
+    int _priority;                     /// higher priority requests leave the queue first
 };
 
 } // namespace network
@@ -53,6 +53,7 @@ public:
     HttpResponse(HttpRequest *request)
     : _pHttpRequest(request),
       _succeed(false),
+      _contentLength(-1),
       _responseDataString("") {
         if (_pHttpRequest) {
             _pHttpRequest->retain();
@@ -127,6 +128,15 @@ public:
         return _responseCode;
     }
 
+    /**
+     * Get the size of the body announced by the server.
+     * It is known once the first chunk of the body arrived, compressed bodies report the compressed size.
+     * @return int64_t the value of the Content-Length header, -1 if it's unknown.
+     */
+    inline int64_t getContentLength() const {
+        return _contentLength;
+    }
+
     /**
      * Get the error buffer which will tell you more about the reason why http request failed.
      * @return const char* the pointer that point to _errorBuffer.
@@ -171,6 +181,14 @@ public:
         _responseCode = value;
     }
 
+    /**
+     * Set the size of the body announced by the server, it is used by HttpClient.
+     * @param value the value of the Content-Length header, -1 if it's unknown.
+     */
+    inline void setContentLength(int64_t value) {
+        _contentLength = value;
+    }
+
     /**
      * Set the error buffer which will tell you more the reason why http request failed.
      * @param value a string pointer that point to the reason.
@@ -208,6 +226,7 @@ protected:
     std::vector<char> _responseData;   /// the returned raw data. You can also dump it as a string
     std::vector<char> _responseHeader; /// the returned raw header data. You can also dump it as a string
     long _responseCode;                /// the status code returned from libcurl, e.g. 200, 404
+    int64_t _contentLength;            /// the announced size of the body, -1 if unknown
     std::string _errorBuffer;          /// if _responseCode != 200, please read _errorBuffer to find the reason
     std::string _responseDataString;   // the returned raw data. You can also dump it as a string
 };
@@ -25,6 +25,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "audio/include/AudioEngine.h"
 #include "base/Scheduler.h"
+#include "base/threading/JobSystem.h"
 #include "cocos/bindings/event/EventDispatcher.h"
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "platform/Application.h"
@@ -80,6 +81,8 @@ Application::~Application() {
 
     EventDispatcher::destroy();
     se::ScriptEngine::destroyInstance();
+    // the pipeline and middleware went away with the script engine, nothing submits jobs any more
+    JobSystem::destroyInstance();
 
     Application::_instance = nullptr;
 }
@@ -25,6 +25,7 @@
 #import "Application.h"
 #import <UIKit/UIKit.h>
 #include "base/Scheduler.h"
+#include "base/threading/JobSystem.h"
 #include "base/AutoreleasePool.h"
 #include "bindings/event/EventDispatcher.h"
 #include "bindings/jswrapper/SeApi.h"
@@ -135,6 +136,8 @@ Application::~Application() {
 
     EventDispatcher::destroy();
     se::ScriptEngine::destroyInstance();
+    // the pipeline and middleware went away with the script engine, nothing submits jobs any more
+    JobSystem::destroyInstance();
 
     Application::_instance = nullptr;
 
@@ -28,9 +28,11 @@ THE SOFTWARE.
 #include "base/CachedArray.h"
 #include "base/StringUtil.h"
 
+#include "gfx/GFXBinaryCache.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXCommand.h"
 #include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXCommandStream.h"
 #include "gfx/GFXCommandPool.h"
 #include "gfx/GFXContext.h"
 #include "gfx/GFXDescriptorSet.h"
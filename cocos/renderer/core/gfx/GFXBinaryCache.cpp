@@ -0,0 +1,290 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "GFXBinaryCache.h"
+#include "base/Data.h"
+#include "platform/FileUtils.h"
+
+#include <cstring>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+constexpr uint CACHE_MAGIC = 0x43424343u; // 'CCBC'
+constexpr uint CACHE_VERSION = 1u;
+constexpr char CACHE_FOLDER[] = "gfx-cache/";
+
+struct FileHeader {
+    uint magic = CACHE_MAGIC;
+    uint version = CACHE_VERSION;
+    uint64_t deviceHash = 0u;
+    uint clock = 0u;
+    uint entryCount = 0u;
+};
+
+struct EntryHeader {
+    uint64_t key = 0u;
+    uint tag = 0u;
+    uint lastUse = 0u;
+    uint size = 0u;
+    uint checksum = 0u;
+};
+
+CC_INLINE uint checksum(const uint8_t *data, size_t size) {
+    uint64_t h = BinaryCache::hash(data, size);
+    return static_cast<uint>(h ^ (h >> 32));
+}
+} // namespace
+
+constexpr uint BinaryCache::DEFAULT_MAX_SIZE;
+constexpr uint BinaryCache::FLUSH_DELAY_FRAMES;
+
+BinaryCache::BinaryCache(const String &name, uint64_t deviceHash, uint maxSize)
+: _deviceHash(deviceHash),
+  _maxSize(maxSize) {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    String folder = fileUtils->getWritablePath() + CACHE_FOLDER;
+    if (!fileUtils->isDirectoryExist(folder)) {
+        fileUtils->createDirectory(folder);
+    }
+    _path = folder + name + ".bin";
+}
+
+BinaryCache::~BinaryCache() {
+    if (_flushThread.joinable()) {
+        _flushThread.join();
+    }
+}
+
+uint64_t BinaryCache::hash(const void *data, size_t size, uint64_t seed) {
+    // 64-bit FNV-1a, stable across platforms and standard library versions
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint64_t h = seed;
+    for (size_t i = 0u; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void BinaryCache::load() {
+    Data data = FileUtils::getInstance()->getDataFromFile(_path);
+    if (data.isNull()) return;
+
+    const uint8_t *cursor = data.getBytes();
+    const uint8_t *end = cursor + data.getSize();
+
+    FileHeader header;
+    if (end - cursor < static_cast<ptrdiff_t>(sizeof(FileHeader))) {
+        CC_LOG_WARNING("Binary cache %s is truncated, discarded.", _path.c_str());
+        return;
+    }
+    memcpy(&header, cursor, sizeof(FileHeader));
+    cursor += sizeof(FileHeader);
+
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.deviceHash != _deviceHash) {
+        CC_LOG_INFO("Binary cache %s is outdated, discarded.", _path.c_str());
+        _dirty = true;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _clock = header.clock;
+    for (uint i = 0u; i < header.entryCount; ++i) {
+        EntryHeader entryHeader;
+        if (end - cursor < static_cast<ptrdiff_t>(sizeof(EntryHeader))) break;
+        memcpy(&entryHeader, cursor, sizeof(EntryHeader));
+        cursor += sizeof(EntryHeader);
+
+        if (end - cursor < static_cast<ptrdiff_t>(entryHeader.size)) break;
+        if (checksum(cursor, entryHeader.size) != entryHeader.checksum) {
+            ++_rejectionCount;
+        } else {
+            Entry &entry = _entries[entryHeader.key];
+            entry.tag = entryHeader.tag;
+            entry.lastUse = entryHeader.lastUse;
+            entry.data = std::make_shared<const vector<uint8_t>>(cursor, cursor + entryHeader.size);
+            _totalSize += entryHeader.size;
+        }
+        cursor += entryHeader.size;
+    }
+
+    if (_entries.size() != header.entryCount) {
+        CC_LOG_WARNING("Binary cache %s: %u corrupted entries dropped.", _path.c_str(), header.entryCount - (uint)_entries.size());
+        _dirty = true;
+    }
+    evict();
+}
+
+bool BinaryCache::find(uint64_t key, uint *tag, vector<uint8_t> &data) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _entries.find(key);
+    if (iter == _entries.end()) {
+        ++_missCount;
+        return false;
+    }
+
+    ++_hitCount;
+    iter->second.lastUse = ++_clock;
+    if (tag) *tag = iter->second.tag;
+    data = *iter->second.data;
+    return true;
+}
+
+void BinaryCache::insert(uint64_t key, uint tag, const void *data, size_t size) {
+    if (!data || !size || size > _maxSize) return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry &entry = _entries[key];
+    if (entry.data) _totalSize -= static_cast<uint>(entry.data->size());
+    entry.tag = tag;
+    entry.lastUse = ++_clock;
+    entry.data = std::make_shared<const vector<uint8_t>>(static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+    _totalSize += static_cast<uint>(size);
+    evict();
+
+    _dirty = true;
+    _idleFrames = 0u;
+}
+
+void BinaryCache::erase(uint64_t key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _entries.find(key);
+    if (iter == _entries.end()) return;
+
+    _totalSize -= static_cast<uint>(iter->second.data->size());
+    _entries.erase(iter);
+    ++_rejectionCount;
+
+    _dirty = true;
+    _idleFrames = 0u;
+}
+
+void BinaryCache::markDirty() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _dirty = true;
+    _idleFrames = 0u;
+}
+
+bool BinaryCache::update() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dirty && ++_idleFrames == FLUSH_DELAY_FRAMES;
+}
+
+void BinaryCache::evict() {
+    // least recently used entries go first
+    while (_totalSize > _maxSize && !_entries.empty()) {
+        auto victim = _entries.begin();
+        for (auto iter = _entries.begin(); iter != _entries.end(); ++iter) {
+            if (iter->second.lastUse < victim->second.lastUse) victim = iter;
+        }
+        _totalSize -= static_cast<uint>(victim->second.data->size());
+        _entries.erase(victim);
+        ++_evictionCount;
+    }
+}
+
+void BinaryCache::flush(bool wait) {
+    // a write still running keeps the cache dirty, update() asks again after FLUSH_DELAY_FRAMES
+    if (!wait && _flushing.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _idleFrames = 0u;
+        return;
+    }
+    if (_flushThread.joinable()) {
+        _flushThread.join();
+    }
+
+    // only blob references are taken under the lock, serializing and checksumming happen in the background
+    vector<SnapshotEntry> snapshot;
+    uint clock = 0u;
+    uint totalSize = 0u;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_dirty) return;
+
+        snapshot.reserve(_entries.size());
+        for (const auto &pair : _entries) {
+            snapshot.push_back({pair.first, pair.second.tag, pair.second.lastUse, pair.second.data});
+        }
+        clock = _clock;
+        totalSize = _totalSize;
+        _dirty = false;
+        _idleFrames = 0u;
+    }
+
+    String path = _path;
+    uint64_t deviceHash = _deviceHash;
+    _flushing.store(true, std::memory_order_release);
+    _flushThread = std::thread([this, path, deviceHash, clock, totalSize](const vector<SnapshotEntry> &entries) {
+        writeSnapshot(path, deviceHash, clock, totalSize, entries);
+        _flushing.store(false, std::memory_order_release);
+    }, std::move(snapshot));
+
+    if (wait) {
+        _flushThread.join();
+    }
+}
+
+void BinaryCache::writeSnapshot(const String &path, uint64_t deviceHash, uint clock, uint totalSize, const vector<SnapshotEntry> &entries) {
+    size_t size = sizeof(FileHeader) + entries.size() * sizeof(EntryHeader) + totalSize;
+    uint8_t *bytes = static_cast<uint8_t *>(malloc(size));
+    uint8_t *cursor = bytes;
+
+    FileHeader header;
+    header.deviceHash = deviceHash;
+    header.clock = clock;
+    header.entryCount = static_cast<uint>(entries.size());
+    memcpy(cursor, &header, sizeof(FileHeader));
+    cursor += sizeof(FileHeader);
+
+    for (const auto &entry : entries) {
+        const vector<uint8_t> &blob = *entry.data;
+        EntryHeader entryHeader;
+        entryHeader.key = entry.key;
+        entryHeader.tag = entry.tag;
+        entryHeader.lastUse = entry.lastUse;
+        entryHeader.size = static_cast<uint>(blob.size());
+        entryHeader.checksum = checksum(blob.data(), blob.size());
+        memcpy(cursor, &entryHeader, sizeof(EntryHeader));
+        cursor += sizeof(EntryHeader);
+        memcpy(cursor, blob.data(), blob.size());
+        cursor += blob.size();
+    }
+
+    Data data;
+    data.fastSet(bytes, static_cast<ssize_t>(size));
+
+    // write to a temporary file first so an interrupted flush never leaves a torn cache behind
+    FileUtils *fileUtils = FileUtils::getInstance();
+    String tmpPath = path + ".tmp";
+    if (fileUtils->writeDataToFile(data, tmpPath)) {
+        fileUtils->renameFile(tmpPath, path);
+    }
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,110 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_CORE_GFX_BINARY_CACHE_H_
+#define CC_CORE_GFX_BINARY_CACHE_H_
+
+#include "GFXDef.h"
+
+#include <atomic>
+#include <memory>
+
+namespace cc {
+namespace gfx {
+
+/**
+ * Persistent key-value store for driver-specific binaries (program binaries, pipeline caches),
+ * kept under the writable path and invalidated as a whole whenever the device hash changes.
+ * All methods may be called from the render thread; serializing and writing the file run on a background thread.
+ */
+class CC_DLL BinaryCache final {
+public:
+    static constexpr uint DEFAULT_MAX_SIZE = 32u * 1024u * 1024u;
+    static constexpr uint FLUSH_DELAY_FRAMES = 60u;
+
+    BinaryCache(const String &name, uint64_t deviceHash, uint maxSize = DEFAULT_MAX_SIZE);
+    ~BinaryCache();
+
+    static uint64_t hash(const void *data, size_t size, uint64_t seed = 14695981039346656037ULL);
+    static CC_INLINE uint64_t hash(const String &str, uint64_t seed = 14695981039346656037ULL) { return hash(str.data(), str.size(), seed); }
+
+    void load();
+    bool find(uint64_t key, uint *tag, vector<uint8_t> &data);
+    void insert(uint64_t key, uint tag, const void *data, size_t size);
+    void erase(uint64_t key);
+    void markDirty();
+    // returns true once the cache has been dirty and untouched for FLUSH_DELAY_FRAMES frames
+    bool update();
+    void flush(bool wait = false);
+
+    CC_INLINE const String &getPath() const { return _path; }
+    CC_INLINE uint getHitCount() const { return _hitCount; }
+    CC_INLINE uint getMissCount() const { return _missCount; }
+    CC_INLINE uint getEvictionCount() const { return _evictionCount; }
+    CC_INLINE uint getRejectionCount() const { return _rejectionCount; }
+    CC_INLINE uint getTotalSize() const { return _totalSize; }
+    CC_INLINE bool isDirty() const { return _dirty; }
+
+private:
+    // blobs are never modified once stored, so a flush can share them with the cache
+    using Blob = std::shared_ptr<const vector<uint8_t>>;
+
+    struct Entry {
+        uint tag = 0u;
+        uint lastUse = 0u;
+        Blob data;
+    };
+
+    struct SnapshotEntry {
+        uint64_t key = 0u;
+        uint tag = 0u;
+        uint lastUse = 0u;
+        Blob data;
+    };
+
+    void evict();
+    static void writeSnapshot(const String &path, uint64_t deviceHash, uint clock, uint totalSize, const vector<SnapshotEntry> &entries);
+
+    String _path;
+    uint64_t _deviceHash = 0u;
+    uint _maxSize = 0u;
+    uint _totalSize = 0u;
+    uint _clock = 0u;
+
+    unordered_map<uint64_t, Entry> _entries;
+    std::mutex _mutex;
+    std::thread _flushThread;
+    std::atomic<bool> _flushing{false};
+    bool _dirty = false;
+    uint _idleFrames = 0u;
+
+    uint _hitCount = 0u;
+    uint _missCount = 0u;
+    uint _evictionCount = 0u;
+    uint _rejectionCount = 0u;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_BINARY_CACHE_H_
@@ -42,6 +42,9 @@ public:
         bindDescriptorSet(set, descriptorSet, static_cast<uint>(dynamicOffsets.size()), dynamicOffsets.data());
     }
 
+    // storage for the object table of CommandStream batches executed from JS
+    CC_INLINE vector<GFXObject *> &getStreamObjectsForJS() { return _streamObjectsForJS; }
+
     CC_INLINE void begin() { begin(nullptr, 0, nullptr, -1); }
     CC_INLINE void begin(int submitIndex) { begin(nullptr, 0, nullptr, submitIndex); }
     // secondary command buffer specifics
@@ -81,6 +84,8 @@ protected:
     uint32_t _numDrawCalls = 0;
     uint32_t _numInstances = 0;
     uint32_t _numTriangles = 0;
+
+    vector<GFXObject *> _streamObjectsForJS;
 };
 
 } // namespace gfx
@@ -0,0 +1,128 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "GFXCommandBuffer.h"
+#include "GFXCommandStream.h"
+#include "GFXDescriptorSet.h"
+#include "GFXInputAssembler.h"
+#include "GFXPipelineState.h"
+
+#include <cstring>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+template <typename T>
+CC_INLINE T *getObject(GFXObject *const *objects, uint objectCount, uint index, ObjectType type) {
+    if (index >= objectCount || !objects[index] || objects[index]->getType() != type) return nullptr;
+    return static_cast<T *>(objects[index]);
+}
+} // namespace
+
+constexpr uint CommandStream::MAX_DYNAMIC_OFFSETS;
+
+bool CommandStream::execute(CommandBuffer *cmdBuff, const uint *words, uint size, GFXObject *const *objects, uint objectCount) {
+    const uint *cursor = words;
+    const uint *end = words + size;
+
+#define CC_STREAM_CHECK(cond)                                                                 \
+    if (!(cond)) {                                                                            \
+        CC_LOG_ERROR("CommandStream: malformed command at word %u.", (uint)(cursor - words)); \
+        return false;                                                                         \
+    }
+
+    while (cursor < end) {
+        auto op = static_cast<CommandStreamOp>(cursor[0]);
+        switch (op) {
+            case CommandStreamOp::BIND_PIPELINE_STATE: {
+                CC_STREAM_CHECK(end - cursor >= 2);
+                auto *pso = getObject<PipelineState>(objects, objectCount, cursor[1], ObjectType::PIPELINE_STATE);
+                CC_STREAM_CHECK(pso);
+                cmdBuff->bindPipelineState(pso);
+                cursor += 2;
+                break;
+            }
+            case CommandStreamOp::BIND_DESCRIPTOR_SET: {
+                CC_STREAM_CHECK(end - cursor >= 4);
+                auto *descriptorSet = getObject<DescriptorSet>(objects, objectCount, cursor[2], ObjectType::DESCRIPTOR_SET);
+                uint dynamicOffsetCount = cursor[3];
+                CC_STREAM_CHECK(descriptorSet && dynamicOffsetCount <= MAX_DYNAMIC_OFFSETS && end - cursor >= 4 + dynamicOffsetCount);
+                // offsets are read in place, no intermediate vector
+                cmdBuff->bindDescriptorSet(cursor[1], descriptorSet, dynamicOffsetCount, dynamicOffsetCount ? cursor + 4 : nullptr);
+                cursor += 4 + dynamicOffsetCount;
+                break;
+            }
+            case CommandStreamOp::BIND_INPUT_ASSEMBLER: {
+                CC_STREAM_CHECK(end - cursor >= 2);
+                auto *ia = getObject<InputAssembler>(objects, objectCount, cursor[1], ObjectType::INPUT_ASSEMBLER);
+                CC_STREAM_CHECK(ia);
+                cmdBuff->bindInputAssembler(ia);
+                cursor += 2;
+                break;
+            }
+            case CommandStreamOp::DRAW: {
+                CC_STREAM_CHECK(end - cursor >= 2);
+                auto *ia = getObject<InputAssembler>(objects, objectCount, cursor[1], ObjectType::INPUT_ASSEMBLER);
+                CC_STREAM_CHECK(ia);
+                cmdBuff->draw(ia);
+                cursor += 2;
+                break;
+            }
+            case CommandStreamOp::SET_VIEWPORT: {
+                CC_STREAM_CHECK(end - cursor >= 7);
+                Viewport vp;
+                vp.left = static_cast<int>(cursor[1]);
+                vp.top = static_cast<int>(cursor[2]);
+                vp.width = cursor[3];
+                vp.height = cursor[4];
+                memcpy(&vp.minDepth, cursor + 5, sizeof(float));
+                memcpy(&vp.maxDepth, cursor + 6, sizeof(float));
+                cmdBuff->setViewport(vp);
+                cursor += 7;
+                break;
+            }
+            case CommandStreamOp::SET_SCISSOR: {
+                CC_STREAM_CHECK(end - cursor >= 5);
+                Rect rect;
+                rect.x = static_cast<int>(cursor[1]);
+                rect.y = static_cast<int>(cursor[2]);
+                rect.width = cursor[3];
+                rect.height = cursor[4];
+                cmdBuff->setScissor(rect);
+                cursor += 5;
+                break;
+            }
+            default:
+                CC_STREAM_CHECK(false);
+        }
+    }
+
+#undef CC_STREAM_CHECK
+    return true;
+}
+
+} // namespace gfx
+} // namespace cc
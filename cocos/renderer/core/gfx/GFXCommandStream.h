@@ -0,0 +1,64 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef CC_CORE_GFX_COMMAND_STREAM_H_
+#define CC_CORE_GFX_COMMAND_STREAM_H_
+
+#include "GFXDef.h"
+
+namespace cc {
+namespace gfx {
+
+/**
+ * Packed command stream written by script into a shared buffer and recorded in one native call.
+ * Each command is an opcode word followed by its operands, object operands are indices into
+ * the object table passed along with the stream:
+ *
+ *   BIND_PIPELINE_STATE  | pso |
+ *   BIND_DESCRIPTOR_SET  | set | descriptorSet | dynamicOffsetCount | dynamicOffsets... |
+ *   BIND_INPUT_ASSEMBLER | ia |
+ *   DRAW                 | ia |
+ *   SET_VIEWPORT         | left | top | width | height | minDepth (float) | maxDepth (float) |
+ *   SET_SCISSOR          | x | y | width | height |
+ */
+enum class CommandStreamOp : uint {
+    BIND_PIPELINE_STATE = 1u,
+    BIND_DESCRIPTOR_SET,
+    BIND_INPUT_ASSEMBLER,
+    DRAW,
+    SET_VIEWPORT,
+    SET_SCISSOR,
+};
+
+class CC_DLL CommandStream final {
+public:
+    static constexpr uint MAX_DYNAMIC_OFFSETS = 16u;
+
+    // Records `size` words of commands into cmdBuff, stops at the first malformed command.
+    static bool execute(CommandBuffer *cmdBuff, const uint *words, uint size, GFXObject *const *objects, uint objectCount);
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_COMMAND_STREAM_H_
@@ -99,6 +99,7 @@ enum class Feature {
     STENCIL_WRITE_MASK,
     STENCIL_COMPARE_MASK,
     MULTITHREADED_SUBMISSION,
+    SECONDARY_COMMAND_BUFFER, // CommandBuffer::execute replays secondary command buffers
     COUNT,
 };
 
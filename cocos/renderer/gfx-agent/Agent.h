@@ -0,0 +1,61 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "base/threading/MessageQueue.h"
+
+namespace cc {
+namespace gfx {
+
+class DeviceAgent;
+
+// An agent mirrors the public state of a backend object (the actor) on the
+// recording thread and forwards every operation to it through the device's
+// message queue.
+template <typename Actor>
+class Agent : public Actor {
+public:
+    Agent(Actor *actor, Device *device)
+    : Actor(device), _actor(actor) {}
+
+    CC_INLINE Actor *getActor() const { return _actor; }
+
+protected:
+    friend class DeviceAgent;
+
+    Actor *_actor = nullptr;
+};
+
+template <typename T>
+CC_INLINE T *actorOf(T *agent) {
+    return agent ? static_cast<Agent<T> *>(agent)->getActor() : nullptr;
+}
+
+template <typename T>
+CC_INLINE const T *actorOf(const T *agent) {
+    return agent ? static_cast<const Agent<T> *>(agent)->getActor() : nullptr;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,299 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "CommandBufferAgent.h"
+#include "DeviceAgent.h"
+#include "gfx/GFXRenderPass.h"
+
+namespace cc {
+namespace gfx {
+
+CommandBufferAgent::~CommandBufferAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool CommandBufferAgent::initialize(const CommandBufferInfo &info) {
+    _type = info.type;
+    _queue = info.queue;
+
+    CommandBufferInfo actorInfo = info;
+    actorInfo.queue = actorOf(info.queue);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferInit,
+        actor, _actor,
+        info, actorInfo,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void CommandBufferAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void CommandBufferAgent::begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer, int submitIndex) {
+    ENQUEUE_MESSAGE_5(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferBegin,
+        actor, _actor,
+        renderPass, actorOf(renderPass),
+        subpass, subpass,
+        frameBuffer, actorOf(frameBuffer),
+        submitIndex, submitIndex,
+        {
+            actor->begin(renderPass, subpass, frameBuffer, submitIndex);
+        });
+}
+
+void CommandBufferAgent::end() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferEnd,
+        actor, _actor,
+        {
+            actor->end();
+        });
+}
+
+void CommandBufferAgent::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) {
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+    const uint colorCount = static_cast<uint>(renderPass->getColorAttachments().size());
+
+    ENQUEUE_MESSAGE_8(
+        queue, CommandBufferBeginRenderPass,
+        actor, _actor,
+        renderPass, actorOf(renderPass),
+        fbo, actorOf(fbo),
+        renderArea, renderArea,
+        colors, queue->allocateAndCopy(colors, colorCount),
+        depth, depth,
+        stencil, stencil,
+        fromSecondaryCB, fromSecondaryCB,
+        {
+            actor->beginRenderPass(renderPass, fbo, renderArea, colors, depth, stencil, fromSecondaryCB);
+        });
+}
+
+void CommandBufferAgent::endRenderPass() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferEndRenderPass,
+        actor, _actor,
+        {
+            actor->endRenderPass();
+        });
+}
+
+void CommandBufferAgent::bindPipelineState(PipelineState *pso) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferBindPipelineState,
+        actor, _actor,
+        pso, actorOf(pso),
+        {
+            actor->bindPipelineState(pso);
+        });
+}
+
+void CommandBufferAgent::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+
+    ENQUEUE_MESSAGE_5(
+        queue, CommandBufferBindDescriptorSet,
+        actor, _actor,
+        set, set,
+        descriptorSet, actorOf(descriptorSet),
+        dynamicOffsetCount, dynamicOffsetCount,
+        dynamicOffsets, queue->allocateAndCopy(dynamicOffsets, dynamicOffsetCount),
+        {
+            actor->bindDescriptorSet(set, descriptorSet, dynamicOffsetCount, dynamicOffsets);
+        });
+}
+
+void CommandBufferAgent::bindInputAssembler(InputAssembler *ia) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferBindInputAssembler,
+        actor, _actor,
+        ia, actorOf(ia),
+        {
+            actor->bindInputAssembler(ia);
+        });
+}
+
+void CommandBufferAgent::setViewport(const Viewport &vp) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetViewport,
+        actor, _actor,
+        vp, vp,
+        {
+            actor->setViewport(vp);
+        });
+}
+
+void CommandBufferAgent::setScissor(const Rect &rect) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetScissor,
+        actor, _actor,
+        rect, rect,
+        {
+            actor->setScissor(rect);
+        });
+}
+
+void CommandBufferAgent::setLineWidth(float width) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetLineWidth,
+        actor, _actor,
+        width, width,
+        {
+            actor->setLineWidth(width);
+        });
+}
+
+void CommandBufferAgent::setDepthBias(float constant, float clamp, float slope) {
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetDepthBias,
+        actor, _actor,
+        constant, constant,
+        clamp, clamp,
+        slope, slope,
+        {
+            actor->setDepthBias(constant, clamp, slope);
+        });
+}
+
+void CommandBufferAgent::setBlendConstants(const Color &constants) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetBlendConstants,
+        actor, _actor,
+        constants, constants,
+        {
+            actor->setBlendConstants(constants);
+        });
+}
+
+void CommandBufferAgent::setDepthBound(float minBounds, float maxBounds) {
+    ENQUEUE_MESSAGE_3(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetDepthBound,
+        actor, _actor,
+        minBounds, minBounds,
+        maxBounds, maxBounds,
+        {
+            actor->setDepthBound(minBounds, maxBounds);
+        });
+}
+
+void CommandBufferAgent::setStencilWriteMask(StencilFace face, uint mask) {
+    ENQUEUE_MESSAGE_3(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetStencilWriteMask,
+        actor, _actor,
+        face, face,
+        mask, mask,
+        {
+            actor->setStencilWriteMask(face, mask);
+        });
+}
+
+void CommandBufferAgent::setStencilCompareMask(StencilFace face, int ref, uint mask) {
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferSetStencilCompareMask,
+        actor, _actor,
+        face, face,
+        ref, ref,
+        mask, mask,
+        {
+            actor->setStencilCompareMask(face, ref, mask);
+        });
+}
+
+void CommandBufferAgent::draw(InputAssembler *ia) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), CommandBufferDraw,
+        actor, _actor,
+        ia, actorOf(ia),
+        {
+            actor->draw(ia);
+        });
+}
+
+void CommandBufferAgent::updateBuffer(Buffer *buff, const void *data, uint size) {
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+
+    ENQUEUE_MESSAGE_4(
+        queue, CommandBufferUpdateBuffer,
+        actor, _actor,
+        buff, actorOf(buff),
+        data, queue->allocateAndCopy(static_cast<const uint8_t *>(data), size),
+        size, size,
+        {
+            actor->updateBuffer(buff, data, size);
+        });
+}
+
+void CommandBufferAgent::copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) {
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+
+    ENQUEUE_MESSAGE_5(
+        queue, CommandBufferCopyBuffersToTexture,
+        actor, _actor,
+        buffers, copyTextureUploadData(queue, buffers, texture, regions, count),
+        texture, actorOf(texture),
+        regions, queue->allocateAndCopy(regions, count),
+        count, count,
+        {
+            actor->copyBuffersToTexture(buffers, texture, regions, count);
+        });
+}
+
+void CommandBufferAgent::execute(const CommandBuffer *const *cmdBuffs, uint32_t count) {
+    if (!count) return;
+
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+    const CommandBuffer **actorCmdBuffs = queue->allocate<const CommandBuffer *>(count);
+    for (uint i = 0u; i < count; ++i) {
+        actorCmdBuffs[i] = actorOf(cmdBuffs[i]);
+    }
+
+    ENQUEUE_MESSAGE_3(
+        queue, CommandBufferExecute,
+        actor, _actor,
+        cmdBuffs, actorCmdBuffs,
+        count, count,
+        {
+            actor->execute(cmdBuffs, count);
+        });
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,132 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DescriptorSetAgent.h"
+#include "DeviceAgent.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+
+namespace cc {
+namespace gfx {
+
+DescriptorSetAgent::~DescriptorSetAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool DescriptorSetAgent::initialize(const DescriptorSetInfo &info) {
+    _layout = info.layout;
+
+    const uint descriptorCount = _layout->getDescriptorCount();
+    _buffers.resize(descriptorCount);
+    _textures.resize(descriptorCount);
+    _samplers.resize(descriptorCount);
+
+    DescriptorSetInfo actorInfo;
+    actorInfo.layout = actorOf(info.layout);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetInit,
+        actor, _actor,
+        info, actorInfo,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void DescriptorSetAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void DescriptorSetAgent::update() {
+    // bindings are tracked here as well, so clean sets never reach the render thread
+    if (!_isDirty) return;
+    _isDirty = false;
+
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetUpdate,
+        actor, _actor,
+        {
+            actor->update();
+        });
+}
+
+void DescriptorSetAgent::bindBuffer(uint binding, Buffer *buffer, uint index) {
+    if (getBuffer(binding, index) == buffer) return;
+    DescriptorSet::bindBuffer(binding, buffer, index);
+
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetBindBuffer,
+        actor, _actor,
+        binding, binding,
+        buffer, actorOf(buffer),
+        index, index,
+        {
+            actor->bindBuffer(binding, buffer, index);
+        });
+}
+
+void DescriptorSetAgent::bindTexture(uint binding, Texture *texture, uint index) {
+    if (getTexture(binding, index) == texture) return;
+    DescriptorSet::bindTexture(binding, texture, index);
+
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetBindTexture,
+        actor, _actor,
+        binding, binding,
+        texture, actorOf(texture),
+        index, index,
+        {
+            actor->bindTexture(binding, texture, index);
+        });
+}
+
+void DescriptorSetAgent::bindSampler(uint binding, Sampler *sampler, uint index) {
+    if (getSampler(binding, index) == sampler) return;
+    DescriptorSet::bindSampler(binding, sampler, index);
+
+    ENQUEUE_MESSAGE_4(
+        DeviceAgent::getInstance()->getMessageQueue(), DescriptorSetBindSampler,
+        actor, _actor,
+        binding, binding,
+        sampler, actorOf(sampler),
+        index, index,
+        {
+            actor->bindSampler(binding, sampler, index);
+        });
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,292 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "BufferAgent.h"
+#include "CommandBufferAgent.h"
+#include "DescriptorSetAgent.h"
+#include "DescriptorSetLayoutAgent.h"
+#include "DeviceAgent.h"
+#include "FenceAgent.h"
+#include "FramebufferAgent.h"
+#include "InputAssemblerAgent.h"
+#include "PipelineLayoutAgent.h"
+#include "PipelineStateAgent.h"
+#include "QueueAgent.h"
+#include "RenderPassAgent.h"
+#include "SamplerAgent.h"
+#include "ShaderAgent.h"
+#include "TextureAgent.h"
+
+namespace cc {
+namespace gfx {
+
+constexpr uint DeviceAgent::MAX_CPU_FRAME_AHEAD;
+
+DeviceAgent *DeviceAgent::_instance = nullptr;
+
+DeviceAgent *DeviceAgent::getInstance() {
+    return DeviceAgent::_instance;
+}
+
+DeviceAgent::DeviceAgent(Device *device)
+: _actor(device) {
+    DeviceAgent::_instance = this;
+    _mainMessageQueue = CC_NEW(MessageQueue);
+}
+
+DeviceAgent::~DeviceAgent() {
+    CC_SAFE_DELETE(_mainMessageQueue); // drains the render thread if still running
+    CC_SAFE_DELETE(_actor);
+    if (this == DeviceAgent::_instance) {
+        DeviceAgent::_instance = nullptr;
+    }
+}
+
+bool DeviceAgent::initialize(const DeviceInfo &info) {
+    if (!_actor->initialize(info)) {
+        return false;
+    }
+
+    _API = _actor->_API;
+    _transform = _actor->_transform;
+    _deviceName = _actor->_deviceName;
+    _renderer = _actor->_renderer;
+    _vendor = _actor->_vendor;
+    _version = _actor->_version;
+    memcpy(_features, _actor->_features, sizeof(_features));
+    _width = _actor->_width;
+    _height = _actor->_height;
+    _nativeWidth = _actor->_nativeWidth;
+    _nativeHeight = _actor->_nativeHeight;
+    _windowHandle = _actor->_windowHandle;
+    _context = _actor->_context;
+    _maxVertexAttributes = _actor->_maxVertexAttributes;
+    _maxVertexUniformVectors = _actor->_maxVertexUniformVectors;
+    _maxFragmentUniformVectors = _actor->_maxFragmentUniformVectors;
+    _maxTextureUnits = _actor->_maxTextureUnits;
+    _maxVertexTextureUnits = _actor->_maxVertexTextureUnits;
+    _maxUniformBufferBindings = _actor->_maxUniformBufferBindings;
+    _maxUniformBlockSize = _actor->_maxUniformBlockSize;
+    _maxTextureSize = _actor->_maxTextureSize;
+    _maxCubeMapTextureSize = _actor->_maxCubeMapTextureSize;
+    _uboOffsetAlignment = _actor->_uboOffsetAlignment;
+    _depthBits = _actor->_depthBits;
+    _stencilBits = _actor->_stencilBits;
+    _macros = _actor->_macros;
+    _clipSpaceMinZ = _actor->_clipSpaceMinZ;
+    _screenSpaceSignY = _actor->_screenSpaceSignY;
+    _UVSpaceSignY = _actor->_UVSpaceSignY;
+    _bindingMappingInfo = _actor->_bindingMappingInfo;
+
+    // the default queue & command buffer are owned by the actor
+    QueueAgent *queue = CC_NEW(QueueAgent(_actor->getQueue(), this));
+    queue->_type = _actor->getQueue()->getType();
+    _queue = queue;
+
+    CommandBufferAgent *cmdBuff = CC_NEW(CommandBufferAgent(_actor->getCommandBuffer(), this));
+    cmdBuff->_type = _actor->getCommandBuffer()->getType();
+    cmdBuff->_queue = _queue;
+    _cmdBuff = cmdBuff;
+
+    return true;
+}
+
+void DeviceAgent::destroy() {
+    setMultithreaded(false);
+
+    if (_cmdBuff) {
+        static_cast<CommandBufferAgent *>(_cmdBuff)->_actor = nullptr;
+        CC_DELETE(_cmdBuff);
+        _cmdBuff = nullptr;
+    }
+    if (_queue) {
+        static_cast<QueueAgent *>(_queue)->_actor = nullptr;
+        CC_DELETE(_queue);
+        _queue = nullptr;
+    }
+
+    _actor->destroy();
+}
+
+void DeviceAgent::resize(uint width, uint height) {
+    _width = width;
+    _height = height;
+
+    ENQUEUE_MESSAGE_3(
+        _mainMessageQueue, DeviceResize,
+        actor, _actor,
+        width, width,
+        height, height,
+        {
+            actor->resize(width, height);
+        });
+}
+
+void DeviceAgent::acquire() {
+    ENQUEUE_MESSAGE_1(
+        _mainMessageQueue, DeviceAcquire,
+        actor, _actor,
+        {
+            actor->acquire();
+        });
+}
+
+void DeviceAgent::present() {
+    ENQUEUE_MESSAGE_2(
+        _mainMessageQueue, DevicePresent,
+        actor, _actor,
+        frameBoundarySemaphore, &_frameBoundarySemaphore,
+        {
+            actor->present();
+            frameBoundarySemaphore->signal();
+        });
+
+    _mainMessageQueue->kick();
+    // keep the recording thread at most MAX_CPU_FRAME_AHEAD frames ahead of the render thread
+    _frameBoundarySemaphore.wait();
+}
+
+void DeviceAgent::setMultithreaded(bool multithreaded) {
+    if (multithreaded == _multithreaded) return;
+    _multithreaded = multithreaded;
+
+    if (multithreaded) {
+        // the render context has to be current on the render thread from now on
+        _actor->bindRenderContext(false);
+        _mainMessageQueue->setImmediateMode(false);
+        _mainMessageQueue->runConsumerThread();
+        ENQUEUE_MESSAGE_1(
+            _mainMessageQueue, DeviceMakeCurrentTrue,
+            actor, _actor,
+            {
+                actor->bindRenderContext(true);
+            });
+        _mainMessageQueue->kick();
+    } else {
+        ENQUEUE_MESSAGE_1(
+            _mainMessageQueue, DeviceMakeCurrentFalse,
+            actor, _actor,
+            {
+                actor->bindRenderContext(false);
+            });
+        _mainMessageQueue->terminateConsumerThread();
+        _mainMessageQueue->setImmediateMode(true);
+        _actor->bindRenderContext(true);
+    }
+}
+
+CommandBuffer *DeviceAgent::doCreateCommandBuffer(const CommandBufferInfo &info, bool /*hasAgent*/) {
+    CommandBuffer *actor = _actor->doCreateCommandBuffer(info, true);
+    return CC_NEW(CommandBufferAgent(actor, this));
+}
+
+Fence *DeviceAgent::createFence() {
+    return CC_NEW(FenceAgent(_actor->createFence(), this));
+}
+
+Queue *DeviceAgent::createQueue() {
+    return CC_NEW(QueueAgent(_actor->createQueue(), this));
+}
+
+Buffer *DeviceAgent::createBuffer() {
+    return CC_NEW(BufferAgent(_actor->createBuffer(), this));
+}
+
+Texture *DeviceAgent::createTexture() {
+    return CC_NEW(TextureAgent(_actor->createTexture(), this));
+}
+
+Sampler *DeviceAgent::createSampler() {
+    return CC_NEW(SamplerAgent(_actor->createSampler(), this));
+}
+
+Shader *DeviceAgent::createShader() {
+    return CC_NEW(ShaderAgent(_actor->createShader(), this));
+}
+
+InputAssembler *DeviceAgent::createInputAssembler() {
+    return CC_NEW(InputAssemblerAgent(_actor->createInputAssembler(), this));
+}
+
+RenderPass *DeviceAgent::createRenderPass() {
+    return CC_NEW(RenderPassAgent(_actor->createRenderPass(), this));
+}
+
+Framebuffer *DeviceAgent::createFramebuffer() {
+    return CC_NEW(FramebufferAgent(_actor->createFramebuffer(), this));
+}
+
+DescriptorSet *DeviceAgent::createDescriptorSet() {
+    return CC_NEW(DescriptorSetAgent(_actor->createDescriptorSet(), this));
+}
+
+DescriptorSetLayout *DeviceAgent::createDescriptorSetLayout() {
+    return CC_NEW(DescriptorSetLayoutAgent(_actor->createDescriptorSetLayout(), this));
+}
+
+PipelineLayout *DeviceAgent::createPipelineLayout() {
+    return CC_NEW(PipelineLayoutAgent(_actor->createPipelineLayout(), this));
+}
+
+PipelineState *DeviceAgent::createPipelineState() {
+    return CC_NEW(PipelineStateAgent(_actor->createPipelineState(), this));
+}
+
+void DeviceAgent::copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) {
+    ENQUEUE_MESSAGE_5(
+        _mainMessageQueue, DeviceCopyBuffersToTexture,
+        actor, _actor,
+        buffers, copyTextureUploadData(_mainMessageQueue, buffers, dst, regions, count),
+        dst, actorOf(dst),
+        regions, _mainMessageQueue->allocateAndCopy(regions, count),
+        count, count,
+        {
+            actor->copyBuffersToTexture(buffers, dst, regions, count);
+        });
+}
+
+const uint8_t *const *copyTextureUploadData(MessageQueue *queue, const uint8_t *const *buffers, const Texture *dst, const BufferTextureCopy *regions, uint count) {
+    // array & cube textures take one buffer per layer, the others one per region
+    const TextureType type = dst->getType();
+    const bool perLayer = type == TextureType::TEX2D_ARRAY || type == TextureType::CUBE;
+    uint bufferCount = 0u;
+    for (uint i = 0u; i < count; i++) {
+        bufferCount += perLayer ? regions[i].texSubres.layerCount : 1u;
+    }
+
+    const uint8_t **dstBuffers = queue->allocate<const uint8_t *>(bufferCount);
+    for (uint i = 0u, n = 0u; i < count; i++) {
+        const BufferTextureCopy &region = regions[i];
+        const uint size = FormatSize(dst->getFormat(), region.texExtent.width, region.texExtent.height, type == TextureType::TEX3D ? region.texExtent.depth : 1u);
+        const uint layerCount = perLayer ? region.texSubres.layerCount : 1u;
+        for (uint l = 0u; l < layerCount; l++, n++) {
+            dstBuffers[n] = queue->allocateAndCopy(buffers[n], size);
+        }
+    }
+    return dstBuffers;
+}
+
+} // namespace gfx
+} // namespace cc
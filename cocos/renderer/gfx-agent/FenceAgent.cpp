@@ -0,0 +1,85 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DeviceAgent.h"
+#include "FenceAgent.h"
+
+namespace cc {
+namespace gfx {
+
+FenceAgent::~FenceAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), FenceDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool FenceAgent::initialize(const FenceInfo &info) {
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), FenceInit,
+        actor, _actor,
+        info, info,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void FenceAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), FenceDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void FenceAgent::wait() {
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+
+    ENQUEUE_MESSAGE_1(
+        queue, FenceWait,
+        actor, _actor,
+        {
+            actor->wait();
+        });
+
+    queue->kickAndWait();
+}
+
+void FenceAgent::reset() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), FenceReset,
+        actor, _actor,
+        {
+            actor->reset();
+        });
+}
+
+} // namespace gfx
+} // namespace cc
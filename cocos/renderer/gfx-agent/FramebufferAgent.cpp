@@ -0,0 +1,74 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DeviceAgent.h"
+#include "FramebufferAgent.h"
+
+namespace cc {
+namespace gfx {
+
+FramebufferAgent::~FramebufferAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), FramebufferDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool FramebufferAgent::initialize(const FramebufferInfo &info) {
+    _renderPass = info.renderPass;
+    _colorTextures = info.colorTextures;
+    _depthStencilTexture = info.depthStencilTexture;
+
+    FramebufferInfo actorInfo = info;
+    actorInfo.renderPass = actorOf(info.renderPass);
+    for (uint i = 0u; i < actorInfo.colorTextures.size(); ++i) {
+        actorInfo.colorTextures[i] = actorOf(info.colorTextures[i]);
+    }
+    actorInfo.depthStencilTexture = actorOf(info.depthStencilTexture);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), FramebufferInit,
+        actor, _actor,
+        info, actorInfo,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void FramebufferAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), FramebufferDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+} // namespace gfx
+} // namespace cc
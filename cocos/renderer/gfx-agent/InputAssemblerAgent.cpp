@@ -0,0 +1,169 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DeviceAgent.h"
+#include "InputAssemblerAgent.h"
+
+namespace cc {
+namespace gfx {
+
+InputAssemblerAgent::~InputAssemblerAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool InputAssemblerAgent::initialize(const InputAssemblerInfo &info) {
+    _attributes = info.attributes;
+    _vertexBuffers = info.vertexBuffers;
+    _indexBuffer = info.indexBuffer;
+    _indirectBuffer = info.indirectBuffer;
+
+    if (_indexBuffer) {
+        _indexCount = _indexBuffer->getCount();
+        _firstIndex = 0;
+    } else if (_vertexBuffers.size()) {
+        _vertexCount = _vertexBuffers[0]->getCount();
+        _firstVertex = 0;
+        _vertexOffset = 0;
+    }
+    _attributesHash = computeAttributesHash();
+
+    InputAssemblerInfo actorInfo = info;
+    for (uint i = 0u; i < actorInfo.vertexBuffers.size(); ++i) {
+        actorInfo.vertexBuffers[i] = actorOf(info.vertexBuffers[i]);
+    }
+    actorInfo.indexBuffer = actorOf(info.indexBuffer);
+    actorInfo.indirectBuffer = actorOf(info.indirectBuffer);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerInit,
+        actor, _actor,
+        info, actorInfo,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void InputAssemblerAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void InputAssemblerAgent::setVertexCount(uint count) {
+    _vertexCount = count;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetVertexCount,
+        actor, _actor,
+        count, count,
+        {
+            actor->setVertexCount(count);
+        });
+}
+
+void InputAssemblerAgent::setFirstVertex(uint first) {
+    _firstVertex = first;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetFirstVertex,
+        actor, _actor,
+        first, first,
+        {
+            actor->setFirstVertex(first);
+        });
+}
+
+void InputAssemblerAgent::setIndexCount(uint count) {
+    _indexCount = count;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetIndexCount,
+        actor, _actor,
+        count, count,
+        {
+            actor->setIndexCount(count);
+        });
+}
+
+void InputAssemblerAgent::setFirstIndex(uint first) {
+    _firstIndex = first;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetFirstIndex,
+        actor, _actor,
+        first, first,
+        {
+            actor->setFirstIndex(first);
+        });
+}
+
+void InputAssemblerAgent::setVertexOffset(uint offset) {
+    _vertexOffset = offset;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetVertexOffset,
+        actor, _actor,
+        offset, offset,
+        {
+            actor->setVertexOffset(offset);
+        });
+}
+
+void InputAssemblerAgent::setInstanceCount(uint count) {
+    _instanceCount = count;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetInstanceCount,
+        actor, _actor,
+        count, count,
+        {
+            actor->setInstanceCount(count);
+        });
+}
+
+void InputAssemblerAgent::setFirstInstance(uint first) {
+    _firstInstance = first;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), InputAssemblerSetFirstInstance,
+        actor, _actor,
+        first, first,
+        {
+            actor->setFirstInstance(first);
+        });
+}
+
+} // namespace gfx
+} // namespace cc
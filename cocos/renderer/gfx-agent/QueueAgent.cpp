@@ -0,0 +1,85 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DeviceAgent.h"
+#include "QueueAgent.h"
+
+namespace cc {
+namespace gfx {
+
+QueueAgent::~QueueAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), QueueDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool QueueAgent::initialize(const QueueInfo &info) {
+    _type = info.type;
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), QueueInit,
+        actor, _actor,
+        info, info,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void QueueAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), QueueDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void QueueAgent::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence *fence) {
+    if (!count) return;
+
+    MessageQueue *queue = DeviceAgent::getInstance()->getMessageQueue();
+    const CommandBuffer **actorCmdBuffs = queue->allocate<const CommandBuffer *>(count);
+    for (uint i = 0u; i < count; ++i) {
+        actorCmdBuffs[i] = actorOf(cmdBuffs[i]);
+    }
+
+    ENQUEUE_MESSAGE_4(
+        queue, QueueSubmit,
+        actor, _actor,
+        cmdBuffs, actorCmdBuffs,
+        count, count,
+        fence, actorOf(fence),
+        {
+            actor->submit(cmdBuffs, count, fence);
+        });
+}
+
+} // namespace gfx
+} // namespace cc
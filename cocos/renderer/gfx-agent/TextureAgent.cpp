@@ -0,0 +1,120 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "DeviceAgent.h"
+#include "TextureAgent.h"
+
+namespace cc {
+namespace gfx {
+
+TextureAgent::~TextureAgent() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), TextureDestruct,
+        actor, _actor,
+        {
+            CC_DELETE(actor);
+        });
+}
+
+bool TextureAgent::initialize(const TextureInfo &info) {
+    _type = info.type;
+    _usage = info.usage;
+    _format = info.format;
+    _width = info.width;
+    _height = info.height;
+    _depth = info.depth;
+    _layerCount = info.layerCount;
+    _levelCount = info.levelCount;
+    _samples = info.samples;
+    _flags = info.flags;
+    _size = FormatSize(_format, _width, _height, _depth);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), TextureInit,
+        actor, _actor,
+        info, info,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+bool TextureAgent::initialize(const TextureViewInfo &info) {
+    _isTextureView = true;
+    _type = info.type;
+    _format = info.format;
+    _baseLevel = info.baseLevel;
+    _levelCount = info.levelCount;
+    _baseLayer = info.baseLayer;
+    _layerCount = info.layerCount;
+    _usage = info.texture->getUsage();
+    _width = info.texture->getWidth();
+    _height = info.texture->getHeight();
+    _depth = info.texture->getDepth();
+    _samples = info.texture->getSamples();
+    _flags = info.texture->getFlags();
+    _size = FormatSize(_format, _width, _height, _depth);
+
+    TextureViewInfo actorInfo = info;
+    actorInfo.texture = actorOf(info.texture);
+
+    ENQUEUE_MESSAGE_2(
+        DeviceAgent::getInstance()->getMessageQueue(), TextureViewInit,
+        actor, _actor,
+        info, actorInfo,
+        {
+            actor->initialize(info);
+        });
+
+    return true;
+}
+
+void TextureAgent::destroy() {
+    ENQUEUE_MESSAGE_1(
+        DeviceAgent::getInstance()->getMessageQueue(), TextureDestroy,
+        actor, _actor,
+        {
+            actor->destroy();
+        });
+}
+
+void TextureAgent::resize(uint width, uint height) {
+    _width = width;
+    _height = height;
+    _size = FormatSize(_format, _width, _height, _depth);
+
+    ENQUEUE_MESSAGE_3(
+        DeviceAgent::getInstance()->getMessageQueue(), TextureResize,
+        actor, _actor,
+        width, width,
+        height, height,
+        {
+            actor->resize(width, height);
+        });
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,65 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "EmptyBuffer.h"
+
+namespace cc {
+namespace gfx {
+
+bool EmptyBuffer::initialize(const BufferInfo &info) {
+    _usage = info.usage;
+    _memUsage = info.memUsage;
+    _size = info.size;
+    _stride = std::max(info.stride, 1U);
+    _count = _size / _stride;
+    _flags = info.flags;
+
+    return true;
+}
+
+bool EmptyBuffer::initialize(const BufferViewInfo &info) {
+    _isBufferView = true;
+    _usage = info.buffer->getUsage();
+    _memUsage = info.buffer->getMemUsage();
+    _size = _stride = info.range;
+    _count = 1u;
+    _flags = info.buffer->getFlags();
+
+    return true;
+}
+
+void EmptyBuffer::destroy() {
+}
+
+void EmptyBuffer::resize(uint size) {
+    _size = size;
+    _count = _size / _stride;
+}
+
+void EmptyBuffer::update(void *buffer, uint size) {
+}
+
+} // namespace gfx
+} // namespace cc
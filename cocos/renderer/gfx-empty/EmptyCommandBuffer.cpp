@@ -0,0 +1,105 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CoreStd.h"
+
+#include "EmptyCommandBuffer.h"
+#include "gfx/GFXInputAssembler.h"
+
+namespace cc {
+namespace gfx {
+
+bool EmptyCommandBuffer::initialize(const CommandBufferInfo &info) {
+    _type = info.type;
+    _queue = info.queue;
+
+    return true;
+}
+
+void EmptyCommandBuffer::destroy() {
+}
+
+void EmptyCommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer, int submitIndex) {
+    _numDrawCalls = 0;
+    _numInstances = 0;
+    _numTriangles = 0;
+}
+
+void EmptyCommandBuffer::end() {
+}
+
+void EmptyCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, bool fromSecondaryCB) {
+}
+
+void EmptyCommandBuffer::endRenderPass() {
+}
+
+void EmptyCommandBuffer::bindPipelineState(PipelineState *pso) {
+}
+
+void EmptyCommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+}
+
+void EmptyCommandBuffer::bindInputAssembler(InputAssembler *ia) {
+}
+
+void EmptyCommandBuffer::setViewport(const Viewport &vp) {
+}
+
+void EmptyCommandBuffer::setScissor(const Rect &rect) {
+}
+
+void EmptyCommandBuffer::setLineWidth(float width) {
+}
+
+void EmptyCommandBuffer::setDepthBias(float constant, float clamp, float slope) {
+}
+
+void EmptyCommandBuffer::setBlendConstants(const Color &constants) {
+}
+
+void EmptyCommandBuffer::setDepthBound(float minBounds, float maxBounds) {
+}
+
+void EmptyCommandBuffer::setStencilWriteMask(StencilFace face, uint mask) {
+}
+
+void EmptyCommandBuffer::setStencilCompareMask(StencilFace face, int ref, uint mask) {
+}
+
+void EmptyCommandBuffer::draw(InputAssembler *ia) {
+    ++_numDrawCalls;
+    _numInstances += ia->getInstanceCount();
+}
+
+void EmptyCommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size) {
+}
+
+void EmptyCommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) {
+}
+
+void EmptyCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t count) {
+}
+
+} // namespace gfx
+} // namespace cc
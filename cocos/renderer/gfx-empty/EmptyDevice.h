@@ -0,0 +1,80 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "gfx/GFXDevice.h"
+
+namespace cc {
+namespace gfx {
+
+// A backend that accepts every call and touches no GPU API. Used to run the
+// renderer headless, e.g. to exercise DeviceAgent record & replay on machines
+// without a graphics driver.
+class CC_DLL EmptyDevice final : public Device {
+public:
+    EmptyDevice();
+    ~EmptyDevice();
+
+    using Device::copyBuffersToTexture;
+    using Device::createBuffer;
+    using Device::createCommandBuffer;
+    using Device::createDescriptorSet;
+    using Device::createDescriptorSetLayout;
+    using Device::createFence;
+    using Device::createFramebuffer;
+    using Device::createInputAssembler;
+    using Device::createPipelineLayout;
+    using Device::createPipelineState;
+    using Device::createQueue;
+    using Device::createRenderPass;
+    using Device::createSampler;
+    using Device::createShader;
+    using Device::createTexture;
+
+    virtual bool initialize(const DeviceInfo &info) override;
+    virtual void destroy() override;
+    virtual void resize(uint width, uint height) override;
+    virtual void acquire() override;
+    virtual void present() override;
+
+protected:
+    virtual CommandBuffer *doCreateCommandBuffer(const CommandBufferInfo &info, bool hasAgent) override;
+    virtual Fence *createFence() override;
+    virtual Queue *createQueue() override;
+    virtual Buffer *createBuffer() override;
+    virtual Texture *createTexture() override;
+    virtual Sampler *createSampler() override;
+    virtual Shader *createShader() override;
+    virtual InputAssembler *createInputAssembler() override;
+    virtual RenderPass *createRenderPass() override;
+    virtual Framebuffer *createFramebuffer() override;
+    virtual DescriptorSet *createDescriptorSet() override;
+    virtual DescriptorSetLayout *createDescriptorSetLayout() override;
+    virtual PipelineLayout *createPipelineLayout() override;
+    virtual PipelineState *createPipelineState() override;
+    virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) override;
+};
+
+} // namespace gfx
+} // namespace cc
@@ -144,6 +144,7 @@ bool GLES2Device::initialize(const DeviceInfo &info) {
     _features[static_cast<uint>(Feature::LINE_WIDTH)] = true;
     _features[static_cast<uint>(Feature::STENCIL_COMPARE_MASK)] = true;
     _features[static_cast<uint>(Feature::STENCIL_WRITE_MASK)] = true;
+    _features[static_cast<uint>(Feature::SECONDARY_COMMAND_BUFFER)] = true;
     _features[static_cast<uint>(Feature::FORMAT_RGB8)] = true;
 
     if (checkExtension("depth_texture")) {
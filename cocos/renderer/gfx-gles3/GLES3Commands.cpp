@@ -1000,90 +1000,141 @@ void GLES3CmdFuncDestroySampler(GLES3Device *device, GLES3GPUSampler *gpuSampler
     }
 }
 
+namespace {
+bool loadProgramBinary(BinaryCache *cache, uint64_t key, GLES3GPUShader *gpuShader) {
+    uint format = 0u;
+    vector<uint8_t> binary;
+    if (!cache->find(key, &format, binary)) return false;
+
+    GLint status = GL_FALSE;
+    GL_CHECK(gpuShader->glProgram = glCreateProgram());
+    GL_CHECK(glProgramBinary(gpuShader->glProgram, format, binary.data(), (GLsizei)binary.size()));
+    GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status));
+    if (status != GL_TRUE) {
+        // driver updates invalidate the binaries without changing the reported version string
+        GL_CHECK(glDeleteProgram(gpuShader->glProgram));
+        gpuShader->glProgram = 0;
+        cache->erase(key);
+        return false;
+    }
+    return true;
+}
+
+void storeProgramBinary(BinaryCache *cache, uint64_t key, GLuint glProgram) {
+    GLint length = 0;
+    GL_CHECK(glGetProgramiv(glProgram, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) return;
+
+    GLenum format = 0;
+    vector<uint8_t> binary(length);
+    GL_CHECK(glGetProgramBinary(glProgram, length, &length, &format, binary.data()));
+    cache->insert(key, format, binary.data(), length);
+}
+} // namespace
+
 void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
     GLenum glShaderStage = 0;
     String shaderStageStr;
     GLint status;
 
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+    BinaryCache *programCache = device->programCache();
+    uint64_t programHash = 0u;
+    if (programCache) {
+        programHash = BinaryCache::hash(gpuShader->name);
+        for (const GLES3GPUShaderStage &gpuStage : gpuShader->gpuStages) {
+            programHash = BinaryCache::hash(&gpuStage.type, sizeof(gpuStage.type), programHash);
+            programHash = BinaryCache::hash(gpuStage.source, programHash);
+        }
+    }
 
-        switch (gpuStage.type) {
-            case ShaderStageFlagBit::VERTEX: {
-                glShaderStage = GL_VERTEX_SHADER;
-                shaderStageStr = "Vertex Shader";
-                break;
-            }
-            case ShaderStageFlagBit::FRAGMENT: {
-                glShaderStage = GL_FRAGMENT_SHADER;
-                shaderStageStr = "Fragment Shader";
-                break;
-            }
-            default: {
-                CCASSERT(false, "Unsupported ShaderStageFlagBit");
-                return;
+    if (!programCache || !loadProgramBinary(programCache, programHash, gpuShader)) {
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+
+            switch (gpuStage.type) {
+                case ShaderStageFlagBit::VERTEX: {
+                    glShaderStage = GL_VERTEX_SHADER;
+                    shaderStageStr = "Vertex Shader";
+                    break;
+                }
+                case ShaderStageFlagBit::FRAGMENT: {
+                    glShaderStage = GL_FRAGMENT_SHADER;
+                    shaderStageStr = "Fragment Shader";
+                    break;
+                }
+                default: {
+                    CCASSERT(false, "Unsupported ShaderStageFlagBit");
+                    return;
+                }
             }
-        }
 
-        GL_CHECK(gpuStage.glShader = glCreateShader(glShaderStage));
-        String shaderSource = "#version 300 es\n" + gpuStage.source;
-        const char *source = shaderSource.c_str();
-        GL_CHECK(glShaderSource(gpuStage.glShader, 1, (const GLchar **)&source, nullptr));
-        GL_CHECK(glCompileShader(gpuStage.glShader));
+            GL_CHECK(gpuStage.glShader = glCreateShader(glShaderStage));
+            String shaderSource = "#version 300 es\n" + gpuStage.source;
+            const char *source = shaderSource.c_str();
+            GL_CHECK(glShaderSource(gpuStage.glShader, 1, (const GLchar **)&source, nullptr));
+            GL_CHECK(glCompileShader(gpuStage.glShader));
 
-        GL_CHECK(glGetShaderiv(gpuStage.glShader, GL_COMPILE_STATUS, &status));
-        if (status != GL_TRUE) {
-            GLint logSize = 0;
-            GL_CHECK(glGetShaderiv(gpuStage.glShader, GL_INFO_LOG_LENGTH, &logSize));
+            GL_CHECK(glGetShaderiv(gpuStage.glShader, GL_COMPILE_STATUS, &status));
+            if (status != GL_TRUE) {
+                GLint logSize = 0;
+                GL_CHECK(glGetShaderiv(gpuStage.glShader, GL_INFO_LOG_LENGTH, &logSize));
 
-            ++logSize;
-            GLchar *logs = (GLchar *)CC_MALLOC(logSize);
-            GL_CHECK(glGetShaderInfoLog(gpuStage.glShader, logSize, nullptr, logs));
+                ++logSize;
+                GLchar *logs = (GLchar *)CC_MALLOC(logSize);
+                GL_CHECK(glGetShaderInfoLog(gpuStage.glShader, logSize, nullptr, logs));
 
-            CC_LOG_ERROR("%s in %s compilation failed.", shaderStageStr.c_str(), gpuShader->name.c_str());
-            CC_LOG_ERROR("Shader source: %s", gpuStage.source.c_str());
-            CC_LOG_ERROR(logs);
-            CC_FREE(logs);
-            GL_CHECK(glDeleteShader(gpuStage.glShader));
-            gpuStage.glShader = 0;
-            return;
+                CC_LOG_ERROR("%s in %s compilation failed.", shaderStageStr.c_str(), gpuShader->name.c_str());
+                CC_LOG_ERROR("Shader source: %s", gpuStage.source.c_str());
+                CC_LOG_ERROR(logs);
+                CC_FREE(logs);
+                GL_CHECK(glDeleteShader(gpuStage.glShader));
+                gpuStage.glShader = 0;
+                return;
+            }
         }
-    }
 
-    GL_CHECK(gpuShader->glProgram = glCreateProgram());
+        GL_CHECK(gpuShader->glProgram = glCreateProgram());
 
-    // link program
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
-        GL_CHECK(glAttachShader(gpuShader->glProgram, gpuStage.glShader));
-    }
+        // link program
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+            GL_CHECK(glAttachShader(gpuShader->glProgram, gpuStage.glShader));
+        }
 
-    GL_CHECK(glLinkProgram(gpuShader->glProgram));
+        if (programCache) {
+            GL_CHECK(glProgramParameteri(gpuShader->glProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+        GL_CHECK(glLinkProgram(gpuShader->glProgram));
 
-    // detach & delete immediately
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
-        if (gpuStage.glShader) {
-            GL_CHECK(glDetachShader(gpuShader->glProgram, gpuStage.glShader));
-            GL_CHECK(glDeleteShader(gpuStage.glShader));
-            gpuStage.glShader = 0;
+        // detach & delete immediately
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+            if (gpuStage.glShader) {
+                GL_CHECK(glDetachShader(gpuShader->glProgram, gpuStage.glShader));
+                GL_CHECK(glDeleteShader(gpuStage.glShader));
+                gpuStage.glShader = 0;
+            }
         }
-    }
 
-    GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status));
-    if (status != 1) {
-        CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
-        GLint logSize = 0;
-        GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize));
-        if (logSize) {
-            ++logSize;
-            GLchar *logs = (GLchar *)CC_MALLOC(logSize);
-            GL_CHECK(glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs));
-
-            CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
-            CC_LOG_ERROR(logs);
-            CC_FREE(logs);
-            return;
+        GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status));
+        if (status != 1) {
+            CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
+            GLint logSize = 0;
+            GL_CHECK(glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize));
+            if (logSize) {
+                ++logSize;
+                GLchar *logs = (GLchar *)CC_MALLOC(logSize);
+                GL_CHECK(glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs));
+
+                CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
+                CC_LOG_ERROR(logs);
+                CC_FREE(logs);
+                return;
+            }
+        }
+
+        if (programCache && status == GL_TRUE) {
+            storeProgramBinary(programCache, programHash, gpuShader->glProgram);
         }
     }
 
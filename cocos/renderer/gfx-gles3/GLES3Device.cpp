@@ -128,6 +128,7 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
     _features[static_cast<uint>(Feature::LINE_WIDTH)] = true;
     _features[static_cast<uint>(Feature::STENCIL_COMPARE_MASK)] = true;
     _features[static_cast<uint>(Feature::STENCIL_WRITE_MASK)] = true;
+    _features[static_cast<uint>(Feature::SECONDARY_COMMAND_BUFFER)] = true;
     _features[static_cast<uint>(Feature::FORMAT_RGB8)] = true;
     _features[static_cast<uint>(Feature::FORMAT_D16)] = true;
     _features[static_cast<uint>(Feature::FORMAT_D24)] = true;
@@ -171,10 +172,28 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache->initialize(_maxTextureUnits, _maxUniformBufferBindings, _maxVertexAttributes);
 
+    GLint numProgramBinaryFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+    if (numProgramBinaryFormats > 0) {
+        uint64_t deviceHash = BinaryCache::hash(_renderer);
+        deviceHash = BinaryCache::hash(_vendor, deviceHash);
+        deviceHash = BinaryCache::hash(_version, deviceHash);
+        _programCache = CC_NEW(BinaryCache("gles3-programs", deviceHash));
+        _programCache->load();
+    }
+
     return true;
 }
 
 void GLES3Device::destroy() {
+    if (_programCache) {
+        CC_LOG_INFO("Program binary cache: %d hits, %d misses, %d evictions, %d rejections.",
+                    _programCache->getHitCount(), _programCache->getMissCount(),
+                    _programCache->getEvictionCount(), _programCache->getRejectionCount());
+        _programCache->flush(true);
+        CC_SAFE_DELETE(_programCache);
+    }
+
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
     CC_SAFE_DELETE(_gpuStagingBufferPool);
@@ -200,6 +219,10 @@ void GLES3Device::present() {
 
     _context->present();
 
+    if (_programCache && _programCache->update()) {
+        _programCache->flush();
+    }
+
     // Clear queue stats
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
@@ -60,6 +60,7 @@ public:
 
     CC_INLINE GLES3GPUStateCache *stateCache() const { return _gpuStateCache; }
     CC_INLINE GLES3GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPool; }
+    CC_INLINE BinaryCache *programCache() const { return _programCache; }
 
     CC_INLINE bool checkExtension(const String &extension) const {
         for (size_t i = 0; i < _extensions.size(); ++i) {
@@ -97,6 +98,7 @@ private:
     GLES3Context *_deviceContext = nullptr;
     GLES3GPUStateCache *_gpuStateCache = nullptr;
     GLES3GPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+    BinaryCache *_programCache = nullptr;
 
     StringArray _extensions;
 
@@ -152,6 +152,8 @@ bool CCMTLDevice::initialize(const DeviceInfo &info) {
     _features[static_cast<uint>(Feature::STENCIL_COMPARE_MASK)] = false;
     _features[static_cast<uint>(Feature::STENCIL_WRITE_MASK)] = false;
     _features[static_cast<uint>(Feature::MULTITHREADED_SUBMISSION)] = true;
+    // MTLCommandBuffer has no secondary command buffers, execute() only merges the statistics
+    _features[static_cast<uint>(Feature::SECONDARY_COMMAND_BUFFER)] = false;
 
     _features[static_cast<uint>(Feature::FORMAT_RGB8)] = false;
     _features[static_cast<uint>(Feature::FORMAT_D16)] = mu::isDepthStencilFormatSupported(mtlDevice, Format::D16, gpuFamily);
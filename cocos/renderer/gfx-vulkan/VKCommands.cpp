@@ -38,11 +38,13 @@ namespace cc {
 namespace gfx {
 
 CCVKGPUCommandBufferPool *CCVKGPUDevice::getCommandBufferPool(std::thread::id threadID) {
-    if (!commandBufferPools.count(threadID)) {
-        //std::scoped_lock<std::mutex> guard(mutex);
-        commandBufferPools[threadID] = CC_NEW(CCVKGPUCommandBufferPool(this));
+    // secondary command buffers may be recorded on worker threads
+    std::lock_guard<std::mutex> guard(mutex);
+    auto iter = commandBufferPools.find(threadID);
+    if (iter == commandBufferPools.end()) {
+        iter = commandBufferPools.emplace(threadID, CC_NEW(CCVKGPUCommandBufferPool(this))).first;
     }
-    return commandBufferPools[threadID];
+    return iter->second;
 }
 
 void insertVkDynamicStates(vector<VkDynamicState> &out, const vector<DynamicStateFlagBit> &dynamicStates) {
@@ -666,6 +668,10 @@ void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gp
 
     VK_CHECK(vkCreateGraphicsPipelines(device->gpuDevice()->vkDevice, device->gpuDevice()->vkPipelineCache,
                                        1, &createInfo, nullptr, &gpuPipelineState->vkPipeline));
+
+    if (device->pipelineCache()) {
+        device->pipelineCache()->markDirty();
+    }
 }
 
 void CCVKCmdFuncCreateFence(CCVKDevice *device, CCVKGPUFence *gpuFence) {
@@ -37,6 +37,22 @@ CCVKDevice::CCVKDevice() {
 CCVKDevice::~CCVKDevice() {
 }
 
+namespace {
+bool isPipelineCacheCompatible(const vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties) {
+    // VkPipelineCacheHeaderVersionOne: length, version, vendorID, deviceID, pipelineCacheUUID
+    constexpr size_t HEADER_SIZE = 4u * sizeof(uint32_t) + VK_UUID_SIZE;
+    if (data.size() < HEADER_SIZE) return false;
+
+    uint32_t header[4];
+    memcpy(header, data.data(), sizeof(header));
+    return header[0] >= HEADER_SIZE &&
+           header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header[2] == properties.vendorID &&
+           header[3] == properties.deviceID &&
+           !memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+} // namespace
+
 CCVKGPUContext *CCVKDevice::gpuContext() const {
     return ((CCVKContext *)_context)->gpuContext();
 }
@@ -189,6 +205,7 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     _features[(uint)Feature::STENCIL_COMPARE_MASK] = true;
     _features[(uint)Feature::STENCIL_WRITE_MASK] = true;
     _features[(uint)Feature::MULTITHREADED_SUBMISSION] = true;
+    _features[(uint)Feature::SECONDARY_COMMAND_BUFFER] = true;
 
     _gpuDevice->useMultiDrawIndirect = deviceFeatures.multiDrawIndirect;
     _gpuDevice->useDescriptorUpdateTemplate = checkExtension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
@@ -327,7 +344,24 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     _gpuDevice->defaultBuffer.count = 1u;
     CCVKCmdFuncCreateBuffer(this, &_gpuDevice->defaultBuffer);
 
+    const VkPhysicalDeviceProperties &deviceProperties = gpuContext->physicalDeviceProperties;
+    uint64_t deviceHash = BinaryCache::hash(&deviceProperties.vendorID, sizeof(deviceProperties.vendorID));
+    deviceHash = BinaryCache::hash(&deviceProperties.deviceID, sizeof(deviceProperties.deviceID), deviceHash);
+    deviceHash = BinaryCache::hash(&deviceProperties.driverVersion, sizeof(deviceProperties.driverVersion), deviceHash);
+    deviceHash = BinaryCache::hash(deviceProperties.pipelineCacheUUID, VK_UUID_SIZE, deviceHash);
+    _pipelineCache = CC_NEW(BinaryCache("vk-pipelines", deviceHash));
+    _pipelineCache->load();
+
+    vector<uint8_t> pipelineCacheData;
+    if (_pipelineCache->find(0u, nullptr, pipelineCacheData) && !isPipelineCacheCompatible(pipelineCacheData, deviceProperties)) {
+        // some drivers crash on foreign cache blobs instead of ignoring them, so validate before handing it over
+        _pipelineCache->erase(0u);
+        pipelineCacheData.clear();
+    }
+
     VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    pipelineCacheInfo.initialDataSize = pipelineCacheData.size();
+    pipelineCacheInfo.pInitialData = pipelineCacheData.data();
     VK_CHECK(vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache));
 
     for (uint i = 0u; i < gpuContext->swapchainCreateInfo.minImageCount; i++) {
@@ -419,6 +453,16 @@ void CCVKDevice::destroy() {
         _gpuSwapchain = nullptr;
     }
 
+    if (_pipelineCache) {
+        CC_LOG_INFO("Pipeline cache: %d hits, %d misses, %d rejections.",
+                    _pipelineCache->getHitCount(), _pipelineCache->getMissCount(), _pipelineCache->getRejectionCount());
+        if (_pipelineCache->isDirty()) {
+            savePipelineCache();
+            _pipelineCache->flush(true);
+        }
+        CC_SAFE_DELETE(_pipelineCache);
+    }
+
     if (_gpuDevice) {
         if (_gpuDevice->vkPipelineCache) {
             vkDestroyPipelineCache(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, nullptr);
@@ -527,6 +571,21 @@ void CCVKDevice::present() {
         gpuRecycleBin()->clear();
         gpuStagingBufferPool()->reset();
     }
+
+    if (_pipelineCache->update()) {
+        savePipelineCache();
+        _pipelineCache->flush();
+    }
+}
+
+void CCVKDevice::savePipelineCache() {
+    size_t size = 0u;
+    VK_CHECK(vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &size, nullptr));
+    if (!size) return;
+
+    vector<uint8_t> data(size);
+    VK_CHECK(vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &size, data.data()));
+    _pipelineCache->insert(0u, 0u, data.data(), size);
 }
 
 CCVKGPUFencePool *CCVKDevice::gpuFencePool() { return _gpuFencePools[_gpuDevice->curBackBufferIndex]; }
@@ -86,6 +86,7 @@ public:
     CC_INLINE CCVKGPUDescriptorHub *gpuDescriptorHub() { return _gpuDescriptorHub; }
     CC_INLINE CCVKGPUSemaphorePool *gpuSemaphorePool() { return _gpuSemaphorePool; }
     CC_INLINE CCVKGPUDescriptorSetHub *gpuDescriptorSetHub() { return _gpuDescriptorSetHub; }
+    CC_INLINE BinaryCache *pipelineCache() { return _pipelineCache; }
 
     CCVKGPUFencePool *gpuFencePool();
     CCVKGPURecycleBin *gpuRecycleBin();
@@ -110,6 +111,7 @@ private:
 
     void destroySwapchain();
     bool checkSwapchainStatus();
+    void savePipelineCache();
 
     CCVKGPUDevice *_gpuDevice = nullptr;
     CCVKGPUSwapchain *_gpuSwapchain = nullptr;
@@ -124,6 +126,7 @@ private:
     CCVKGPUDescriptorHub *_gpuDescriptorHub = nullptr;
     CCVKGPUSemaphorePool *_gpuSemaphorePool = nullptr;
     CCVKGPUDescriptorSetHub *_gpuDescriptorSetHub = nullptr;
+    BinaryCache *_pipelineCache = nullptr;
 
     vector<const char *> _layers;
     vector<const char *> _extensions;
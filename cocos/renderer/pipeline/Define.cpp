@@ -277,6 +277,43 @@ const gfx::UniformSampler SPOT_LIGHTING_MAP::LAYOUT = {
     1,
 };
 
+const String UBOClusterLights::NAME = "CCClusterLights";
+const gfx::DescriptorSetLayoutBinding UBOClusterLights::DESCRIPTOR = {
+    UBOClusterLights::BINDING,
+    gfx::DescriptorType::UNIFORM_BUFFER,
+    1,
+    gfx::ShaderStageFlagBit::FRAGMENT,
+};
+const gfx::UniformBlock UBOClusterLights::LAYOUT = {
+    GLOBAL_SET,
+    UBOClusterLights::BINDING,
+    UBOClusterLights::NAME,
+    {
+        {"cc_clusterInfo", gfx::Type::FLOAT4, 1},
+        {"cc_clusterParams", gfx::Type::FLOAT4, 1},
+        {"cc_clusterLightPos", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightColor", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightSizeRangeAngle", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightDir", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+    },
+    1,
+};
+
+const String CLUSTER_LIGHTS::NAME = "cc_clusterLights";
+const gfx::DescriptorSetLayoutBinding CLUSTER_LIGHTS::DESCRIPTOR = {
+    CLUSTER_LIGHTS::BINDING,
+    gfx::DescriptorType::SAMPLER,
+    1,
+    gfx::ShaderStageFlagBit::FRAGMENT,
+};
+const gfx::UniformSampler CLUSTER_LIGHTS::LAYOUT = {
+    GLOBAL_SET,
+    CLUSTER_LIGHTS::BINDING,
+    CLUSTER_LIGHTS::NAME,
+    gfx::Type::SAMPLER2D,
+    1,
+};
+
 const String JOINT_TEXTURE::NAME = "cc_jointTexture";
 const gfx::DescriptorSetLayoutBinding JOINT_TEXTURE::DESCRIPTOR = {
     JOINT_TEXTURE::BINDING,
@@ -123,10 +123,18 @@ struct CC_DLL InternalBindingInst : public InternalBindingDesc {
     gfx::Texture *texture = nullptr;
 };
 
+enum class CC_DLL RenderQueueSortMode {
+    FRONT_TO_BACK,
+    BACK_TO_FRONT,
+};
+
 struct CC_DLL RenderQueueCreateInfo {
     bool isTransparent = false;
     uint phases = 0;
     std::function<bool(const RenderPass &a, const RenderPass &b)> sortFunc;
+    RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
+    // sorts by packed 64-bit keys instead of calling sortFunc
+    bool radixSort = true;
 };
 
 enum class CC_DLL RenderPriority {
@@ -135,11 +143,6 @@ enum class CC_DLL RenderPriority {
     DEFAULT = 0x80,
 };
 
-enum class CC_DLL RenderQueueSortMode {
-    FRONT_TO_BACK,
-    BACK_TO_FRONT,
-};
-
 struct CC_DLL RenderQueueDesc {
     bool isTransparent = false;
     RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
@@ -176,6 +179,10 @@ enum class CC_DLL PipelineGlobalBindings {
     SAMPLER_ENVIRONMENT, // don't put this as the first sampler binding due to Mac GL driver issues: cubemap at texture unit 0 causes rendering issues
     SAMPLER_SPOT_LIGHTING_MAP,
 
+    // clustered lighting, kept last so the bindings above don't move
+    UBO_CLUSTER_LIGHTS,
+    SAMPLER_CLUSTER_LIGHTS,
+
     COUNT,
 };
 
@@ -344,6 +351,23 @@ struct CC_DLL UBOShadow : public Object {
     static const String NAME;
 };
 
+// Light list for clustered forward shading, the per-cluster light indices live in CLUSTER_LIGHTS.
+struct CC_DLL UBOClusterLights : public Object {
+    static constexpr uint MAX_LIGHTS = 128;
+    static constexpr uint CLUSTER_INFO_OFFSET = 0;   // tilesX, tilesY, slicesZ, lightCount
+    static constexpr uint CLUSTER_PARAMS_OFFSET = 4; // sliceScale, sliceBias, texture width, first index texel
+    static constexpr uint LIGHT_POS_OFFSET = UBOClusterLights::CLUSTER_PARAMS_OFFSET + 4;
+    static constexpr uint LIGHT_COLOR_OFFSET = UBOClusterLights::LIGHT_POS_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint LIGHT_SIZE_RANGE_ANGLE_OFFSET = UBOClusterLights::LIGHT_COLOR_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint LIGHT_DIR_OFFSET = UBOClusterLights::LIGHT_SIZE_RANGE_ANGLE_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint COUNT = UBOClusterLights::LIGHT_DIR_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint SIZE = UBOClusterLights::COUNT * 4;
+    static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::UBO_CLUSTER_LIGHTS);
+    static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
+    static const gfx::UniformBlock LAYOUT;
+    static const String NAME;
+};
+
 class CC_DLL SamplerLib : public Object {
 public:
     gfx::Sampler *getSampler(uint hash);
@@ -414,6 +438,16 @@ struct CC_DLL SPOT_LIGHTING_MAP : public Object {
     static const String NAME;
 };
 
+// RGBA32F texture, TEXTURE_WIDTH texels wide. Texel i < cluster count holds (first index, light count)
+// of cluster i, the light indices follow from the texel given in UBOClusterLights, four per texel.
+struct CC_DLL CLUSTER_LIGHTS : public Object {
+    static constexpr uint TEXTURE_WIDTH = 1024;
+    static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::SAMPLER_CLUSTER_LIGHTS);
+    static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
+    static const gfx::UniformSampler LAYOUT;
+    static const String NAME;
+};
+
 struct CC_DLL JOINT_TEXTURE : public Object {
     static constexpr uint BINDING = static_cast<uint>(ModelLocalBindings::SAMPLER_JOINTS);
     static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
@@ -32,6 +32,7 @@ THE SOFTWARE.
 namespace cc {
 namespace pipeline {
 map<uint, map<uint, InstancedBuffer *>> InstancedBuffer::_buffers;
+uint InstancedBuffer::_frameIndex = 0;
 InstancedBuffer *InstancedBuffer::get(uint pass) {
     return InstancedBuffer::get(pass, 0);
 }
@@ -53,11 +54,14 @@ InstancedBuffer::~InstancedBuffer() {
 
 void InstancedBuffer::destroy() {
     for (auto &instance : _instances) {
-        instance.vb->destroy();
-        instance.ia->destroy();
+        for (uint i = 0; i < InstancedItem::RING_SIZE; ++i) {
+            CC_SAFE_DESTROY(instance.ias[i]);
+            CC_SAFE_DESTROY(instance.vbs[i]);
+        }
         CC_FREE(instance.data);
     }
     _instances.clear();
+    _itemIndices.clear();
 }
 
 void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel, uint passIdx) {
@@ -66,52 +70,53 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
 
     if (!stride) return; // we assume per-instance attributes are always present
     auto sourceIA = subModel->getInputAssembler();
-    auto lightingMap = subModel->getDescriptorSet()->getTexture(LIGHTMAP_TEXTURE::BINDING);
-    auto shader = subModel->getShader(passIdx);
     auto descriptorSet = subModel->getDescriptorSet();
-    for (int i = 0; i < _instances.size(); i++) {
-        auto &instance = _instances[i];
-        if (instance.ia->getIndexBuffer() != sourceIA->getIndexBuffer() || instance.count >= MAX_CAPACITY) {
-            continue;
-        }
-
-        // check same binding
-        if (instance.lightingMap != lightingMap) {
-            continue;
+    const ItemKey key = {sourceIA->getIndexBuffer(), descriptorSet->getTexture(LIGHTMAP_TEXTURE::BINDING)};
+
+    // items sharing a key are chained, walk to the first one with room left
+    auto iter = _itemIndices.find(key);
+    uint idx = iter != _itemIndices.end() ? iter->second : InstancedItem::INVALID_INDEX;
+    uint prev = InstancedItem::INVALID_INDEX;
+    while (idx != InstancedItem::INVALID_INDEX && _instances[idx].count >= MAX_CAPACITY) {
+        prev = idx;
+        idx = _instances[idx].next;
+    }
+    if (idx == InstancedItem::INVALID_INDEX) {
+        idx = createItem(model, subModel, stride, passIdx);
+        if (prev != InstancedItem::INVALID_INDEX) {
+            _instances[prev].next = idx;
+        } else {
+            _itemIndices.emplace(key, idx);
         }
+    }
 
-        if (instance.stride != stride) {
-            return;
-        }
-        if (instance.count >= instance.capacity) { // resize buffers
-            instance.capacity <<= 1;
-            const auto newSize = instance.stride * instance.capacity;
-            const auto oldData = instance.data;
-            instance.data = (uint8_t *)CC_MALLOC(newSize);
-            memcpy(instance.data, oldData, instance.vb->getSize());
-            instance.vb->resize(newSize);
-            CC_FREE(oldData);
-        }
-        if (instance.shader != shader) {
-            instance.shader = shader;
-        }
-        if (instance.descriptorSet != descriptorSet) {
-            instance.descriptorSet = descriptorSet;
-        }
-        memcpy(instance.data + instance.stride * instance.count++, instancedBuffer, stride);
-        _hasPendingModels = true;
+    auto &instance = _instances[idx];
+    if (instance.stride != stride) {
         return;
     }
+    if (instance.count >= instance.capacity) { // grow the staging data, vertex buffers follow on upload
+        instance.capacity <<= 1;
+        instance.data = (uint8_t *)CC_REALLOC(instance.data, instance.stride * instance.capacity);
+    }
+    instance.shader = subModel->getShader(passIdx);
+    instance.descriptorSet = descriptorSet;
+
+    // static instances write the same bytes every frame, those are left alone so nothing gets uploaded
+    const uint offset = instance.stride * instance.count++;
+    uint8_t *dst = instance.data + offset;
+    if (offset >= instance.writtenSize || memcmp(dst, instancedBuffer, stride)) {
+        memcpy(dst, instancedBuffer, stride);
+        const uint end = offset + stride;
+        instance.writtenSize = std::max(instance.writtenSize, end);
+        for (auto &dirtyEnd : instance.dirtyEnds) {
+            dirtyEnd = std::max(dirtyEnd, end);
+        }
+    }
+    _hasPendingModels = true;
+}
 
-    // Create a new instance
-    auto newSize = stride * INITIAL_CAPACITY;
-    auto vb = _device->createBuffer({
-        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
-        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
-        static_cast<uint>(newSize),
-        static_cast<uint>(stride),
-    });
-
+uint InstancedBuffer::createItem(const ModelView *model, const SubModelView *subModel, uint stride, uint passIdx) {
+    auto sourceIA = subModel->getInputAssembler();
     auto vertexBuffers = sourceIA->getVertexBuffers();
     auto attributes = sourceIA->getAttributes();
     auto indexBuffer = sourceIA->getIndexBuffer();
@@ -123,22 +128,57 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         gfx::Attribute newAttr = {attribute->name, attribute->format, attribute->isNormalized, static_cast<uint>(vertexBuffers.size()), true, attribute->location};
         attributes.emplace_back(std::move(newAttr));
     }
-
-    uint8_t *data = (uint8_t *)CC_MALLOC(newSize);
-    memcpy(data, instancedBuffer, stride);
-    vertexBuffers.emplace_back(vb);
-    gfx::InputAssemblerInfo iaInfo = {attributes, vertexBuffers, indexBuffer};
-    auto ia = _device->createInputAssembler(iaInfo);
-    InstancedItem item = {1, INITIAL_CAPACITY, vb, data, ia, stride, shader, descriptorSet, lightingMap};
+    vertexBuffers.emplace_back(nullptr);
+
+    InstancedItem item;
+    item.capacity = INITIAL_CAPACITY;
+    item.data = (uint8_t *)CC_MALLOC(stride * INITIAL_CAPACITY);
+    item.stride = stride;
+    item.shader = subModel->getShader(passIdx);
+    item.descriptorSet = subModel->getDescriptorSet();
+    item.lightingMap = item.descriptorSet->getTexture(LIGHTMAP_TEXTURE::BINDING);
+    for (uint i = 0; i < InstancedItem::RING_SIZE; ++i) {
+        item.vbs[i] = _device->createBuffer({
+            gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+            stride * INITIAL_CAPACITY,
+            stride,
+        });
+        vertexBuffers.back() = item.vbs[i];
+        item.ias[i] = _device->createInputAssembler({attributes, vertexBuffers, indexBuffer});
+    }
+    item.vb = item.vbs[0];
+    item.ia = item.ias[0];
     _instances.emplace_back(std::move(item));
-    _hasPendingModels = true;
+    return static_cast<uint>(_instances.size() - 1);
 }
 
 void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
+    const uint slot = _frameIndex % InstancedItem::RING_SIZE;
     for (auto &instance : _instances) {
         if (!instance.count) continue;
 
-        cmdBuff->updateBuffer(instance.vb, instance.data, instance.vb->getSize());
+        const uint usedSize = instance.stride * instance.count;
+        auto *vb = instance.vbs[slot];
+        uint &dirtyEnd = instance.dirtyEnds[slot];
+        uint &validEnd = instance.validEnds[slot];
+        if (vb->getSize() < usedSize) {
+            vb->resize(instance.stride * instance.capacity);
+            validEnd = 0;
+        }
+
+        // buffer updates can't take an offset, so the upload is the dirty prefix, or all used bytes
+        // once they reach past what the slot holds, clipped to the used bytes
+        const uint uploadSize = std::min(std::max(dirtyEnd, validEnd < usedSize ? usedSize : 0U), usedSize);
+        if (uploadSize) {
+            cmdBuff->updateBuffer(vb, instance.data, uploadSize);
+        }
+        // dirty bytes past the used ones were not sent, they are stale until the next full upload
+        validEnd = dirtyEnd > usedSize ? usedSize : std::max(validEnd, uploadSize);
+        dirtyEnd = 0;
+
+        instance.vb = vb;
+        instance.ia = instance.ias[slot];
         instance.ia->setInstanceCount(instance.count);
     }
 }
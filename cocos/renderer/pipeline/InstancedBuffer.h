@@ -41,6 +41,10 @@ struct PSOInfo;
 #endif
 
 struct CC_DLL InstancedItem {
+    // each slot is uploaded every RING_SIZE frames, so frames in flight never share a vertex buffer
+    static constexpr uint RING_SIZE = 2;
+    static constexpr uint INVALID_INDEX = ~0u;
+
     uint count = 0;
     uint capacity = 0;
     gfx::Buffer *vb = nullptr;
@@ -50,6 +54,12 @@ struct CC_DLL InstancedItem {
     gfx::Shader *shader = nullptr;
     gfx::DescriptorSet *descriptorSet = nullptr;
     gfx::Texture *lightingMap = nullptr;
+    uint writtenSize = 0; // bytes of data ever written, anything past it is uninitialized
+    uint next = INVALID_INDEX; // next item sharing the same lookup key
+    gfx::Buffer *vbs[RING_SIZE] = {};
+    gfx::InputAssembler *ias[RING_SIZE] = {};
+    uint dirtyEnds[RING_SIZE] = {}; // the leading bytes of data each slot has not received yet
+    uint validEnds[RING_SIZE] = {}; // bytes each slot holds, apart from its dirty prefix
 };
 typedef vector<InstancedItem> InstancedItemList;
 typedef vector<uint> DynamicOffsetList;
@@ -60,6 +70,9 @@ public:
     static constexpr uint MAX_CAPACITY = 1024;
     static InstancedBuffer *get(uint pass);
     static InstancedBuffer *get(uint pass, uint extraKey);
+    // Moves every buffer on to the next vertex buffer slot, called once at the start of each frame.
+    // All uploads of a frame go to the same slot, however many cameras or queues upload.
+    static CC_INLINE void beginFrame() { ++_frameIndex; }
 
     InstancedBuffer(const PassView *pass);
     virtual ~InstancedBuffer();
@@ -76,8 +89,28 @@ public:
     CC_INLINE const DynamicOffsetList &dynamicOffsets() const { return _dynamicOffsets; }
 
 private:
+    struct ItemKey {
+        const gfx::Buffer *indexBuffer = nullptr;
+        const gfx::Texture *lightingMap = nullptr;
+
+        CC_INLINE bool operator==(const ItemKey &rhs) const {
+            return indexBuffer == rhs.indexBuffer && lightingMap == rhs.lightingMap;
+        }
+    };
+    struct ItemKeyHasher {
+        CC_INLINE size_t operator()(const ItemKey &key) const {
+            const auto a = reinterpret_cast<size_t>(key.indexBuffer);
+            const auto b = reinterpret_cast<size_t>(key.lightingMap);
+            return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+        }
+    };
+
+    uint createItem(const ModelView *model, const SubModelView *subModel, uint stride, uint passIdx);
+
     static map<uint, map<uint, InstancedBuffer *>> _buffers;
+    static uint _frameIndex;
     InstancedItemList _instances;
+    unordered_map<ItemKey, uint, ItemKeyHasher> _itemIndices;
     const PassView *_pass = nullptr;
     bool _hasPendingModels = false;
     DynamicOffsetList _dynamicOffsets;
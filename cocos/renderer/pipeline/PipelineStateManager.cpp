@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "PipelineStateManager.h"
+#include "base/ThreadPool.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXInputAssembler.h"
 #include "gfx/GFXRenderPass.h"
@@ -30,36 +31,280 @@ THE SOFTWARE.
 
 namespace cc {
 namespace pipeline {
-map<uint, gfx::PipelineState *> PipelineStateManager::_PSOHashMap;
+namespace {
+constexpr uint INITIAL_CAPACITY = 256;
+
+CC_INLINE uint64_t mix(uint64_t h) {
+    // splitmix64 finalizer
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// these states are made of 32-bit fields only, see GFXDef.h, so they compare bytewise
+static_assert(sizeof(gfx::RasterizerState) == 12 * 4, "RasterizerState has padding");
+static_assert(sizeof(gfx::DepthStencilState) == 19 * 4, "DepthStencilState has padding");
+static_assert(sizeof(gfx::BlendTarget) == 8 * 4, "BlendTarget has padding");
+static_assert(sizeof(gfx::Color) == 4 * 4, "Color has padding");
+
+template <typename T>
+CC_INLINE bool sameBytes(const T &lhs, const T &rhs) {
+    return memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+
+bool sameBlendState(const gfx::BlendState &lhs, const gfx::BlendState &rhs) {
+    if (lhs.isA2C != rhs.isA2C || lhs.isIndepend != rhs.isIndepend ||
+        !sameBytes(lhs.blendColor, rhs.blendColor) || lhs.targets.size() != rhs.targets.size()) {
+        return false;
+    }
+    return lhs.targets.empty() || memcmp(lhs.targets.data(), rhs.targets.data(), lhs.targets.size() * sizeof(gfx::BlendTarget)) == 0;
+}
+
+bool sameAttributes(const gfx::AttributeList &lhs, const gfx::AttributeList &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        const auto &a = lhs[i];
+        const auto &b = rhs[i];
+        if (a.format != b.format || a.isNormalized != b.isNormalized || a.stream != b.stream ||
+            a.isInstanced != b.isInstanced || a.location != b.location || a.name != b.name) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// render pass compatibility, same as RenderPass::computeHash
+bool sameAttachments(const gfx::ColorAttachmentList &lhsColors, const gfx::DepthStencilAttachment &lhsDepthStencil,
+                     const gfx::ColorAttachmentList &rhsColors, const gfx::DepthStencilAttachment &rhsDepthStencil) {
+    if (lhsColors.size() != rhsColors.size() ||
+        lhsDepthStencil.format != rhsDepthStencil.format || lhsDepthStencil.sampleCount != rhsDepthStencil.sampleCount) {
+        return false;
+    }
+    for (size_t i = 0; i < lhsColors.size(); ++i) {
+        if (lhsColors[i].format != rhsColors[i].format || lhsColors[i].sampleCount != rhsColors[i].sampleCount) return false;
+    }
+    return true;
+}
+} // namespace
+
+std::atomic<PipelineStateManager::PSOTable *> PipelineStateManager::_table{nullptr};
+vector<PipelineStateManager::PSOTable *> PipelineStateManager::_retiredTables;
+uint PipelineStateManager::_count = 0;
+std::mutex PipelineStateManager::_writeMutex;
+bool PipelineStateManager::_asyncCreation = false;
+bool PipelineStateManager::_inFrame = false;
+ThreadPool *PipelineStateManager::_creationThreadPool = nullptr;
+unordered_multimap<uint64_t, PipelineStateManager::PSOEntry *> PipelineStateManager::_layoutFallbacks;
+vector<PipelineStateManager::PendingCreation *> PipelineStateManager::_pendingCreations;
+std::condition_variable PipelineStateManager::_creationDone;
+std::atomic<uint> PipelineStateManager::_hits{0};
+std::atomic<uint> PipelineStateManager::_creations{0};
+std::atomic<uint> PipelineStateManager::_asyncCreations{0};
+std::atomic<uint> PipelineStateManager::_fallbacks{0};
+PipelineStateStatistics PipelineStateManager::_frameStatistics;
+
+PipelineStateManager::PSOSource PipelineStateManager::PSOEntry::getSource() const {
+    PSOSource source;
+    source.pipelineLayout = info.pipelineLayout;
+    source.rasterizerState = &info.rasterizerState;
+    source.depthStencilState = &info.depthStencilState;
+    source.blendState = &info.blendState;
+    source.primitive = info.primitive;
+    source.dynamicStates = info.dynamicStates;
+    source.attributes = &info.inputState.attributes;
+    source.colorAttachments = &colorAttachments;
+    source.depthStencilAttachment = &depthStencilAttachment;
+    return source;
+}
+
+bool PipelineStateManager::sameLayout(const PSOEntry *entry, const PSOSource &source) {
+    return entry->info.pipelineLayout == source.pipelineLayout &&
+           sameAttributes(entry->info.inputState.attributes, *source.attributes) &&
+           sameAttachments(entry->colorAttachments, entry->depthStencilAttachment, *source.colorAttachments, *source.depthStencilAttachment);
+}
+
+bool PipelineStateManager::sameStates(const PSOEntry *entry, const PSOSource &source) {
+    const auto &info = entry->info;
+    return info.primitive == source.primitive && info.dynamicStates == source.dynamicStates &&
+           sameBytes(info.rasterizerState, *source.rasterizerState) &&
+           sameBytes(info.depthStencilState, *source.depthStencilState) &&
+           sameBlendState(info.blendState, *source.blendState);
+}
+
+uint64_t PipelineStateManager::hashKey(const PSOKey &key) {
+    const uint64_t a = (static_cast<uint64_t>(key.passHash) << 32) | key.shaderID;
+    const uint64_t b = (static_cast<uint64_t>(key.renderPassHash) << 32) | key.iaHash;
+    return mix(mix(a) ^ b);
+}
+
+uint64_t PipelineStateManager::hashLayout(const PSOKey &key) {
+    const uint64_t b = (static_cast<uint64_t>(key.renderPassHash) << 32) | key.iaHash;
+    return mix(mix(key.shaderID) ^ b);
+}
+
+gfx::PipelineState *PipelineStateManager::find(const PSOKey &key, const PSOSource &source) {
+    const PSOTable *table = _table.load(std::memory_order_acquire);
+    if (!table) return nullptr;
+
+    for (uint i = static_cast<uint>(hashKey(key)) & table->mask;; i = (i + 1) & table->mask) {
+        const PSOEntry *entry = table->slots[i].load(std::memory_order_acquire);
+        if (!entry) return nullptr;
+        if (entry->key == key && sameStates(entry, source) && sameLayout(entry, source)) return entry->pso;
+    }
+}
+
+gfx::PipelineState *PipelineStateManager::findFallback(const PSOKey &key, const PSOSource &source) {
+    const auto range = _layoutFallbacks.equal_range(hashLayout(key));
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        const PSOEntry *candidate = iter->second;
+        if (candidate->key.shaderID == key.shaderID && candidate->key.renderPassHash == key.renderPassHash &&
+            candidate->key.iaHash == key.iaHash && sameLayout(candidate, source)) {
+            return candidate->pso;
+        }
+    }
+    return nullptr;
+}
+
+bool PipelineStateManager::isPending(const PSOKey &key, const PSOSource &source) {
+    for (const auto creation : _pendingCreations) {
+        if (creation->entry->key == key && sameStates(creation->entry, source) && sameLayout(creation->entry, source)) return true;
+    }
+    return false;
+}
+
+PipelineStateManager::PSOEntry *PipelineStateManager::createEntry(const PSOKey &key, const PSOSource &source,
+                                                                  gfx::Shader *shader, gfx::RenderPass *renderPass) {
+    PSOEntry *entry = CC_NEW(PSOEntry);
+    entry->key = key;
+    entry->info.shader = shader;
+    entry->info.pipelineLayout = const_cast<gfx::PipelineLayout *>(source.pipelineLayout);
+    entry->info.renderPass = renderPass;
+    entry->info.inputState.attributes = *source.attributes;
+    entry->info.rasterizerState = *source.rasterizerState;
+    entry->info.depthStencilState = *source.depthStencilState;
+    entry->info.blendState = *source.blendState;
+    entry->info.primitive = source.primitive;
+    entry->info.dynamicStates = source.dynamicStates;
+    entry->colorAttachments = *source.colorAttachments;
+    entry->depthStencilAttachment = *source.depthStencilAttachment;
+    return entry;
+}
+
+void PipelineStateManager::rehash(uint capacity) {
+    PSOTable *table = CC_NEW(PSOTable);
+    table->mask = capacity - 1;
+    table->slots = CC_NEW_ARRAY(std::atomic<PSOEntry *>, capacity);
+    for (uint i = 0; i < capacity; ++i) {
+        table->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    PSOTable *oldTable = _table.load(std::memory_order_relaxed);
+    if (oldTable) {
+        for (uint i = 0; i <= oldTable->mask; ++i) {
+            PSOEntry *entry = oldTable->slots[i].load(std::memory_order_relaxed);
+            if (!entry) continue;
+            uint slot = static_cast<uint>(hashKey(entry->key)) & table->mask;
+            while (table->slots[slot].load(std::memory_order_relaxed)) slot = (slot + 1) & table->mask;
+            table->slots[slot].store(entry, std::memory_order_relaxed);
+        }
+        // readers may still be probing the old table, it's freed at the next beginFrame
+        _retiredTables.push_back(oldTable);
+    }
+
+    _table.store(table, std::memory_order_release);
+}
+
+void PipelineStateManager::insert(PSOEntry *entry) {
+    // called with _writeMutex held
+    PSOTable *table = _table.load(std::memory_order_relaxed);
+    if (!table || (_count + 1) * 2 > table->mask + 1) {
+        rehash(table ? (table->mask + 1) * 2 : INITIAL_CAPACITY);
+        table = _table.load(std::memory_order_relaxed);
+    }
+
+    // the objects it was created from may be gone by the time anyone looks at it again
+    entry->info.shader = nullptr;
+    entry->info.renderPass = nullptr;
+
+    uint slot = static_cast<uint>(hashKey(entry->key)) & table->mask;
+    while (table->slots[slot].load(std::memory_order_relaxed)) slot = (slot + 1) & table->mask;
+    table->slots[slot].store(entry, std::memory_order_release);
+    ++_count;
+
+    _layoutFallbacks.emplace(hashLayout(entry->key), entry);
+}
+
+gfx::PipelineState *PipelineStateManager::publish(PSOEntry *entry) {
+    // called with _writeMutex held, creation itself runs unlocked so two threads may race for the same entry
+    auto pso = find(entry->key, entry->getSource());
+    if (pso) {
+        CC_SAFE_DESTROY(entry->pso);
+        CC_DELETE(entry);
+        return pso;
+    }
+    insert(entry);
+    return entry->pso;
+}
+
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const PassView *pass,
                                                                    gfx::Shader *shader,
                                                                    gfx::InputAssembler *inputAssembler,
                                                                    gfx::RenderPass *renderPass) {
-    const auto passHash = pass->hash;
-    const auto renderPassHash = renderPass->getHash();
-    const auto iaHash = inputAssembler->getAttributesHash();
-    const auto shaderID = shader->getID();
-    const auto hash = passHash ^ renderPassHash ^ iaHash ^ shaderID;
+    PSOKey key;
+    key.passHash = pass->hash;
+    key.renderPassHash = renderPass->getHash();
+    key.iaHash = inputAssembler->getAttributesHash();
+    key.shaderID = shader->getID();
+
+    PSOSource source;
+    source.pipelineLayout = pass->getPipelineLayout();
+    source.rasterizerState = pass->getRasterizerState();
+    source.depthStencilState = pass->getDepthStencilState();
+    source.blendState = pass->getBlendState();
+    source.primitive = pass->getPrimitive();
+    source.dynamicStates = pass->getDynamicState();
+    source.attributes = &inputAssembler->getAttributes();
+    source.colorAttachments = &renderPass->getColorAttachments();
+    source.depthStencilAttachment = &renderPass->getDepthStencilAttachment();
+
+    auto pso = find(key, source);
+    if (pso) {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return pso;
+    }
+
+    PSOEntry *entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        pso = find(key, source); // another thread may have created it meanwhile
+        if (pso) {
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            return pso;
+        }
 
-    auto pso = _PSOHashMap[hash];
-    if (!pso) {
-        auto pipelineLayout = pass->getPipelineLayout();
-        gfx::PipelineStateInfo info = {
-            shader,
-            pipelineLayout,
-            renderPass,
-            {inputAssembler->getAttributes()},
-            *(pass->getRasterizerState()),
-            *(pass->getDepthStencilState()),
-            *(pass->getBlendState()),
-            pass->getPrimitive(),
-            pass->getDynamicState()};
+        auto fallback = _asyncCreation && _inFrame ? findFallback(key, source) : nullptr;
+        if (fallback) {
+            if (!isPending(key, source)) {
+                auto creation = CC_NEW(PendingCreation);
+                creation->entry = createEntry(key, source, shader, renderPass);
+                _pendingCreations.push_back(creation);
+                _creationThreadPool->pushTask([](int /*tid*/) { runPendingCreation(); });
+            }
+            _fallbacks.fetch_add(1, std::memory_order_relaxed);
+            return fallback;
+        }
 
-        pso = gfx::Device::getInstance()->createPipelineState(std::move(info));
-        _PSOHashMap[hash] = pso;
+        entry = createEntry(key, source, shader, renderPass);
     }
 
-    return pso;
+    entry->pso = gfx::Device::getInstance()->createPipelineState(entry->info);
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    _creations.fetch_add(1, std::memory_order_relaxed);
+    return publish(entry);
 }
 
 gfx::PipelineState *PipelineStateManager::getOrCreatePipelineStateByJS(uint32_t passHandle,
@@ -71,5 +316,111 @@ gfx::PipelineState *PipelineStateManager::getOrCreatePipelineStateByJS(uint32_t
     return PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
 }
 
+void PipelineStateManager::runPendingCreation() {
+    PendingCreation *creation = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        for (const auto pending : _pendingCreations) {
+            if (!pending->started) {
+                creation = pending;
+                break;
+            }
+        }
+        if (!creation) return; // dropped by endFrame
+        creation->started = true;
+    }
+
+    auto entry = creation->entry;
+    entry->pso = gfx::Device::getInstance()->createPipelineState(entry->info);
+
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        publish(entry);
+        _pendingCreations.erase(std::find(_pendingCreations.begin(), _pendingCreations.end(), creation));
+        _asyncCreations.fetch_add(1, std::memory_order_relaxed);
+    }
+    CC_DELETE(creation);
+    _creationDone.notify_all();
+}
+
+void PipelineStateManager::cancelPendingCreations() {
+    std::unique_lock<std::mutex> lock(_writeMutex);
+    for (auto iter = _pendingCreations.begin(); iter != _pendingCreations.end();) {
+        auto creation = *iter;
+        if (creation->started) {
+            ++iter;
+            continue;
+        }
+        CC_DELETE(creation->entry);
+        CC_DELETE(creation);
+        iter = _pendingCreations.erase(iter);
+    }
+    _creationDone.wait(lock, [] { return _pendingCreations.empty(); });
+}
+
+void PipelineStateManager::setAsyncCreation(bool enabled) {
+    if (_asyncCreation == enabled) return;
+
+    if (enabled) {
+        _creationThreadPool = ThreadPool::newSingleThreadPool();
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _asyncCreation = true;
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            _asyncCreation = false;
+        }
+        cancelPendingCreations();
+        CC_SAFE_DELETE(_creationThreadPool);
+    }
+}
+
+void PipelineStateManager::beginFrame() {
+    _frameStatistics.hits = _hits.exchange(0);
+    _frameStatistics.creations = _creations.exchange(0);
+    _frameStatistics.asyncCreations = _asyncCreations.exchange(0);
+    _frameStatistics.fallbacks = _fallbacks.exchange(0);
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    // no recording is in flight between frames, so nobody is probing the retired tables anymore
+    for (auto table : _retiredTables) {
+        CC_DELETE_ARRAY(table->slots);
+        CC_DELETE(table);
+    }
+    _retiredTables.clear();
+    _inFrame = true;
+}
+
+void PipelineStateManager::endFrame() {
+    {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _inFrame = false;
+    }
+    cancelPendingCreations();
+}
+
+void PipelineStateManager::destroyAll() {
+    setAsyncCreation(false);
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    PSOTable *table = _table.exchange(nullptr);
+    if (table) {
+        for (uint i = 0; i <= table->mask; ++i) {
+            PSOEntry *entry = table->slots[i].load(std::memory_order_relaxed);
+            if (!entry) continue;
+            CC_SAFE_DESTROY(entry->pso);
+            CC_DELETE(entry);
+        }
+        _retiredTables.push_back(table);
+    }
+    for (auto retired : _retiredTables) {
+        CC_DELETE_ARRAY(retired->slots);
+        CC_DELETE(retired);
+    }
+    _retiredTables.clear();
+    _layoutFallbacks.clear();
+    _count = 0;
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -24,8 +24,11 @@ THE SOFTWARE.
 #pragma once
 
 #include "core/CoreStd.h"
+#include <condition_variable>
 
 namespace cc {
+class ThreadPool;
+
 namespace gfx {
 class InputAssembler;
 class PipelineState;
@@ -35,6 +38,13 @@ class RenderPass;
 namespace pipeline {
 struct PassView;
 
+struct CC_DLL PipelineStateStatistics {
+    uint hits = 0;
+    uint creations = 0;
+    uint asyncCreations = 0;
+    uint fallbacks = 0;
+};
+
 class CC_DLL PipelineStateManager {
 public:
     static gfx::PipelineState *getOrCreatePipelineState(const PassView *pass,
@@ -46,8 +56,104 @@ public:
                                                             gfx::InputAssembler *inputAssembler,
                                                             gfx::RenderPass *renderPass);
 
+    // When enabled, a pipeline state that only differs from an existing one in its pass states
+    // (rasterizer, depth stencil, blend, etc.) is created on a background thread, and the existing
+    // one is returned until it's ready. The device must support creating objects off the main thread,
+    // which rules out the multithreaded device agent.
+    // Background creations only run between beginFrame and endFrame: script may destroy the shaders,
+    // layouts and render passes they reference once the frame is done, so endFrame drops the creations
+    // that haven't started yet. They are requested again the next time the pipeline state is needed.
+    static void setAsyncCreation(bool enabled);
+    static CC_INLINE bool isAsyncCreation() { return _asyncCreation; }
+
+    // Publishes the counters of the previous frame and resets them.
+    static void beginFrame();
+    static void endFrame();
+    static CC_INLINE const PipelineStateStatistics &getFrameStatistics() { return _frameStatistics; }
+
+    // Destroys every cached pipeline state.
+    static void destroyAll();
+
 private:
-    static map<uint, gfx::PipelineState *> _PSOHashMap;
+    // Picks the slot, the entry itself is compared on the structural fields below.
+    struct PSOKey {
+        uint passHash = 0;
+        uint renderPassHash = 0;
+        uint iaHash = 0;
+        uint shaderID = 0;
+
+        CC_INLINE bool operator==(const PSOKey &rhs) const {
+            return passHash == rhs.passHash && renderPassHash == rhs.renderPassHash &&
+                   iaHash == rhs.iaHash && shaderID == rhs.shaderID;
+        }
+    };
+
+    // Everything a pipeline state is created from, viewed in place.
+    struct PSOSource {
+        const gfx::PipelineLayout *pipelineLayout = nullptr;
+        const gfx::RasterizerState *rasterizerState = nullptr;
+        const gfx::DepthStencilState *depthStencilState = nullptr;
+        const gfx::BlendState *blendState = nullptr;
+        gfx::PrimitiveMode primitive = gfx::PrimitiveMode::TRIANGLE_LIST;
+        gfx::DynamicStateFlags dynamicStates = gfx::DynamicStateFlagBit::NONE;
+        const gfx::AttributeList *attributes = nullptr;
+        const gfx::ColorAttachmentList *colorAttachments = nullptr;
+        const gfx::DepthStencilAttachment *depthStencilAttachment = nullptr;
+    };
+
+    struct PSOEntry {
+        PSOKey key;
+        gfx::PipelineStateInfo info; // shader and render pass are only valid until the pipeline state is created
+        gfx::ColorAttachmentList colorAttachments;
+        gfx::DepthStencilAttachment depthStencilAttachment;
+        gfx::PipelineState *pso = nullptr;
+
+        PSOSource getSource() const;
+    };
+
+    // Open addressing with linear probing. Slots are only ever filled, never cleared,
+    // so readers can probe without taking a lock.
+    struct PSOTable {
+        uint mask = 0;
+        std::atomic<PSOEntry *> *slots = nullptr;
+    };
+
+    struct PendingCreation {
+        PSOEntry *entry = nullptr;
+        bool started = false;
+    };
+
+    static bool sameLayout(const PSOEntry *entry, const PSOSource &source);
+    static bool sameStates(const PSOEntry *entry, const PSOSource &source);
+    static uint64_t hashKey(const PSOKey &key);
+    static uint64_t hashLayout(const PSOKey &key);
+    static gfx::PipelineState *find(const PSOKey &key, const PSOSource &source);
+    static gfx::PipelineState *findFallback(const PSOKey &key, const PSOSource &source);
+    static bool isPending(const PSOKey &key, const PSOSource &source);
+    static PSOEntry *createEntry(const PSOKey &key, const PSOSource &source, gfx::Shader *shader, gfx::RenderPass *renderPass);
+    static gfx::PipelineState *publish(PSOEntry *entry);
+    static void insert(PSOEntry *entry);
+    static void rehash(uint capacity);
+    static void runPendingCreation();
+    static void cancelPendingCreations();
+
+    static std::atomic<PSOTable *> _table;
+    static vector<PSOTable *> _retiredTables;
+    static uint _count;
+    static std::mutex _writeMutex;
+
+    static bool _asyncCreation;
+    static bool _inFrame;
+    static ThreadPool *_creationThreadPool;
+    static unordered_multimap<uint64_t, PSOEntry *> _layoutFallbacks;
+    static vector<PendingCreation *> _pendingCreations;
+    static std::condition_variable _creationDone;
+
+    static std::atomic<uint> _hits;
+    static std::atomic<uint> _creations;
+    static std::atomic<uint> _asyncCreations;
+    static std::atomic<uint> _fallbacks;
+    static PipelineStateStatistics _frameStatistics;
 };
 
 } // namespace pipeline
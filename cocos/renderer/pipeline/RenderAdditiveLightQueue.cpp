@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "gfx/GFXTexture.h"
 #include "Define.h"
 #include "forward/SceneCulling.h"
+#include "helper/ClusterLightGrid.h"
 
 namespace cc {
 namespace pipeline {
@@ -97,6 +98,7 @@ RenderAdditiveLightQueue::RenderAdditiveLightQueue(RenderPipeline *pipeline) : _
 RenderAdditiveLightQueue ::~RenderAdditiveLightQueue() {
     CC_DELETE(_instancedQueue);
     CC_DELETE(_batchedQueue);
+    CC_SAFE_DELETE(_clusterGrid);
 }
 
 void RenderAdditiveLightQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
@@ -133,6 +135,12 @@ void RenderAdditiveLightQueue::gatherLightPasses(const Camera *camera, gfx::Comm
 
     clear();
 
+    if (_pipeline->isClusteredLighting()) {
+        // lit models shade every light in their forward pass, no additive passes are needed
+        gatherClusterLights(camera, cmdBufferer);
+        return;
+    }
+
     gatherValidLights(camera);
 
     if (_validLights.empty()) return;
@@ -185,6 +193,8 @@ void RenderAdditiveLightQueue::destroy() {
         descriptorSet->destroy();
     }
     _descriptorSetMap.clear();
+
+    CC_SAFE_DESTROY(_clusterLightTexture);
 }
 
 void RenderAdditiveLightQueue::clear() {
@@ -210,7 +220,6 @@ void RenderAdditiveLightQueue::gatherValidLights(const Camera* camera) {
         sphere.setRadius(light->range);
         if (sphere_frustum(&sphere, camera->getFrustum())) {
             _validLights.emplace_back(light);
-            getOrCreateDescriptorSet(light);
         }
     }
     const auto spotLightArrayID = scene->getSpotLightArrayID();
@@ -221,11 +230,95 @@ void RenderAdditiveLightQueue::gatherValidLights(const Camera* camera) {
         sphere.setRadius(light->range);
         if (sphere_frustum(&sphere, camera->getFrustum())) {
             _validLights.emplace_back(light);
-            getOrCreateDescriptorSet(light);
         }
     }
 }
 
+void RenderAdditiveLightQueue::gatherClusterLights(const Camera *camera, gfx::CommandBuffer *cmdBuffer) {
+    auto *device = gfx::Device::getInstance();
+    if (!_clusterGrid) {
+        _clusterGrid = CC_NEW(ClusterLightGrid);
+        _clusterLightData.resize(UBOClusterLights::COUNT, 0.0f);
+    }
+
+    gatherValidLights(camera);
+
+    // lights past the UBO capacity are dropped
+    const auto exposure = camera->exposure;
+    const auto lightCount = std::min(static_cast<uint>(_validLights.size()), UBOClusterLights::MAX_LIGHTS);
+    _clusterSpheres.resize(lightCount);
+    for (uint i = 0; i < lightCount; ++i) {
+        const auto *light = _validLights[i];
+        Vec3 center;
+        camera->matView.transformPoint(light->position, &center);
+        _clusterSpheres[i].set(center.x, center.y, center.z, light->range);
+
+        const uint offset = i * 4;
+        packLight(light, exposure,
+                  &_clusterLightData[UBOClusterLights::LIGHT_POS_OFFSET + offset],
+                  &_clusterLightData[UBOClusterLights::LIGHT_COLOR_OFFSET + offset],
+                  &_clusterLightData[UBOClusterLights::LIGHT_SIZE_RANGE_ANGLE_OFFSET + offset],
+                  &_clusterLightData[UBOClusterLights::LIGHT_DIR_OFFSET + offset]);
+    }
+
+    ClusterLightGridInfo info;
+    info.matProjInv = camera->matProjInv;
+    info.clipSpaceMinZ = device->getClipSpaceMinZ();
+    _clusterGrid->build(info, _clusterSpheres.data(), lightCount, [this](uint taskCount, const std::function<void(uint)> &task) {
+        _pipeline->parallelFor(taskCount, task);
+    });
+
+    // cluster headers first, then the light indices packed four per texel
+    const auto clusterCount = _clusterGrid->getClusterCount();
+    const auto &offsets = _clusterGrid->getClusterOffsets();
+    const auto &counts = _clusterGrid->getClusterCounts();
+    const auto &indices = _clusterGrid->getLightIndices();
+    const uint width = CLUSTER_LIGHTS::TEXTURE_WIDTH;
+    const uint texelCount = clusterCount + (static_cast<uint>(indices.size()) + 3) / 4;
+    const uint height = (texelCount + width - 1) / width;
+    _clusterTextureData.assign(width * height * 4, 0.0f);
+    for (uint i = 0; i < clusterCount; ++i) {
+        _clusterTextureData[i * 4] = static_cast<float>(offsets[i]);
+        _clusterTextureData[i * 4 + 1] = static_cast<float>(counts[i]);
+    }
+    float *indexData = &_clusterTextureData[clusterCount * 4];
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indexData[i] = static_cast<float>(indices[i]);
+    }
+
+    auto *descriptorSet = _pipeline->getDescriptorSet();
+    if (!_clusterLightTexture || _clusterLightTexture->getHeight() < height) {
+        if (_clusterLightTexture) {
+            _clusterLightTexture->resize(width, height);
+        } else {
+            _clusterLightTexture = device->createTexture({
+                gfx::TextureType::TEX2D,
+                gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST,
+                gfx::Format::RGBA32F,
+                width,
+                height,
+            });
+        }
+        descriptorSet->bindTexture(CLUSTER_LIGHTS::BINDING, _clusterLightTexture);
+        descriptorSet->update();
+    }
+
+    _clusterLightData[UBOClusterLights::CLUSTER_INFO_OFFSET] = static_cast<float>(info.tilesX);
+    _clusterLightData[UBOClusterLights::CLUSTER_INFO_OFFSET + 1] = static_cast<float>(info.tilesY);
+    _clusterLightData[UBOClusterLights::CLUSTER_INFO_OFFSET + 2] = static_cast<float>(info.slicesZ);
+    _clusterLightData[UBOClusterLights::CLUSTER_INFO_OFFSET + 3] = static_cast<float>(lightCount);
+    _clusterLightData[UBOClusterLights::CLUSTER_PARAMS_OFFSET] = _clusterGrid->getSliceScale();
+    _clusterLightData[UBOClusterLights::CLUSTER_PARAMS_OFFSET + 1] = _clusterGrid->getSliceBias();
+    _clusterLightData[UBOClusterLights::CLUSTER_PARAMS_OFFSET + 2] = static_cast<float>(width);
+    _clusterLightData[UBOClusterLights::CLUSTER_PARAMS_OFFSET + 3] = static_cast<float>(clusterCount);
+    cmdBuffer->updateBuffer(descriptorSet->getBuffer(UBOClusterLights::BINDING), _clusterLightData.data(), UBOClusterLights::SIZE);
+
+    gfx::BufferTextureCopy region;
+    region.texExtent = {width, height, 1};
+    const uint8_t *buffers[] = {reinterpret_cast<const uint8_t *>(_clusterTextureData.data())};
+    cmdBuffer->copyBuffersToTexture(buffers, _clusterLightTexture, &region, 1);
+}
+
 bool RenderAdditiveLightQueue::cullingLight(const Light *light, const ModelView *model) {
     switch (light->getType()) {
         case LightType::SPHERE:
@@ -282,57 +375,59 @@ void RenderAdditiveLightQueue::updateUBOs(const Camera *camera, gfx::CommandBuff
     }
 
     for (unsigned l = 0, offset = 0; l < validLightCount; l++, offset += _lightBufferElementCount) {
-        const auto light = _validLights[l];
-
-        auto index = offset + UBOForwardLight::LIGHT_POS_OFFSET;
-        _lightBufferData[index++] = light->position.x;
-        _lightBufferData[index++] = light->position.y;
-        _lightBufferData[index] = light->position.z;
-
-        index = offset + UBOForwardLight::LIGHT_SIZE_RANGE_ANGLE_OFFSET;
-        _lightBufferData[index++] = light->size;
-        _lightBufferData[index] = light->range;
-
-        index = offset + UBOForwardLight::LIGHT_COLOR_OFFSET;
-        const auto &color = light->color;
-        if (light->useColorTemperature) {
-            const auto &tempRGB = light->colorTemperatureRGB;
-            _lightBufferData[index++] = color.x * tempRGB.x;
-            _lightBufferData[index++] = color.y * tempRGB.y;
-            _lightBufferData[index++] = color.z * tempRGB.z;
-        } else {
-            _lightBufferData[index++] = color.x;
-            _lightBufferData[index++] = color.y;
-            _lightBufferData[index++] = color.z;
-        }
-        if (_isHDR) {
-            _lightBufferData[index] = light->luminance * _fpScale * _lightMeterScale;
-        } else {
-            _lightBufferData[index] = light->luminance * exposure * _lightMeterScale;
-        }
-
-        switch (light->getType()) {
-            case LightType::SPHERE:
-                _lightBufferData[offset + UBOForwardLight::LIGHT_POS_OFFSET + 3] = 0;
-                _lightBufferData[offset + UBOForwardLight::LIGHT_SIZE_RANGE_ANGLE_OFFSET + 2] = 0;
-                break;
-            case LightType::SPOT:
-                _lightBufferData[offset + UBOForwardLight::LIGHT_POS_OFFSET + 3] = 1.0f;
-                _lightBufferData[offset + UBOForwardLight::LIGHT_SIZE_RANGE_ANGLE_OFFSET + 2] = light->spotAngle;
-
-                index = offset + UBOForwardLight::LIGHT_DIR_OFFSET;
-                _lightBufferData[index++] = light->direction.x;
-                _lightBufferData[index++] = light->direction.y;
-                _lightBufferData[index] = light->direction.z;
-                break;
-            default:
-                break;
-        }
+        packLight(_validLights[l], exposure,
+                  &_lightBufferData[offset + UBOForwardLight::LIGHT_POS_OFFSET],
+                  &_lightBufferData[offset + UBOForwardLight::LIGHT_COLOR_OFFSET],
+                  &_lightBufferData[offset + UBOForwardLight::LIGHT_SIZE_RANGE_ANGLE_OFFSET],
+                  &_lightBufferData[offset + UBOForwardLight::LIGHT_DIR_OFFSET]);
     }
 
     cmdBuffer->updateBuffer(_lightBuffer, _lightBufferData.data(), _lightBufferData.size() * sizeof(float));
 }
 
+void RenderAdditiveLightQueue::packLight(const Light *light, float exposure, float *pos, float *color, float *sizeRangeAngle, float *dir) const {
+    pos[0] = light->position.x;
+    pos[1] = light->position.y;
+    pos[2] = light->position.z;
+
+    sizeRangeAngle[0] = light->size;
+    sizeRangeAngle[1] = light->range;
+
+    const auto &lightColor = light->color;
+    if (light->useColorTemperature) {
+        const auto &tempRGB = light->colorTemperatureRGB;
+        color[0] = lightColor.x * tempRGB.x;
+        color[1] = lightColor.y * tempRGB.y;
+        color[2] = lightColor.z * tempRGB.z;
+    } else {
+        color[0] = lightColor.x;
+        color[1] = lightColor.y;
+        color[2] = lightColor.z;
+    }
+    if (_isHDR) {
+        color[3] = light->luminance * _fpScale * _lightMeterScale;
+    } else {
+        color[3] = light->luminance * exposure * _lightMeterScale;
+    }
+
+    switch (light->getType()) {
+        case LightType::SPHERE:
+            pos[3] = 0;
+            sizeRangeAngle[2] = 0;
+            break;
+        case LightType::SPOT:
+            pos[3] = 1.0f;
+            sizeRangeAngle[2] = light->spotAngle;
+
+            dir[0] = light->direction.x;
+            dir[1] = light->direction.y;
+            dir[2] = light->direction.z;
+            break;
+        default:
+            break;
+    }
+}
+
 void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gfx::CommandBuffer *cmdBuffer) {
     auto *shadowInfo = _pipeline->getShadows();
     const auto scene = camera->getScene();
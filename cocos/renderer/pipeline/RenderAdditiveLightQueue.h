@@ -41,6 +41,7 @@ struct Sphere;
 class Shader;
 class ForwardPipeline;
 class DescriptorSet;
+class ClusterLightGrid;
 
 struct AdditiveLightPass {
     const SubModelView *subModel = nullptr;
@@ -62,6 +63,8 @@ public:
 private:
     void clear();
     void gatherValidLights(const Camera *camera);
+    void gatherClusterLights(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
+    void packLight(const Light *light, float exposure, float *pos, float *color, float *sizeRangeAngle, float *dir) const;
     bool cullingLight(const Light *light, const ModelView *model);
     void addRenderQueue(const PassView *pass, const SubModelView *subModel, const ModelView *model, uint lightPassIdx);
     void updateUBOs(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
@@ -87,6 +90,12 @@ private:
     gfx::Buffer *_firstLightBufferView = nullptr;
     gfx::Sampler *_sampler = nullptr;
 
+    ClusterLightGrid *_clusterGrid = nullptr;
+    gfx::Texture *_clusterLightTexture = nullptr;
+    vector<Vec4> _clusterSpheres;
+    vector<float> _clusterLightData;
+    vector<float> _clusterTextureData;
+
     std::unordered_map<const Light *, gfx::DescriptorSet *> _descriptorSetMap;
     std::array<float, UBOGlobal::COUNT> _globalUBO;
     std::array<float, UBOCamera::COUNT> _cameraUBO;
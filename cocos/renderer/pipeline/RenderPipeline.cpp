@@ -62,6 +62,10 @@ void RenderPipeline::setDescriptorSetLayout() {
     globalDescriptorSetLayout.bindings[ENVIRONMENT::BINDING] = ENVIRONMENT::DESCRIPTOR;
     globalDescriptorSetLayout.samplers[SPOT_LIGHTING_MAP::NAME] = SPOT_LIGHTING_MAP::LAYOUT;
     globalDescriptorSetLayout.bindings[SPOT_LIGHTING_MAP::BINDING] = SPOT_LIGHTING_MAP::DESCRIPTOR;
+    globalDescriptorSetLayout.blocks[UBOClusterLights::NAME] = UBOClusterLights::LAYOUT;
+    globalDescriptorSetLayout.bindings[UBOClusterLights::BINDING] = UBOClusterLights::DESCRIPTOR;
+    globalDescriptorSetLayout.samplers[CLUSTER_LIGHTS::NAME] = CLUSTER_LIGHTS::LAYOUT;
+    globalDescriptorSetLayout.bindings[CLUSTER_LIGHTS::BINDING] = CLUSTER_LIGHTS::DESCRIPTOR;
 
     localDescriptorSetLayout.bindings.resize(static_cast<size_t>(ModelLocalBindings::COUNT));
     localDescriptorSetLayout.blocks[UBOLocalBatched::NAME] = UBOLocalBatched::LAYOUT;
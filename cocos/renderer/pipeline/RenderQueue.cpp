@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "PipelineStateManager.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXShader.h"
+#include "helper/CommandRecorder.h"
 #include "helper/SharedMemory.h"
 
 namespace cc {
@@ -56,10 +57,15 @@ bool RenderQueue::insertRenderPass(const RenderObject &renderObj, uint subModelI
 }
 
 void RenderQueue::sort() {
-    std::sort(_queue.begin(), _queue.end(), _passDesc.sortFunc);
+    if (_passDesc.radixSort) {
+        _sorter.sort(_queue, _passDesc.sortMode);
+    } else {
+        std::sort(_queue.begin(), _queue.end(), _passDesc.sortFunc);
+    }
 }
 
-void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, BindStatistics *stats) {
+    CommandRecorder recorder(cmdBuff, stats);
     for (size_t i = 0; i < _queue.size(); ++i) {
         const auto subModel = _queue[i].subModel;
         const auto passIdx = _queue[i].passIndex;
@@ -69,13 +75,32 @@ void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *rend
         auto shader = subModel->getShader(passIdx);
 
         auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
-        cmdBuff->bindPipelineState(pso);
-        cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-        cmdBuff->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
-        cmdBuff->bindInputAssembler(inputAssembler);
-        cmdBuff->draw(inputAssembler);
+        recorder.bindPipelineState(pso);
+        recorder.bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
+        recorder.bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
+        recorder.bindInputAssembler(inputAssembler);
+        recorder.draw(inputAssembler);
+    }
+}
+
+void RenderQueue::resolve(gfx::RenderPass *renderPass) {
+    _resolvedDraws.resize(_queue.size());
+    for (size_t i = 0; i < _queue.size(); ++i) {
+        const auto subModel = _queue[i].subModel;
+        const auto passIdx = _queue[i].passIndex;
+        const auto pass = subModel->getPassView(passIdx);
+        auto &draw = _resolvedDraws[i];
+        draw.inputAssembler = subModel->getInputAssembler();
+        draw.pso = PipelineStateManager::getOrCreatePipelineState(pass, subModel->getShader(passIdx), draw.inputAssembler, renderPass);
+        draw.materialSet = pass->getDescriptorSet();
+        draw.localSet = subModel->getDescriptorSet();
     }
 }
 
+void RenderQueue::recordResolved(gfx::CommandBuffer *cmdBuff, uint begin, uint end, BindStatistics *stats) const {
+    CommandRecorder recorder(cmdBuff, stats);
+    recorder.drawResolved(_resolvedDraws.data() + begin, end - begin, MATERIAL_SET, LOCAL_SET);
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -24,22 +24,38 @@ THE SOFTWARE.
 #pragma once
 
 #include "Define.h"
+#include "helper/RenderPassSorter.h"
 
 namespace cc {
 namespace pipeline {
 
+struct BindStatistics;
+struct ResolvedDraw;
+
 class CC_DLL RenderQueue : public Object {
 public:
     RenderQueue(const RenderQueueCreateInfo &desc);
 
     void clear();
     bool insertRenderPass(const RenderObject &renderObj, uint subModelIdx, uint passIdx);
-    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, BindStatistics *stats = nullptr);
     void sort();
 
+    // Looks up the pipeline states and bindings of the sorted passes. This reads the shared memory
+    // pools and may create pipeline states, so it has to run on the main thread.
+    void resolve(gfx::RenderPass *renderPass);
+    // Records the resolved passes in [begin, end), safe to call from worker threads.
+    void recordResolved(gfx::CommandBuffer *cmdBuff, uint begin, uint end, BindStatistics *stats = nullptr) const;
+
+    CC_INLINE uint getPassCount() const { return static_cast<uint>(_queue.size()); }
+
 private:
     RenderPassList _queue;
     RenderQueueCreateInfo _passDesc;
+
+    RenderPassSorter _sorter;
+
+    vector<ResolvedDraw> _resolvedDraws;
 };
 
 } // namespace pipeline
@@ -22,9 +22,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "ForwardPipeline.h"
+#include "../InstancedBuffer.h"
+#include "../PipelineStateManager.h"
+#include "../helper/ModelBVH.h"
 #include "../shadow/ShadowFlow.h"
 #include "ForwardFlow.h"
 #include "SceneCulling.h"
+#include "base/threading/JobSystem.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
@@ -48,6 +52,8 @@ namespace {
     dst[offset + 1] = src.y;      \
     dst[offset + 2] = src.z;      \
     dst[offset + 3] = src.w;
+
+constexpr uint MODEL_BVH_IDLE_FRAMES = 300;
 } // namespace
 
 gfx::RenderPass *ForwardPipeline::getOrCreateRenderPass(gfx::ClearFlags clearFlags) {
@@ -103,6 +109,69 @@ void ForwardPipeline::setShadows(uint shadows) {
     _shadows = GET_SHADOWS(shadows);
 }
 
+void ForwardPipeline::setParallelCulling(bool value) {
+    _isParallelCulling = value;
+    // spin up the workers now rather than on the first frame
+    if (value) JobSystem::getInstance();
+}
+
+void ForwardPipeline::setParallelRecording(bool value) {
+    if (value && !_device->hasFeature(gfx::Feature::SECONDARY_COMMAND_BUFFER)) {
+        CC_LOG_WARNING("Parallel recording needs secondary command buffers, keeping serial recording.");
+        value = false;
+    }
+    _isParallelRecording = value;
+    if (value) JobSystem::getInstance();
+}
+
+void ForwardPipeline::setClusteredLighting(bool value) {
+    if (value && !_device->hasFeature(gfx::Feature::TEXTURE_FLOAT)) {
+        CC_LOG_WARNING("Clustered lighting needs float textures, keeping additive light passes.");
+        value = false;
+    }
+    _isClusteredLighting = value;
+    _macros.setValue("CC_ENABLE_CLUSTERED_LIGHTING", value);
+}
+
+uint ForwardPipeline::getMaxParallelTasks() const {
+    return JobSystem::getInstance()->getWorkerCount() + 1;
+}
+
+void ForwardPipeline::parallelFor(uint taskCount, const std::function<void(uint)> &task) {
+    // tasks are already coarse, one job each
+    JobSystem::getInstance()->parallelFor(taskCount, 1, task);
+}
+
+ModelBVH *ForwardPipeline::getOrCreateModelBVH(const Scene *scene) {
+    auto &entry = _modelBVHs[scene];
+    if (!entry.bvh) {
+        entry.bvh = CC_NEW(ModelBVH);
+    }
+    entry.lastFrame = _frameIndex;
+    return entry.bvh;
+}
+
+void ForwardPipeline::destroyModelBVH(uint sceneID) {
+    auto iter = _modelBVHs.find(GET_SCENE(sceneID));
+    if (iter != _modelBVHs.end()) {
+        CC_DELETE(iter->second.bvh);
+        _modelBVHs.erase(iter);
+    }
+}
+
+void ForwardPipeline::pruneModelBVHs() {
+    // scenes no camera has culled for a while were most likely destroyed without notice,
+    // a scene that comes back later just rebuilds its tree
+    for (auto iter = _modelBVHs.begin(); iter != _modelBVHs.end();) {
+        if (_frameIndex - iter->second.lastFrame > MODEL_BVH_IDLE_FRAMES) {
+            CC_DELETE(iter->second.bvh);
+            iter = _modelBVHs.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
 void ForwardPipeline::destroyShadowFrameBuffers() {
     for (auto &pair : _shadowFrameBufferMap) {
         pair.second->destroy();
@@ -143,6 +212,10 @@ bool ForwardPipeline::activate() {
 }
 
 void ForwardPipeline::render(const vector<uint> &cameras) {
+    PipelineStateManager::beginFrame();
+    InstancedBuffer::beginFrame();
+    _frameBindStatistics = _bindStatistics;
+    _bindStatistics = BindStatistics();
     _commandBuffers[0]->begin();
     updateGlobalUBO();
     for (const auto cameraId : cameras) {
@@ -154,6 +227,10 @@ void ForwardPipeline::render(const vector<uint> &cameras) {
     }
     _commandBuffers[0]->end();
     _device->getQueue()->submit(_commandBuffers);
+    PipelineStateManager::endFrame();
+
+    ++_frameIndex;
+    pruneModelBVHs();
 }
 
 void ForwardPipeline::updateCameraUBO(Camera *camera) {
@@ -365,6 +442,15 @@ bool ForwardPipeline::activeRenderer() {
     });
     _descriptorSet->bindBuffer(UBOShadow::BINDING, shadowUBO);
 
+    auto clusterLightsUBO = _device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        UBOClusterLights::SIZE,
+        UBOClusterLights::SIZE,
+        gfx::BufferFlagBit::NONE,
+    });
+    _descriptorSet->bindBuffer(UBOClusterLights::BINDING, clusterLightsUBO);
+
     gfx::SamplerInfo info{
         gfx::Filter::LINEAR,
         gfx::Filter::LINEAR,
@@ -384,11 +470,24 @@ bool ForwardPipeline::activeRenderer() {
     this->_descriptorSet->bindSampler(SPOT_LIGHTING_MAP::BINDING, shadowMapSampler);
     this->_descriptorSet->bindTexture(SPOT_LIGHTING_MAP::BINDING, getDefaultTexture());
 
+    // Cluster light list, the real texture is bound once clustered lighting gathers lights
+    gfx::SamplerInfo clusterInfo{
+        gfx::Filter::POINT,
+        gfx::Filter::POINT,
+        gfx::Filter::NONE,
+        gfx::Address::CLAMP,
+        gfx::Address::CLAMP,
+        gfx::Address::CLAMP,
+    };
+    this->_descriptorSet->bindSampler(CLUSTER_LIGHTS::BINDING, getSampler(genSamplerHash(std::move(clusterInfo))));
+    this->_descriptorSet->bindTexture(CLUSTER_LIGHTS::BINDING, getDefaultTexture());
+
     _descriptorSet->update();
 
     // update global defines when all states initialized.
     _macros.setValue("CC_USE_HDR", _isHDR);
     _macros.setValue("CC_SUPPORT_FLOAT_TEXTURE", _device->hasFeature(gfx::Feature::TEXTURE_FLOAT));
+    _macros.setValue("CC_ENABLE_CLUSTERED_LIGHTING", _isClusteredLighting);
 
     return true;
 }
@@ -398,6 +497,7 @@ void ForwardPipeline::destroy() {
         _descriptorSet->getBuffer(UBOGlobal::BINDING)->destroy();
         _descriptorSet->getBuffer(UBOCamera::BINDING)->destroy();
         _descriptorSet->getBuffer(UBOShadow::BINDING)->destroy();
+        _descriptorSet->getBuffer(UBOClusterLights::BINDING)->destroy();
         _descriptorSet->getSampler(SHADOWMAP::BINDING)->destroy();
         _descriptorSet->getTexture(SHADOWMAP::BINDING)->destroy();
         _descriptorSet->getSampler(SPOT_LIGHTING_MAP::BINDING)->destroy();
@@ -412,9 +512,19 @@ void ForwardPipeline::destroy() {
     _commandBuffers.clear();
 
     CC_SAFE_DELETE(_sphere);
+    _isParallelCulling = false;
+    _isParallelRecording = false;
+    _isClusteredLighting = false;
+
+    for (auto &pair : _modelBVHs) {
+        CC_DELETE(pair.second.bvh);
+    }
+    _modelBVHs.clear();
 
     _shadowFrameBufferMap.clear();
 
+    PipelineStateManager::destroyAll();
+
     RenderPipeline::destroy();
 }
 
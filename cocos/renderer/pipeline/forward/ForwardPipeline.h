@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <array>
 
 #include "../RenderPipeline.h"
+#include "../helper/CommandRecorder.h"
 #include "../helper/SharedMemory.h"
 
 namespace cc {
@@ -40,6 +41,7 @@ struct Shadows;
 struct Sphere;
 struct Camera;
 class Framebuffer;
+class ModelBVH;
 
 class CC_DLL ForwardPipeline : public RenderPipeline {
 public:
@@ -55,6 +57,14 @@ public:
     void updateCameraUBO(Camera *camera);
     void updateShadowUBO(Camera *camera);
     CC_INLINE void setHDR(bool isHDR) { _isHDR = isHDR; }
+    void setParallelCulling(bool value);
+    // Records the forward stage into one secondary command buffer per queue segment on the worker threads.
+    // Stays off on backends without secondary command buffers (Metal).
+    void setParallelRecording(bool value);
+    CC_INLINE void setSpatialCulling(bool value) { _isSpatialCulling = value; }
+    // Shades sphere and spot lights from a clustered light grid instead of one additive pass per light.
+    // Needs float textures and effects built with CC_ENABLE_CLUSTERED_LIGHTING.
+    void setClusteredLighting(bool value);
 
     gfx::RenderPass *getOrCreateRenderPass(gfx::ClearFlags clearFlags);
     void setFog(uint);
@@ -76,6 +86,21 @@ public:
     CC_INLINE float getShadingScale() const { return _shadingScale; }
     CC_INLINE float getFpScale() const { return _fpScale; }
     CC_INLINE bool isHDR() const { return _isHDR; }
+    CC_INLINE bool isParallelCulling() const { return _isParallelCulling; }
+    CC_INLINE bool isParallelRecording() const { return _isParallelRecording; }
+    // Number of threads taking part in parallelFor, including the calling thread.
+    uint getMaxParallelTasks() const;
+    // Spreads the tasks over the job system workers and the calling thread, then waits for all of them.
+    void parallelFor(uint taskCount, const std::function<void(uint)> &task);
+    CC_INLINE bool isSpatialCulling() const { return _isSpatialCulling; }
+    CC_INLINE bool isClusteredLighting() const { return _isClusteredLighting; }
+    ModelBVH *getOrCreateModelBVH(const Scene *scene);
+    // Bind counters of the stages' command recorders, to be added from the main thread.
+    CC_INLINE void addBindStatistics(const BindStatistics &stats) { _bindStatistics += stats; }
+    // Counters of the previous frame.
+    CC_INLINE const BindStatistics &getBindStatistics() const { return _frameBindStatistics; }
+    // Called when a scene is destroyed, before its handle can be reused by another scene.
+    void destroyModelBVH(uint sceneID);
     CC_INLINE const Fog *getFog() const { return _fog; }
     CC_INLINE const Ambient *getAmbient() const { return _ambient; }
     CC_INLINE const Skybox *getSkybox() const { return _skybox; }
@@ -89,6 +114,7 @@ public:
 private:
     bool activeRenderer();
     void updateUBO(Camera *);
+    void pruneModelBVHs();
 
 private:
     const Fog *_fog = nullptr;
@@ -110,6 +136,18 @@ private:
 
     float _shadingScale = 1.0f;
     bool _isHDR = false;
+    bool _isParallelCulling = false;
+    bool _isParallelRecording = false;
+    bool _isSpatialCulling = false;
+    bool _isClusteredLighting = false;
+    struct ModelBVHEntry {
+        ModelBVH *bvh = nullptr;
+        uint lastFrame = 0;
+    };
+    std::unordered_map<const Scene *, ModelBVHEntry> _modelBVHs;
+    uint _frameIndex = 0;
+    BindStatistics _bindStatistics;
+    BindStatistics _frameBindStatistics;
     float _fpScale = 1.0f / 1024.0f;
 
     std::unordered_map<const Light *, gfx::Framebuffer *> _shadowFrameBufferMap;
@@ -35,11 +35,16 @@ THE SOFTWARE.
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXFramebuffer.h"
 #include "gfx/GFXQueue.h"
+#include "gfx-agent/DeviceAgent.h"
 #include "UIPhase.h"
+#include "base/threading/JobSystem.h"
 
 namespace cc {
 namespace pipeline {
 namespace {
+// below this many passes per task the recording overhead outweighs the parallelism
+constexpr uint RECORD_PASSES_PER_TASK = 128;
+
 void SRGBToLinear(gfx::Color &out, const gfx::Color &gamma) {
     out.x = gamma.x * gamma.x;
     out.y = gamma.y * gamma.y;
@@ -96,7 +101,7 @@ void ForwardStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
                 break;
         }
 
-        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc};
+        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc, descriptor.sortMode};
         _renderQueues.emplace_back(CC_NEW(RenderQueue(std::move(info))));
     }
 
@@ -111,6 +116,11 @@ void ForwardStage::destroy() {
     CC_SAFE_DELETE(_additiveLightQueue);
     CC_SAFE_DELETE(_planarShadowQueue);
     CC_SAFE_DELETE(_uiPhase);
+    for (auto cmdBuff : _secondaryCmdBuffs) {
+        CC_SAFE_DESTROY(cmdBuff);
+    }
+    _secondaryCmdBuffs.clear();
+    _recordTasks.clear();
     RenderStage::destroy();
 }
 
@@ -193,17 +203,115 @@ void ForwardStage::render(Camera *camera) {
 
     auto renderPass = colorTextures.size() && colorTextures[0] ? framebuffer->getRenderPass() : pipeline->getOrCreateRenderPass(static_cast<gfx::ClearFlagBit>(camera->clearFlag));
 
+    // the device agent's message queue only accepts commands from a single thread
+    if (pipeline->isParallelRecording() && !gfx::DeviceAgent::getInstance()) {
+        recordCommandBuffersParallel(camera, renderPass, framebuffer, cmdBuff);
+        return;
+    }
+
     cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
     cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+    recordCommandBuffers(camera, renderPass, cmdBuff);
+    cmdBuff->endRenderPass();
+}
 
-    _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff);
+void ForwardStage::recordCommandBuffers(Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    BindStatistics stats;
+    _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff, &stats);
     _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
     _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
     _additiveLightQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
     _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _uiPhase->render(camera, renderPass);
-    
+    _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff, &stats);
+    _uiPhase->render(camera, renderPass, cmdBuff, &stats);
+    static_cast<ForwardPipeline *>(_pipeline)->addBindStatistics(stats);
+}
+
+void ForwardStage::recordCommandBuffersParallel(Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer, gfx::CommandBuffer *cmdBuff) {
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    const uint maxTasksPerQueue = pipeline->getMaxParallelTasks();
+
+    // Only tasks that touch nothing but plain native objects may run on the workers: the shared memory
+    // pools can fall back to the script engine, and pipeline states are created on this thread.
+    // The opaque and transparent queues are resolved here and recorded by the workers in contiguous
+    // ranges of their sorted passes, the other queues are recorded here in the meantime.
+    _recordTasks.clear();
+    auto addRenderQueueTasks = [&](RenderQueue *queue) {
+        queue->resolve(renderPass);
+        const uint passCount = queue->getPassCount();
+        const uint taskCount = std::max(1u, std::min(maxTasksPerQueue, passCount / RECORD_PASSES_PER_TASK));
+        const uint passesPerTask = (passCount + taskCount - 1) / taskCount;
+        for (uint begin = 0; begin < passCount; begin += passesPerTask) {
+            const uint end = std::min(passCount, begin + passesPerTask);
+            _recordTasks.push_back({[queue, begin, end](gfx::CommandBuffer *secondary, BindStatistics *stats) {
+                                        queue->recordResolved(secondary, begin, end, stats);
+                                    },
+                                    true});
+        }
+    };
+
+    addRenderQueueTasks(_renderQueues[0]);
+    _recordTasks.push_back({[this, renderPass](gfx::CommandBuffer *secondary, BindStatistics * /*stats*/) {
+                                _instancedQueue->recordCommandBuffer(_device, renderPass, secondary);
+                                _batchedQueue->recordCommandBuffer(_device, renderPass, secondary);
+                                _additiveLightQueue->recordCommandBuffer(_device, renderPass, secondary);
+                                _planarShadowQueue->recordCommandBuffer(_device, renderPass, secondary);
+                            },
+                            false});
+    addRenderQueueTasks(_renderQueues[1]);
+    _recordTasks.push_back({[this, camera, renderPass](gfx::CommandBuffer *secondary, BindStatistics *stats) {
+                                _uiPhase->render(camera, renderPass, secondary, stats);
+                            },
+                            false});
+
+    const uint taskCount = static_cast<uint>(_recordTasks.size());
+    // one slot per task, so the workers never write the same counters
+    _recordStats.assign(taskCount, BindStatistics());
+    while (_secondaryCmdBuffs.size() < taskCount) {
+        gfx::CommandBufferInfo info;
+        info.queue = _device->getQueue();
+        info.type = gfx::CommandBufferType::SECONDARY;
+        _secondaryCmdBuffs.push_back(_device->createCommandBuffer(info));
+    }
+
+    gfx::Viewport viewport;
+    viewport.left = _renderArea.x;
+    viewport.top = _renderArea.y;
+    viewport.width = _renderArea.width;
+    viewport.height = _renderArea.height;
+    auto globalDescriptorSet = _pipeline->getDescriptorSet();
+
+    auto record = [&](uint t) {
+        auto secondary = _secondaryCmdBuffs[t];
+        // secondary command buffers inherit neither dynamic states nor bound descriptor sets
+        secondary->begin(renderPass, 0, framebuffer);
+        secondary->setViewport(viewport);
+        secondary->setScissor(_renderArea);
+        secondary->bindDescriptorSet(GLOBAL_SET, globalDescriptorSet);
+        _recordTasks[t].record(secondary, &_recordStats[t]);
+        secondary->end();
+    };
+
+    auto jobSystem = JobSystem::getInstance();
+    auto root = jobSystem->createJob([] {});
+    for (uint t = 0; t < taskCount; ++t) {
+        if (!_recordTasks[t].onWorker) continue;
+        auto job = jobSystem->createJob([&record, t] { record(t); }, root);
+        jobSystem->run(job);
+        jobSystem->release(job);
+    }
+    for (uint t = 0; t < taskCount; ++t) {
+        if (!_recordTasks[t].onWorker) record(t);
+    }
+    jobSystem->run(root);
+    jobSystem->wait(root);
+
+    for (const auto &stats : _recordStats) {
+        pipeline->addBindStatistics(stats);
+    }
+
+    cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors.data(), camera->clearDepth, camera->clearStencil, true);
+    cmdBuff->execute(_secondaryCmdBuffs.data(), taskCount);
     cmdBuff->endRenderPass();
 }
 
@@ -36,6 +36,7 @@ class PlanarShadowQueue;
 class ForwardPipeline;
 class UIPhase;
 struct Camera;
+struct BindStatistics;
 
 class CC_DLL ForwardStage : public RenderStage {
 public:
@@ -50,6 +51,9 @@ public:
     virtual void render(Camera *camera) override;
 
 private:
+    void recordCommandBuffers(Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    void recordCommandBuffersParallel(Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer, gfx::CommandBuffer *cmdBuff);
+
     static RenderStageInfo _initInfo;
     ForwardPipeline *_forwrdPipeline = nullptr;
     PlanarShadowQueue *_planarShadowQueue = nullptr;
@@ -59,6 +63,16 @@ private:
     UIPhase *_uiPhase = nullptr;
     gfx::Rect _renderArea;
     uint _phaseID = 0;
+
+    struct RecordTask {
+        std::function<void(gfx::CommandBuffer *, BindStatistics *)> record;
+        bool onWorker = false;
+    };
+
+    // one secondary command buffer per recording task, executed in order by the primary one
+    gfx::CommandBufferList _secondaryCmdBuffs;
+    vector<RecordTask> _recordTasks;
+    vector<BindStatistics> _recordStats;
 };
 
 } // namespace pipeline
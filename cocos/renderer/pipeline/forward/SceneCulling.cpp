@@ -22,9 +22,12 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include <array>
+#include <unordered_set>
 #include <vector>
 
 #include "../Define.h"
+#include "../helper/FrustumCulling.h"
+#include "../helper/ModelBVH.h"
 #include "../helper/SharedMemory.h"
 #include "ForwardPipeline.h"
 #include "SceneCulling.h"
@@ -50,6 +53,119 @@ RenderObject genRenderObject(const ModelView *model, const Camera *camera) {
     return {depth, model};
 }
 
+namespace {
+// Models handled by one culling task, small scenes are culled on the calling thread only.
+constexpr uint CULLING_MODELS_PER_TASK = 1024;
+
+struct CullingTask {
+    uint begin = 0;
+    uint end = 0;
+    vector<const ModelView *> candidates;
+    AABBSoA bounds;
+    vector<uint8_t> visible;
+    RenderObjectList renderObjects;
+};
+vector<CullingTask> cullingTasks;
+vector<const ModelView *> spatialCandidates;
+vector<const ModelView *> shadowCandidates;
+
+bool isModelVisible(const ModelView *model, uint visibility) {
+    if (!model->enabled) return false;
+    const auto node = model->getNode();
+    return (model->nodeID && ((visibility & node->layer) == node->layer)) ||
+           (visibility & model->visFlags);
+}
+
+void cullModels(CullingTask &task, const uint *models, const Scene *scene, const Camera *camera) {
+    const auto visibility = camera->visibility;
+    task.candidates.clear();
+    task.bounds.clear();
+    task.renderObjects.clear();
+
+    for (uint i = task.begin; i < task.end; ++i) {
+        const auto model = scene->getModelView(models[i]);
+        if (!isModelVisible(model, visibility)) continue;
+        if (model->worldBoundsID) {
+            task.bounds.push(*model->getWorldBounds());
+        } else {
+            task.bounds.push(AABB());
+        }
+        task.candidates.emplace_back(model);
+    }
+
+    task.visible.resize(task.bounds.count);
+    aabbFrustumBatch(task.bounds, camera->getFrustum(), task.visible.data());
+
+    for (uint i = 0; i < task.candidates.size(); ++i) {
+        const auto model = task.candidates[i];
+        // models without world bounds are never frustum culled
+        if (model->worldBoundsID && !task.visible[i]) continue;
+        task.renderObjects.emplace_back(genRenderObject(model, camera));
+    }
+}
+
+// World space bounds of the orthographic shadow camera of a directional light without auto adapt.
+AABB getDirShadowBounds(const Light *light, const Shadows *shadows) {
+    const auto &matShadowCamera = light->getNode()->worldMatrix;
+    const auto x = shadows->orthoSize * shadows->aspect;
+    const auto y = shadows->orthoSize;
+
+    Vec3 minPos, maxPos;
+    for (int i = 0; i < 8; ++i) {
+        Vec3 corner((i & 1) ? x : -x, (i & 2) ? y : -y, (i & 4) ? -shadows->farValue : -shadows->nearValue);
+        matShadowCamera.transformPoint(&corner);
+        if (i == 0) {
+            minPos = maxPos = corner;
+        } else {
+            Vec3::min(minPos, corner, &minPos);
+            Vec3::max(maxPos, corner, &maxPos);
+        }
+    }
+
+    AABB bounds;
+    bounds.center = (minPos + maxPos) * 0.5f;
+    bounds.halfExtents = (maxPos - minPos) * 0.5f;
+    return bounds;
+}
+
+// Collects the shadow casters lit by the main light and the spot lights of the scene from the BVH.
+// Auto adapted directional shadows fit every caster in the scene, so they have no bounded region to query.
+bool queryShadowCasters(ForwardPipeline *pipeline, const Scene *scene, vector<const ModelView *> &out) {
+    const auto *shadows = pipeline->getShadows();
+    const Light *mainLight = scene->mainLightID ? scene->getMainLight() : nullptr;
+    if (mainLight && mainLight->getType() == LightType::DIRECTIONAL && shadows->autoAdapt) return false;
+
+    auto bvh = pipeline->getOrCreateModelBVH(scene);
+    bvh->update(scene);
+
+    out.clear();
+    if (mainLight && mainLight->getType() == LightType::DIRECTIONAL) {
+        const auto bounds = getDirShadowBounds(mainLight, shadows);
+        bvh->queryAABB(&bounds, out);
+    }
+
+    const auto spotLightArrayID = scene->getSpotLightArrayID();
+    const auto count = spotLightArrayID ? spotLightArrayID[0] : 0;
+    if (!count) return true;
+
+    // spot light hits are appended after the main light hits, skipping duplicates
+    unordered_set<const ModelView *> collected(out.begin(), out.end());
+    vector<const ModelView *> hits;
+    Sphere sphere;
+    for (uint32_t i = 1; i <= count; ++i) {
+        const auto *spotLight = scene->getSpotLight(spotLightArrayID[i]);
+        sphere.center.set(spotLight->position);
+        sphere.radius = spotLight->range;
+        hits.clear();
+        bvh->querySphere(&sphere, hits);
+        for (const auto model : hits) {
+            if (collected.insert(model).second) out.emplace_back(model);
+        }
+    }
+    return true;
+}
+} // namespace
+
 void getShadowWorldMatrix(const Sphere *sphere, const cc::Vec4 &rotation, const cc::Vec3 &dir, cc::Mat4 &shadowWorldMat, cc::Vec3 &out) {
     Vec3 translation(dir);
     translation.negate();
@@ -138,7 +254,7 @@ void updateDirLight(Shadows *shadows, const Light *light, std::array<float, UBOS
 
 void lightCollecting(Camera *camera, std::vector<const Light *> &validLights) {
     validLights.clear();
-    auto *sphere = CC_NEW(Sphere);
+    Sphere sphere;
     const auto scene = camera->getScene();
     const Light *mainLight = nullptr;
     if (scene->mainLightID) mainLight = scene->getMainLight();
@@ -148,14 +264,12 @@ void lightCollecting(Camera *camera, std::vector<const Light *> &validLights) {
     const auto count = spotLightArrayID ? spotLightArrayID[0] : 0;
     for (uint32_t i = 1; i <= count; ++i) {
         const auto *spotLight = scene->getSpotLight(spotLightArrayID[i]);
-        sphere->center.set(spotLight->position);
-        sphere->radius = spotLight->range;
-        if (sphere->interset(*camera->getFrustum())) {
+        sphere.center.set(spotLight->position);
+        sphere.radius = spotLight->range;
+        if (sphere.interset(*camera->getFrustum())) {
             validLights.emplace_back(spotLight);
         }
     }
-
-    CC_SAFE_DELETE(sphere);
 }
 
 void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
@@ -165,28 +279,31 @@ void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
 
     RenderObjectList shadowObjects;
 
-    const auto models = scene->getModels();
-    const auto modelCount = models[0];
-    for (size_t i = 1; i <= modelCount; i++) {
-        const auto model = scene->getModelView(models[i]);
-
+    auto collect = [&](const ModelView *model) {
         // filter model by view visibility
-        if (model->enabled) {
-            const auto visibility = camera->visibility;
-            const auto node = model->getNode();
-            if ((model->nodeID && ((visibility & node->layer) == node->layer)) ||
-                (visibility & model->visFlags)) {
-                // shadow render Object
-                if (model->castShadow && model->getWorldBounds()) {
-                    if (!castBoundsInitialized) {
-                        castWorldBounds = *model->getWorldBounds();
-                        castBoundsInitialized = true;
-                    }
-                    castWorldBounds.merge(*model->getWorldBounds());
-                    shadowObjects.emplace_back(genRenderObject(model, camera));
+        if (isModelVisible(model, camera->visibility)) {
+            // shadow render Object
+            if (model->castShadow && model->getWorldBounds()) {
+                if (!castBoundsInitialized) {
+                    castWorldBounds = *model->getWorldBounds();
+                    castBoundsInitialized = true;
                 }
+                castWorldBounds.merge(*model->getWorldBounds());
+                shadowObjects.emplace_back(genRenderObject(model, camera));
             }
         }
+    };
+
+    if (pipeline->isSpatialCulling() && queryShadowCasters(pipeline, scene, shadowCandidates)) {
+        for (const auto model : shadowCandidates) {
+            collect(model);
+        }
+    } else {
+        const auto models = scene->getModels();
+        const auto modelCount = models[0];
+        for (size_t i = 1; i <= modelCount; i++) {
+            collect(scene->getModelView(models[i]));
+        }
     }
 
     pipeline->getSphere()->define(castWorldBounds);
@@ -207,8 +324,49 @@ void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
         renderObjects.emplace_back(genRenderObject(skyBox->getModel(), camera));
     }
 
+    if (pipeline->isSpatialCulling()) {
+        auto bvh = pipeline->getOrCreateModelBVH(scene);
+        bvh->update(scene);
+
+        spatialCandidates.clear();
+        bvh->queryFrustum(camera->getFrustum(), spatialCandidates);
+        for (const auto model : spatialCandidates) {
+            if (isModelVisible(model, camera->visibility)) {
+                renderObjects.emplace_back(genRenderObject(model, camera));
+            }
+        }
+
+        pipeline->setRenderObjects(std::move(renderObjects));
+        return;
+    }
+
     const auto models = scene->getModels();
     const auto modelCount = models[0];
+
+    if (pipeline->isParallelCulling()) {
+        const uint maxTasks = pipeline->getMaxParallelTasks();
+        const uint taskCount = std::max(1u, std::min(maxTasks, (modelCount + CULLING_MODELS_PER_TASK - 1) / CULLING_MODELS_PER_TASK));
+        const uint modelsPerTask = (modelCount + taskCount - 1) / taskCount;
+        if (cullingTasks.size() < taskCount) cullingTasks.resize(taskCount);
+        for (uint t = 0; t < taskCount; ++t) {
+            cullingTasks[t].begin = 1 + t * modelsPerTask;
+            cullingTasks[t].end = std::min(modelCount + 1, cullingTasks[t].begin + modelsPerTask);
+        }
+
+        pipeline->parallelFor(taskCount, [&](uint t) {
+            cullModels(cullingTasks[t], models, scene, camera);
+        });
+
+        // concatenate in task order so the result matches the serial path
+        for (uint t = 0; t < taskCount; ++t) {
+            const auto &taskObjects = cullingTasks[t].renderObjects;
+            renderObjects.insert(renderObjects.end(), taskObjects.begin(), taskObjects.end());
+        }
+
+        pipeline->setRenderObjects(std::move(renderObjects));
+        return;
+    }
+
     for (size_t i = 1; i <= modelCount; i++) {
         const auto model = scene->getModelView(models[i]);
 
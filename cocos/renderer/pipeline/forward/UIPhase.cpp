@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "UIPhase.h"
 #include "ForwardPipeline.h"
 #include "pipeline/PipelineStateManager.h"
+#include "pipeline/helper/CommandRecorder.h"
 #include "gfx/GFXCommandBuffer.h"
 
 namespace cc {
@@ -34,9 +35,8 @@ void UIPhase::activate(RenderPipeline *pipeline){
     _phaseID = getPhaseID("default");
 };
 
-void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass){
-    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    auto cmdBuff = pipeline->getCommandBuffers()[0];
+void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, BindStatistics *stats){
+    CommandRecorder recorder(cmdBuff, stats);
 
     auto batches = camera->getScene()->getUIBatches();
     const int batchCount = batches[0];
@@ -57,11 +57,11 @@ void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass){
             const auto inputAssembler = batch->getInputAssembler();
             const auto ds = batch->getDescriptorSet();
             auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
-            cmdBuff->bindPipelineState(pso);
-            cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-            cmdBuff->bindDescriptorSet(LOCAL_SET, ds);
-            cmdBuff->bindInputAssembler(inputAssembler);
-            cmdBuff->draw(inputAssembler);
+            recorder.bindPipelineState(pso);
+            recorder.bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
+            recorder.bindDescriptorSet(LOCAL_SET, ds);
+            recorder.bindInputAssembler(inputAssembler);
+            recorder.draw(inputAssembler);
         }
     }
 }
@@ -27,11 +27,13 @@ THE SOFTWARE.
 namespace cc {
 namespace pipeline {
 
+struct BindStatistics;
+
 class CC_DLL UIPhase {
 public:
     UIPhase () = default;
     void activate(RenderPipeline* pipeline);
-    void render(Camera *camera, gfx::RenderPass* renderPass);
+    void render(Camera *camera, gfx::RenderPass* renderPass, gfx::CommandBuffer *cmdBuff, BindStatistics *stats = nullptr);
 protected:
     RenderPipeline *_pipeline = nullptr;
     uint _phaseID = 0;
@@ -0,0 +1,275 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "ClusterLightGrid.h"
+#include "math/Vec3.h"
+#include <cfloat>
+#include <cmath>
+
+// math/Vec4.h and math/Mat4.h #undef __SSE__, so test the target architecture instead
+#if defined(__x86_64__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define CC_CLUSTER_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define CC_CLUSTER_NEON
+#endif
+
+namespace cc {
+namespace pipeline {
+
+constexpr float ClusterLightGrid::MIN_SLICE_DEPTH;
+
+namespace {
+bool isSameLayout(const ClusterLightGridInfo &a, const ClusterLightGridInfo &b) {
+    return a.tilesX == b.tilesX && a.tilesY == b.tilesY && a.slicesZ == b.slicesZ &&
+           a.clipSpaceMinZ == b.clipSpaceMinZ && !memcmp(a.matProjInv.m, b.matProjInv.m, sizeof(a.matProjInv.m));
+}
+
+Vec3 unproject(const Mat4 &matProjInv, float x, float y, float z) {
+    Vec4 p(x, y, z, 1.0f);
+    matProjInv.transformVector(&p);
+    return Vec3(p.x / p.w, p.y / p.w, p.z / p.w);
+}
+
+// squared distance from the sphere center to the box, compared against the squared radius
+CC_INLINE bool sphereClusterScalar(float x, float y, float z, float radiusSq, const float *boundsMin, const float *boundsMax) {
+    const float dx = std::max(std::max(boundsMin[0] - x, x - boundsMax[0]), 0.0f);
+    const float dy = std::max(std::max(boundsMin[1] - y, y - boundsMax[1]), 0.0f);
+    const float dz = std::max(std::max(boundsMin[2] - z, z - boundsMax[2]), 0.0f);
+    return dx * dx + dy * dy + dz * dz <= radiusSq;
+}
+} // namespace
+
+uint ClusterLightGrid::getSlice(float viewDepth) const {
+    if (viewDepth <= 0.0f) return 0;
+    const float slice = std::floor(std::log(viewDepth) * _sliceScale + _sliceBias);
+    if (slice <= 0.0f) return 0;
+    return std::min(static_cast<uint>(slice), _info.slicesZ - 1);
+}
+
+void ClusterLightGrid::updateClusterBounds(const ClusterLightGridInfo &info) {
+    const uint tilesX = info.tilesX;
+    const uint tilesY = info.tilesY;
+    const uint slicesZ = info.slicesZ;
+
+    const float zNear = -unproject(info.matProjInv, 0.0f, 0.0f, info.clipSpaceMinZ).z;
+    const float zFar = -unproject(info.matProjInv, 0.0f, 0.0f, 1.0f).z;
+    const float sliceNear = std::max(zNear, MIN_SLICE_DEPTH);
+    const float logRange = std::log(std::max(zFar, sliceNear * 1.001f) / sliceNear);
+    _sliceScale = static_cast<float>(slicesZ) / logRange;
+    _sliceBias = -std::log(sliceNear) * _sliceScale;
+
+    _sliceDepths.resize(slicesZ + 1);
+    for (uint z = 0; z <= slicesZ; ++z) {
+        _sliceDepths[z] = sliceNear * std::exp(logRange * static_cast<float>(z) / static_cast<float>(slicesZ));
+    }
+    _sliceDepths[0] = std::min(zNear, sliceNear);
+    _sliceDepths[slicesZ] = std::max(zFar, _sliceDepths[slicesZ]);
+
+    // tile corners as view space segments between the near and far planes,
+    // interpolating along them works for both perspective and orthographic projections
+    const uint cornersX = tilesX + 1;
+    vector<Vec3> nearCorners(cornersX * (tilesY + 1));
+    vector<Vec3> farCorners(nearCorners.size());
+    for (uint y = 0; y <= tilesY; ++y) {
+        const float ndcY = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(tilesY);
+        for (uint x = 0; x <= tilesX; ++x) {
+            const float ndcX = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(tilesX);
+            nearCorners[y * cornersX + x] = unproject(info.matProjInv, ndcX, ndcY, info.clipSpaceMinZ);
+            farCorners[y * cornersX + x] = unproject(info.matProjInv, ndcX, ndcY, 1.0f);
+        }
+    }
+
+    _bounds.resize(tilesX * tilesY * slicesZ);
+    for (uint z = 0; z < slicesZ; ++z) {
+        const float depths[2] = {_sliceDepths[z], _sliceDepths[z + 1]};
+        for (uint y = 0; y < tilesY; ++y) {
+            for (uint x = 0; x < tilesX; ++x) {
+                auto &bounds = _bounds[(z * tilesY + y) * tilesX + x];
+                bounds = {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+                for (uint c = 0; c < 4; ++c) {
+                    const uint corner = (y + (c >> 1)) * cornersX + x + (c & 1);
+                    const auto &n = nearCorners[corner];
+                    const auto &f = farCorners[corner];
+                    const float range = n.z - f.z;
+                    for (const float depth : depths) {
+                        const float t = range != 0.0f ? (depth + n.z) / range : 0.0f;
+                        const Vec3 p = n + (f - n) * t;
+                        bounds.minX = std::min(bounds.minX, p.x);
+                        bounds.minY = std::min(bounds.minY, p.y);
+                        bounds.maxX = std::max(bounds.maxX, p.x);
+                        bounds.maxY = std::max(bounds.maxY, p.y);
+                    }
+                }
+                bounds.minZ = -depths[1];
+                bounds.maxZ = -depths[0];
+            }
+        }
+    }
+
+    _info = info;
+    _hasBounds = true;
+}
+
+void ClusterLightGrid::build(const ClusterLightGridInfo &info, const Vec4 *spheres, uint count, const ParallelFor &parallelFor) {
+    if (!_hasBounds || !isSameLayout(info, _info)) {
+        updateClusterBounds(info);
+    }
+    _info.maxLightsPerCluster = info.maxLightsPerCluster;
+
+    const uint slicesZ = _info.slicesZ;
+    const uint clusterCount = _info.tilesX * _info.tilesY * slicesZ;
+    _clusterCounts.assign(clusterCount, 0);
+    _clusterOffsets.assign(clusterCount, 0);
+    _lightIndices.clear();
+    if (!count) return;
+
+    const uint taskCount = (slicesZ + SLICES_PER_TASK - 1) / SLICES_PER_TASK;
+    if (_candidates.size() < taskCount) _candidates.resize(taskCount);
+    _sliceIndices.resize(slicesZ);
+
+    const auto task = [&](uint t) {
+        const uint end = std::min((t + 1) * SLICES_PER_TASK, slicesZ);
+        for (uint z = t * SLICES_PER_TASK; z < end; ++z) {
+            buildSlice(z, spheres, count, _candidates[t]);
+        }
+    };
+    if (parallelFor) {
+        parallelFor(taskCount, task);
+    } else {
+        for (uint t = 0; t < taskCount; ++t) task(t);
+    }
+
+    // slices are stored in cluster order already, so compaction is a prefix sum and a concatenation
+    uint offset = 0;
+    for (uint i = 0; i < clusterCount; ++i) {
+        _clusterOffsets[i] = offset;
+        offset += _clusterCounts[i];
+    }
+    _lightIndices.reserve(offset);
+    for (uint z = 0; z < slicesZ; ++z) {
+        _lightIndices.insert(_lightIndices.end(), _sliceIndices[z].begin(), _sliceIndices[z].end());
+    }
+}
+
+void ClusterLightGrid::buildSlice(uint slice, const Vec4 *spheres, uint count, Candidates &candidates) {
+    auto &indices = _sliceIndices[slice];
+    indices.clear();
+
+    const float sliceNear = _sliceDepths[slice];
+    const float sliceFar = _sliceDepths[slice + 1];
+    candidates.x.clear();
+    candidates.y.clear();
+    candidates.z.clear();
+    candidates.radiusSq.clear();
+    candidates.lights.clear();
+    for (uint i = 0; i < count; ++i) {
+        const auto &sphere = spheres[i];
+        const float depth = -sphere.z;
+        if (depth + sphere.w < sliceNear || depth - sphere.w > sliceFar) continue;
+        candidates.x.push_back(sphere.x);
+        candidates.y.push_back(sphere.y);
+        candidates.z.push_back(sphere.z);
+        candidates.radiusSq.push_back(sphere.w * sphere.w);
+        candidates.lights.push_back(i);
+    }
+    candidates.count = static_cast<uint>(candidates.lights.size());
+    if (!candidates.count) return;
+
+    while (candidates.x.size() & 3) {
+        candidates.x.push_back(0.0f);
+        candidates.y.push_back(0.0f);
+        candidates.z.push_back(0.0f);
+        candidates.radiusSq.push_back(-1.0f);
+    }
+
+    const uint tileCount = _info.tilesX * _info.tilesY;
+    const uint maxLights = _info.maxLightsPerCluster;
+#if defined(CC_CLUSTER_SSE) || defined(CC_CLUSTER_NEON)
+    const uint padded = static_cast<uint>(candidates.x.size());
+#endif
+    for (uint tile = 0; tile < tileCount; ++tile) {
+        const uint cluster = slice * tileCount + tile;
+        const auto &bounds = _bounds[cluster];
+        uint hits = 0;
+        uint i = 0;
+
+#if defined(CC_CLUSTER_SSE)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minX = _mm_set1_ps(bounds.minX), minY = _mm_set1_ps(bounds.minY), minZ = _mm_set1_ps(bounds.minZ);
+        const __m128 maxX = _mm_set1_ps(bounds.maxX), maxY = _mm_set1_ps(bounds.maxY), maxZ = _mm_set1_ps(bounds.maxZ);
+        for (; i < padded && hits < maxLights; i += 4) {
+            const __m128 cx = _mm_loadu_ps(&candidates.x[i]);
+            const __m128 cy = _mm_loadu_ps(&candidates.y[i]);
+            const __m128 cz = _mm_loadu_ps(&candidates.z[i]);
+            const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, cx), _mm_sub_ps(cx, maxX)), zero);
+            const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, cy), _mm_sub_ps(cy, maxY)), zero);
+            const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, cz), _mm_sub_ps(cz, maxZ)), zero);
+            const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            const int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, _mm_loadu_ps(&candidates.radiusSq[i])));
+            for (uint lane = 0; lane < 4 && hits < maxLights; ++lane) {
+                if (mask & (1 << lane)) {
+                    indices.push_back(candidates.lights[i + lane]);
+                    ++hits;
+                }
+            }
+        }
+#elif defined(CC_CLUSTER_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t minX = vdupq_n_f32(bounds.minX), minY = vdupq_n_f32(bounds.minY), minZ = vdupq_n_f32(bounds.minZ);
+        const float32x4_t maxX = vdupq_n_f32(bounds.maxX), maxY = vdupq_n_f32(bounds.maxY), maxZ = vdupq_n_f32(bounds.maxZ);
+        for (; i < padded && hits < maxLights; i += 4) {
+            const float32x4_t cx = vld1q_f32(&candidates.x[i]);
+            const float32x4_t cy = vld1q_f32(&candidates.y[i]);
+            const float32x4_t cz = vld1q_f32(&candidates.z[i]);
+            const float32x4_t dx = vmaxq_f32(vmaxq_f32(vsubq_f32(minX, cx), vsubq_f32(cx, maxX)), zero);
+            const float32x4_t dy = vmaxq_f32(vmaxq_f32(vsubq_f32(minY, cy), vsubq_f32(cy, maxY)), zero);
+            const float32x4_t dz = vmaxq_f32(vmaxq_f32(vsubq_f32(minZ, cz), vsubq_f32(cz, maxZ)), zero);
+            // explicit vmul + vadd instead of vmla so the rounding matches the scalar path
+            const float32x4_t distSq = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)), vmulq_f32(dz, dz));
+            const uint32x4_t hit = vcleq_f32(distSq, vld1q_f32(&candidates.radiusSq[i]));
+            const uint lanes[4] = {vgetq_lane_u32(hit, 0), vgetq_lane_u32(hit, 1), vgetq_lane_u32(hit, 2), vgetq_lane_u32(hit, 3)};
+            for (uint lane = 0; lane < 4 && hits < maxLights; ++lane) {
+                if (lanes[lane]) {
+                    indices.push_back(candidates.lights[i + lane]);
+                    ++hits;
+                }
+            }
+        }
+#endif
+
+        const float boundsMin[3] = {bounds.minX, bounds.minY, bounds.minZ};
+        const float boundsMax[3] = {bounds.maxX, bounds.maxY, bounds.maxZ};
+        for (; i < candidates.count && hits < maxLights; ++i) {
+            if (sphereClusterScalar(candidates.x[i], candidates.y[i], candidates.z[i], candidates.radiusSq[i], boundsMin, boundsMax)) {
+                indices.push_back(candidates.lights[i]);
+                ++hits;
+            }
+        }
+        _clusterCounts[cluster] = hits;
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "math/Mat4.h"
+#include "math/Vec4.h"
+#include <functional>
+
+namespace cc {
+namespace pipeline {
+
+struct CC_DLL ClusterLightGridInfo {
+    uint tilesX = 16;
+    uint tilesY = 8;
+    uint slicesZ = 24;
+    uint maxLightsPerCluster = 32;
+    Mat4 matProjInv;
+    float clipSpaceMinZ = -1.0f;
+};
+
+// Froxel light grid for clustered forward shading. The view frustum is split into
+// tilesX * tilesY screen tiles and slicesZ exponential depth slices, and every cluster
+// lists the lights whose bounding sphere touches it. Only CPU data is involved, the
+// results are flat arrays ready to be uploaded.
+class CC_DLL ClusterLightGrid : public Object {
+public:
+    using ParallelFor = std::function<void(uint taskCount, const std::function<void(uint)> &task)>;
+
+    static constexpr float MIN_SLICE_DEPTH = 0.1f;
+    static constexpr uint SLICES_PER_TASK = 4;
+
+    // `spheres` are view space bounding spheres (xyz center, w radius) with the camera looking down -Z.
+    // Light indices in the output refer to positions in `spheres`.
+    void build(const ClusterLightGridInfo &info, const Vec4 *spheres, uint count, const ParallelFor &parallelFor = nullptr);
+
+    CC_INLINE uint getClusterCount() const { return static_cast<uint>(_clusterCounts.size()); }
+    CC_INLINE uint getClusterIndex(uint x, uint y, uint z) const { return (z * _info.tilesY + y) * _info.tilesX + x; }
+    CC_INLINE const vector<uint> &getClusterOffsets() const { return _clusterOffsets; }
+    CC_INLINE const vector<uint> &getClusterCounts() const { return _clusterCounts; }
+    CC_INLINE const vector<uint> &getLightIndices() const { return _lightIndices; }
+    // slice = floor(log(viewDepth) * sliceScale + sliceBias), clamped to [0, slicesZ)
+    CC_INLINE float getSliceScale() const { return _sliceScale; }
+    CC_INLINE float getSliceBias() const { return _sliceBias; }
+    uint getSlice(float viewDepth) const;
+
+private:
+    struct ClusterBounds {
+        float minX, minY, minZ;
+        float maxX, maxY, maxZ;
+    };
+    // lights overlapping the slice being built, padded to a multiple of 4 with spheres that never hit
+    struct Candidates {
+        vector<float> x;
+        vector<float> y;
+        vector<float> z;
+        vector<float> radiusSq;
+        vector<uint> lights;
+        uint count = 0;
+    };
+
+    void updateClusterBounds(const ClusterLightGridInfo &info);
+    void buildSlice(uint slice, const Vec4 *spheres, uint count, Candidates &candidates);
+
+    ClusterLightGridInfo _info;
+    bool _hasBounds = false;
+    float _sliceScale = 0.0f;
+    float _sliceBias = 0.0f;
+    vector<float> _sliceDepths;
+    vector<ClusterBounds> _bounds;
+    vector<Candidates> _candidates;
+    vector<vector<uint>> _sliceIndices;
+    vector<uint> _clusterOffsets;
+    vector<uint> _clusterCounts;
+    vector<uint> _lightIndices;
+};
+
+} // namespace pipeline
+} // namespace cc
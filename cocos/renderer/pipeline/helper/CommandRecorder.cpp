@@ -0,0 +1,59 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CommandRecorder.h"
+
+namespace cc {
+namespace pipeline {
+
+constexpr uint CommandRecorder::MAX_DESCRIPTOR_SETS;
+
+CommandRecorder::CommandRecorder(gfx::CommandBuffer *cmdBuff, BindStatistics *stats)
+: _cmdBuff(cmdBuff), _output(stats) {
+}
+
+CommandRecorder::~CommandRecorder() {
+    if (_output) *_output += _stats;
+}
+
+void CommandRecorder::drawResolved(const ResolvedDraw *draws, uint count, uint materialSet, uint localSet) {
+    for (uint i = 0; i < count; ++i) {
+        const auto &draw = draws[i];
+        bindPipelineState(draw.pso);
+        bindDescriptorSet(materialSet, draw.materialSet);
+        bindDescriptorSet(localSet, draw.localSet);
+        bindInputAssembler(draw.inputAssembler);
+        _cmdBuff->draw(draw.inputAssembler);
+    }
+}
+
+void CommandRecorder::reset() {
+    _pso = nullptr;
+    for (auto &descriptorSet : _descriptorSets) {
+        descriptorSet = nullptr;
+    }
+    _inputAssembler = nullptr;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "gfx/GFXCommandBuffer.h"
+
+namespace cc {
+namespace pipeline {
+
+struct CC_DLL BindStatistics {
+    uint issued = 0;
+    uint elided = 0;
+
+    CC_INLINE BindStatistics &operator+=(const BindStatistics &rhs) {
+        issued += rhs.issued;
+        elided += rhs.elided;
+        return *this;
+    }
+};
+
+// A draw whose objects were looked up beforehand, see RenderQueue::resolve.
+struct CC_DLL ResolvedDraw {
+    gfx::PipelineState *pso = nullptr;
+    gfx::DescriptorSet *materialSet = nullptr;
+    gfx::DescriptorSet *localSet = nullptr;
+    gfx::InputAssembler *inputAssembler = nullptr;
+};
+
+// Thin wrapper over a command buffer that drops binds of the state that is already bound.
+// The tracked state starts out unknown, so construct one per recording pass and don't
+// interleave it with binds issued on the command buffer directly.
+// The counters are the recorder's own; when `stats` is given they are added to it on destruction,
+// so recorders on different threads should be given different statistics.
+class CC_DLL CommandRecorder final {
+public:
+    static constexpr uint MAX_DESCRIPTOR_SETS = 4;
+
+    explicit CommandRecorder(gfx::CommandBuffer *cmdBuff, BindStatistics *stats = nullptr);
+    ~CommandRecorder();
+
+    CC_INLINE void bindPipelineState(gfx::PipelineState *pso) {
+        if (pso == _pso) {
+            ++_stats.elided;
+            return;
+        }
+        _pso = pso;
+        _cmdBuff->bindPipelineState(pso);
+        ++_stats.issued;
+    }
+
+    CC_INLINE void bindDescriptorSet(uint set, gfx::DescriptorSet *descriptorSet) {
+        if (descriptorSet == _descriptorSets[set]) {
+            ++_stats.elided;
+            return;
+        }
+        _descriptorSets[set] = descriptorSet;
+        _cmdBuff->bindDescriptorSet(set, descriptorSet);
+        ++_stats.issued;
+    }
+
+    // binds with dynamic offsets always go through
+    CC_INLINE void bindDescriptorSet(uint set, gfx::DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+        _descriptorSets[set] = nullptr;
+        _cmdBuff->bindDescriptorSet(set, descriptorSet, dynamicOffsetCount, dynamicOffsets);
+        ++_stats.issued;
+    }
+
+    CC_INLINE void bindInputAssembler(gfx::InputAssembler *ia) {
+        if (ia == _inputAssembler) {
+            ++_stats.elided;
+            return;
+        }
+        _inputAssembler = ia;
+        _cmdBuff->bindInputAssembler(ia);
+        ++_stats.issued;
+    }
+
+    CC_INLINE void draw(gfx::InputAssembler *ia) { _cmdBuff->draw(ia); }
+
+    // Only touches the objects in `draws`, so it can run on any thread.
+    void drawResolved(const ResolvedDraw *draws, uint count, uint materialSet, uint localSet);
+
+    // Forgets the tracked state, e.g. after binds were issued on the command buffer directly.
+    void reset();
+
+    CC_INLINE uint getNumBindsIssued() const { return _stats.issued; }
+    CC_INLINE uint getNumBindsElided() const { return _stats.elided; }
+
+private:
+    gfx::CommandBuffer *_cmdBuff = nullptr;
+    gfx::PipelineState *_pso = nullptr;
+    gfx::DescriptorSet *_descriptorSets[MAX_DESCRIPTOR_SETS] = {};
+    gfx::InputAssembler *_inputAssembler = nullptr;
+    BindStatistics _stats;
+    BindStatistics *_output = nullptr;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,160 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "FrustumCulling.h"
+#include "SharedMemory.h"
+
+// math/Vec4.h and math/Mat4.h #undef __SSE__, so test the target architecture instead
+#if defined(__x86_64__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define CC_CULLING_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define CC_CULLING_NEON
+#endif
+
+namespace cc {
+namespace pipeline {
+
+void AABBSoA::push(const AABB &aabb) {
+    if (count == centerX.size()) {
+        const size_t capacity = std::max<size_t>(64, centerX.size() * 2);
+        centerX.resize(capacity, 0.0f);
+        centerY.resize(capacity, 0.0f);
+        centerZ.resize(capacity, 0.0f);
+        halfExtentX.resize(capacity, 0.0f);
+        halfExtentY.resize(capacity, 0.0f);
+        halfExtentZ.resize(capacity, 0.0f);
+    }
+    centerX[count] = aabb.center.x;
+    centerY[count] = aabb.center.y;
+    centerZ[count] = aabb.center.z;
+    halfExtentX[count] = aabb.halfExtents.x;
+    halfExtentY[count] = aabb.halfExtents.y;
+    halfExtentZ[count] = aabb.halfExtents.z;
+    ++count;
+}
+
+namespace {
+void aabbFrustumScalar(const AABBSoA &bounds, const Frustum *frustum, uint begin, uint end, uint8_t *visible) {
+    for (uint i = begin; i < end; ++i) {
+        uint8_t result = 1;
+        for (uint p = 0; p < PLANE_LENGTH; ++p) {
+            const auto &plane = frustum->planes[p];
+            const auto r = bounds.halfExtentX[i] * std::abs(plane.normal.x) +
+                           bounds.halfExtentY[i] * std::abs(plane.normal.y) +
+                           bounds.halfExtentZ[i] * std::abs(plane.normal.z);
+            const auto dot = plane.normal.x * bounds.centerX[i] +
+                             plane.normal.y * bounds.centerY[i] +
+                             plane.normal.z * bounds.centerZ[i];
+            if (dot + r < plane.distance) {
+                result = 0;
+                break;
+            }
+        }
+        visible[i] = result;
+    }
+}
+} // namespace
+
+void aabbFrustumBatch(const AABBSoA &bounds, const Frustum *frustum, uint8_t *visible) {
+    uint i = 0;
+
+#if defined(CC_CULLING_SSE)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 nx[PLANE_LENGTH], ny[PLANE_LENGTH], nz[PLANE_LENGTH];
+    __m128 ax[PLANE_LENGTH], ay[PLANE_LENGTH], az[PLANE_LENGTH], d[PLANE_LENGTH];
+    for (uint p = 0; p < PLANE_LENGTH; ++p) {
+        const auto &plane = frustum->planes[p];
+        nx[p] = _mm_set1_ps(plane.normal.x);
+        ny[p] = _mm_set1_ps(plane.normal.y);
+        nz[p] = _mm_set1_ps(plane.normal.z);
+        ax[p] = _mm_andnot_ps(signMask, nx[p]);
+        ay[p] = _mm_andnot_ps(signMask, ny[p]);
+        az[p] = _mm_andnot_ps(signMask, nz[p]);
+        d[p] = _mm_set1_ps(plane.distance);
+    }
+
+    for (; i + 4 <= bounds.count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+        const __m128 hx = _mm_loadu_ps(&bounds.halfExtentX[i]);
+        const __m128 hy = _mm_loadu_ps(&bounds.halfExtentY[i]);
+        const __m128 hz = _mm_loadu_ps(&bounds.halfExtentZ[i]);
+
+        __m128 outside = _mm_setzero_ps();
+        for (uint p = 0; p < PLANE_LENGTH; ++p) {
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(hx, ax[p]), _mm_mul_ps(hy, ay[p])), _mm_mul_ps(hz, az[p]));
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_mul_ps(nz[p], cz));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dot, r), d[p]));
+        }
+
+        const int mask = _mm_movemask_ps(outside);
+        visible[i] = (mask & 0x1) ? 0 : 1;
+        visible[i + 1] = (mask & 0x2) ? 0 : 1;
+        visible[i + 2] = (mask & 0x4) ? 0 : 1;
+        visible[i + 3] = (mask & 0x8) ? 0 : 1;
+    }
+#elif defined(CC_CULLING_NEON)
+    float32x4_t nx[PLANE_LENGTH], ny[PLANE_LENGTH], nz[PLANE_LENGTH];
+    float32x4_t ax[PLANE_LENGTH], ay[PLANE_LENGTH], az[PLANE_LENGTH], d[PLANE_LENGTH];
+    for (uint p = 0; p < PLANE_LENGTH; ++p) {
+        const auto &plane = frustum->planes[p];
+        nx[p] = vdupq_n_f32(plane.normal.x);
+        ny[p] = vdupq_n_f32(plane.normal.y);
+        nz[p] = vdupq_n_f32(plane.normal.z);
+        ax[p] = vabsq_f32(nx[p]);
+        ay[p] = vabsq_f32(ny[p]);
+        az[p] = vabsq_f32(nz[p]);
+        d[p] = vdupq_n_f32(plane.distance);
+    }
+
+    for (; i + 4 <= bounds.count; i += 4) {
+        const float32x4_t cx = vld1q_f32(&bounds.centerX[i]);
+        const float32x4_t cy = vld1q_f32(&bounds.centerY[i]);
+        const float32x4_t cz = vld1q_f32(&bounds.centerZ[i]);
+        const float32x4_t hx = vld1q_f32(&bounds.halfExtentX[i]);
+        const float32x4_t hy = vld1q_f32(&bounds.halfExtentY[i]);
+        const float32x4_t hz = vld1q_f32(&bounds.halfExtentZ[i]);
+
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (uint p = 0; p < PLANE_LENGTH; ++p) {
+            // explicit vmul + vadd instead of vmla so the rounding matches the scalar path
+            const float32x4_t r = vaddq_f32(vaddq_f32(vmulq_f32(hx, ax[p]), vmulq_f32(hy, ay[p])), vmulq_f32(hz, az[p]));
+            const float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(nx[p], cx), vmulq_f32(ny[p], cy)), vmulq_f32(nz[p], cz));
+            outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(dot, r), d[p]));
+        }
+
+        visible[i] = vgetq_lane_u32(outside, 0) ? 0 : 1;
+        visible[i + 1] = vgetq_lane_u32(outside, 1) ? 0 : 1;
+        visible[i + 2] = vgetq_lane_u32(outside, 2) ? 0 : 1;
+        visible[i + 3] = vgetq_lane_u32(outside, 3) ? 0 : 1;
+    }
+#endif
+
+    aabbFrustumScalar(bounds, frustum, i, bounds.count, visible);
+}
+
+} // namespace pipeline
+} // namespace cc
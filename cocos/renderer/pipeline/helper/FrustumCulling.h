@@ -0,0 +1,55 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+
+namespace cc {
+namespace pipeline {
+
+struct AABB;
+struct Frustum;
+
+// World bounds laid out as struct-of-arrays so that they can be tested against
+// the frustum planes four at a time. Capacity is always padded to a multiple of 4.
+struct CC_DLL AABBSoA {
+    vector<float> centerX;
+    vector<float> centerY;
+    vector<float> centerZ;
+    vector<float> halfExtentX;
+    vector<float> halfExtentY;
+    vector<float> halfExtentZ;
+    uint count = 0;
+
+    void clear() { count = 0; }
+    void push(const AABB &aabb);
+};
+
+// Tests every AABB in `bounds` against the frustum and writes 1 (visible) or 0 (culled)
+// to `visible[i]`. The plane test is evaluated in the same order as `aabb_frustum`,
+// so the results are identical to calling it once per AABB.
+void aabbFrustumBatch(const AABBSoA &bounds, const Frustum *frustum, uint8_t *visible);
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,394 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "ModelBVH.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// Leaves are enlarged by this ratio of their half extents plus a constant margin,
+// so small movements do not force a re-insertion.
+constexpr float FAT_BOUNDS_RATIO = 0.1f;
+constexpr float FAT_BOUNDS_MARGIN = 0.05f;
+
+CC_INLINE float boundsCost(const AABB &aabb) {
+    const auto &h = aabb.halfExtents;
+    return h.x * h.y + h.y * h.z + h.z * h.x;
+}
+
+AABB combine(const AABB &a, const AABB &b) {
+    AABB result = a;
+    result.merge(b);
+    return result;
+}
+
+bool contains(const AABB &outer, const AABB &inner) {
+    const auto dx = std::abs(outer.center.x - inner.center.x);
+    const auto dy = std::abs(outer.center.y - inner.center.y);
+    const auto dz = std::abs(outer.center.z - inner.center.z);
+    return dx + inner.halfExtents.x <= outer.halfExtents.x &&
+           dy + inner.halfExtents.y <= outer.halfExtents.y &&
+           dz + inner.halfExtents.z <= outer.halfExtents.z;
+}
+
+bool sphere_aabb(const Sphere *sphere, const AABB *aabb) {
+    const auto dx = std::max(0.0f, std::abs(sphere->center.x - aabb->center.x) - aabb->halfExtents.x);
+    const auto dy = std::max(0.0f, std::abs(sphere->center.y - aabb->center.y) - aabb->halfExtents.y);
+    const auto dz = std::max(0.0f, std::abs(sphere->center.z - aabb->center.z) - aabb->halfExtents.z);
+    return dx * dx + dy * dy + dz * dz <= sphere->radius * sphere->radius;
+}
+} // namespace
+
+void ModelBVH::clear() {
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeList = NULL_NODE;
+    _proxies.clear();
+    _modelIDs.clear();
+    _unbounded.clear();
+    _reinsertCount = 0;
+}
+
+void ModelBVH::update(const Scene *scene) {
+    const auto models = scene->getModels();
+    const uint modelCount = models ? models[0] : 0;
+
+    if (_modelIDs.size() != modelCount ||
+        (modelCount && memcmp(_modelIDs.data(), models + 1, modelCount * sizeof(uint)) != 0)) {
+        rebuildProxies(scene, models);
+        return;
+    }
+
+    for (auto &proxy : _proxies) {
+        if ((proxy.transform && proxy.transform->flagsChanged) ||
+            (proxy.node && proxy.node->flagsChanged) ||
+            proxy.model->worldBoundsID != proxy.worldBoundsID) {
+            refreshProxy(proxy);
+        }
+    }
+}
+
+void ModelBVH::rebuildProxies(const Scene *scene, const uint *models) {
+    const uint modelCount = models ? models[0] : 0;
+
+    unordered_map<uint, int> oldLeaves;
+    for (const auto &proxy : _proxies) {
+        if (proxy.leaf != NULL_NODE) oldLeaves.emplace(proxy.modelID, proxy.leaf);
+    }
+
+    _proxies.resize(modelCount);
+    _unbounded.clear();
+    for (uint i = 0; i < modelCount; ++i) {
+        auto &proxy = _proxies[i];
+        const auto model = scene->getModelView(models[i + 1]);
+        proxy.modelID = models[i + 1];
+        proxy.order = i;
+        proxy.model = model;
+        proxy.node = model->nodeID ? model->getNode() : nullptr;
+        proxy.transform = model->transformID ? model->getTransform() : nullptr;
+        proxy.worldBoundsID = 0;
+        proxy.leaf = NULL_NODE;
+
+        auto iter = oldLeaves.find(proxy.modelID);
+        if (iter != oldLeaves.end()) {
+            proxy.leaf = iter->second;
+            proxy.worldBoundsID = model->worldBoundsID;
+            _nodes[proxy.leaf].proxy = i;
+            oldLeaves.erase(iter);
+        }
+        refreshProxy(proxy);
+    }
+
+    // models that left the scene
+    for (const auto &pair : oldLeaves) {
+        removeLeaf(pair.second);
+        freeNode(pair.second);
+    }
+
+    _unbounded.clear();
+    for (const auto &proxy : _proxies) {
+        if (proxy.leaf == NULL_NODE) _unbounded.emplace_back(proxy.order);
+    }
+
+    _modelIDs.assign(models ? models + 1 : nullptr, models ? models + 1 + modelCount : nullptr);
+}
+
+void ModelBVH::refreshProxy(Proxy &proxy) {
+    const auto hadBounds = proxy.leaf != NULL_NODE;
+    proxy.worldBoundsID = proxy.model->worldBoundsID;
+
+    if (!proxy.worldBoundsID) {
+        if (hadBounds) {
+            removeLeaf(proxy.leaf);
+            freeNode(proxy.leaf);
+            proxy.leaf = NULL_NODE;
+            _unbounded.emplace_back(proxy.order);
+            std::sort(_unbounded.begin(), _unbounded.end());
+        }
+        return;
+    }
+
+    const auto &worldBounds = *proxy.model->getWorldBounds();
+    if (hadBounds) {
+        if (contains(_nodes[proxy.leaf].bounds, worldBounds)) return;
+        removeLeaf(proxy.leaf);
+    } else {
+        proxy.leaf = allocateNode();
+        _unbounded.erase(std::remove(_unbounded.begin(), _unbounded.end(), proxy.order), _unbounded.end());
+    }
+
+    auto &leaf = _nodes[proxy.leaf];
+    leaf.bounds.center = worldBounds.center;
+    leaf.bounds.halfExtents = worldBounds.halfExtents * (1.0f + FAT_BOUNDS_RATIO) + Vec3(FAT_BOUNDS_MARGIN, FAT_BOUNDS_MARGIN, FAT_BOUNDS_MARGIN);
+    leaf.proxy = proxy.order;
+    leaf.height = 0;
+    insertLeaf(proxy.leaf);
+    ++_reinsertCount;
+}
+
+int ModelBVH::allocateNode() {
+    if (_freeList == NULL_NODE) {
+        _nodes.emplace_back();
+        _freeList = static_cast<int>(_nodes.size()) - 1;
+        _nodes[_freeList].parent = NULL_NODE;
+    }
+
+    const auto nodeID = _freeList;
+    auto &node = _nodes[nodeID];
+    _freeList = node.parent;
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    return nodeID;
+}
+
+void ModelBVH::freeNode(int nodeID) {
+    auto &node = _nodes[nodeID];
+    node.parent = _freeList;
+    node.height = -1;
+    _freeList = nodeID;
+}
+
+void ModelBVH::insertLeaf(int leaf) {
+    if (_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // find the best sibling using the surface area heuristic
+    const auto leafBounds = _nodes[leaf].bounds;
+    int index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const auto &node = _nodes[index];
+        const auto area = boundsCost(node.bounds);
+        const auto combinedArea = boundsCost(combine(node.bounds, leafBounds));
+        const auto cost = 2.0f * combinedArea;
+        const auto inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](int child) {
+            const auto &childNode = _nodes[child];
+            const auto newArea = boundsCost(combine(childNode.bounds, leafBounds));
+            return (childNode.isLeaf() ? newArea : newArea - boundsCost(childNode.bounds)) + inheritanceCost;
+        };
+        const auto cost1 = childCost(node.child1);
+        const auto cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int sibling = index;
+    const int oldParent = _nodes[sibling].parent;
+    const int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].bounds = combine(leafBounds, _nodes[sibling].bounds);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE) {
+        if (_nodes[oldParent].child1 == sibling) {
+            _nodes[oldParent].child1 = newParent;
+        } else {
+            _nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        _root = newParent;
+    }
+
+    // walk back up the tree fixing heights and bounds
+    index = _nodes[leaf].parent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+        auto &node = _nodes[index];
+        const auto &child1 = _nodes[node.child1];
+        const auto &child2 = _nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = combine(child1.bounds, child2.bounds);
+        index = node.parent;
+    }
+}
+
+void ModelBVH::removeLeaf(int leaf) {
+    if (leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const int parent = _nodes[leaf].parent;
+    const int grandParent = _nodes[parent].parent;
+    const int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_NODE) {
+        if (_nodes[grandParent].child1 == parent) {
+            _nodes[grandParent].child1 = sibling;
+        } else {
+            _nodes[grandParent].child2 = sibling;
+        }
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index != NULL_NODE) {
+            index = balance(index);
+            auto &node = _nodes[index];
+            const auto &child1 = _nodes[node.child1];
+            const auto &child2 = _nodes[node.child2];
+            node.bounds = combine(child1.bounds, child2.bounds);
+            node.height = 1 + std::max(child1.height, child2.height);
+            index = node.parent;
+        }
+    } else {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced, returns the new subtree root.
+int ModelBVH::balance(int iA) {
+    auto &A = _nodes[iA];
+    if (A.isLeaf() || A.height < 2) return iA;
+
+    const int iB = A.child1;
+    const int iC = A.child2;
+    auto &B = _nodes[iB];
+    auto &C = _nodes[iC];
+    const int heightDiff = C.height - B.height;
+
+    auto rotate = [&](int iUp, TreeNode &up, const TreeNode &side, bool upIsChild2) {
+        const int iF = up.child1;
+        const int iG = up.child2;
+        const auto &F = _nodes[iF];
+        const auto &G = _nodes[iG];
+
+        // swap A and the node moving up
+        up.child1 = iA;
+        up.parent = A.parent;
+        A.parent = iUp;
+
+        if (up.parent != NULL_NODE) {
+            if (_nodes[up.parent].child1 == iA) {
+                _nodes[up.parent].child1 = iUp;
+            } else {
+                _nodes[up.parent].child2 = iUp;
+            }
+        } else {
+            _root = iUp;
+        }
+
+        // keep the taller grandchild under the promoted node
+        const bool keepF = F.height > G.height;
+        const int iKeep = keepF ? iF : iG;
+        const int iMove = keepF ? iG : iF;
+        auto &moved = _nodes[iMove];
+        up.child2 = iKeep;
+        if (upIsChild2) {
+            A.child2 = iMove;
+        } else {
+            A.child1 = iMove;
+        }
+        moved.parent = iA;
+        A.bounds = combine(side.bounds, moved.bounds);
+        up.bounds = combine(A.bounds, _nodes[iKeep].bounds);
+        A.height = 1 + std::max(side.height, moved.height);
+        up.height = 1 + std::max(A.height, _nodes[iKeep].height);
+        return iUp;
+    };
+
+    // rotate C up
+    if (heightDiff > 1) return rotate(iC, C, B, true);
+    // rotate B up
+    if (heightDiff < -1) return rotate(iB, B, C, false);
+    return iA;
+}
+
+template <typename Fn>
+void ModelBVH::query(vector<const ModelView *> &out, bool includeUnbounded, const Fn &overlaps) {
+    _hits.clear();
+    _stack.clear();
+    if (_root != NULL_NODE) _stack.emplace_back(_root);
+
+    while (!_stack.empty()) {
+        const auto &node = _nodes[_stack.back()];
+        _stack.pop_back();
+        if (!overlaps(&node.bounds)) continue;
+
+        if (node.isLeaf()) {
+            // the leaf bounds are enlarged, test the exact world bounds as well
+            const auto model = _proxies[node.proxy].model;
+            if (model->worldBoundsID && overlaps(model->getWorldBounds())) {
+                _hits.emplace_back(node.proxy);
+            }
+        } else {
+            _stack.emplace_back(node.child1);
+            _stack.emplace_back(node.child2);
+        }
+    }
+
+    if (includeUnbounded) _hits.insert(_hits.end(), _unbounded.begin(), _unbounded.end());
+    std::sort(_hits.begin(), _hits.end());
+
+    for (const auto proxy : _hits) {
+        out.emplace_back(_proxies[proxy].model);
+    }
+}
+
+void ModelBVH::queryFrustum(const Frustum *frustum, vector<const ModelView *> &out) {
+    query(out, true, [frustum](const AABB *aabb) { return aabb_frustum(aabb, frustum); });
+}
+
+void ModelBVH::querySphere(const Sphere *sphere, vector<const ModelView *> &out) {
+    query(out, false, [sphere](const AABB *aabb) { return sphere_aabb(sphere, aabb); });
+}
+
+void ModelBVH::queryAABB(const AABB *aabb, vector<const ModelView *> &out) {
+    query(out, false, [aabb](const AABB *bounds) { return aabb_aabb(bounds, aabb); });
+}
+
+} // namespace pipeline
+} // namespace cc
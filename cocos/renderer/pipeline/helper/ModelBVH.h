@@ -0,0 +1,105 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include "../../core/CoreStd.h"
+#include "SharedMemory.h"
+
+namespace cc {
+namespace pipeline {
+
+// Dynamic AABB tree over the world bounds of the models in one scene.
+// Leaves store slightly enlarged bounds, so a moving model only has to be
+// re-inserted once it leaves its enlarged box. Models are only re-checked when
+// their node reports `flagsChanged`. All queries return models in scene order,
+// i.e. the same order a linear scan over `Scene::getModels()` would produce.
+class CC_DLL ModelBVH final : public Object {
+public:
+    ModelBVH() = default;
+    ~ModelBVH() = default;
+
+    // Synchronizes the tree with the model list and transforms of `scene`.
+    void update(const Scene *scene);
+    void clear();
+
+    // Models whose world bounds intersect the frustum. Models without world bounds are always included.
+    void queryFrustum(const Frustum *frustum, vector<const ModelView *> &out);
+    // Models whose world bounds intersect the sphere.
+    void querySphere(const Sphere *sphere, vector<const ModelView *> &out);
+    // Models whose world bounds intersect the AABB.
+    void queryAABB(const AABB *aabb, vector<const ModelView *> &out);
+
+    CC_INLINE uint getModelCount() const { return static_cast<uint>(_proxies.size()); }
+    CC_INLINE uint getReinsertCount() const { return _reinsertCount; }
+
+private:
+    static constexpr int NULL_NODE = -1;
+
+    struct TreeNode {
+        AABB bounds;
+        int parent = NULL_NODE; // also the free list link
+        int child1 = NULL_NODE;
+        int child2 = NULL_NODE;
+        int height = -1; // 0 for leaves, -1 for free nodes
+        uint proxy = 0;
+
+        CC_INLINE bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    struct Proxy {
+        uint modelID = 0;
+        uint worldBoundsID = 0;
+        uint order = 0; // index in the scene model array
+        int leaf = NULL_NODE;
+        const ModelView *model = nullptr;
+        const Node *node = nullptr;
+        const Node *transform = nullptr;
+    };
+
+    void rebuildProxies(const Scene *scene, const uint *models);
+    void refreshProxy(Proxy &proxy);
+
+    int allocateNode();
+    void freeNode(int nodeID);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int nodeID);
+
+    template <typename Fn>
+    void query(vector<const ModelView *> &out, bool includeUnbounded, const Fn &overlaps);
+
+    vector<TreeNode> _nodes;
+    int _root = NULL_NODE;
+    int _freeList = NULL_NODE;
+
+    vector<Proxy> _proxies;
+    vector<uint> _modelIDs; // snapshot of the scene model array, used to detect membership changes
+    vector<uint> _unbounded;
+    vector<int> _stack;
+    vector<uint> _hits;
+    uint _reinsertCount = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,92 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "RenderPassSorter.h"
+
+namespace cc {
+namespace pipeline {
+
+namespace {
+// Maps a float to an unsigned integer with the same ordering.
+CC_INLINE uint sortableDepth(float depth) {
+    uint bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+CC_INLINE uint64_t packSortKey(const RenderPass &pass, bool backToFront) {
+    uint depth = sortableDepth(pass.depth) >> 8;
+    if (backToFront) depth = ~depth & 0xffffffu;
+    return (static_cast<uint64_t>(pass.hash & 0xffffffu) << 40) |
+           (static_cast<uint64_t>(depth) << 16) |
+           (pass.shaderID & 0xffffu);
+}
+} // namespace
+
+void RenderPassSorter::sort(RenderPassList &passes, RenderQueueSortMode sortMode) {
+    const uint count = static_cast<uint>(passes.size());
+    if (count < 2) return;
+
+    const bool backToFront = sortMode == RenderQueueSortMode::BACK_TO_FRONT;
+    _keys.resize(count);
+    _keysTemp.resize(count);
+    _indices.resize(count);
+    _indicesTemp.resize(count);
+    for (uint i = 0; i < count; ++i) {
+        _keys[i] = packSortKey(passes[i], backToFront);
+        _indices[i] = i;
+    }
+
+    // LSD radix sort over 8-bit digits, skipping digits shared by every key
+    uint histogram[256];
+    for (uint shift = 0; shift < 64; shift += 8) {
+        memset(histogram, 0, sizeof(histogram));
+        for (uint i = 0; i < count; ++i) {
+            ++histogram[(_keys[i] >> shift) & 0xff];
+        }
+        if (histogram[(_keys[0] >> shift) & 0xff] == count) continue;
+
+        uint offset = 0;
+        for (uint &bucket : histogram) {
+            const uint bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (uint i = 0; i < count; ++i) {
+            const uint dst = histogram[(_keys[i] >> shift) & 0xff]++;
+            _keysTemp[dst] = _keys[i];
+            _indicesTemp[dst] = _indices[i];
+        }
+        _keys.swap(_keysTemp);
+        _indices.swap(_indicesTemp);
+    }
+
+    _sorted.resize(count);
+    for (uint i = 0; i < count; ++i) {
+        _sorted[i] = passes[_indices[i]];
+    }
+    passes.swap(_sorted);
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -95,35 +95,20 @@ class CC_DLL SharedMemory : public Object {
 public:
     template <typename T>
     static T *getBuffer(uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(T::type) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(T::type);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        const se::BufferPool *bufferPool = se::BufferPool::getPool(T::type);
+        return bufferPool ? bufferPool->getTypedObject<T>(index) : nullptr;
     }
 
     template <typename T>
     static T *getBuffer(se::PoolType poolType, uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(poolType) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(poolType);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        const se::BufferPool *bufferPool = se::BufferPool::getPool(poolType);
+        return bufferPool ? bufferPool->getTypedObject<T>(index) : nullptr;
     }
 
     template <typename T, se::PoolType p>
     static T *getObject(uint index) {
-        const auto &poolMap = se::ObjectPool::getPoolMap();
-        if (poolMap.count(p) != 0) {
-            const se::ObjectPool *objectPool = poolMap.at(p);
-            return objectPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        const se::ObjectPool *objectPool = se::ObjectPool::getPool(p);
+        return objectPool ? objectPool->getTypedObject<T>(index) : nullptr;
     }
 
     static uint32_t *getHandleArray(se::PoolType type, uint index) {
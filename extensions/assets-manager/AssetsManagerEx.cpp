@@ -25,10 +25,14 @@
  ****************************************************************************/
 #include "AssetsManagerEx.h"
 #include "base/UTF8.h"
+#include "base/MD5.h"
+#include "base/ThreadPool.h"
 #include "AsyncTaskPool.h"
+#include "DeltaPatcher.h"
 
 #include <stdio.h>
 #include <errno.h>
+#include <thread>
 
 #ifdef MINIZIP_FROM_SYSTEM
     #include <minizip/unzip.h>
@@ -41,15 +45,24 @@ NS_CC_EXT_BEGIN
 #define VERSION_FILENAME       "version.manifest"
 #define TEMP_MANIFEST_FILENAME "project.manifest.temp"
 #define TEMP_PACKAGE_SUFFIX    "_temp"
+#define PATCH_SUFFIX           ".patch"
+#define PATCHED_SUFFIX         ".patched"
 #define MANIFEST_FILENAME      "project.manifest"
 
 #define BUFFER_SIZE  8192
 #define MAX_FILENAME 512
 
 #define DEFAULT_CONNECTION_TIMEOUT 45
+// large assets are fetched as this many parallel ranges where the server allows it
+#define DEFAULT_SEGMENTS_PER_TASK 4
 
 #define SAVE_POINT_INTERVAL 0.1
 
+// downloaded assets are verified and decompressed by up to this many worker threads,
+// each of them can have a few more assets waiting before downloading pauses
+#define MAX_PROCESSING_THREADS      4
+#define PROCESSING_TASKS_PER_THREAD 4
+
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
@@ -75,6 +88,7 @@ void AssetsManagerEx::init(const std::string &manifestUrl, const std::string &st
             static_cast<uint32_t>(_maxConcurrentTask),
             DEFAULT_CONNECTION_TIMEOUT,
             ".tmp"};
+    hints.countOfSegmentsPerTask = DEFAULT_SEGMENTS_PER_TASK;
     _downloader = std::shared_ptr<network::Downloader>(new network::Downloader(hints));
     _downloader->onTaskError = std::bind(&AssetsManagerEx::onError, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
     _downloader->onTaskProgress = [this](const network::DownloadTask &task,
@@ -100,6 +114,8 @@ AssetsManagerEx::~AssetsManagerEx() {
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
+    // processing tasks retain this object, so the workers are idle here
+    CC_SAFE_DELETE(_processingPool);
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
     if (_tempManifest != _localManifest && _tempManifest != _remoteManifest)
@@ -486,38 +502,137 @@ bool AssetsManagerEx::decompress(const std::string &zip) {
     return true;
 }
 
-void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath) {
-    struct AsyncData {
-        std::string customId;
-        std::string zipFile;
-        bool succeed;
-    };
+static bool md5Equals(const std::string &hex, const std::string &md5) {
+    if (hex.size() != md5.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); ++i) {
+        if (hex[i] != tolower(static_cast<unsigned char>(md5[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    AsyncData *asyncData = new AsyncData;
-    asyncData->customId = customId;
-    asyncData->zipFile = storagePath;
-    asyncData->succeed = false;
+static bool verifyFileMD5(const std::string &path, const std::string &md5) {
+    FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    MD5 digest;
+    char buffer[BUFFER_SIZE * 8];
+    size_t size = 0;
+    while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        digest.update(buffer, size);
+    }
+    bool failed = ferror(fp) != 0;
+    fclose(fp);
+    return !failed && md5Equals(digest.hexDigest(), md5);
+}
 
-    std::function<void(void *)> decompressFinished = [this](void *param) {
-        auto dataInner = reinterpret_cast<AsyncData *>(param);
-        if (dataInner->succeed) {
-            fileSuccess(dataInner->customId, dataInner->zipFile);
-        } else {
-            std::string errorMsg = "Unable to decompress file " + dataInner->zipFile;
-            // Ensure zip file deletion (if decompress failure cause task thread exit anormally)
-            _fileUtils->removeFile(dataInner->zipFile);
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
-            fileError(dataInner->customId, errorMsg);
+// Rebuild an asset from its local version, the result only replaces targetPath once its md5 is the expected one
+static bool applyDownloadedPatch(const std::string &basePath, const std::string &baseMd5, const std::string &patchPath,
+                                 const std::string &targetPath, const std::string &md5) {
+    auto fileUtils = FileUtils::getInstance();
+    std::string patchedPath = targetPath + PATCHED_SUFFIX;
+    std::string patchedMd5;
+    bool succeed = verifyFileMD5(basePath, baseMd5) &&
+                   DeltaPatcher::apply(basePath, patchPath, patchedPath, &patchedMd5) &&
+                   md5Equals(patchedMd5, md5);
+    if (succeed) {
+        if (fileUtils->isFileExist(targetPath)) {
+            fileUtils->removeFile(targetPath);
         }
-        delete dataInner;
+        succeed = fileUtils->renameFile(patchedPath, targetPath);
+    }
+    if (!succeed) {
+        fileUtils->removeFile(patchedPath);
+    }
+    fileUtils->removeFile(patchPath);
+    return succeed;
+}
+
+void AssetsManagerEx::processDownloadedAsset(const std::string &customId, const std::string &storagePath) {
+    auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (assetIt == assets.end()) {
+        fileSuccess(customId, storagePath);
+        return;
+    }
+    const Manifest::Asset &asset = assetIt->second;
+
+    // A downloaded patch always has its result checked against the manifest md5
+    auto patchIt = _patchUnits.find(customId);
+    bool patched = patchIt != _patchUnits.end();
+    PatchUnit patch = patched ? patchIt->second : PatchUnit();
+
+    // Assets are verified natively unless a verify callback is set and native verification wasn't forced,
+    // the verify callback may call into script, so it stays in the main thread
+    bool nativeVerify = _nativeVerifyEnabled || _verifyCallback == nullptr;
+    if (!patched && !nativeVerify && !_verifyCallback(storagePath, asset)) {
+        fileError(customId, "Asset file verification failed after downloaded");
+        return;
+    }
+
+    std::string md5 = nativeVerify || patched ? asset.md5 : "";
+    bool compressed = asset.compressed;
+    if (md5.empty() && !compressed) {
+        fileSuccess(customId, storagePath);
+        return;
+    }
+
+    if (!_processingPool) {
+        int threadNum = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        threadNum = std::max(1, std::min(MAX_PROCESSING_THREADS, threadNum));
+        _processingPool = ThreadPool::newFixedThreadPool(threadNum);
+        _maxProcessingTask = threadNum * PROCESSING_TASKS_PER_THREAD;
+    }
+
+    enum class Result {
+        SUCCEED,
+        VERIFY_FAILED,
+        PATCH_FAILED,
+        DECOMPRESS_FAILED
     };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, (void *)asyncData, [this, asyncData]() {
-        // Decompress all compressed files
-        if (decompress(asyncData->zipFile)) {
-            asyncData->succeed = true;
+
+    _currProcessingTask++;
+    // Released once the result is handled in the main thread
+    retain();
+    _processingPool->pushTask([this, customId, storagePath, md5, compressed, patched, patch](int /*threadId*/) {
+        Result result = Result::SUCCEED;
+        std::string assetPath = storagePath;
+        if (patched) {
+            assetPath = patch.targetPath;
+            if (!applyDownloadedPatch(patch.basePath, patch.baseMd5, storagePath, assetPath, md5)) {
+                result = Result::PATCH_FAILED;
+            }
+        } else if (!md5.empty() && !verifyFileMD5(storagePath, md5)) {
+            result = Result::VERIFY_FAILED;
+        }
+        if (result == Result::SUCCEED && compressed) {
+            if (!decompress(assetPath)) {
+                result = Result::DECOMPRESS_FAILED;
+            }
+            _fileUtils->removeFile(assetPath);
         }
-        _fileUtils->removeFile(asyncData->zipFile);
+
+        Application::getInstance()->getScheduler()->performFunctionInCocosThread([this, customId, assetPath, result]() {
+            _currProcessingTask--;
+            if (result == Result::SUCCEED) {
+                fileSuccess(customId, assetPath);
+            } else if (result == Result::PATCH_FAILED) {
+                fallbackToFullDownload(customId);
+            } else if (result == Result::VERIFY_FAILED) {
+                fileError(customId, "Asset file verification failed after downloaded");
+            } else {
+                std::string errorMsg = "Unable to decompress file " + assetPath;
+                dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
+                fileError(customId, errorMsg);
+            }
+            release();
+        });
     });
+    queueDowload();
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId /* = ""*/, const std::string &message /* = ""*/, int curle_code /* = CURLE_OK*/, int curlm_code /* = CURLM_OK*/) {
@@ -652,6 +767,7 @@ void AssetsManagerEx::prepareUpdate() {
     // Clean up before update
     _failedUnits.clear();
     _downloadUnits.clear();
+    _patchUnits.clear();
     _totalWaitToDownload = _totalToDownload = 0;
     _nextSavePoint = 0;
     _percent = _percentByFile = _sizeCollected = _totalDownloaded = _totalSize = 0;
@@ -706,6 +822,9 @@ void AssetsManagerEx::prepareUpdate() {
                     unit.srcUrl = packageUrl + path + "?md5=" + diff.asset.md5;
                     unit.storagePath = _tempStoragePath + path;
                     unit.size = diff.asset.size;
+                    if (diff.type == Manifest::DiffType::MODIFIED) {
+                        preparePatchUnit(unit, diff.asset);
+                    }
                     _downloadUnits.emplace(unit.customId, unit);
                     _tempManifest->setAssetDownloadState(it->first, Manifest::DownloadState::UNSTARTED);
                     _totalSize += unit.size;
@@ -913,6 +1032,7 @@ void AssetsManagerEx::updateAssets(const DownloadUnits &assets) {
     if (_updateState != State::UPDATING && _localManifest->isLoaded() && _remoteManifest->isLoaded()) {
         _updateState = State::UPDATING;
         _downloadUnits.clear();
+        _patchUnits.clear();
         _downloadedSize.clear();
         _percent = _percentByFile = _sizeCollected = _totalDownloaded = _totalSize = 0;
         _totalWaitToDownload = _totalToDownload = (int)assets.size();
@@ -948,7 +1068,6 @@ void AssetsManagerEx::fileError(const std::string &identifier, const std::string
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_UPDATING, identifier, errorStr, errorCode, errorCodeInternal);
     _tempManifest->setAssetDownloadState(identifier, Manifest::DownloadState::UNSTARTED);
 
-    _currConcurrentTask = std::max(0, _currConcurrentTask - 1);
     queueDowload();
 }
 
@@ -975,7 +1094,6 @@ void AssetsManagerEx::fileSuccess(const std::string &customId, const std::string
     // Notify asset updated event
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ASSET_UPDATED, customId);
 
-    _currConcurrentTask = std::max(0, _currConcurrentTask - 1);
     queueDowload();
 }
 
@@ -992,7 +1110,12 @@ void AssetsManagerEx::onError(const network::DownloadTask &task,
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DOWNLOAD_MANIFEST, task.identifier, errorStr, errorCode, errorCodeInternal);
         _updateState = State::FAIL_TO_UPDATE;
     } else {
-        fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
+        _currConcurrentTask = std::max(0, _currConcurrentTask - 1);
+        if (_patchUnits.find(task.identifier) != _patchUnits.end()) {
+            fallbackToFullDownload(task.identifier);
+        } else {
+            fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
+        }
     }
 }
 
@@ -1050,26 +1173,10 @@ void AssetsManagerEx::onSuccess(const std::string & /*srcUrl*/, const std::strin
         _updateState = State::MANIFEST_LOADED;
         parseManifest();
     } else {
-        bool ok = true;
-        auto &assets = _remoteManifest->getAssets();
-        auto assetIt = assets.find(customId);
-        if (assetIt != assets.end()) {
-            Manifest::Asset asset = assetIt->second;
-            if (_verifyCallback != nullptr) {
-                ok = _verifyCallback(storagePath, asset);
-            }
-        }
-
-        if (ok) {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed) {
-                decompressDownloadedZip(customId, storagePath);
-            } else {
-                fileSuccess(customId, storagePath);
-            }
-        } else {
-            fileError(customId, "Asset file verification failed after downloaded");
-        }
+        // The download slot is free as soon as the file landed, the next download
+        // starts while this one is verified and decompressed
+        _currConcurrentTask = std::max(0, _currConcurrentTask - 1);
+        processDownloadedAsset(customId, storagePath);
     }
 }
 
@@ -1078,6 +1185,64 @@ void AssetsManagerEx::destroyDownloadedVersion() {
     _fileUtils->removeDirectory(_tempStoragePath);
 }
 
+bool AssetsManagerEx::preparePatchUnit(DownloadUnit &unit, const Manifest::Asset &asset) {
+    auto localIt = _assets->find(unit.customId);
+    if (asset.patches.empty() || localIt == _assets->end() || localIt->second.md5.empty()) {
+        return false;
+    }
+    const Manifest::Asset &localAsset = localIt->second;
+    for (const auto &patch : asset.patches) {
+        if (!md5Equals(patch.base, localAsset.md5)) {
+            continue;
+        }
+        // The local version is only read when the patch is applied, a missing or different file falls back to a full download
+        std::string basePath = _fileUtils->fullPathForFilename(_localManifest->getManifestRoot() + localAsset.path);
+        if (basePath.empty()) {
+            return false;
+        }
+        // DeltaPatcher streams the base with fopen, which can't read files packed in the apk,
+        // only bases on the writable file system are patched
+        const std::string writablePath = _fileUtils->getWritablePath();
+        if (basePath.compare(0, _storagePath.size(), _storagePath) != 0 &&
+            (writablePath.empty() || basePath.compare(0, writablePath.size(), writablePath) != 0)) {
+            return false;
+        }
+
+        PatchUnit patchUnit;
+        patchUnit.basePath = basePath;
+        patchUnit.baseMd5 = localAsset.md5;
+        patchUnit.targetPath = unit.storagePath;
+        patchUnit.fullUnit = unit;
+        _patchUnits.emplace(unit.customId, patchUnit);
+
+        unit.srcUrl = _remoteManifest->getPackageUrl() + patch.path + "?md5=" + asset.md5;
+        unit.storagePath += PATCH_SUFFIX;
+        unit.size = patch.size;
+        return true;
+    }
+    return false;
+}
+
+void AssetsManagerEx::fallbackToFullDownload(const std::string &customId) {
+    auto patchIt = _patchUnits.find(customId);
+    auto unitIt = _downloadUnits.find(customId);
+    if (patchIt == _patchUnits.end() || unitIt == _downloadUnits.end()) {
+        fileError(customId, "Asset patch failed");
+        return;
+    }
+    CC_LOG_DEBUG("AssetsManagerEx : fail to patch %s, download it in full\n", customId.c_str());
+
+    DownloadUnit &unit = unitIt->second;
+    if (unit.size > 0 && patchIt->second.fullUnit.size > 0) {
+        _totalSize += patchIt->second.fullUnit.size - unit.size;
+    }
+    unit = patchIt->second.fullUnit;
+    _patchUnits.erase(patchIt);
+
+    _queue.push_back(customId);
+    queueDowload();
+}
+
 void AssetsManagerEx::batchDownload() {
     _queue.clear();
     for (auto iter : _downloadUnits) {
@@ -1103,7 +1268,8 @@ void AssetsManagerEx::queueDowload() {
         return;
     }
 
-    while (_currConcurrentTask < _maxConcurrentTask && _queue.size() > 0) {
+    // Downloading waits while the processing of downloaded assets can't keep up
+    while (_currConcurrentTask < _maxConcurrentTask && (_maxProcessingTask == 0 || _currProcessingTask < _maxProcessingTask) && _queue.size() > 0) {
         std::string key = _queue.back();
         _queue.pop_back();
 
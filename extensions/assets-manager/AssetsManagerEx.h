@@ -41,6 +41,10 @@
 #include "extensions/ExtensionExport.h"
 #include "json/document-wrapper.h"
 
+namespace cc {
+class ThreadPool;
+}
+
 NS_CC_EXT_BEGIN
 
 /**
@@ -206,6 +210,21 @@ public:
         _verifyCallback = callback;
     };
 
+    /** @brief Force the native md5 verification of downloaded assets even if a verify callback is set.
+     * Assets are checked against the md5 of the remote manifest on worker threads whenever no verify callback is set,
+     * when enabled the verify callback isn't called either.
+     * @param enabled  Whether to verify natively
+     */
+    void setNativeVerifyEnabled(bool enabled) {
+        _nativeVerifyEnabled = enabled;
+    };
+
+    /** @brief Gets whether downloaded assets are verified natively
+     */
+    bool isNativeVerifyEnabled() const {
+        return _nativeVerifyEnabled;
+    };
+
     /** @brief Set the event callback for receiving update process events
      * @param callback  The event callback function
      */
@@ -237,7 +256,10 @@ protected:
     void startUpdate();
     void updateSucceed();
     bool decompress(const std::string &filename);
-    void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
+
+    /** @brief Verify and decompress a downloaded asset on a worker thread, the result is reported in the main thread
+     */
+    void processDownloadedAsset(const std::string &customId, const std::string &storagePath);
 
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -294,8 +316,23 @@ protected:
     virtual void onSuccess(const std::string &srcUrl, const std::string &storagePath, const std::string &customId);
 
 private:
+    //! A modified asset downloaded as a patch against its local version
+    struct PatchUnit {
+        std::string basePath;
+        std::string baseMd5;
+        std::string targetPath;
+        //! Used when the patch can't be downloaded or applied
+        DownloadUnit fullUnit;
+    };
+
     void batchDownload();
 
+    // Turn the download unit of a modified asset into a patch download if the manifest has a patch for the local version
+    bool preparePatchUnit(DownloadUnit &unit, const Manifest::Asset &asset);
+
+    // Download the asset in full after its patch failed
+    void fallbackToFullDownload(const std::string &customId);
+
     // Called when one DownloadUnits finished
     void onDownloadUnitsFinished();
 
@@ -358,6 +395,9 @@ private:
     //! All failed units
     DownloadUnits _failedUnits;
 
+    //! Units of the current update downloaded as patches
+    std::unordered_map<std::string, PatchUnit> _patchUnits;
+
     //! Download queue
     std::vector<std::string> _queue;
 
@@ -369,6 +409,15 @@ private:
     //! Current concurrent task count
     int _currConcurrentTask = 0;
 
+    //! Worker threads verifying and decompressing downloaded assets
+    ThreadPool *_processingPool = nullptr;
+
+    //! Max count of downloaded assets waiting for or being processed, downloading pauses when it's reached
+    int _maxProcessingTask = 0;
+
+    //! Current count of downloaded assets waiting for or being processed
+    int _currProcessingTask = 0;
+
     //! Download percent
     float _percent = 0.f;
 
@@ -403,6 +452,9 @@ private:
     //! Callback function to verify the downloaded assets
     VerifyCallback _verifyCallback = nullptr;
 
+    //! Whether downloaded assets are verified with md5 natively even if the verify callback is set
+    bool _nativeVerifyEnabled = false;
+
     //! Callback function to dispatch events
     EventCallback _eventCallback = nullptr;
 
@@ -0,0 +1,220 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DeltaPatcher.h"
+#include "base/Log.h"
+#include "base/MD5.h"
+#include "platform/FileUtils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <zlib.h>
+
+#define PATCH_MAGIC       "CCDIFF01"
+#define PATCH_MAGIC_SIZE  8
+#define PATCH_BUFFER_SIZE 65536
+
+NS_CC_EXT_BEGIN
+
+namespace {
+
+enum PatchCommand {
+    END = 0,
+    COPY = 1,
+    ADD = 2,
+    INSERT = 3
+};
+
+// buffered reads from the patch, zlib reads plain files as they are
+class PatchReader {
+public:
+    explicit PatchReader(gzFile file)
+    : _file(file),
+      _buffer(PATCH_BUFFER_SIZE) {}
+
+    bool read(uint8_t *dst, size_t size) {
+        while (size) {
+            if (_pos == _end) {
+                int got = gzread(_file, _buffer.data(), static_cast<unsigned>(_buffer.size()));
+                if (got <= 0) {
+                    return false;
+                }
+                _pos = 0;
+                _end = static_cast<size_t>(got);
+            }
+            size_t n = std::min(size, _end - _pos);
+            memcpy(dst, _buffer.data() + _pos, n);
+            _pos += n;
+            dst += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool readVarint(uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = 0;
+            if (!read(&byte, 1)) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    gzFile _file;
+    std::vector<uint8_t> _buffer;
+    size_t _pos = 0;
+    size_t _end = 0;
+};
+
+bool applyPatch(FILE *baseFile, uint64_t baseSize, PatchReader &patch, FILE *outFile, std::string *outMD5) {
+    uint8_t magic[PATCH_MAGIC_SIZE];
+    if (!patch.read(magic, PATCH_MAGIC_SIZE) || memcmp(magic, PATCH_MAGIC, PATCH_MAGIC_SIZE) != 0) {
+        CC_LOG_DEBUG("DeltaPatcher : unknown patch format\n");
+        return false;
+    }
+    uint64_t targetSize = 0;
+    if (!patch.readVarint(targetSize)) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(PATCH_BUFFER_SIZE);
+    std::vector<uint8_t> base(PATCH_BUFFER_SIZE);
+    MD5 digest;
+    uint64_t written = 0;
+    for (;;) {
+        uint64_t command = END;
+        if (!patch.readVarint(command)) {
+            return false;
+        }
+        if (command == END) {
+            break;
+        }
+
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        bool fromBase = command == COPY || command == ADD;
+        if ((!fromBase && command != INSERT) ||
+            (fromBase && !patch.readVarint(offset)) ||
+            !patch.readVarint(length)) {
+            return false;
+        }
+        // never write past the announced size or read past the base
+        if (length > targetSize - written ||
+            (fromBase && (offset > baseSize || length > baseSize - offset))) {
+            CC_LOG_DEBUG("DeltaPatcher : patch command out of range\n");
+            return false;
+        }
+        if (fromBase && fseek(baseFile, static_cast<long>(offset), SEEK_SET) != 0) {
+            return false;
+        }
+
+        while (length) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(length, PATCH_BUFFER_SIZE));
+            if (fromBase && fread(base.data(), 1, n, baseFile) != n) {
+                return false;
+            }
+            if (command != COPY && !patch.read(data.data(), n)) {
+                return false;
+            }
+
+            const uint8_t *chunk = data.data();
+            if (command == COPY) {
+                chunk = base.data();
+            } else if (command == ADD) {
+                for (size_t i = 0; i < n; ++i) {
+                    data[i] = static_cast<uint8_t>(data[i] + base[i]);
+                }
+            }
+            if (fwrite(chunk, 1, n, outFile) != n) {
+                return false;
+            }
+            digest.update(chunk, n);
+            length -= n;
+            written += n;
+        }
+    }
+
+    if (written != targetSize || fflush(outFile) != 0) {
+        return false;
+    }
+    *outMD5 = digest.hexDigest();
+    return true;
+}
+
+} // namespace
+
+bool DeltaPatcher::apply(const std::string &basePath, const std::string &patchPath, const std::string &outPath, std::string *outMD5) {
+    auto fileUtils = FileUtils::getInstance();
+    FILE *baseFile = fopen(fileUtils->getSuitableFOpen(basePath).c_str(), "rb");
+    if (!baseFile) {
+        CC_LOG_DEBUG("DeltaPatcher : can not open base file %s\n", basePath.c_str());
+        return false;
+    }
+    gzFile patchFile = gzopen(fileUtils->getSuitableFOpen(patchPath).c_str(), "rb");
+    if (!patchFile) {
+        CC_LOG_DEBUG("DeltaPatcher : can not open patch file %s\n", patchPath.c_str());
+        fclose(baseFile);
+        return false;
+    }
+    FILE *outFile = fopen(fileUtils->getSuitableFOpen(outPath).c_str(), "wb");
+    if (!outFile) {
+        CC_LOG_DEBUG("DeltaPatcher : can not create file %s\n", outPath.c_str());
+        gzclose(patchFile);
+        fclose(baseFile);
+        return false;
+    }
+
+    bool succeed = false;
+    long baseSize = -1;
+    if (fseek(baseFile, 0, SEEK_END) == 0) {
+        baseSize = ftell(baseFile);
+    }
+    if (baseSize >= 0) {
+        PatchReader reader(patchFile);
+        succeed = applyPatch(baseFile, static_cast<uint64_t>(baseSize), reader, outFile, outMD5);
+    }
+
+    if (fclose(outFile) != 0) {
+        succeed = false;
+    }
+    gzclose(patchFile);
+    fclose(baseFile);
+    if (!succeed) {
+        CC_LOG_DEBUG("DeltaPatcher : fail to apply %s on %s\n", patchPath.c_str(), basePath.c_str());
+        fileUtils->removeFile(outPath);
+    }
+    return succeed;
+}
+
+NS_CC_EXT_END
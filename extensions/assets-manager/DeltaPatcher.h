@@ -0,0 +1,66 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __DeltaPatcher__
+#define __DeltaPatcher__
+
+#include <string>
+#include "extensions/ExtensionMacros.h"
+#include "extensions/ExtensionExport.h"
+
+NS_CC_EXT_BEGIN
+
+/**
+ * @brief Applies binary delta patches of hot update assets.
+ *
+ * A patch rebuilds the new version of a file from the old one, all integers are
+ * unsigned LEB128 varints:
+ *
+ *     "CCDIFF01"                        magic
+ *     targetSize                        size of the rebuilt file
+ *     commands until END:
+ *       0                               END
+ *       1 offset length                 COPY length bytes of the base from offset
+ *       2 offset length bytes[length]   ADD bytes to the base bytes from offset, byte wise modulo 256
+ *       3 length bytes[length]          INSERT literal bytes
+ *
+ * ADD is the bsdiff way of coping with shifted pointers and offsets, its bytes are
+ * mostly zero, so patches are usually gzip compressed as a whole. Both plain and
+ * gzip compressed patches are accepted. tools/delta-patch/make_patch.py creates them.
+ */
+class CC_EX_DLL DeltaPatcher {
+public:
+    /** @brief Stream a patch over the base file into a new file, nothing is loaded in memory as a whole.
+     * @param basePath   The file the patch was created against
+     * @param patchPath  The patch file
+     * @param outPath    The rebuilt file, it's removed if patching fails
+     * @param outMD5     Receives the md5 of the rebuilt file in lower case hex
+     * @return Whether the patch is well formed and was applied completely
+     */
+    static bool apply(const std::string &basePath, const std::string &patchPath, const std::string &outPath, std::string *outMD5);
+};
+
+NS_CC_EXT_END
+
+#endif /* defined(__DeltaPatcher__) */
@@ -50,6 +50,8 @@
 #define KEY_SIZE            "size"
 #define KEY_COMPRESSED_FILE "compressedFile"
 #define KEY_DOWNLOAD_STATE  "downloadState"
+#define KEY_PATCHES         "patches"
+#define KEY_PATCH_BASE      "base"
 
 NS_CC_EXT_BEGIN
 
@@ -439,6 +441,27 @@ Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::V
     } else
         asset.downloadState = DownloadState::UNMARKED;
 
+    // Patches from older versions, a patch needs both its base md5 and its path
+    if (json.HasMember(KEY_PATCHES) && json[KEY_PATCHES].IsArray()) {
+        const rapidjson::Value &patches = json[KEY_PATCHES];
+        for (rapidjson::SizeType i = 0; i < patches.Size(); ++i) {
+            const rapidjson::Value &entry = patches[i];
+            if (!entry.IsObject() ||
+                !entry.HasMember(KEY_PATCH_BASE) || !entry[KEY_PATCH_BASE].IsString() ||
+                !entry.HasMember(KEY_PATH) || !entry[KEY_PATH].IsString()) {
+                continue;
+            }
+            Patch patch;
+            patch.base = entry[KEY_PATCH_BASE].GetString();
+            patch.path = entry[KEY_PATH].GetString();
+            if (entry.HasMember(KEY_SIZE) && entry[KEY_SIZE].IsInt()) {
+                patch.size = entry[KEY_SIZE].GetInt();
+            } else
+                patch.size = 0;
+            asset.patches.push_back(patch);
+        }
+    }
+
     return asset;
 }
 
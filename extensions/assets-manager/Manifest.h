@@ -48,12 +48,20 @@ struct DownloadUnit {
     float size;
 };
 
+//! A binary delta rebuilding an asset from the version whose md5 is base, see DeltaPatcher
+struct ManifestPatch {
+    std::string base;
+    std::string path;
+    float size;
+};
+
 struct ManifestAsset {
     std::string md5;
     std::string path;
     bool compressed;
     float size;
     int downloadState;
+    std::vector<ManifestPatch> patches;
 };
 
 typedef std::unordered_map<std::string, DownloadUnit> DownloadUnits;
@@ -79,6 +87,9 @@ public:
     //! Asset object
     typedef ManifestAsset Asset;
 
+    //! Patch of an asset
+    typedef ManifestPatch Patch;
+
     //! Object indicate the difference between two Assets
     struct AssetDiff {
         Asset asset;
@@ -0,0 +1,205 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// gfx::CommandStream decoding against calling the command buffer directly.
+//
+// Every draw binds a pipeline state, a descriptor set with one dynamic offset and an input
+// assembler, then draws. The direct path makes the same virtual calls from pre-resolved
+// pointers, which is what the per-call bindings end up doing once past the script boundary,
+// so the difference is the decoding and validation cost of the stream. Both paths record into
+// a command buffer that stores the commands, and the recorded commands must match.
+//
+//   command_stream_benchmark [maxDraws] [objectCount]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "renderer/core/CoreStd.h"
+
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXCommandStream.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineState.h"
+
+using namespace cc;
+
+namespace {
+constexpr int RUNS = 51;
+constexpr uint LOCAL_SET = 2;
+
+struct StoredCommand {
+    uint32_t type;
+    uint32_t arg;
+    const void *object;
+
+    bool operator==(const StoredCommand &rhs) const { return type == rhs.type && arg == rhs.arg && object == rhs.object; }
+};
+
+class StoringCommandBuffer final : public gfx::CommandBuffer {
+public:
+    StoringCommandBuffer() : CommandBuffer(nullptr) {}
+    using CommandBuffer::begin;
+
+    bool initialize(const gfx::CommandBufferInfo & /*info*/) override { return true; }
+    void destroy() override {}
+    void begin(gfx::RenderPass * /*renderPass*/, uint /*subpass*/, gfx::Framebuffer * /*frameBuffer*/, int /*submitIndex*/) override {
+        _commands.clear();
+    }
+    void end() override {}
+    void beginRenderPass(gfx::RenderPass * /*renderPass*/, gfx::Framebuffer * /*fbo*/, const gfx::Rect & /*renderArea*/, const gfx::Color * /*colors*/,
+                         float /*depth*/, int /*stencil*/, bool /*fromSecondaryCB*/) override {}
+    void endRenderPass() override {}
+    void bindPipelineState(gfx::PipelineState *pso) override { _commands.push_back({1, 0, pso}); }
+    void bindDescriptorSet(uint set, gfx::DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override {
+        _commands.push_back({2, set ^ (dynamicOffsetCount ? dynamicOffsets[0] << 8 : 0), descriptorSet});
+    }
+    void bindInputAssembler(gfx::InputAssembler *ia) override { _commands.push_back({3, 0, ia}); }
+    void setViewport(const gfx::Viewport &vp) override { _commands.push_back({4, vp.width, nullptr}); }
+    void setScissor(const gfx::Rect &rect) override { _commands.push_back({5, rect.width, nullptr}); }
+    void setLineWidth(float /*width*/) override {}
+    void setDepthBias(float /*constant*/, float /*clamp*/, float /*slope*/) override {}
+    void setBlendConstants(const gfx::Color & /*constants*/) override {}
+    void setDepthBound(float /*minBounds*/, float /*maxBounds*/) override {}
+    void setStencilWriteMask(gfx::StencilFace /*face*/, uint /*mask*/) override {}
+    void setStencilCompareMask(gfx::StencilFace /*face*/, int /*ref*/, uint /*mask*/) override {}
+    void draw(gfx::InputAssembler *ia) override { _commands.push_back({6, 0, ia}); }
+    void updateBuffer(gfx::Buffer * /*buff*/, const void * /*data*/, uint /*size*/) override {}
+    void copyBuffersToTexture(const uint8_t *const * /*buffers*/, gfx::Texture * /*texture*/, const gfx::BufferTextureCopy * /*regions*/, uint /*count*/) override {}
+    void execute(const CommandBuffer *const * /*cmdBuffs*/, uint32_t /*count*/) override {}
+
+    CC_INLINE const std::vector<StoredCommand> &getCommands() const { return _commands; }
+
+private:
+    std::vector<StoredCommand> _commands;
+};
+
+// objects only need a type for the stream to resolve them
+class StubPipelineState final : public gfx::PipelineState {
+public:
+    StubPipelineState() : PipelineState(nullptr) {}
+    bool initialize(const gfx::PipelineStateInfo & /*info*/) override { return true; }
+    void destroy() override {}
+};
+
+class StubDescriptorSet final : public gfx::DescriptorSet {
+public:
+    StubDescriptorSet() : DescriptorSet(nullptr) {}
+    bool initialize(const gfx::DescriptorSetInfo & /*info*/) override { return true; }
+    void destroy() override {}
+    void update() override {}
+};
+
+class StubInputAssembler final : public gfx::InputAssembler {
+public:
+    StubInputAssembler() : InputAssembler(nullptr) {}
+    bool initialize(const gfx::InputAssemblerInfo & /*info*/) override { return true; }
+    void destroy() override {}
+};
+
+struct Draw {
+    uint pso;
+    uint descriptorSet;
+    uint ia;
+    uint dynamicOffset;
+};
+
+template <typename Fn>
+double medianNsPerDraw(uint drawCount, const Fn &fn) {
+    std::vector<double> times;
+    for (int run = 0; run < RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / drawCount);
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint maxDraws = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 16384;
+    const uint objectCount = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 256;
+
+    // the object table holds every kind, the same way script passes one array along
+    std::vector<StubPipelineState> psos(objectCount);
+    std::vector<StubDescriptorSet> descriptorSets(objectCount);
+    std::vector<StubInputAssembler> ias(objectCount);
+    std::vector<gfx::GFXObject *> objects;
+    for (uint i = 0; i < objectCount; ++i) {
+        objects.push_back(&psos[i]);
+        objects.push_back(&descriptorSets[i]);
+        objects.push_back(&ias[i]);
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint> object(0, objectCount - 1);
+    std::uniform_int_distribution<uint> offset(0, 255);
+
+    StoringCommandBuffer direct;
+    StoringCommandBuffer streamed;
+    bool allMatch = true;
+
+    printf("%u objects of each kind, median of %d runs, ns per draw\n", objectCount, RUNS);
+    printf("%8s %8s %8s %8s %6s\n", "draws", "direct", "stream", "ratio", "match");
+
+    for (uint drawCount = 256; drawCount <= maxDraws; drawCount *= 4) {
+        std::vector<Draw> draws(drawCount);
+        std::vector<uint> words;
+        for (auto &draw : draws) {
+            draw = {object(rng), object(rng), object(rng), offset(rng) * 256};
+            words.insert(words.end(), {static_cast<uint>(gfx::CommandStreamOp::BIND_PIPELINE_STATE), draw.pso * 3});
+            words.insert(words.end(), {static_cast<uint>(gfx::CommandStreamOp::BIND_DESCRIPTOR_SET), LOCAL_SET, draw.descriptorSet * 3 + 1, 1, draw.dynamicOffset});
+            words.insert(words.end(), {static_cast<uint>(gfx::CommandStreamOp::BIND_INPUT_ASSEMBLER), draw.ia * 3 + 2});
+            words.insert(words.end(), {static_cast<uint>(gfx::CommandStreamOp::DRAW), draw.ia * 3 + 2});
+        }
+
+        const double directTime = medianNsPerDraw(drawCount, [&]() {
+            direct.begin();
+            for (const auto &draw : draws) {
+                direct.bindPipelineState(&psos[draw.pso]);
+                direct.bindDescriptorSet(LOCAL_SET, &descriptorSets[draw.descriptorSet], 1, &draw.dynamicOffset);
+                direct.bindInputAssembler(&ias[draw.ia]);
+                direct.draw(&ias[draw.ia]);
+            }
+            direct.end();
+        });
+
+        bool ok = true;
+        const double streamTime = medianNsPerDraw(drawCount, [&]() {
+            streamed.begin();
+            ok &= gfx::CommandStream::execute(&streamed, words.data(), static_cast<uint>(words.size()), objects.data(), static_cast<uint>(objects.size()));
+            streamed.end();
+        });
+
+        const bool match = ok && direct.getCommands() == streamed.getCommands();
+        allMatch &= match;
+        printf("%8u %8.1f %8.1f %7.2fx %6s\n", drawCount, directTime, streamTime, streamTime / directTime, match ? "yes" : "NO");
+    }
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Wall time of a batch of HttpClient requests against a loopback server by the number of
+// transfers the client runs at once.
+//
+// The server answers every request after a fixed delay, standing in for network latency.
+// One concurrent request is what the client did before it moved onto a curl multi handle:
+// a single worker thread running one transfer after the other. All requests go to one
+// host, so above six the default setMaxConnectionsPerHost() limit caps the gain. The match
+// column checks that every callback arrived with the body the server sent for its path.
+//
+//   http_client_benchmark [requestCount] [latencyMs]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+    #define closeSocket closesocket
+#else
+    #include <arpa/inet.h>
+    #include <csignal>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+using SocketHandle = int;
+    #define INVALID_SOCKET (-1)
+    #define closeSocket    close
+#endif
+
+#include "network/HttpClient.h"
+#include "platform/Application.h"
+#include "platform/FileUtils.h"
+
+using cc::network::HttpClient;
+using cc::network::HttpRequest;
+using cc::network::HttpResponse;
+
+// The real Application needs a window, the client only posts its callbacks to the scheduler.
+namespace cc {
+Application *Application::_instance = nullptr;
+std::shared_ptr<Scheduler> Application::_scheduler = nullptr;
+
+Application::Application(int /*width*/, int /*height*/) {
+    Application::_instance = this;
+    _scheduler = std::make_shared<Scheduler>();
+}
+
+Application::~Application() {
+    _scheduler.reset();
+    Application::_instance = nullptr;
+}
+
+bool Application::init() { return true; }
+void Application::onPause() {}
+void Application::onResume() {}
+
+// cookies stay disabled
+FileUtils *FileUtils::getInstance() { return nullptr; }
+} // namespace cc
+
+namespace {
+constexpr int RUNS = 5;
+const int CONCURRENCY[] = {1, 2, 4, 8, 16};
+
+// HTTP/1.1 keep-alive server on 127.0.0.1, one thread per connection, answers every GET
+// with its path after the configured latency.
+class LoopbackServer {
+public:
+    explicit LoopbackServer(int latencyMs) : _latencyMs(latencyMs) {}
+
+    bool start() {
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#else
+        signal(SIGPIPE, SIG_IGN);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET) return false;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+            listen(_listenSocket, 64) != 0 ||
+            getsockname(_listenSocket, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+        _acceptThread = std::thread(&LoopbackServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        _stopping = true;
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _acceptThread.join();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto connection : _connections) shutdown(connection, 2);
+        }
+        for (auto &thread : _connectionThreads) thread.join();
+        for (auto connection : _connections) closeSocket(connection);
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSACleanup();
+#endif
+    }
+
+    std::string url(const std::string &path) const { return "http://127.0.0.1:" + std::to_string(_port) + path; }
+
+private:
+    void acceptLoop() {
+        while (!_stopping) {
+            SocketHandle connection = accept(_listenSocket, nullptr, nullptr);
+            if (connection == INVALID_SOCKET) break;
+            std::lock_guard<std::mutex> lock(_mutex);
+            _connections.push_back(connection);
+            _connectionThreads.emplace_back(&LoopbackServer::serve, this, connection);
+        }
+    }
+
+    void serve(SocketHandle connection) {
+        std::string buffer;
+        char chunk[1024];
+        while (true) {
+            size_t end = buffer.find("\r\n\r\n");
+            while (end == std::string::npos) {
+                int received = static_cast<int>(recv(connection, chunk, sizeof(chunk), 0));
+                if (received <= 0) return;
+                buffer.append(chunk, received);
+                end = buffer.find("\r\n\r\n");
+            }
+            // "GET /path HTTP/1.1"
+            const size_t pathBegin = buffer.find(' ') + 1;
+            std::string path = buffer.substr(pathBegin, buffer.find(' ', pathBegin) - pathBegin);
+            buffer.erase(0, end + 4);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(_latencyMs));
+            const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(path.size()) + "\r\n\r\n" + path;
+            if (send(connection, response.data(), static_cast<int>(response.size()), 0) < 0) return;
+        }
+    }
+
+    int _latencyMs = 0;
+    SocketHandle _listenSocket = INVALID_SOCKET;
+    int _port = 0;
+    std::atomic<bool> _stopping{false};
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<SocketHandle> _connections;
+    std::vector<std::thread> _connectionThreads;
+};
+
+// Sends the whole batch and runs the scheduler until every callback has been called.
+double runBatch(const LoopbackServer &server, uint requestCount, bool &match) {
+    auto *client = HttpClient::getInstance();
+    std::vector<std::string> bodies(requestCount);
+    uint completed = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint i = 0; i < requestCount; ++i) {
+        auto *request = new HttpRequest();
+        request->setRequestType(HttpRequest::Type::GET);
+        request->setUrl(server.url("/r" + std::to_string(i)));
+        request->setResponseCallback([&bodies, &completed, i](HttpClient * /*client*/, HttpResponse *response) {
+            if (response->isSucceed()) bodies[i].assign(response->getResponseData()->begin(), response->getResponseData()->end());
+            ++completed;
+        });
+        client->send(request);
+        request->release();
+    }
+    while (completed < requestCount) {
+        cc::Application::getInstance()->getScheduler()->update(0.016F);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (uint i = 0; i < requestCount; ++i) match &= bodies[i] == "/r" + std::to_string(i);
+    return elapsed;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint requestCount = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 64;
+    const int latencyMs = argc > 2 ? atoi(argv[2]) : 20;
+
+    new cc::Application(1, 1);
+    LoopbackServer server(latencyMs);
+    if (!server.start()) {
+        printf("failed to start the loopback server\n");
+        return 1;
+    }
+
+    printf("%u requests, %d ms server latency\n", requestCount, latencyMs);
+    printf("%11s %10s %9s %8s %6s\n", "concurrent", "ms", "req/s", "speedup", "match");
+
+    bool allMatch = true;
+    double baseline = 0.0;
+    for (int concurrency : CONCURRENCY) {
+        HttpClient::getInstance()->setMaxConcurrentRequests(concurrency);
+        bool match = true;
+        std::vector<double> times;
+        runBatch(server, requestCount, match); // warm up, opens the connections
+        for (int run = 0; run < RUNS; ++run) times.push_back(runBatch(server, requestCount, match));
+        std::sort(times.begin(), times.end());
+        const double median = times[RUNS / 2];
+        if (concurrency == 1) baseline = median;
+
+        allMatch &= match;
+        printf("%11d %10.1f %9.0f %7.2fx %6s\n", concurrency, median, requestCount * 1000.0 / median, baseline / median, match ? "yes" : "NO");
+    }
+
+    HttpClient::destroyInstance();
+    server.stop();
+    delete cc::Application::getInstance();
+    return allMatch ? 0 : 1;
+}
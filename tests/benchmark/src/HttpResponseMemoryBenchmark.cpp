@@ -0,0 +1,350 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Peak memory of receiving one large arraybuffer response, by how the body reaches its owner.
+//
+//   collected  the body is gathered in HttpResponse::getResponseData(), copied into a cc::Data
+//              in the callback and copied again for the ArrayBuffer, like XMLHttpRequest did
+//              before responses were streamed
+//   streamed   setResponseDataCallback() appends into a buffer sized from Content-Length, the
+//              buffer is moved into a cc::Data and handed on as is, like XMLHttpRequest does now
+//
+// Peak RSS only grows, so every mode runs in a child process of its own and reports its peak
+// over the baseline taken right before the request. The match column compares a checksum of
+// the delivered body with the one the server sent.
+//
+//   http_response_memory_benchmark [sizeMB]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #include <windows.h>
+    #include <psapi.h>
+    #pragma comment(lib, "ws2_32.lib")
+    #pragma comment(lib, "psapi.lib")
+using SocketHandle = SOCKET;
+    #define closeSocket closesocket
+#else
+    #include <arpa/inet.h>
+    #include <csignal>
+    #include <netinet/in.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+using SocketHandle = int;
+    #define INVALID_SOCKET (-1)
+    #define closeSocket    close
+#endif
+
+#include "base/Data.h"
+#include "network/HttpClient.h"
+#include "platform/Application.h"
+#include "platform/FileUtils.h"
+
+using cc::network::HttpClient;
+using cc::network::HttpRequest;
+using cc::network::HttpResponse;
+
+// The real Application needs a window, the client only posts its callbacks to the scheduler.
+namespace cc {
+Application *Application::_instance = nullptr;
+std::shared_ptr<Scheduler> Application::_scheduler = nullptr;
+
+Application::Application(int /*width*/, int /*height*/) {
+    Application::_instance = this;
+    _scheduler = std::make_shared<Scheduler>();
+}
+
+Application::~Application() {
+    _scheduler.reset();
+    Application::_instance = nullptr;
+}
+
+bool Application::init() { return true; }
+void Application::onPause() {}
+void Application::onResume() {}
+
+// cookies stay disabled
+FileUtils *FileUtils::getInstance() { return nullptr; }
+} // namespace cc
+
+namespace {
+const char *const MODES[] = {"collected", "streamed"};
+
+size_t getPeakResidentBytes() {
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    #if CC_PLATFORM == CC_PLATFORM_MAC_OSX
+    return static_cast<size_t>(usage.ru_maxrss);
+    #else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+    #endif
+#endif
+}
+
+uint64_t checksum(const unsigned char *bytes, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+// HTTP/1.1 server on 127.0.0.1 that answers "/body" with the whole body and any other path
+// with its first bytes. It sends straight from the one buffer, so the server side adds
+// nothing while a request is measured.
+class BodyServer {
+public:
+    explicit BodyServer(const std::vector<unsigned char> &body) : _body(body) {}
+
+    bool start() {
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#else
+        signal(SIGPIPE, SIG_IGN);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET) return false;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+            listen(_listenSocket, 4) != 0 ||
+            getsockname(_listenSocket, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+        _acceptThread = std::thread(&BodyServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        _stopping = true;
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _acceptThread.join();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto connection : _connections) shutdown(connection, 2);
+        }
+        for (auto &thread : _connectionThreads) thread.join();
+        for (auto connection : _connections) closeSocket(connection);
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSACleanup();
+#endif
+    }
+
+    std::string url(const std::string &path) const { return "http://127.0.0.1:" + std::to_string(_port) + path; }
+
+private:
+    void acceptLoop() {
+        while (!_stopping) {
+            SocketHandle connection = accept(_listenSocket, nullptr, nullptr);
+            if (connection == INVALID_SOCKET) break;
+            std::lock_guard<std::mutex> lock(_mutex);
+            _connections.push_back(connection);
+            _connectionThreads.emplace_back(&BodyServer::serve, this, connection);
+        }
+    }
+
+    void serve(SocketHandle connection) {
+        std::string buffer;
+        char chunk[1024];
+        while (true) {
+            size_t end = buffer.find("\r\n\r\n");
+            while (end == std::string::npos) {
+                int received = static_cast<int>(recv(connection, chunk, sizeof(chunk), 0));
+                if (received <= 0) return;
+                buffer.append(chunk, received);
+                end = buffer.find("\r\n\r\n");
+            }
+            // "GET /path HTTP/1.1"
+            const size_t pathBegin = buffer.find(' ') + 1;
+            const std::string path = buffer.substr(pathBegin, buffer.find(' ', pathBegin) - pathBegin);
+            buffer.erase(0, end + 4);
+
+            const size_t size = path == "/body" ? _body.size() : std::min<size_t>(_body.size(), 16);
+            const std::string header = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " + std::to_string(size) + "\r\n\r\n";
+            if (send(connection, header.data(), static_cast<int>(header.size()), 0) < 0) return;
+            size_t sent = 0;
+            while (sent < size) {
+                const int count = static_cast<int>(std::min<size_t>(size - sent, 1 << 20));
+                const int result = static_cast<int>(send(connection, reinterpret_cast<const char *>(_body.data() + sent), count, 0));
+                if (result <= 0) return;
+                sent += result;
+            }
+        }
+    }
+
+    const std::vector<unsigned char> &_body;
+    SocketHandle _listenSocket = INVALID_SOCKET;
+    int _port = 0;
+    std::atomic<bool> _stopping{false};
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<SocketHandle> _connections;
+    std::vector<std::thread> _connectionThreads;
+};
+
+// Same growth policy as the buffer XMLHttpRequest streams arraybuffer responses into.
+struct StreamBuffer {
+    unsigned char *bytes = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    ~StreamBuffer() { free(bytes); }
+
+    bool append(HttpResponse *response, const char *data, size_t len) {
+        if (size + len > capacity) {
+            const size_t contentLength = response->getContentLength() > 0 ? static_cast<size_t>(response->getContentLength()) : 0;
+            const size_t newCapacity = std::max({size + len, capacity * 2, contentLength});
+            auto *newBytes = static_cast<unsigned char *>(realloc(bytes, newCapacity));
+            if (!newBytes) return false;
+            bytes = newBytes;
+            capacity = newCapacity;
+        }
+        memcpy(bytes + size, data, len);
+        size += len;
+        return true;
+    }
+};
+
+// Fetches the body once in the given mode, returns the checksum of what the owner ends up with.
+uint64_t fetch(const std::string &url, bool streamed) {
+    auto *request = new HttpRequest();
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setUrl(url);
+    request->setTimeout(60.0F);
+
+    auto stream = std::make_shared<StreamBuffer>();
+    if (streamed) {
+        request->setResponseDataCallback([stream](HttpResponse *response, const char *data, size_t len) {
+            return stream->append(response, data, len);
+        });
+    }
+
+    cc::Data owned;
+    std::unique_ptr<unsigned char, decltype(&free)> arrayBuffer(nullptr, &free);
+    ssize_t arrayBufferSize = 0;
+    bool done = false;
+    request->setResponseCallback([&](HttpClient * /*client*/, HttpResponse *response) {
+        done = true;
+        if (!response->isSucceed()) return;
+        if (streamed) {
+            owned.fastSet(stream->bytes, stream->size);
+            stream->bytes = nullptr;
+        } else {
+            const std::vector<char> *body = response->getResponseData();
+            owned.copy(reinterpret_cast<const unsigned char *>(body->data()), body->size());
+        }
+    });
+    HttpClient::getInstance()->send(request);
+    request->release();
+
+    while (!done) {
+        cc::Application::getInstance()->getScheduler()->update(0.016F);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (streamed) {
+        // the buffer itself becomes the ArrayBuffer backing store
+        arrayBufferSize = owned.getSize();
+        arrayBuffer.reset(owned.takeBuffer(&arrayBufferSize));
+    } else {
+        arrayBufferSize = owned.getSize();
+        arrayBuffer.reset(static_cast<unsigned char *>(malloc(arrayBufferSize)));
+        memcpy(arrayBuffer.get(), owned.getBytes(), arrayBufferSize);
+    }
+    return checksum(arrayBuffer.get(), arrayBufferSize);
+}
+
+int runMode(const char *mode, size_t bodySize) {
+    std::vector<unsigned char> body(bodySize);
+    uint32_t state = 1;
+    for (auto &byte : body) {
+        state = state * 1664525U + 1013904223U;
+        byte = static_cast<unsigned char>(state >> 24);
+    }
+    const uint64_t expected = checksum(body.data(), body.size());
+
+    new cc::Application(1, 1);
+    BodyServer server(body);
+    if (!server.start()) {
+        printf("failed to start the loopback server\n");
+        return 1;
+    }
+
+    const bool streamed = strcmp(mode, "streamed") == 0;
+    // a small request first, so the client thread and connection exist before the baseline
+    fetch(server.url("/small"), streamed);
+    const size_t baseline = getPeakResidentBytes();
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool match = fetch(server.url("/body"), streamed) == expected;
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const size_t peak = getPeakResidentBytes();
+
+    printf("%10s %12.1f %10.1f %6s\n", mode, (peak - baseline) / (1024.0 * 1024.0), elapsed, match ? "yes" : "NO");
+
+    HttpClient::destroyInstance();
+    server.stop();
+    delete cc::Application::getInstance();
+    return match ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc > 2) return runMode(argv[1], static_cast<size_t>(atoi(argv[2])) << 20);
+
+    const int sizeMB = argc > 1 ? atoi(argv[1]) : 64;
+    printf("%d MB body\n", sizeMB);
+    printf("%10s %12s %10s %6s\n", "mode", "peak MB", "ms", "match");
+    fflush(stdout);
+
+    int result = 0;
+    for (const char *mode : MODES) {
+        const std::string command = std::string("\"") + argv[0] + "\" " + mode + " " + std::to_string(sizeMB);
+        result |= std::system(command.c_str());
+    }
+    return result ? 1 : 0;
+}
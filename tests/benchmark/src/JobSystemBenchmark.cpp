@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Fork/join throughput of JobSystem::parallelFor against the same split pushed onto a
+// fixed ThreadPool, by thread count.
+//
+// Both sides get the same number of threads doing work: the JobSystem has threads - 1
+// workers plus the calling thread, the ThreadPool has threads workers while the caller
+// blocks on a condition variable until every chunk has reported back. Every item runs a
+// configurable amount of integer work; small grain sizes show the per task overhead.
+//
+//   job_system_benchmark [itemCount] [workPerItem] [grainSize] [maxThreads]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/ThreadPool.h"
+#include "base/threading/JobSystem.h"
+
+using namespace cc;
+
+namespace {
+constexpr int RUNS = 15;
+
+uint64_t processItem(uint index, uint work) {
+    uint64_t value = index;
+    for (uint i = 0; i < work; ++i) {
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return value;
+}
+
+template <typename F>
+double measure(const F &frame) {
+    std::vector<double> times;
+    frame(); // warm up
+    for (int run = 0; run < RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        frame();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+
+void runJobSystem(JobSystem *jobSystem, std::vector<uint64_t> &results, uint work, uint grainSize) {
+    jobSystem->parallelFor(static_cast<uint>(results.size()), grainSize, [&](uint i) {
+        results[i] = processItem(i, work);
+    });
+}
+
+void runThreadPool(ThreadPool *pool, std::vector<uint64_t> &results, uint work, uint grainSize) {
+    const uint count = static_cast<uint>(results.size());
+    const uint chunkCount = (count + grainSize - 1) / grainSize;
+    std::mutex mutex;
+    std::condition_variable finished;
+    uint pending = chunkCount;
+
+    for (uint chunk = 0; chunk < chunkCount; ++chunk) {
+        pool->pushTask([&, chunk](int /*threadId*/) {
+            const uint begin = chunk * grainSize;
+            const uint end = std::min(count, begin + grainSize);
+            for (uint i = begin; i < end; ++i) results[i] = processItem(i, work);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!--pending) finished.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return pending == 0; });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint itemCount = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 1 << 18;
+    const uint work = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 32;
+    const uint grainSize = std::max(1, argc > 3 ? atoi(argv[3]) : 256);
+    const uint hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint maxThreads = std::max(1u, argc > 4 ? static_cast<uint>(atoi(argv[4])) : hardwareThreads);
+
+    std::vector<uint64_t> reference(itemCount);
+    for (uint i = 0; i < itemCount; ++i) reference[i] = processItem(i, work);
+
+    printf("%u items, %u work per item, grain size %u, %u hardware threads\n", itemCount, work, grainSize, hardwareThreads);
+    printf("%8s %14s %14s %8s %6s\n", "threads", "threadpool ms", "jobsystem ms", "ratio", "match");
+
+    bool allMatch = true;
+    for (uint threads = 1; threads <= maxThreads; ++threads) {
+        std::vector<uint64_t> poolResults(itemCount);
+        std::vector<uint64_t> jobResults(itemCount);
+
+        ThreadPool *pool = ThreadPool::newFixedThreadPool(static_cast<int>(threads));
+        const double poolTime = measure([&] { runThreadPool(pool, poolResults, work, grainSize); });
+        delete pool;
+
+        JobSystem jobSystem(threads - 1);
+        const double jobTime = measure([&] { runJobSystem(&jobSystem, jobResults, work, grainSize); });
+
+        const bool match = poolResults == reference && jobResults == reference;
+        allMatch &= match;
+        printf("%8u %14.3f %14.3f %7.2fx %6s\n", threads, poolTime, jobTime, poolTime / jobTime, match ? "yes" : "NO");
+    }
+
+    return allMatch ? 0 : 1;
+}
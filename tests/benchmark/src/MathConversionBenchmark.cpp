@@ -0,0 +1,113 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// seval_to_Vec3/seval_to_Mat4, plain script objects against Float32Array views.
+//
+// The values are created by script in a real V8 instance, then converted from native in a loop,
+// so the numbers leave out the cost of calling into native, which is the same for both. The
+// converted values are checked against what the script wrote.
+//
+//   math_conversion_benchmark [calls]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bindings/jswrapper/SeApi.h"
+#include "bindings/manual/jsb_conversions.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+// scripts are only evaluated from strings here
+FileUtils *FileUtils::getInstance() { return nullptr; }
+} // namespace cc
+
+namespace {
+constexpr int RUNS = 21;
+
+template <typename Fn>
+double medianNsPerCall(int calls, const Fn &fn) {
+    std::vector<double> times;
+    for (int run = 0; run < RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            fn();
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls);
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+
+se::Value eval(const char *script) {
+    se::Value value;
+    se::ScriptEngine::getInstance()->evalString(script, -1, &value);
+    return value;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const int calls = argc > 1 ? atoi(argv[1]) : 200000;
+
+    se::ScriptEngine::getInstance()->start();
+
+    bool allMatch = true;
+    {
+        se::AutoHandleScope hs;
+        // views into one scratch array, the way jsb.mathScratch is meant to be used
+        eval("var scratch = new Float32Array(64);"
+             "var vec3View = scratch.subarray(4, 7); vec3View.set([1, 2, 3]);"
+             "var mat4View = scratch.subarray(16, 32); for (var i = 0; i < 16; ++i) mat4View[i] = i;");
+        const se::Value vec3Object = eval("({x: 1, y: 2, z: 3})");
+        const se::Value vec3View = eval("vec3View");
+        const se::Value mat4Object = eval("var m = {}; for (var i = 0; i < 16; ++i) m[(i < 10 ? 'm0' : 'm') + i] = i; m");
+        const se::Value mat4View = eval("mat4View");
+
+        printf("%d calls, median of %d runs, ns per call\n", calls, RUNS);
+        printf("%6s %10s %10s %8s %6s\n", "type", "object", "view", "speedup", "match");
+
+        cc::Vec3 vec3;
+        const double vec3ObjectTime = medianNsPerCall(calls, [&]() { seval_to_Vec3(vec3Object, &vec3); });
+        bool match = vec3 == cc::Vec3(1, 2, 3);
+        const double vec3ViewTime = medianNsPerCall(calls, [&]() { seval_to_Vec3(vec3View, &vec3); });
+        match &= vec3 == cc::Vec3(1, 2, 3);
+        allMatch &= match;
+        printf("%6s %10.1f %10.1f %7.2fx %6s\n", "Vec3", vec3ObjectTime, vec3ViewTime, vec3ObjectTime / vec3ViewTime, match ? "yes" : "NO");
+
+        cc::Mat4 expected;
+        for (int i = 0; i < 16; ++i) expected.m[i] = static_cast<float>(i);
+        cc::Mat4 mat4;
+        const double mat4ObjectTime = medianNsPerCall(calls, [&]() { seval_to_Mat4(mat4Object, &mat4); });
+        match = !memcmp(mat4.m, expected.m, sizeof(expected.m));
+        const double mat4ViewTime = medianNsPerCall(calls, [&]() { seval_to_Mat4(mat4View, &mat4); });
+        match &= !memcmp(mat4.m, expected.m, sizeof(expected.m));
+        allMatch &= match;
+        printf("%6s %10.1f %10.1f %7.2fx %6s\n", "Mat4", mat4ObjectTime, mat4ViewTime, mat4ObjectTime / mat4ViewTime, match ? "yes" : "NO");
+    }
+
+    se::ScriptEngine::destroyInstance();
+    return allMatch ? 0 : 1;
+}
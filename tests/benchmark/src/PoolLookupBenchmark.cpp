@@ -0,0 +1,141 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// se::BufferAllocator::getBuffer, the lookup behind every GET_*_ARRAY and GET_RAW_BUFFER.
+//
+// Array buffers are allocated in a real V8 instance for a few pools. The same random sequence
+// of (pool, index) handles is then resolved through BufferAllocator and through the lookup it
+// replaced: a map of pools, a map of buffers and getArrayBufferData on every access. Both must
+// return the same pointers.
+//
+//   pool_lookup_benchmark [buffersPerPool] [lookups]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bindings/dop/BufferAllocator.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+// scripts are never loaded from files here
+FileUtils *FileUtils::getInstance() { return nullptr; }
+} // namespace cc
+
+namespace {
+constexpr int RUNS = 21;
+constexpr uint BUFFER_BYTES = 64;
+
+struct Handle {
+    se::PoolType type;
+    uint index;
+};
+
+// how BufferAllocator::getBuffer used to resolve a handle
+class MapLookup {
+public:
+    void add(se::PoolType type, uint index, se::Object *obj) { _pools[type][index] = obj; }
+
+    uint32_t *getBuffer(se::PoolType type, uint index) {
+        if (_pools.count(type) == 0) return nullptr;
+        auto &buffers = _pools[type];
+        if (buffers.count(index) == 0) return nullptr;
+        uint32_t *ret = nullptr;
+        size_t len = 0;
+        buffers[index]->getArrayBufferData(reinterpret_cast<uint8_t **>(&ret), &len);
+        return ret;
+    }
+
+private:
+    std::map<se::PoolType, std::map<uint, se::Object *>> _pools;
+};
+
+template <typename Fn>
+double medianNsPerLookup(const std::vector<Handle> &handles, std::vector<uint32_t *> &results, const Fn &lookup) {
+    std::vector<double> times;
+    for (int run = 0; run < RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < handles.size(); ++i) {
+            results[i] = lookup(handles[i]);
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / handles.size());
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint buffersPerPool = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 64;
+    const uint lookups = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 1 << 20;
+
+    se::ScriptEngine::getInstance()->start();
+
+    bool match = true;
+    double mapTime = 0.0;
+    double flatTime = 0.0;
+    {
+        se::AutoHandleScope hs;
+
+        const se::PoolType types[] = {se::PoolType::MODEL_ARRAY, se::PoolType::SUB_MODEL_ARRAY, se::PoolType::LIGHT_ARRAY, se::PoolType::ATTRIBUTE_ARRAY};
+        std::vector<std::unique_ptr<se::BufferAllocator>> allocators;
+        MapLookup mapLookup;
+        for (const auto type : types) {
+            allocators.emplace_back(new se::BufferAllocator(type));
+            for (uint i = 0; i < buffersPerPool; ++i) {
+                mapLookup.add(type, i, allocators.back()->alloc(i, BUFFER_BYTES));
+            }
+        }
+
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<uint> pool(0, 3);
+        std::uniform_int_distribution<uint> index(0, buffersPerPool - 1);
+        std::vector<Handle> handles(lookups);
+        for (auto &handle : handles) {
+            handle = {types[pool(rng)], index(rng)};
+        }
+
+        std::vector<uint32_t *> expected(lookups);
+        std::vector<uint32_t *> actual(lookups);
+        mapTime = medianNsPerLookup(handles, expected, [&](const Handle &handle) {
+            return mapLookup.getBuffer(handle.type, handle.index);
+        });
+        flatTime = medianNsPerLookup(handles, actual, [](const Handle &handle) {
+            return se::BufferAllocator::getBuffer<uint32_t>(handle.type, handle.index);
+        });
+        match = expected == actual && std::find(actual.begin(), actual.end(), nullptr) == actual.end();
+    }
+
+    printf("4 pools x %u buffers, %u lookups, median of %d runs, ns per lookup\n", buffersPerPool, lookups, RUNS);
+    printf("%10s %10s %8s %6s\n", "map", "flat", "speedup", "match");
+    printf("%10.1f %10.1f %7.2fx %6s\n", mapTime, flatTime, mapTime / flatTime, match ? "yes" : "NO");
+
+    se::ScriptEngine::destroyInstance();
+    return match ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Scaling of ForwardStage's parallel recording by worker count.
+//
+// The opaque queue is resolved up front, split into the same ranges ForwardStage uses and
+// recorded through CommandRecorder into one secondary command buffer per range on the
+// JobSystem. There is no GPU backend here: the command buffer encodes every command into a
+// plain array and spends a configurable amount of work on it, standing in for the driver.
+//
+//   recording_benchmark [drawCount] [workPerCommand] [maxWorkers]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "pipeline/helper/CommandRecorder.h"
+#include "base/threading/JobSystem.h"
+#include "gfx/GFXCommandBuffer.h"
+
+using namespace cc;
+
+namespace {
+// same as ForwardStage
+constexpr uint RECORD_PASSES_PER_TASK = 128;
+constexpr uint GLOBAL_SET = 0;
+constexpr uint MATERIAL_SET = 1;
+constexpr uint LOCAL_SET = 2;
+constexpr int RUNS = 15;
+
+struct EncodedCommand {
+    uint32_t type;
+    uint32_t set;
+    const void *object;
+    uint64_t payload;
+};
+
+class EncodingCommandBuffer final : public gfx::CommandBuffer {
+public:
+    explicit EncodingCommandBuffer(uint work) : CommandBuffer(nullptr), _work(work) {}
+
+    bool initialize(const gfx::CommandBufferInfo & /*info*/) override { return true; }
+    void destroy() override {}
+    void begin(gfx::RenderPass * /*renderPass*/, uint /*subpass*/, gfx::Framebuffer * /*frameBuffer*/, int /*submitIndex*/) override {
+        _commands.clear();
+    }
+    void end() override {}
+    void beginRenderPass(gfx::RenderPass *renderPass, gfx::Framebuffer * /*fbo*/, const gfx::Rect & /*renderArea*/, const gfx::Color * /*colors*/,
+                         float /*depth*/, int /*stencil*/, bool /*fromSecondaryCB*/) override { encode(1, 0, renderPass); }
+    void endRenderPass() override { encode(2, 0, nullptr); }
+    void bindPipelineState(gfx::PipelineState *pso) override { encode(3, 0, pso); }
+    void bindDescriptorSet(uint set, gfx::DescriptorSet *descriptorSet, uint /*dynamicOffsetCount*/, const uint * /*dynamicOffsets*/) override {
+        encode(4, set, descriptorSet);
+    }
+    void bindInputAssembler(gfx::InputAssembler *ia) override { encode(5, 0, ia); }
+    void setViewport(const gfx::Viewport & /*vp*/) override { encode(6, 0, nullptr); }
+    void setScissor(const gfx::Rect & /*rect*/) override { encode(7, 0, nullptr); }
+    void setLineWidth(float /*width*/) override {}
+    void setDepthBias(float /*constant*/, float /*clamp*/, float /*slope*/) override {}
+    void setBlendConstants(const gfx::Color & /*constants*/) override {}
+    void setDepthBound(float /*minBounds*/, float /*maxBounds*/) override {}
+    void setStencilWriteMask(gfx::StencilFace /*face*/, uint /*mask*/) override {}
+    void setStencilCompareMask(gfx::StencilFace /*face*/, int /*ref*/, uint /*mask*/) override {}
+    void draw(gfx::InputAssembler *ia) override { encode(8, 0, ia); }
+    void updateBuffer(gfx::Buffer * /*buff*/, const void * /*data*/, uint /*size*/) override {}
+    void copyBuffersToTexture(const uint8_t *const * /*buffers*/, gfx::Texture * /*texture*/, const gfx::BufferTextureCopy * /*regions*/, uint /*count*/) override {}
+    void execute(const CommandBuffer *const * /*cmdBuffs*/, uint32_t /*count*/) override {}
+
+    CC_INLINE size_t getCommandCount() const { return _commands.size(); }
+
+private:
+    void encode(uint32_t type, uint32_t set, const void *object) {
+        uint64_t payload = reinterpret_cast<uintptr_t>(object) ^ type;
+        for (uint i = 0; i < _work; ++i) {
+            payload = payload * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        _commands.push_back({type, set, object, payload});
+    }
+
+    uint _work = 0;
+    std::vector<EncodedCommand> _commands;
+};
+
+template <typename T>
+T *fakeObject(uintptr_t id) {
+    // only compared and forwarded, never dereferenced
+    return reinterpret_cast<T *>((id + 1) * 64);
+}
+
+double recordFrame(JobSystem *jobSystem, const std::vector<pipeline::ResolvedDraw> &draws,
+                   std::vector<EncodingCommandBuffer *> &secondaries, size_t &commandCount) {
+    const uint passCount = static_cast<uint>(draws.size());
+    const uint maxTasks = jobSystem->getWorkerCount() + 1;
+    const uint taskCount = std::max(1u, std::min(maxTasks, passCount / RECORD_PASSES_PER_TASK));
+    const uint passesPerTask = (passCount + taskCount - 1) / taskCount;
+    std::vector<pipeline::BindStatistics> stats(taskCount);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto record = [&](uint t) {
+        const uint begin = t * passesPerTask;
+        const uint end = std::min(passCount, begin + passesPerTask);
+        gfx::CommandBuffer *secondary = secondaries[t];
+        secondary->begin();
+        secondary->setViewport(gfx::Viewport());
+        secondary->setScissor(gfx::Rect());
+        secondary->bindDescriptorSet(GLOBAL_SET, fakeObject<gfx::DescriptorSet>(0));
+        pipeline::CommandRecorder recorder(secondary, &stats[t]);
+        recorder.drawResolved(draws.data() + begin, end - begin, MATERIAL_SET, LOCAL_SET);
+        secondary->end();
+    };
+
+    auto root = jobSystem->createJob([] {});
+    for (uint t = 0; t < taskCount; ++t) {
+        auto job = jobSystem->createJob([&record, t] { record(t); }, root);
+        jobSystem->run(job);
+        jobSystem->release(job);
+    }
+    jobSystem->run(root);
+    jobSystem->wait(root);
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    commandCount = 0;
+    for (uint t = 0; t < taskCount; ++t) commandCount += secondaries[t]->getCommandCount();
+    return elapsed;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint drawCount = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 20000;
+    const uint work = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 64;
+    const uint hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint maxWorkers = argc > 3 ? static_cast<uint>(atoi(argv[3])) : hardwareThreads - 1;
+
+    // sorted opaque queue: pipeline states change every 16 draws, materials every 4,
+    // every draw has its own local descriptor set and input assembler
+    std::vector<pipeline::ResolvedDraw> draws(drawCount);
+    for (uint i = 0; i < drawCount; ++i) {
+        draws[i].pso = fakeObject<gfx::PipelineState>(i / 16);
+        draws[i].materialSet = fakeObject<gfx::DescriptorSet>(1 + i / 4);
+        draws[i].localSet = fakeObject<gfx::DescriptorSet>(1 + drawCount + i);
+        draws[i].inputAssembler = fakeObject<gfx::InputAssembler>(i);
+    }
+
+    std::vector<EncodingCommandBuffer *> secondaries;
+    for (uint i = 0; i <= maxWorkers; ++i) secondaries.push_back(new EncodingCommandBuffer(work));
+
+    printf("%u draws, %u work per command, %u hardware threads\n", drawCount, work, hardwareThreads);
+    printf("%8s %8s %10s %10s %8s\n", "workers", "tasks", "commands", "ms", "speedup");
+
+    double baseline = 0.0;
+    for (uint workers = 0; workers <= maxWorkers; ++workers) {
+        JobSystem jobSystem(workers);
+        size_t commandCount = 0;
+        std::vector<double> times;
+        recordFrame(&jobSystem, draws, secondaries, commandCount); // warm up
+        for (int run = 0; run < RUNS; ++run) {
+            times.push_back(recordFrame(&jobSystem, draws, secondaries, commandCount));
+        }
+        std::sort(times.begin(), times.end());
+        const double median = times[RUNS / 2];
+        if (!workers) baseline = median;
+
+        const uint taskCount = std::max(1u, std::min(workers + 1, drawCount / RECORD_PASSES_PER_TASK));
+        printf("%8u %8u %10zu %10.3f %7.2fx\n", workers, taskCount, commandCount, median, baseline / median);
+    }
+
+    for (auto secondary : secondaries) delete secondary;
+    return 0;
+}
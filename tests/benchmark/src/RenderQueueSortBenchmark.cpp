@@ -0,0 +1,119 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// RenderQueue::sort, comparator path against the packed key radix sort.
+//
+// Entries get random priorities, pass indices, depths and one of a fixed set of shaders, like
+// a scene with many materials. The comparator path is timed the way RenderQueue calls it,
+// through std::function. The radix result is checked against the comparator order: adjacent
+// entries the comparator would swap are counted, they can only come from depths that differ
+// by less than the quantization step.
+//
+//   render_queue_sort_benchmark [shaderCount] [maxEntries]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "pipeline/helper/RenderPassSorter.h"
+
+using namespace cc;
+using namespace cc::pipeline;
+
+namespace {
+constexpr int RUNS = 51;
+
+RenderPassList makePasses(uint count, uint shaderCount, std::mt19937 &rng) {
+    std::uniform_int_distribution<uint> priority(0, 3);
+    std::uniform_int_distribution<uint> passIndex(0, 1);
+    std::uniform_int_distribution<uint> shader(0, shaderCount - 1);
+    std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+
+    RenderPassList passes(count);
+    for (auto &pass : passes) {
+        // same layout as RenderQueue::insertRenderPass
+        pass.hash = (priority(rng) << 16) | (priority(rng) << 8) | passIndex(rng);
+        pass.depth = depth(rng);
+        pass.shaderID = 1 + shader(rng);
+    }
+    return passes;
+}
+
+template <typename Fn>
+double medianMicroseconds(const RenderPassList &input, RenderPassList &output, const Fn &sort) {
+    std::vector<double> times;
+    for (int run = 0; run < RUNS; ++run) {
+        output = input;
+        const auto start = std::chrono::steady_clock::now();
+        sort(output);
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+
+uint countInversions(const RenderPassList &passes, const std::function<bool(const RenderPass &, const RenderPass &)> &compare) {
+    uint inversions = 0;
+    for (size_t i = 1; i < passes.size(); ++i) {
+        if (compare(passes[i], passes[i - 1])) ++inversions;
+    }
+    return inversions;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint shaderCount = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 200;
+    const uint maxEntries = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 16384;
+
+    std::mt19937 rng(1234);
+    RenderPassSorter sorter;
+    RenderPassList sorted;
+
+    printf("%u shaders, median of %d runs\n", shaderCount, RUNS);
+    printf("%10s %8s %12s %12s %8s %11s\n", "mode", "entries", "std::sort us", "radix us", "speedup", "inversions");
+
+    const RenderQueueSortMode modes[] = {RenderQueueSortMode::FRONT_TO_BACK, RenderQueueSortMode::BACK_TO_FRONT};
+    for (const auto mode : modes) {
+        const bool backToFront = mode == RenderQueueSortMode::BACK_TO_FRONT;
+        const std::function<bool(const RenderPass &, const RenderPass &)> sortFunc = backToFront ? transparentCompareFn : opaqueCompareFn;
+
+        for (uint count = 256; count <= maxEntries; count *= 4) {
+            const RenderPassList passes = makePasses(count, shaderCount, rng);
+
+            const double comparatorTime = medianMicroseconds(passes, sorted, [&](RenderPassList &list) {
+                std::sort(list.begin(), list.end(), sortFunc);
+            });
+            const double radixTime = medianMicroseconds(passes, sorted, [&](RenderPassList &list) {
+                sorter.sort(list, mode);
+            });
+
+            printf("%10s %8u %12.1f %12.1f %7.2fx %11u\n", backToFront ? "back" : "front", count,
+                   comparatorTime, radixTime, comparatorTime / radixTime, countInversions(sorted, sortFunc));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// Cost of Scheduler::update() by number of scheduled timers.
+//
+// The baseline walks every timer each frame through Timer::update(), the loop the
+// Scheduler ran before timers moved onto the timing wheel, minus its hash lookups.
+// One timer in 16 fires every frame, the others have intervals between 50 ms and 10 s.
+// The fired columns count callbacks including the warm up frames; the two can differ by a
+// few timers landing exactly on an interval boundary, the wheel counts in 1 ms ticks.
+// The last line times functions posted from another thread with performFunctionInCocosThread().
+//
+//   scheduler_benchmark [frames] [functionCount]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/Scheduler.h"
+
+using namespace cc;
+
+namespace {
+constexpr float FRAME_TIME = 0.016F;
+constexpr int WARM_UP_FRAMES = 10;
+
+class WalkedTimer final : public Timer {
+public:
+    WalkedTimer(Scheduler *idle, uint64_t *fired, float interval) : _fired(fired) {
+        _scheduler = idle;
+        setupTimerWithInterval(interval, UINT_MAX - 1, 0.F);
+    }
+
+    void trigger(float /*dt*/) override { ++*_fired; }
+    void cancel() override {}
+
+private:
+    uint64_t *_fired = nullptr;
+};
+
+std::vector<float> makeIntervals(uint timerCount) {
+    std::mt19937 rng(7);
+    std::vector<float> intervals(timerCount);
+    for (uint i = 0; i < timerCount; ++i) {
+        intervals[i] = i % 16 == 0 ? 0.F : 0.05F + static_cast<float>(rng() % 1000) * 0.01F;
+    }
+    return intervals;
+}
+
+double timeFrames(uint frames, const std::function<void()> &update) {
+    for (int i = 0; i < WARM_UP_FRAMES; ++i) update();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint i = 0; i < frames; ++i) update();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+double benchmarkWalk(const std::vector<float> &intervals, uint frames, uint64_t &fired) {
+    Scheduler idle;
+    uint64_t count = 0;
+    std::vector<WalkedTimer *> timers;
+    timers.reserve(intervals.size());
+    for (float interval : intervals) timers.push_back(new WalkedTimer(&idle, &count, interval));
+
+    const double time = timeFrames(frames, [&] {
+        for (auto *timer : timers) timer->update(FRAME_TIME);
+    });
+    fired = count;
+
+    for (auto *timer : timers) timer->release();
+    return time;
+}
+
+double benchmarkScheduler(const std::vector<float> &intervals, uint frames, uint64_t &fired) {
+    Scheduler scheduler;
+    uint64_t count = 0;
+    // eight keyed timers per target, like components scheduling a few callbacks each
+    std::vector<char> targets(intervals.size() / 8 + 1);
+    for (size_t i = 0; i < intervals.size(); ++i) {
+        scheduler.schedule([&count](float /*dt*/) { ++count; }, &targets[i / 8], intervals[i], UINT_MAX - 1, 0.F, false,
+                           "t" + std::to_string(i % 8));
+    }
+
+    const double time = timeFrames(frames, [&] { scheduler.update(FRAME_TIME); });
+    fired = count;
+    return time;
+}
+
+double benchmarkFunctions(uint functionCount) {
+    Scheduler scheduler;
+    std::atomic<uint> performed{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (uint i = 0; i < functionCount; ++i) {
+            scheduler.performFunctionInCocosThread([&performed] { performed.fetch_add(1, std::memory_order_relaxed); });
+        }
+    });
+    while (performed.load(std::memory_order_relaxed) < functionCount) scheduler.update(FRAME_TIME);
+    producer.join();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const uint frames = argc > 1 ? static_cast<uint>(atoi(argv[1])) : 600;
+    const uint functionCount = argc > 2 ? static_cast<uint>(atoi(argv[2])) : 100000;
+
+    printf("%u frames of %.0f ms\n", frames, FRAME_TIME * 1000);
+    printf("%8s %12s %12s %8s %12s %12s\n", "timers", "walk us", "wheel us", "speedup", "walk fired", "wheel fired");
+
+    for (uint timerCount : {1000u, 10000u, 50000u}) {
+        const auto intervals = makeIntervals(timerCount);
+        uint64_t walkFired = 0;
+        uint64_t wheelFired = 0;
+        const double walkTime = benchmarkWalk(intervals, frames, walkFired);
+        const double wheelTime = benchmarkScheduler(intervals, frames, wheelFired);
+        printf("%8u %12.1f %12.1f %7.2fx %12llu %12llu\n", timerCount, walkTime, wheelTime, walkTime / wheelTime,
+               static_cast<unsigned long long>(walkFired), static_cast<unsigned long long>(wheelFired));
+    }
+
+    printf("%u functions from another thread: %.1f ms\n", functionCount, benchmarkFunctions(functionCount));
+    return 0;
+}
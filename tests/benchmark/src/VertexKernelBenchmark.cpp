@@ -0,0 +1,174 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+// middleware VertexKernel against the scalar loops SkeletonRenderer used before.
+//
+// Both run over the same random vertex buffer, with the stride of a plain skeleton (9 floats)
+// and of a tinted one (13 floats). Every kernel output is compared with the scalar output
+// and the run fails if they differ.
+//
+//   vertex_kernel_benchmark [vertexCount]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "VertexKernel.h"
+
+using namespace cc;
+using namespace cc::middleware;
+
+namespace {
+constexpr int RUNS = 51;
+constexpr int REPEAT = 200;
+constexpr int UV_OFFSET = 3;
+constexpr int COLOR_OFFSET = 5;
+constexpr int COLOR2_OFFSET = 9;
+
+void scalarFillColors(float *verts, int count, int stride, const Color4F &light, const Color4F *dark) {
+    for (int i = 0; i < count; ++i, verts += stride) {
+        verts[COLOR_OFFSET] = light.r;
+        verts[COLOR_OFFSET + 1] = light.g;
+        verts[COLOR_OFFSET + 2] = light.b;
+        verts[COLOR_OFFSET + 3] = light.a;
+        if (dark) {
+            verts[COLOR2_OFFSET] = dark->r;
+            verts[COLOR2_OFFSET + 1] = dark->g;
+            verts[COLOR2_OFFSET + 2] = dark->b;
+            verts[COLOR2_OFFSET + 3] = dark->a;
+        }
+    }
+}
+
+void scalarCopyTexCoords(float *dst, int dstStride, const float *src, int srcStride, int count) {
+    for (int i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+        dst[UV_OFFSET] = src[UV_OFFSET];
+        dst[UV_OFFSET + 1] = src[UV_OFFSET + 1];
+    }
+}
+
+void scalarCopyClipped(float *dst, int stride, const float *positions, const float *uvs, int count) {
+    for (int i = 0; i < count; ++i, dst += stride) {
+        dst[0] = positions[i * 2];
+        dst[1] = positions[i * 2 + 1];
+        dst[UV_OFFSET] = uvs[i * 2];
+        dst[UV_OFFSET + 1] = uvs[i * 2 + 1];
+    }
+}
+
+void scalarTransform(float *verts, int count, int stride, const Mat4 &mat) {
+    const float *m = mat.m;
+    for (int i = 0; i < count; ++i, verts += stride) {
+        const float x = verts[0];
+        const float y = verts[1];
+        verts[0] = x * m[0] + y * m[4] + m[12];
+        verts[1] = x * m[1] + y * m[5] + m[13];
+        verts[2] = 0;
+    }
+}
+
+// median over RUNS of REPEAT calls, in nanoseconds per vertex
+template <typename Fn>
+double medianNsPerVertex(std::vector<float> &buffer, const std::vector<float> &input, int count, const Fn &fn) {
+    std::vector<double> times;
+    for (int run = 0; run < RUNS; ++run) {
+        buffer = input;
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < REPEAT; ++r) {
+            fn(buffer.data());
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (REPEAT * count));
+    }
+    std::sort(times.begin(), times.end());
+    return times[RUNS / 2];
+}
+
+// runs both once on fresh copies of input and compares the whole buffers
+template <typename Scalar, typename Kernel>
+bool sameOutput(const std::vector<float> &input, const Scalar &scalar, const Kernel &kernel) {
+    std::vector<float> expected = input;
+    std::vector<float> actual = input;
+    scalar(expected.data());
+    kernel(actual.data());
+    return !memcmp(expected.data(), actual.data(), expected.size() * sizeof(float));
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    const int count = argc > 1 ? atoi(argv[1]) : 1200;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    Mat4 mat;
+    Mat4::createRotationZ(0.7f, &mat);
+    mat.scale(1.2f, 0.8f, 1.0f);
+    mat.m[12] = 12.5f;
+    mat.m[13] = -4.0f;
+    const Color4F light(0.9f, 0.5f, 0.25f, 1.0f);
+    const Color4F dark(0.1f, 0.2f, 0.3f, 1.0f);
+
+    std::vector<float> positions(count * 2);
+    std::vector<float> uvs(count * 2);
+    for (auto &v : positions) v = dist(rng);
+    for (auto &v : uvs) v = dist(rng);
+
+    printf("%d vertices, median of %d runs, ns per vertex\n", count, RUNS);
+    printf("%6s %10s %8s %8s %8s %6s\n", "stride", "kernel", "scalar", "simd", "speedup", "match");
+
+    bool allMatch = true;
+    const int strides[] = {9, 13};
+    for (const int stride : strides) {
+        const Color4F *darkColor = stride == 13 ? &dark : nullptr;
+        std::vector<float> input(count * stride);
+        for (auto &v : input) v = dist(rng);
+        std::vector<float> source = input;
+        std::vector<float> buffer;
+
+        auto report = [&](const char *name, auto scalar, auto kernel) {
+            const double scalarTime = medianNsPerVertex(buffer, input, count, scalar);
+            const double kernelTime = medianNsPerVertex(buffer, input, count, kernel);
+            const bool match = sameOutput(input, scalar, kernel);
+            allMatch &= match;
+            printf("%6d %10s %8.2f %8.2f %7.2fx %6s\n", stride, name, scalarTime, kernelTime, scalarTime / kernelTime, match ? "yes" : "NO");
+        };
+
+        report(
+            "color", [&](float *v) { scalarFillColors(v, count, stride, light, darkColor); },
+            [&](float *v) { fillVertexColors(v, count, stride, light, darkColor); });
+        report(
+            "texcoord", [&](float *v) { scalarCopyTexCoords(v, stride, source.data(), stride, count); },
+            [&](float *v) { copyVertexTexCoords(v, stride, source.data(), stride, count); });
+        report(
+            "clip copy", [&](float *v) { scalarCopyClipped(v, stride, positions.data(), uvs.data(), count); },
+            [&](float *v) { copyClippedVertices(v, stride, positions.data(), uvs.data(), count); });
+        report(
+            "transform", [&](float *v) { scalarTransform(v, count, stride, mat); },
+            [&](float *v) { transformVertices(v, count, stride, mat); });
+    }
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include "renderer/pipeline/helper/ClusterLightGrid.h"
+#include <algorithm>
+#include <cfloat>
+#include <random>
+#include <thread>
+
+using cc::Mat4;
+using cc::Vec3;
+using cc::Vec4;
+using cc::pipeline::ClusterLightGrid;
+using cc::pipeline::ClusterLightGridInfo;
+
+namespace {
+
+const float NEAR_PLANE = 0.5f;
+const float FAR_PLANE = 200.0f;
+
+ClusterLightGridInfo perspectiveInfo() {
+    ClusterLightGridInfo info;
+    Mat4 proj;
+    Mat4::createPerspective(1.0f, 16.0f / 9.0f, NEAR_PLANE, FAR_PLANE, &proj);
+    info.matProjInv = proj.getInversed();
+    return info;
+}
+
+ClusterLightGridInfo orthographicInfo() {
+    ClusterLightGridInfo info;
+    Mat4 proj;
+    Mat4::createOrthographic(-20.0f, 20.0f, -10.0f, 10.0f, NEAR_PLANE, FAR_PLANE, &proj);
+    info.matProjInv = proj.getInversed();
+    return info;
+}
+
+Vec3 unproject(const Mat4 &matProjInv, float x, float y, float z) {
+    Vec4 p(x, y, z, 1.0f);
+    matProjInv.transformVector(&p);
+    return Vec3(p.x / p.w, p.y / p.w, p.z / p.w);
+}
+
+// Independent cluster box: the four tile corner rays cut at the slice depths
+// derived from the exposed slice parameters.
+void referenceBounds(const ClusterLightGrid &grid, const ClusterLightGridInfo &info, uint x, uint y, uint z, Vec3 *min, Vec3 *max) {
+    const float nearDepth = z == 0 ? NEAR_PLANE : std::exp((static_cast<float>(z) - grid.getSliceBias()) / grid.getSliceScale());
+    const float farDepth = z + 1 == info.slicesZ ? FAR_PLANE : std::exp((static_cast<float>(z + 1) - grid.getSliceBias()) / grid.getSliceScale());
+    *min = Vec3(FLT_MAX, FLT_MAX, -farDepth);
+    *max = Vec3(-FLT_MAX, -FLT_MAX, -nearDepth);
+    for (uint c = 0; c < 4; ++c) {
+        const float ndcX = -1.0f + 2.0f * static_cast<float>(x + (c & 1)) / static_cast<float>(info.tilesX);
+        const float ndcY = -1.0f + 2.0f * static_cast<float>(y + (c >> 1)) / static_cast<float>(info.tilesY);
+        const Vec3 n = unproject(info.matProjInv, ndcX, ndcY, info.clipSpaceMinZ);
+        const Vec3 f = unproject(info.matProjInv, ndcX, ndcY, 1.0f);
+        for (const float depth : {nearDepth, farDepth}) {
+            const Vec3 p = n + (f - n) * ((depth + n.z) / (n.z - f.z));
+            min->x = std::min(min->x, p.x);
+            min->y = std::min(min->y, p.y);
+            max->x = std::max(max->x, p.x);
+            max->y = std::max(max->y, p.y);
+        }
+    }
+}
+
+float distanceSq(const Vec4 &sphere, const Vec3 &min, const Vec3 &max) {
+    const float dx = std::max(std::max(min.x - sphere.x, sphere.x - max.x), 0.0f);
+    const float dy = std::max(std::max(min.y - sphere.y, sphere.y - max.y), 0.0f);
+    const float dz = std::max(std::max(min.z - sphere.z, sphere.z - max.z), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+bool clusterHasLight(const ClusterLightGrid &grid, uint cluster, uint light) {
+    const auto &indices = grid.getLightIndices();
+    const uint begin = grid.getClusterOffsets()[cluster];
+    const uint end = begin + grid.getClusterCounts()[cluster];
+    return std::find(indices.begin() + begin, indices.begin() + end, light) != indices.begin() + end;
+}
+
+std::vector<Vec4> randomLights(uint count, uint seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> xy(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> depth(0.1f, 150.0f);
+    std::uniform_real_distribution<float> radius(0.2f, 8.0f);
+    std::vector<Vec4> lights;
+    for (uint i = 0; i < count; ++i) {
+        lights.emplace_back(xy(rng), xy(rng) * 0.5f, -depth(rng), radius(rng));
+    }
+    return lights;
+}
+
+void checkLayout(const ClusterLightGrid &grid, const ClusterLightGridInfo &info) {
+    const uint clusterCount = info.tilesX * info.tilesY * info.slicesZ;
+    ASSERT_TRUE(grid.getClusterCount() == clusterCount);
+    uint offset = 0;
+    for (uint i = 0; i < clusterCount; ++i) {
+        EXPECT_EQ(grid.getClusterOffsets()[i], offset);
+        EXPECT_TRUE(grid.getClusterCounts()[i] <= info.maxLightsPerCluster);
+        offset += grid.getClusterCounts()[i];
+    }
+    EXPECT_EQ(grid.getLightIndices().size(), offset);
+}
+
+// Every listed light touches the reference box, and every light clearly inside
+// a box is listed unless the cluster is full.
+void checkAgainstReference(const ClusterLightGrid &grid, const ClusterLightGridInfo &info, const std::vector<Vec4> &lights) {
+    for (uint z = 0; z < info.slicesZ; ++z) {
+        for (uint y = 0; y < info.tilesY; ++y) {
+            for (uint x = 0; x < info.tilesX; ++x) {
+                const uint cluster = grid.getClusterIndex(x, y, z);
+                const bool full = grid.getClusterCounts()[cluster] == info.maxLightsPerCluster;
+                Vec3 min, max;
+                referenceBounds(grid, info, x, y, z, &min, &max);
+                for (uint i = 0; i < lights.size(); ++i) {
+                    const float tolerance = 1e-3f * lights[i].w + 1e-3f;
+                    const float distSq = distanceSq(lights[i], min, max);
+                    const bool listed = clusterHasLight(grid, cluster, i);
+                    if (listed) {
+                        EXPECT_TRUE(distSq <= (lights[i].w + tolerance) * (lights[i].w + tolerance));
+                    } else if (!full && lights[i].w > tolerance) {
+                        EXPECT_TRUE(distSq > (lights[i].w - tolerance) * (lights[i].w - tolerance));
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(ClusterLightGrid, EmptyInput) {
+    const auto info = perspectiveInfo();
+    ClusterLightGrid grid;
+    grid.build(info, nullptr, 0);
+    checkLayout(grid, info);
+    EXPECT_TRUE(grid.getLightIndices().empty());
+}
+
+TEST(ClusterLightGrid, SliceMapping) {
+    const auto info = perspectiveInfo();
+    ClusterLightGrid grid;
+    grid.build(info, nullptr, 0);
+    EXPECT_EQ(grid.getSlice(0.0f), 0u);
+    EXPECT_EQ(grid.getSlice(NEAR_PLANE), 0u);
+    EXPECT_EQ(grid.getSlice(FAR_PLANE * 2.0f), info.slicesZ - 1);
+    uint last = 0;
+    for (float depth = NEAR_PLANE; depth < FAR_PLANE; depth *= 1.05f) {
+        const uint slice = grid.getSlice(depth);
+        EXPECT_TRUE(slice >= last);
+        last = slice;
+    }
+    EXPECT_EQ(last, info.slicesZ - 1);
+}
+
+TEST(ClusterLightGrid, LightCenterCluster) {
+    const auto info = perspectiveInfo();
+    const Mat4 proj = info.matProjInv.getInversed();
+    const auto lights = randomLights(200, 1);
+    ClusterLightGrid grid;
+    grid.build(info, lights.data(), static_cast<uint>(lights.size()));
+
+    for (uint i = 0; i < lights.size(); ++i) {
+        Vec4 clip(lights[i].x, lights[i].y, lights[i].z, 1.0f);
+        proj.transformVector(&clip);
+        const float ndcX = clip.x / clip.w;
+        const float ndcY = clip.y / clip.w;
+        const float depth = -lights[i].z;
+        if (std::fabs(ndcX) >= 0.99f || std::fabs(ndcY) >= 0.99f || depth <= NEAR_PLANE || depth >= FAR_PLANE) continue;
+        const uint x = static_cast<uint>((ndcX * 0.5f + 0.5f) * info.tilesX);
+        const uint y = static_cast<uint>((ndcY * 0.5f + 0.5f) * info.tilesY);
+        const uint cluster = grid.getClusterIndex(x, y, grid.getSlice(depth));
+        EXPECT_TRUE(clusterHasLight(grid, cluster, i) || grid.getClusterCounts()[cluster] == info.maxLightsPerCluster);
+    }
+}
+
+TEST(ClusterLightGrid, LightsOutsideFrustum) {
+    const auto info = perspectiveInfo();
+    const std::vector<Vec4> lights = {
+        {0.0f, 0.0f, 5.0f, 1.0f},                // behind the camera
+        {0.0f, 0.0f, -FAR_PLANE - 10.0f, 2.0f},  // past the far plane
+        {500.0f, 0.0f, -10.0f, 1.0f},            // far to the right
+    };
+    ClusterLightGrid grid;
+    grid.build(info, lights.data(), static_cast<uint>(lights.size()));
+    checkLayout(grid, info);
+    EXPECT_TRUE(grid.getLightIndices().empty());
+}
+
+TEST(ClusterLightGrid, MatchesReferencePerspective) {
+    const auto info = perspectiveInfo();
+    const auto lights = randomLights(300, 2);
+    ClusterLightGrid grid;
+    grid.build(info, lights.data(), static_cast<uint>(lights.size()));
+    checkLayout(grid, info);
+    checkAgainstReference(grid, info, lights);
+}
+
+TEST(ClusterLightGrid, MatchesReferenceOrthographic) {
+    const auto info = orthographicInfo();
+    const auto lights = randomLights(300, 3);
+    ClusterLightGrid grid;
+    grid.build(info, lights.data(), static_cast<uint>(lights.size()));
+    checkLayout(grid, info);
+    checkAgainstReference(grid, info, lights);
+}
+
+TEST(ClusterLightGrid, ClusterCapacity) {
+    auto info = perspectiveInfo();
+    info.maxLightsPerCluster = 4;
+    // twenty lights on top of each other
+    std::vector<Vec4> lights(20, Vec4(0.0f, 0.0f, -20.0f, 3.0f));
+    ClusterLightGrid grid;
+    grid.build(info, lights.data(), static_cast<uint>(lights.size()));
+    checkLayout(grid, info);
+    const uint cluster = grid.getClusterIndex(info.tilesX / 2, info.tilesY / 2, grid.getSlice(20.0f));
+    EXPECT_EQ(grid.getClusterCounts()[cluster], 4u);
+}
+
+TEST(ClusterLightGrid, ParallelBuildMatchesSerial) {
+    const auto info = perspectiveInfo();
+    const auto lights = randomLights(500, 4);
+    ClusterLightGrid serial;
+    serial.build(info, lights.data(), static_cast<uint>(lights.size()));
+
+    ClusterLightGrid parallel;
+    const auto parallelFor = [](uint taskCount, const std::function<void(uint)> &task) {
+        std::vector<std::thread> threads;
+        for (uint t = 0; t < taskCount; ++t) threads.emplace_back(task, t);
+        for (auto &thread : threads) thread.join();
+    };
+    // twice, the second build reuses the cached bounds and candidate buffers
+    for (uint i = 0; i < 2; ++i) {
+        parallel.build(info, lights.data(), static_cast<uint>(lights.size()), parallelFor);
+        EXPECT_TRUE(parallel.getClusterCounts() == serial.getClusterCounts());
+        EXPECT_TRUE(parallel.getClusterOffsets() == serial.getClusterOffsets());
+        EXPECT_TRUE(parallel.getLightIndices() == serial.getLightIndices());
+    }
+}
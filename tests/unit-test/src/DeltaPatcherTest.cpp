@@ -0,0 +1,277 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "UnitTest.h"
+#include "base/MD5.h"
+#include "extensions/assets-manager/DeltaPatcher.h"
+#include "platform/FileUtils.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using cc::FileUtils;
+using cc::MD5;
+using cc::extension::DeltaPatcher;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+const char PATCH_MAGIC[] = "CCDIFF01";
+
+// Writes patches in the format described in DeltaPatcher.h
+class PatchBuilder {
+public:
+    explicit PatchBuilder(uint64_t targetSize) {
+        _data.assign(PATCH_MAGIC, PATCH_MAGIC + sizeof(PATCH_MAGIC) - 1);
+        varint(targetSize);
+    }
+
+    PatchBuilder &copy(uint64_t offset, uint64_t length) {
+        varint(1);
+        varint(offset);
+        varint(length);
+        return *this;
+    }
+
+    PatchBuilder &add(uint64_t offset, const Bytes &diff) {
+        varint(2);
+        varint(offset);
+        varint(diff.size());
+        _data.insert(_data.end(), diff.begin(), diff.end());
+        return *this;
+    }
+
+    PatchBuilder &insert(const Bytes &bytes) {
+        varint(3);
+        varint(bytes.size());
+        _data.insert(_data.end(), bytes.begin(), bytes.end());
+        return *this;
+    }
+
+    const Bytes &end() {
+        varint(0);
+        return _data;
+    }
+
+private:
+    void varint(uint64_t value) {
+        do {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            _data.push_back(value ? byte | 0x80 : byte);
+        } while (value);
+    }
+
+    Bytes _data;
+};
+
+std::string pathOf(const char *name) {
+    return FileUtils::getInstance()->getWritablePath() + name;
+}
+
+void writeFile(const std::string &path, const Bytes &bytes) {
+    FILE *file = fopen(path.c_str(), "wb");
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+void writeGzipFile(const std::string &path, const Bytes &bytes) {
+    gzFile file = gzopen(path.c_str(), "wb");
+    gzwrite(file, bytes.data(), static_cast<unsigned>(bytes.size()));
+    gzclose(file);
+}
+
+bool readFile(const std::string &path, Bytes *bytes) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    bytes->clear();
+    uint8_t buffer[4096];
+    size_t got = 0;
+    while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes->insert(bytes->end(), buffer, buffer + got);
+    }
+    fclose(file);
+    return true;
+}
+
+bool fileExists(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file) fclose(file);
+    return file != nullptr;
+}
+
+std::string md5Of(const Bytes &bytes) {
+    MD5 digest;
+    digest.update(bytes.data(), bytes.size());
+    return digest.hexDigest();
+}
+
+Bytes randomBytes(size_t size, uint32_t seed) {
+    Bytes bytes(size);
+    for (auto &byte : bytes) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    return bytes;
+}
+
+// base and patch on disk, apply() into the output file
+struct PatchFixture {
+    std::string basePath = pathOf("delta_patcher_base.bin");
+    std::string patchPath = pathOf("delta_patcher_patch.bin");
+    std::string outPath = pathOf("delta_patcher_out.bin");
+
+    ~PatchFixture() {
+        remove(basePath.c_str());
+        remove(patchPath.c_str());
+        remove(outPath.c_str());
+    }
+
+    bool apply(const Bytes &base, const Bytes &patch, std::string *outMD5) {
+        writeFile(basePath, base);
+        writeFile(patchPath, patch);
+        return DeltaPatcher::apply(basePath, patchPath, outPath, outMD5);
+    }
+};
+
+} // namespace
+
+TEST(DeltaPatcher, AllCommands) {
+    const Bytes base = randomBytes(1000, 1);
+    Bytes expected(base.begin() + 100, base.begin() + 400);
+    const Bytes inserted = {'c', 'o', 'c', 'o', 's'};
+    expected.insert(expected.end(), inserted.begin(), inserted.end());
+    // ADD shifts every byte of base[500, 600) by its position
+    Bytes diff(100);
+    for (size_t i = 0; i < diff.size(); ++i) {
+        diff[i] = static_cast<uint8_t>(i);
+        expected.push_back(static_cast<uint8_t>(base[500 + i] + i));
+    }
+
+    PatchBuilder builder(expected.size());
+    const Bytes &patch = builder.copy(100, 300).insert(inserted).add(500, diff).end();
+
+    PatchFixture fixture;
+    std::string outMD5;
+    ASSERT_TRUE(fixture.apply(base, patch, &outMD5));
+    Bytes out;
+    ASSERT_TRUE(readFile(fixture.outPath, &out));
+    EXPECT_TRUE(out == expected);
+    EXPECT_EQ(outMD5, md5Of(expected));
+}
+
+// commands longer than the 64KB read buffers of the patcher
+TEST(DeltaPatcher, LargeGzipPatch) {
+    const Bytes base = randomBytes(300000, 2);
+    Bytes expected(base.begin() + 1000, base.begin() + 201000);
+    const Bytes inserted = randomBytes(70000, 3);
+    expected.insert(expected.end(), inserted.begin(), inserted.end());
+    const Bytes diff(150000, 0);
+    expected.insert(expected.end(), base.begin() + 100000, base.begin() + 250000);
+
+    PatchBuilder builder(expected.size());
+    const Bytes &patch = builder.copy(1000, 200000).insert(inserted).add(100000, diff).end();
+
+    PatchFixture fixture;
+    writeFile(fixture.basePath, base);
+    writeGzipFile(fixture.patchPath, patch);
+    std::string outMD5;
+    ASSERT_TRUE(DeltaPatcher::apply(fixture.basePath, fixture.patchPath, fixture.outPath, &outMD5));
+    Bytes out;
+    ASSERT_TRUE(readFile(fixture.outPath, &out));
+    EXPECT_TRUE(out == expected);
+    EXPECT_EQ(outMD5, md5Of(expected));
+}
+
+TEST(DeltaPatcher, EmptyTarget) {
+    PatchBuilder builder(0);
+    PatchFixture fixture;
+    std::string outMD5;
+    ASSERT_TRUE(fixture.apply(randomBytes(10, 4), builder.end(), &outMD5));
+    EXPECT_EQ(outMD5, "d41d8cd98f00b204e9800998ecf8427e");
+}
+
+// a failed patch never leaves a partial file behind
+TEST(DeltaPatcher, MalformedPatches) {
+    const Bytes base = randomBytes(1000, 5);
+    std::string outMD5;
+
+    {
+        Bytes patch = PatchBuilder(10).copy(0, 10).end();
+        patch[0] = 'X';
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, patch, &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        // reads past the end of the base
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, PatchBuilder(100).copy(950, 100).end(), &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        // writes more than the announced size
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, PatchBuilder(10).copy(0, 20).end(), &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        // ends before the announced size
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, PatchBuilder(20).copy(0, 10).end(), &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        Bytes patch = PatchBuilder(10).copy(0, 10).end();
+        patch.pop_back();
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, patch, &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        Bytes patch = PatchBuilder(10).insert(Bytes(10, 'a')).end();
+        patch.resize(patch.size() - 5);
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, patch, &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+    {
+        Bytes patch = PatchBuilder(10).copy(0, 10).end();
+        patch[patch.size() - 1] = 7; // unknown command instead of END
+        PatchFixture fixture;
+        EXPECT_FALSE(fixture.apply(base, patch, &outMD5));
+        EXPECT_FALSE(fileExists(fixture.outPath));
+    }
+}
+
+TEST(DeltaPatcher, MissingBase) {
+    PatchFixture fixture;
+    writeFile(fixture.patchPath, PatchBuilder(10).insert(Bytes(10, 'a')).end());
+    std::string outMD5;
+    EXPECT_FALSE(DeltaPatcher::apply(fixture.basePath, fixture.patchPath, fixture.outPath, &outMD5));
+    EXPECT_FALSE(fileExists(fixture.outPath));
+}
@@ -0,0 +1,217 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include "renderer/core/CoreStd.h"
+#include "base/threading/MessageQueue.h"
+#include "renderer/gfx-agent/BufferAgent.h"
+#include "renderer/gfx-agent/DeviceAgent.h"
+#include "renderer/gfx-empty/EmptyDevice.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using cc::MessageQueue;
+using cc::gfx::Buffer;
+using cc::gfx::BufferAgent;
+using cc::gfx::BufferInfo;
+using cc::gfx::BufferUsageBit;
+using cc::gfx::CommandBuffer;
+using cc::gfx::DeviceAgent;
+using cc::gfx::DeviceInfo;
+using cc::gfx::EmptyDevice;
+using cc::gfx::MemoryUsageBit;
+
+namespace {
+
+// Every record carries a payload in queue memory, large enough to force chunk switches.
+const uint PAYLOAD_WORDS = 16 * 1024;
+
+struct ReplayLog {
+    std::vector<uint> order;
+    uint corruptPayloads = 0;
+    std::thread::id thread;
+};
+
+void recordMessage(MessageQueue *queue, ReplayLog *log, uint index) {
+    uint *payload = queue->allocate<uint>(PAYLOAD_WORDS);
+    for (uint i = 0; i < PAYLOAD_WORDS; ++i) payload[i] = index + i;
+
+    ENQUEUE_MESSAGE_3(
+        queue, Record,
+        log, log,
+        index, index,
+        payload, payload,
+        {
+            for (uint i = 0; i < PAYLOAD_WORDS; ++i) {
+                if (payload[i] != index + i) {
+                    ++log->corruptPayloads;
+                    break;
+                }
+            }
+            log->order.push_back(index);
+            log->thread = std::this_thread::get_id();
+        });
+}
+
+bool isSequential(const std::vector<uint> &order, uint count) {
+    if (order.size() != count) return false;
+    for (uint i = 0; i < count; ++i) {
+        if (order[i] != i) return false;
+    }
+    return true;
+}
+
+DeviceAgent *createDevice() {
+    auto *device = CC_NEW(DeviceAgent(CC_NEW(EmptyDevice)));
+    DeviceInfo info;
+    info.width = info.nativeWidth = 64;
+    info.height = info.nativeHeight = 64;
+    device->initialize(info);
+    return device;
+}
+
+void destroyDevice(DeviceAgent *device) {
+    device->destroy();
+    CC_DELETE(device);
+}
+
+} // namespace
+
+TEST(MessageQueue, ImmediateModeExecutesInPlace) {
+    MessageQueue queue;
+    ReplayLog log;
+    for (uint i = 0; i < 100; ++i) {
+        recordMessage(&queue, &log, i);
+        // no kick needed, every message runs as soon as it is enqueued
+        EXPECT_EQ(log.order.size(), i + 1);
+    }
+    EXPECT_TRUE(isSequential(log.order, 100));
+    EXPECT_EQ(log.corruptPayloads, 0u);
+    EXPECT_TRUE(log.thread == std::this_thread::get_id());
+}
+
+TEST(MessageQueue, ReplaysInOrderOnConsumerThread) {
+    MessageQueue queue;
+    queue.setImmediateMode(false);
+    queue.runConsumerThread();
+
+    // ~64 MB of payload in total, so plenty of chunks get retired and released on the consumer side
+    const uint count = 1024;
+    ReplayLog log;
+    for (uint i = 0; i < count; ++i) {
+        recordMessage(&queue, &log, i);
+        if (i % 7 == 0) queue.kick();
+    }
+    queue.kickAndWait();
+
+    EXPECT_TRUE(isSequential(log.order, count));
+    EXPECT_EQ(log.corruptPayloads, 0u);
+    EXPECT_TRUE(log.thread != std::this_thread::get_id());
+
+    queue.terminateConsumerThread();
+    queue.setImmediateMode(true);
+}
+
+TEST(MessageQueue, TerminateDrainsPublishedMessages) {
+    ReplayLog log;
+    {
+        MessageQueue queue;
+        queue.setImmediateMode(false);
+        queue.runConsumerThread();
+        for (uint i = 0; i < 64; ++i) recordMessage(&queue, &log, i);
+        queue.kick();
+        queue.terminateConsumerThread();
+        EXPECT_TRUE(isSequential(log.order, 64));
+
+        // back to immediate mode, the queue keeps working on the calling thread
+        queue.setImmediateMode(true);
+        recordMessage(&queue, &log, 64);
+        EXPECT_TRUE(isSequential(log.order, 65));
+        EXPECT_TRUE(log.thread == std::this_thread::get_id());
+    }
+    EXPECT_EQ(log.corruptPayloads, 0u);
+}
+
+TEST(DeviceAgent, SingleThreadedForwardsInPlace) {
+    DeviceAgent *device = createDevice();
+    ASSERT_TRUE(device == DeviceAgent::getInstance());
+    EXPECT_FALSE(device->isMultithreaded());
+    EXPECT_EQ(device->getWidth(), 64u);
+
+    auto *buffer = static_cast<BufferAgent *>(device->createBuffer({BufferUsageBit::VERTEX, MemoryUsageBit::DEVICE, 256, 16}));
+    // the actor is initialized before createBuffer returns
+    EXPECT_EQ(buffer->getActor()->getSize(), 256u);
+    EXPECT_EQ(buffer->getCount(), 16u);
+
+    CC_DELETE(buffer);
+    destroyDevice(device);
+    EXPECT_TRUE(DeviceAgent::getInstance() == nullptr);
+}
+
+TEST(DeviceAgent, MultithreadedReplaysOnRenderThread) {
+    DeviceAgent *device = createDevice();
+    device->setMultithreaded(true);
+    EXPECT_TRUE(device->isMultithreaded());
+
+    auto *buffer = static_cast<BufferAgent *>(device->createBuffer({BufferUsageBit::UNIFORM, MemoryUsageBit::HOST | MemoryUsageBit::DEVICE, 1024}));
+    CommandBuffer *cmdBuff = device->getCommandBuffer();
+    std::vector<CommandBuffer *> cmdBuffs{cmdBuff};
+
+    ReplayLog log;
+    std::vector<uint8_t> data(1024);
+    for (uint frame = 0; frame < 32; ++frame) {
+        device->acquire();
+        cmdBuff->begin();
+        for (auto &byte : data) byte = static_cast<uint8_t>(frame);
+        // the data is copied at record time, the source may change right after
+        cmdBuff->updateBuffer(buffer, data.data());
+        cmdBuff->end();
+        device->getQueue()->submit(cmdBuffs);
+        recordMessage(device->getMessageQueue(), &log, frame);
+        device->present();
+    }
+    device->getMessageQueue()->kickAndWait();
+
+    EXPECT_TRUE(isSequential(log.order, 32));
+    EXPECT_EQ(log.corruptPayloads, 0u);
+    EXPECT_TRUE(log.thread != std::this_thread::get_id());
+    EXPECT_EQ(buffer->getActor()->getSize(), 1024u);
+
+    // resizing before the actor caught up still ends with the last size
+    buffer->resize(4096);
+    device->getMessageQueue()->kickAndWait();
+    EXPECT_EQ(buffer->getSize(), 4096u);
+    EXPECT_EQ(buffer->getActor()->getSize(), 4096u);
+
+    CC_DELETE(buffer);
+    device->setMultithreaded(false);
+    EXPECT_FALSE(device->isMultithreaded());
+
+    // switching back replays on the calling thread again
+    recordMessage(device->getMessageQueue(), &log, 32);
+    EXPECT_TRUE(isSequential(log.order, 33));
+    EXPECT_TRUE(log.thread == std::this_thread::get_id());
+
+    destroyDevice(device);
+}
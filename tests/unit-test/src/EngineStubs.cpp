@@ -0,0 +1,98 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Stand-ins for the engine pieces the tests link against, the real ones need a window, the
+// platform layer or the script engine. Only what the tested sources touch is provided.
+
+#include <cstdarg>
+#include <cstdio>
+#include "base/Log.h"
+#include "bindings/event/EventDispatcher.h"
+#include "platform/Application.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+LogLevel Log::logLevel = LogLevel::WARN;
+FILE *Log::_logFile = nullptr;
+
+void Log::logMessage(LogType /*type*/, LogLevel level, const char *formats, ...) {
+    if (level > logLevel) return;
+    va_list args;
+    va_start(args, formats);
+    vfprintf(stderr, formats, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+Application *Application::_instance = nullptr;
+std::shared_ptr<Scheduler> Application::_scheduler = nullptr;
+
+Application::Application(int /*width*/, int /*height*/) {
+    Application::_instance = this;
+    _scheduler = std::make_shared<Scheduler>();
+}
+
+Application::~Application() {
+    _scheduler.reset();
+    Application::_instance = nullptr;
+}
+
+bool Application::init() { return true; }
+void Application::onPause() {}
+void Application::onResume() {}
+
+// nothing restarts the VM in the tests, gfx::Device registers for it on construction
+uint32_t EventDispatcher::addCustomEventListener(const std::string & /*eventName*/, const CustomEventListener & /*listener*/) { return 0; }
+void EventDispatcher::removeCustomEventListener(const std::string & /*eventName*/, uint32_t /*listenerID*/) {}
+
+#if CC_UNIT_TEST_FILE_UTILS
+// the real FileUtils with the platform part done by the C runtime, files are relative to the working directory
+class UnitTestFileUtils : public FileUtils {
+public:
+    std::string getWritablePath() const override { return ""; }
+    std::string getSuitableFOpen(const std::string &filenameUtf8) const override { return filenameUtf8; }
+    bool removeFile(const std::string &filepath) override { return remove(filepath.c_str()) == 0; }
+
+protected:
+    bool isFileExistInternal(const std::string &filename) const override {
+        FILE *file = fopen(filename.c_str(), "rb");
+        if (file) fclose(file);
+        return file != nullptr;
+    }
+};
+
+FileUtils *FileUtils::getInstance() {
+    if (s_sharedFileUtils == nullptr) {
+        s_sharedFileUtils = new UnitTestFileUtils();
+        s_sharedFileUtils->init();
+    }
+    return s_sharedFileUtils;
+}
+#else
+// cookies are not enabled by the tests, nothing else asks for the file utils
+FileUtils *FileUtils::getInstance() { return nullptr; }
+#endif
+
+} // namespace cc
@@ -0,0 +1,326 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+    #define closeSocket closesocket
+#else
+    #include <arpa/inet.h>
+    #include <csignal>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+using SocketHandle = int;
+    #define INVALID_SOCKET (-1)
+    #define closeSocket    close
+#endif
+
+#include "network/HttpClient.h"
+#include "platform/Application.h"
+
+using cc::network::HttpClient;
+using cc::network::HttpRequest;
+using cc::network::HttpResponse;
+
+namespace {
+
+// HTTP/1.1 keep-alive server on 127.0.0.1, answers every GET with its path after an optional
+// delay given by the query ("/a?delay=200"), counts the connections it accepted.
+class LoopbackServer {
+public:
+    bool start() {
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+#else
+        // writing to a connection the client dropped must not kill the test
+        signal(SIGPIPE, SIG_IGN);
+#endif
+        _listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (_listenSocket == INVALID_SOCKET) return false;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(_listenSocket, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+            listen(_listenSocket, 16) != 0 ||
+            getsockname(_listenSocket, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            return false;
+        }
+        _port = ntohs(address.sin_port);
+        _acceptThread = std::thread(&LoopbackServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        _stopping = true;
+        shutdown(_listenSocket, 2);
+        closeSocket(_listenSocket);
+        _acceptThread.join();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto connection : _connections) shutdown(connection, 2);
+        }
+        for (auto &thread : _connectionThreads) thread.join();
+        for (auto connection : _connections) closeSocket(connection);
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        WSACleanup();
+#endif
+    }
+
+    std::string url(const std::string &path) const { return "http://127.0.0.1:" + std::to_string(_port) + path; }
+    int getConnectionCount() const { return _connectionCount; }
+    int getRequestCount() const { return _requestCount; }
+
+private:
+    void acceptLoop() {
+        while (!_stopping) {
+            SocketHandle connection = accept(_listenSocket, nullptr, nullptr);
+            if (connection == INVALID_SOCKET) break;
+            ++_connectionCount;
+            std::lock_guard<std::mutex> lock(_mutex);
+            _connections.push_back(connection);
+            _connectionThreads.emplace_back(&LoopbackServer::serve, this, connection);
+        }
+    }
+
+    void serve(SocketHandle connection) {
+        std::string buffer;
+        char chunk[1024];
+        while (true) {
+            size_t end = buffer.find("\r\n\r\n");
+            while (end == std::string::npos) {
+                int received = static_cast<int>(recv(connection, chunk, sizeof(chunk), 0));
+                if (received <= 0) return;
+                buffer.append(chunk, received);
+                end = buffer.find("\r\n\r\n");
+            }
+            // "GET /path HTTP/1.1"
+            const size_t pathBegin = buffer.find(' ') + 1;
+            std::string path = buffer.substr(pathBegin, buffer.find(' ', pathBegin) - pathBegin);
+            buffer.erase(0, end + 4);
+            ++_requestCount;
+
+            const size_t delay = path.find("delay=");
+            if (delay != std::string::npos) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(atoi(path.c_str() + delay + 6)));
+            }
+            const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(path.size()) + "\r\n\r\n" + path;
+            if (send(connection, response.data(), static_cast<int>(response.size()), 0) < 0) return;
+        }
+    }
+
+    SocketHandle _listenSocket = INVALID_SOCKET;
+    int _port = 0;
+    std::atomic<bool> _stopping{false};
+    std::atomic<int> _connectionCount{0};
+    std::atomic<int> _requestCount{0};
+    std::thread _acceptThread;
+    std::mutex _mutex;
+    std::vector<SocketHandle> _connections;
+    std::vector<std::thread> _connectionThreads;
+};
+
+void ensureApplication() {
+    if (!cc::Application::getInstance()) {
+        new cc::Application(1, 1);
+    }
+}
+
+// Runs the main thread part of the client, its callbacks, until done() or the timeout.
+template <typename Done>
+bool pumpUntil(Done done, int timeoutMs = 5000) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        cc::Application::getInstance()->getScheduler()->update(0.016F);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+HttpRequest *createRequest(const std::string &url, std::vector<std::string> *completed, std::mutex *mutex = nullptr) {
+    auto *request = new HttpRequest();
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setUrl(url);
+    request->setResponseCallback([completed, mutex](HttpClient * /*client*/, HttpResponse *response) {
+        std::string body(response->getResponseData()->begin(), response->getResponseData()->end());
+        if (!response->isSucceed()) body = "failed";
+        if (mutex) mutex->lock();
+        completed->push_back(body);
+        if (mutex) mutex->unlock();
+    });
+    return request;
+}
+
+} // namespace
+
+TEST(HttpClient, SendReusesConnection) {
+    ensureApplication();
+    LoopbackServer server;
+    ASSERT_TRUE(server.start());
+
+    auto *client = HttpClient::getInstance();
+    std::vector<std::string> completed;
+    for (int i = 0; i < 5; ++i) {
+        auto *request = createRequest(server.url("/send" + std::to_string(i)), &completed);
+        client->send(request);
+        request->release();
+        EXPECT_TRUE(pumpUntil([&] { return completed.size() == static_cast<size_t>(i + 1); }));
+    }
+    EXPECT_EQ(completed.size(), 5U);
+    EXPECT_EQ(completed.back(), std::string("/send4"));
+    // keep-alive: one connection for all of them
+    EXPECT_EQ(server.getConnectionCount(), 1);
+
+    HttpClient::destroyInstance();
+    server.stop();
+}
+
+TEST(HttpClient, SendImmediateSharesConnectionsAndSkipsSlots) {
+    ensureApplication();
+    LoopbackServer server;
+    ASSERT_TRUE(server.start());
+
+    auto *client = HttpClient::getInstance();
+    client->setMaxConcurrentRequests(1);
+    std::vector<std::string> completed;
+    for (int i = 0; i < 3; ++i) {
+        auto *request = createRequest(server.url("/immediate" + std::to_string(i)), &completed);
+        client->sendImmediate(request);
+        request->release();
+        EXPECT_TRUE(pumpUntil([&] { return completed.size() == static_cast<size_t>(i + 1); }));
+    }
+    // the immediate requests run on the multi handle, they reuse its connection cache
+    EXPECT_EQ(server.getConnectionCount(), 1);
+
+    // the only slot is busy, an immediate request still starts right away
+    auto *slow = createRequest(server.url("/slow?delay=1000"), &completed);
+    client->send(slow);
+    slow->release();
+    EXPECT_TRUE(pumpUntil([&] { return server.getRequestCount() == 4; }));
+    auto *fast = createRequest(server.url("/fast"), &completed);
+    client->sendImmediate(fast);
+    fast->release();
+    EXPECT_TRUE(pumpUntil([&] { return completed.size() == 4; }));
+    EXPECT_EQ(completed.back(), std::string("/fast"));
+    EXPECT_TRUE(pumpUntil([&] { return completed.size() == 5; }));
+    EXPECT_EQ(completed.back(), std::string("/slow?delay=1000"));
+
+    HttpClient::destroyInstance();
+    server.stop();
+}
+
+TEST(HttpClient, QueuedRequestsLeaveByPriority) {
+    ensureApplication();
+    LoopbackServer server;
+    ASSERT_TRUE(server.start());
+
+    auto *client = HttpClient::getInstance();
+    client->setMaxConcurrentRequests(1);
+    std::vector<std::string> completed;
+
+    // occupies the only slot while the others are queued
+    auto *blocker = createRequest(server.url("/blocker?delay=300"), &completed);
+    client->send(blocker);
+    blocker->release();
+    EXPECT_TRUE(pumpUntil([&] { return server.getRequestCount() == 1; }));
+
+    const int priorities[] = {0, 5, 1, 5};
+    for (int i = 0; i < 4; ++i) {
+        auto *request = createRequest(server.url("/p" + std::to_string(i)), &completed);
+        request->setPriority(priorities[i]);
+        client->send(request);
+        request->release();
+    }
+    ASSERT_TRUE(pumpUntil([&] { return completed.size() == 5; }));
+    EXPECT_EQ(completed[0], std::string("/blocker?delay=300"));
+    // higher priority first, same priority in the order they were sent
+    EXPECT_EQ(completed[1], std::string("/p1"));
+    EXPECT_EQ(completed[2], std::string("/p3"));
+    EXPECT_EQ(completed[3], std::string("/p2"));
+    EXPECT_EQ(completed[4], std::string("/p0"));
+
+    HttpClient::destroyInstance();
+    server.stop();
+}
+
+TEST(HttpClient, DestroyInstanceWithPendingRequests) {
+    ensureApplication();
+    LoopbackServer server;
+    ASSERT_TRUE(server.start());
+
+    auto *client = HttpClient::getInstance();
+    client->setMaxConcurrentRequests(1);
+    std::vector<std::string> completed;
+    std::vector<HttpRequest *> requests;
+    for (int i = 0; i < 4; ++i) {
+        auto *request = createRequest(server.url("/pending" + std::to_string(i) + "?delay=2000"), &completed);
+        requests.push_back(request);
+        client->send(request);
+    }
+    auto *immediate = createRequest(server.url("/pending-immediate?delay=2000"), &completed);
+    requests.push_back(immediate);
+    client->sendImmediate(immediate);
+    EXPECT_TRUE(pumpUntil([&] { return server.getRequestCount() >= 1; }));
+
+    // the network thread quits without waiting for the slow transfers or a free slot,
+    // every request it took or left queued is released and no callback runs
+    const auto start = std::chrono::steady_clock::now();
+    HttpClient::destroyInstance();
+    const bool released = pumpUntil([&] {
+        for (auto *request : requests) {
+            if (request->getReferenceCount() != 1) return false;
+        }
+        return true;
+    }, 1500);
+    EXPECT_TRUE(released);
+    EXPECT_TRUE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1500));
+    EXPECT_TRUE(completed.empty());
+    for (auto *request : requests) request->release();
+
+    // a new client gets its own curl handles and works while the old thread may still be around
+    std::vector<std::string> after;
+    auto *request = createRequest(server.url("/after"), &after);
+    HttpClient::getInstance()->send(request);
+    request->release();
+    EXPECT_TRUE(pumpUntil([&] { return after.size() == 1; }));
+    EXPECT_TRUE(!after.empty() && after[0] == "/after");
+
+    HttpClient::destroyInstance();
+    server.stop();
+}
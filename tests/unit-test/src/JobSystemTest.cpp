@@ -0,0 +1,182 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include "base/threading/JobSystem.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using cc::Job;
+using cc::JobSystem;
+
+// These run many small jobs on several workers so stealing and the continuation
+// hand-off happen constantly; build with -fsanitize=thread to check them for races.
+namespace {
+
+const uint WORKER_COUNT = 4;
+const uint ITERATIONS = 200;
+
+// Spawns a binary tree of child jobs, every leaf counts itself once.
+void spawnTree(JobSystem *system, Job *parent, uint depth, std::atomic<uint> *leaves) {
+    if (!depth) {
+        leaves->fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    for (uint i = 0; i < 2; ++i) {
+        Job *child = system->createJob([] {}, parent);
+        Job *grandChild = system->createJob([=] { spawnTree(system, child, depth - 1, leaves); }, child);
+        system->run(grandChild);
+        system->release(grandChild);
+        system->run(child);
+        system->release(child);
+    }
+}
+
+} // namespace
+
+TEST(JobSystem, NestedChildrenFinishBeforeParent) {
+    JobSystem system(WORKER_COUNT);
+    const uint depth = 8;
+    for (uint iteration = 0; iteration < ITERATIONS; ++iteration) {
+        std::atomic<uint> leaves{0};
+        Job *root = system.createJob([] {});
+        Job *spawner = system.createJob([&] { spawnTree(&system, root, depth, &leaves); }, root);
+        system.run(spawner);
+        system.release(spawner);
+        system.run(root);
+        system.wait(root);
+        EXPECT_EQ(leaves.load(), 1u << depth);
+    }
+}
+
+TEST(JobSystem, ParallelForVisitsEveryIndexOnce) {
+    JobSystem system(WORKER_COUNT);
+    const uint counts[] = {1, 2, 7, 64, 1000, 4097};
+    const uint grainSizes[] = {0, 1, 3, 16, 256};
+    for (uint iteration = 0; iteration < ITERATIONS / 10; ++iteration) {
+        for (uint count : counts) {
+            for (uint grainSize : grainSizes) {
+                std::vector<std::atomic<uint>> visits(count);
+                for (auto &visit : visits) visit.store(0, std::memory_order_relaxed);
+                std::atomic<uint64_t> sum{0};
+                system.parallelFor(count, grainSize, [&](uint i) {
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+                    sum.fetch_add(i, std::memory_order_relaxed);
+                });
+
+                uint wrong = 0;
+                for (auto &visit : visits) wrong += visit.load() != 1;
+                EXPECT_EQ(wrong, 0u);
+                EXPECT_EQ(sum.load(), static_cast<uint64_t>(count) * (count - 1) / 2);
+            }
+        }
+    }
+}
+
+TEST(JobSystem, NestedParallelForDoesNotDeadlock) {
+    JobSystem system(WORKER_COUNT);
+    const uint outer = 32;
+    const uint inner = 256;
+    for (uint iteration = 0; iteration < ITERATIONS / 10; ++iteration) {
+        std::atomic<uint> visits{0};
+        system.parallelFor(outer, 1, [&](uint /*i*/) {
+            system.parallelFor(inner, 8, [&](uint /*j*/) { visits.fetch_add(1, std::memory_order_relaxed); });
+        });
+        EXPECT_EQ(visits.load(), outer * inner);
+    }
+}
+
+TEST(JobSystem, DependenciesRunInOrder) {
+    JobSystem system(WORKER_COUNT);
+    const uint chainLength = 16;
+    for (uint iteration = 0; iteration < ITERATIONS; ++iteration) {
+        // plain ints on purpose, the dependency edges have to publish every write
+        std::vector<uint> order;
+        order.reserve(chainLength);
+        std::vector<Job *> jobs(chainLength);
+        for (uint i = 0; i < chainLength; ++i) {
+            jobs[i] = system.createJob([&order, i] { order.push_back(i); });
+            if (i) system.addDependency(jobs[i], jobs[i - 1]);
+        }
+        // schedule back to front so nothing is ready before its dependency finished
+        for (uint i = chainLength; i-- > 1;) {
+            system.run(jobs[i]);
+            system.release(jobs[i]);
+        }
+        Job *last = system.createJob([] {});
+        system.addDependency(last, jobs[chainLength - 1]);
+        system.run(last);
+        system.run(jobs[0]);
+        system.release(jobs[0]);
+        system.wait(last);
+
+        ASSERT_TRUE(order.size() == chainLength);
+        bool inOrder = true;
+        for (uint i = 0; i < chainLength; ++i) inOrder &= order[i] == i;
+        EXPECT_TRUE(inOrder);
+    }
+}
+
+TEST(JobSystem, FanInWaitsForEveryDependency) {
+    JobSystem system(WORKER_COUNT);
+    for (uint iteration = 0; iteration < ITERATIONS; ++iteration) {
+        std::atomic<uint> finished{0};
+        uint seenByJoin = 0;
+        Job *join = system.createJob([&] { seenByJoin = finished.load(std::memory_order_relaxed); });
+        const uint fanIn = Job::MAX_CONTINUATIONS * 2;
+        for (uint i = 0; i < fanIn; ++i) {
+            Job *job = system.createJob([&] { finished.fetch_add(1, std::memory_order_relaxed); });
+            system.addDependency(join, job);
+            system.run(job);
+            system.release(job);
+        }
+        system.run(join);
+        system.wait(join);
+        EXPECT_EQ(seenByJoin, fanIn);
+    }
+}
+
+TEST(JobSystem, DispatchFromManyThreads) {
+    JobSystem system(WORKER_COUNT);
+    const uint threadCount = 4;
+    const uint jobsPerThread = 2000;
+    std::atomic<uint> executed{0};
+    std::vector<std::thread> producers;
+    for (uint t = 0; t < threadCount; ++t) {
+        producers.emplace_back([&] {
+            for (uint i = 0; i < jobsPerThread; ++i) {
+                system.dispatch([&] { executed.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+    for (auto &producer : producers) producer.join();
+
+    // dispatch() hands out no handle, drain through a job that every worker can steal from
+    while (executed.load() != threadCount * jobsPerThread) {
+        Job *drain = system.createJob([] {});
+        system.run(drain);
+        system.wait(drain);
+    }
+    EXPECT_EQ(executed.load(), threadCount * jobsPerThread);
+}
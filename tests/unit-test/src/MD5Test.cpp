@@ -0,0 +1,99 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "UnitTest.h"
+#include "base/MD5.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using cc::MD5;
+
+namespace {
+
+std::string md5Of(const std::string &text) {
+    MD5 digest;
+    digest.update(text.data(), text.size());
+    return digest.hexDigest();
+}
+
+} // namespace
+
+// the test suite of RFC 1321
+TEST(MD5, ReferenceVectors) {
+    EXPECT_EQ(md5Of(""), "d41d8cd98f00b204e9800998ecf8427e");
+    EXPECT_EQ(md5Of("a"), "0cc175b9c0f1b6a831c399e269772661");
+    EXPECT_EQ(md5Of("abc"), "900150983cd24fb0d6963f7d28e17f72");
+    EXPECT_EQ(md5Of("message digest"), "f96b697d7cb7938d525a2f31aaf161d0");
+    EXPECT_EQ(md5Of("abcdefghijklmnopqrstuvwxyz"), "c3fcd3d76192e4007dfb496cca67e13b");
+    EXPECT_EQ(md5Of("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"), "d174ab98d277d9f5a5611c2c9f419d9f");
+    EXPECT_EQ(md5Of("12345678901234567890123456789012345678901234567890123456789012345678901234567890"), "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+// lengths around the 56 byte padding limit and the 64 byte block
+TEST(MD5, PaddingBoundaries) {
+    EXPECT_EQ(md5Of(std::string(55, 'a')), "ef1772b6dff9a122358552954ad0df65");
+    EXPECT_EQ(md5Of(std::string(56, 'a')), "3b0c8ac703f828b04c6c197006d17218");
+    EXPECT_EQ(md5Of(std::string(63, 'a')), "b06521f39153d618550606be297466d5");
+    EXPECT_EQ(md5Of(std::string(64, 'a')), "014842d480b571495a4a0363793f7367");
+    EXPECT_EQ(md5Of(std::string(65, 'a')), "c743a45e0d2e6a95cb859adae0248435");
+}
+
+// the digest must not depend on how the data is split between update() calls
+TEST(MD5, IncrementalUpdates) {
+    std::vector<unsigned char> data(100000);
+    uint32_t seed = 12345;
+    for (auto &byte : data) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<unsigned char>(seed >> 24);
+    }
+    MD5 whole;
+    whole.update(data.data(), data.size());
+    const std::string expected = whole.hexDigest();
+
+    const size_t chunkSizes[] = {1, 3, 63, 64, 65, 4096, 65537};
+    for (size_t chunkSize : chunkSizes) {
+        MD5 digest;
+        for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+            digest.update(data.data() + offset, std::min(chunkSize, data.size() - offset));
+        }
+        EXPECT_EQ(digest.hexDigest(), expected);
+    }
+
+    MD5 withEmptyUpdates;
+    withEmptyUpdates.update(data.data(), 0);
+    withEmptyUpdates.update(data.data(), data.size());
+    withEmptyUpdates.update(data.data(), 0);
+    EXPECT_EQ(withEmptyUpdates.hexDigest(), expected);
+}
+
+TEST(MD5, MillionBytes) {
+    const std::string block(1000, 'a');
+    MD5 digest;
+    for (int i = 0; i < 1000; ++i) {
+        digest.update(block.data(), block.size());
+    }
+    EXPECT_EQ(digest.hexDigest(), "7707d6ae4e027c70eea2a935c2296f21");
+}
@@ -0,0 +1,223 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include "base/Scheduler.h"
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using cc::Scheduler;
+using cc::Timer;
+
+namespace {
+
+const int TARGET_COUNT = 16;
+const int KEY_COUNT = 8;
+const int FRAME_COUNT = 600;
+
+struct Event {
+    int frame;
+    int target;
+    int key;
+    float dt;
+};
+
+// The per target timer tables the Scheduler used before the timing wheel, driving the
+// same Timer::update() it called every frame. Pause state lives with the table, which is
+// dropped once the target has no timers left.
+class ReferenceScheduler {
+public:
+    ReferenceScheduler() = default;
+    ReferenceScheduler(const ReferenceScheduler &) = delete;
+    ReferenceScheduler &operator=(const ReferenceScheduler &) = delete;
+
+    ~ReferenceScheduler() {
+        for (auto &target : _targets) {
+            for (auto &timer : target.second.timers) timer.second->release();
+        }
+    }
+
+    void schedule(const cc::ccSchedulerFunc &callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string &key) {
+        auto &entry = _targets[target];
+        if (entry.timers.empty()) entry.paused = paused;
+        auto *&timer = entry.timers[key];
+        CC_ASSERT(!timer);
+        timer = new ReferenceTimer(&_idle, callback, interval, repeat, delay);
+    }
+
+    void unschedule(const std::string &key, void *target) {
+        auto entry = _targets.find(target);
+        if (entry == _targets.end()) return;
+        auto timer = entry->second.timers.find(key);
+        if (timer == entry->second.timers.end()) return;
+        timer->second->release();
+        entry->second.timers.erase(timer);
+        if (entry->second.timers.empty()) _targets.erase(entry);
+    }
+
+    bool isScheduled(const std::string &key, void *target) const {
+        auto entry = _targets.find(target);
+        return entry != _targets.end() && entry->second.timers.count(key);
+    }
+
+    bool isTargetPaused(void *target) const {
+        auto entry = _targets.find(target);
+        return entry != _targets.end() && entry->second.paused;
+    }
+
+    void pauseTarget(void *target) { setPaused(target, true); }
+    void resumeTarget(void *target) { setPaused(target, false); }
+
+    void update(float dt) {
+        for (auto entry = _targets.begin(); entry != _targets.end();) {
+            auto &timers = entry->second.timers;
+            if (!entry->second.paused) {
+                for (auto timer = timers.begin(); timer != timers.end();) {
+                    timer->second->update(dt);
+                    if (timer->second->isCancelled()) {
+                        timer->second->release();
+                        timer = timers.erase(timer);
+                    } else {
+                        ++timer;
+                    }
+                }
+            }
+            entry = timers.empty() ? _targets.erase(entry) : std::next(entry);
+        }
+    }
+
+private:
+    class ReferenceTimer final : public Timer {
+    public:
+        ReferenceTimer(Scheduler *idle, const cc::ccSchedulerFunc &callback, float interval, unsigned int repeat, float delay)
+        : _callback(callback) {
+            // only asked whether the current target was salvaged, which an idle scheduler never is
+            _scheduler = idle;
+            setupTimerWithInterval(interval, repeat, delay);
+        }
+
+        void trigger(float dt) override { _callback(dt); }
+        void cancel() override { _cancelled = true; }
+        bool isCancelled() const { return _cancelled; }
+
+    private:
+        cc::ccSchedulerFunc _callback;
+        bool _cancelled = false;
+    };
+
+    struct TargetEntry {
+        bool paused = false;
+        std::map<std::string, ReferenceTimer *> timers;
+    };
+
+    void setPaused(void *target, bool paused) {
+        auto entry = _targets.find(target);
+        if (entry != _targets.end()) entry->second.paused = paused;
+    }
+
+    Scheduler _idle;
+    std::map<void *, TargetEntry> _targets;
+};
+
+// Random schedule/unschedule/pause/resume traffic with uneven frame times, both
+// scheduler types see the same operations in the same order.
+template <typename S>
+std::vector<Event> simulate(unsigned seed) {
+    S scheduler;
+    std::vector<Event> events;
+    std::mt19937 rng(seed);
+    char targets[TARGET_COUNT];
+    int frame = 0;
+    auto random = [&](int n) { return static_cast<int>(rng() % n); };
+
+    for (frame = 0; frame < FRAME_COUNT; ++frame) {
+        const int ops = random(6);
+        for (int i = 0; i < ops; ++i) {
+            const int t = random(TARGET_COUNT);
+            const int k = random(KEY_COUNT);
+            const int op = random(10);
+            const std::string key = "k" + std::to_string(k);
+            if (op < 6) {
+                if (scheduler.isScheduled(key, &targets[t])) continue;
+                const float interval = random(4) == 0 ? 0.F : (random(8) + 1) * 0.0125F;
+                const unsigned int repeat = random(3) == 0 ? static_cast<unsigned int>(random(5)) : UINT_MAX - 1;
+                const float delay = random(4) == 0 ? random(10) * 0.01F : 0.F;
+                const bool paused = scheduler.isTargetPaused(&targets[t]);
+                scheduler.schedule([&events, &frame, t, k](float dt) { events.push_back({frame, t, k, dt}); },
+                                   &targets[t], interval, repeat, delay, paused, key);
+            } else if (op == 6) {
+                scheduler.unschedule(key, &targets[t]);
+            } else if (op == 7) {
+                scheduler.pauseTarget(&targets[t]);
+            } else if (op == 8) {
+                scheduler.resumeTarget(&targets[t]);
+            }
+        }
+        scheduler.update(random(5) == 0 ? 0.0491F : 0.0163F);
+    }
+    return events;
+}
+
+// Counts the events both runs share, compared as multisets since firing order within a
+// frame is not part of the contract.
+size_t countCommonEvents(const std::vector<Event> &expected, const std::vector<Event> &actual) {
+    std::map<std::tuple<int, int, int, int>, int> pending;
+    auto toKey = [](const Event &e) { return std::make_tuple(e.frame, e.target, e.key, static_cast<int>(e.dt * 10000 + 0.5F)); };
+    for (const auto &event : expected) ++pending[toKey(event)];
+
+    size_t common = 0;
+    for (const auto &event : actual) {
+        auto &count = pending[toKey(event)];
+        if (count > 0) {
+            --count;
+            ++common;
+        }
+    }
+    return common;
+}
+
+} // namespace
+
+TEST(Scheduler, MatchesReferenceTimers) {
+    // The wheel counts in 1 ms ticks while Timer accumulates float seconds, so a timer
+    // landing exactly on an interval boundary may fire one frame apart between the two.
+    // Anything beyond such ties shows up as a much lower match rate.
+    const unsigned seedCount = 100;
+    size_t total = 0;
+    size_t common = 0;
+    for (unsigned seed = 1; seed <= seedCount; ++seed) {
+        const auto expected = simulate<ReferenceScheduler>(seed);
+        const auto actual = simulate<Scheduler>(seed);
+        total += std::max(expected.size(), actual.size());
+        common += countCommonEvents(expected, actual);
+    }
+    ASSERT_TRUE(total > 0);
+    const double matchRate = static_cast<double>(common) / total;
+    printf("    %zu of %zu callback events match the reference\n", common, total);
+    EXPECT_TRUE(matchRate >= 0.995);
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// Minimal self-registering test cases, the engine does not ship a test framework.
+namespace cc {
+namespace test {
+
+struct TestCase {
+    const char *suite;
+    const char *name;
+    std::function<void()> body;
+};
+
+inline std::vector<TestCase> &getTestCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int &getFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char *suite, const char *name, std::function<void()> body) {
+        getTestCases().push_back({suite, name, std::move(body)});
+    }
+};
+
+} // namespace test
+} // namespace cc
+
+#define TEST(suite, name)                                                           \
+    static void suite##_##name##_body();                                            \
+    static cc::test::TestRegistrar suite##_##name##_registrar(#suite, #name, &suite##_##name##_body); \
+    static void suite##_##name##_body()
+
+#define EXPECT_TRUE(cond)                                                               \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            printf("%s:%d: expected %s\n", __FILE__, __LINE__, #cond);                  \
+            ++cc::test::getFailureCount();                                              \
+        }                                                                               \
+    } while (0)
+
+#define EXPECT_FALSE(cond) EXPECT_TRUE(!(cond))
+#define EXPECT_EQ(a, b)    EXPECT_TRUE((a) == (b))
+#define EXPECT_NEAR(a, b, eps) EXPECT_TRUE(std::fabs((a) - (b)) <= (eps))
+
+// Stops the current test case, for preconditions later checks depend on.
+#define ASSERT_TRUE(cond)                                                               \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            printf("%s:%d: expected %s\n", __FILE__, __LINE__, #cond);                  \
+            ++cc::test::getFailureCount();                                              \
+            return;                                                                     \
+        }                                                                               \
+    } while (0)
@@ -0,0 +1,43 @@
+/****************************************************************************
+Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "UnitTest.h"
+#include <cstring>
+
+int main(int argc, char **argv) {
+    // optional filter, runs the cases whose "suite.name" contains it
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const auto &testCase : cc::test::getTestCases()) {
+        char fullName[256];
+        snprintf(fullName, sizeof(fullName), "%s.%s", testCase.suite, testCase.name);
+        if (filter && !strstr(fullName, filter)) continue;
+
+        const int failuresBefore = cc::test::getFailureCount();
+        testCase.body();
+        printf("[%s] %s\n", cc::test::getFailureCount() == failuresBefore ? "  OK  " : "FAILED", fullName);
+        ++run;
+    }
+    printf("%d test cases, %d failed checks\n", run, cc::test::getFailureCount());
+    return cc::test::getFailureCount() ? 1 : 0;
+}
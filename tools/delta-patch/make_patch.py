@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+# Creates the binary delta patches AssetsManagerEx applies to hot update assets.
+#
+# The format is described in extensions/assets-manager/DeltaPatcher.h, all integers are
+# unsigned LEB128 varints:
+#
+#     "CCDIFF01" targetSize commands... END
+#     COPY offset length / ADD offset length bytes / INSERT length bytes
+#
+# Blocks of the base are indexed by content, runs of the target that start with such a block
+# become COPY, runs that mostly match the base after it (shifted offsets, patched pointers)
+# become ADD, everything else INSERT. The patch is gzip compressed unless --no-gzip is given.
+#
+# usage: make_patch.py [--no-gzip] [--block N] [--manifest NAME] base target patch
+#
+# --manifest prints the entry of the asset's "patches" list in the remote manifest, NAME
+# being the patch path relative to the package url.
+
+import argparse
+import gzip
+import hashlib
+import json
+import sys
+
+MAGIC = b'CCDIFF01'
+END, COPY, ADD, INSERT = 0, 1, 2, 3
+DEFAULT_BLOCK = 32
+
+
+def encode_varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _extend_approximate(base, target, base_pos, target_pos):
+    # bsdiff's rule: keep the longest run in which matches outnumber mismatches
+    limit = min(len(base) - base_pos, len(target) - target_pos)
+    score = best_score = best_length = 0
+    for n in range(limit):
+        score += 1 if base[base_pos + n] == target[target_pos + n] else -1
+        if score > best_score:
+            best_score, best_length = score, n + 1
+        elif score < best_score - 16:
+            break
+    return best_length
+
+
+def make_patch(base, target, block=DEFAULT_BLOCK):
+    """Returns the uncompressed patch that rebuilds target from base."""
+    index = {}
+    for offset in range(0, len(base) - block + 1, block):
+        index.setdefault(base[offset:offset + block], offset)
+
+    out = bytearray(MAGIC + encode_varint(len(target)))
+    literal = bytearray()
+
+    def flush_literal():
+        if literal:
+            out.extend(encode_varint(INSERT) + encode_varint(len(literal)) + bytes(literal))
+            del literal[:]
+
+    pos = 0
+    while pos < len(target):
+        match = index.get(target[pos:pos + block]) if pos + block <= len(target) else None
+        if match is None:
+            literal.append(target[pos])
+            pos += 1
+            continue
+
+        # grow the match back into the pending literal, then forward
+        start, base_start = pos, match
+        while literal and base_start > 0 and base[base_start - 1] == literal[-1]:
+            literal.pop()
+            start -= 1
+            base_start -= 1
+        end = pos + block
+        base_end = match + block
+        while end < len(target) and base_end < len(base) and target[end] == base[base_end]:
+            end += 1
+            base_end += 1
+
+        flush_literal()
+        out.extend(encode_varint(COPY) + encode_varint(base_start) + encode_varint(end - start))
+
+        length = _extend_approximate(base, target, base_end, end)
+        if length:
+            delta = bytes((target[end + i] - base[base_end + i]) & 0xff for i in range(length))
+            out.extend(encode_varint(ADD) + encode_varint(base_end) + encode_varint(length) + delta)
+            end += length
+        pos = end
+
+    flush_literal()
+    out.extend(encode_varint(END))
+    return bytes(out)
+
+
+def _read_varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data) or shift >= 64:
+            raise ValueError('truncated varint')
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def apply_patch(base, patch):
+    """Reference decoder with the checks of DeltaPatcher::apply, accepts plain and gzipped patches."""
+    if patch[:2] == b'\x1f\x8b':
+        patch = gzip.decompress(patch)
+    if patch[:len(MAGIC)] != MAGIC:
+        raise ValueError('unknown patch format')
+    target_size, pos = _read_varint(patch, len(MAGIC))
+    out = bytearray()
+    while True:
+        command, pos = _read_varint(patch, pos)
+        if command == END:
+            break
+        if command not in (COPY, ADD, INSERT):
+            raise ValueError('unknown command %d' % command)
+        offset = 0
+        if command != INSERT:
+            offset, pos = _read_varint(patch, pos)
+        length, pos = _read_varint(patch, pos)
+        if length > target_size - len(out) or (command != INSERT and offset + length > len(base)):
+            raise ValueError('command out of range')
+        if command == COPY:
+            out.extend(base[offset:offset + length])
+            continue
+        data = patch[pos:pos + length]
+        if len(data) != length:
+            raise ValueError('truncated patch')
+        pos += length
+        if command == ADD:
+            data = bytes((data[i] + base[offset + i]) & 0xff for i in range(length))
+        out.extend(data)
+    if len(out) != target_size:
+        raise ValueError('patch rebuilds %d bytes instead of %d' % (len(out), target_size))
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Create a CCDIFF01 delta patch for AssetsManagerEx.')
+    parser.add_argument('base', help='the version of the asset clients have')
+    parser.add_argument('target', help='the new version of the asset')
+    parser.add_argument('patch', help='the patch file to write')
+    parser.add_argument('--no-gzip', action='store_true', help='write the patch uncompressed')
+    parser.add_argument('--block', type=int, default=DEFAULT_BLOCK, help='match block size in bytes')
+    parser.add_argument('--manifest', metavar='NAME', help='print the manifest entry of the patch, NAME being its path')
+    args = parser.parse_args()
+
+    with open(args.base, 'rb') as f:
+        base = f.read()
+    with open(args.target, 'rb') as f:
+        target = f.read()
+
+    patch = make_patch(base, target, args.block)
+    if not args.no_gzip:
+        patch = gzip.compress(patch, 9)
+    # never ship a patch that doesn't rebuild the target
+    if apply_patch(base, patch) != target:
+        sys.exit('make_patch.py: patch verification failed')
+    with open(args.patch, 'wb') as f:
+        f.write(patch)
+
+    if args.manifest:
+        entry = {'base': hashlib.md5(base).hexdigest(), 'path': args.manifest, 'size': len(patch)}
+        print(json.dumps(entry))
+
+
+if __name__ == '__main__':
+    main()
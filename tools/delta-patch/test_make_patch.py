@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# Round trip tests of make_patch.py: python3 tools/delta-patch/test_make_patch.py
+
+import gzip
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import make_patch
+
+
+def random_bytes(rng, size):
+    return bytes(rng.getrandbits(8) for _ in range(size))
+
+
+def edit(rng, data, count):
+    # inserts, deletions, byte tweaks and shifted little endian pointers, like a rebuilt asset
+    out = bytearray(data)
+    for _ in range(count):
+        pos = rng.randrange(len(out) + 1)
+        kind = rng.randrange(4)
+        if kind == 0:
+            out[pos:pos] = random_bytes(rng, rng.randrange(1, 200))
+        elif kind == 1:
+            del out[pos:pos + rng.randrange(1, 200)]
+        elif kind == 2 and pos < len(out):
+            out[pos] = rng.getrandbits(8)
+        else:
+            for p in range(pos, min(len(out) - 4, pos + 2048), 64):
+                value = int.from_bytes(out[p:p + 4], 'little')
+                out[p:p + 4] = ((value + 24) & 0xffffffff).to_bytes(4, 'little')
+    return bytes(out)
+
+
+class MakePatchTest(unittest.TestCase):
+    def setUp(self):
+        self.rng = random.Random(25)
+
+    def check_round_trip(self, base, target):
+        patch = make_patch.make_patch(base, target)
+        self.assertTrue(patch.startswith(make_patch.MAGIC))
+        self.assertEqual(make_patch.apply_patch(base, patch), target)
+        self.assertEqual(make_patch.apply_patch(base, gzip.compress(patch)), target)
+        return patch
+
+    def test_edited_file(self):
+        base = random_bytes(self.rng, 200000)
+        target = edit(self.rng, base, 40)
+        patch = gzip.compress(self.check_round_trip(base, target))
+        self.assertLess(len(patch), len(target) // 10)
+
+    def test_shifted_pointers_use_add(self):
+        base = random_bytes(self.rng, 20000)
+        target = bytearray(base)
+        for p in range(0, len(target), 64):
+            target[p] = (target[p] + 1) & 0xff
+        patch = self.check_round_trip(base, bytes(target))
+        self.assertLess(len(gzip.compress(patch)), len(gzip.compress(bytes(target))) // 4)
+
+    def test_unrelated_and_empty_files(self):
+        self.check_round_trip(random_bytes(self.rng, 5000), random_bytes(self.rng, 3000))
+        self.check_round_trip(b'', random_bytes(self.rng, 100))
+        self.check_round_trip(random_bytes(self.rng, 100), b'')
+        self.check_round_trip(b'', b'')
+
+    def test_corrupt_patches_are_rejected(self):
+        base = random_bytes(self.rng, 10000)
+        patch = make_patch.make_patch(base, edit(self.rng, base, 5))
+        for broken in (patch[:-1], patch[:len(patch) // 2], b'CCDIFF02' + patch[8:]):
+            with self.assertRaises(ValueError):
+                make_patch.apply_patch(base, broken)
+        with self.assertRaises(ValueError):
+            make_patch.apply_patch(base[:5000], patch)
+
+    def test_command_line(self):
+        base = random_bytes(self.rng, 50000)
+        target = edit(self.rng, base, 10)
+        script = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'make_patch.py')
+        with tempfile.TemporaryDirectory() as directory:
+            paths = [os.path.join(directory, name) for name in ('base', 'target', 'patch')]
+            for path, data in zip(paths, (base, target)):
+                with open(path, 'wb') as f:
+                    f.write(data)
+            output = subprocess.check_output([sys.executable, script, '--manifest', 'patches/a.bin.diff'] + paths)
+            with open(paths[2], 'rb') as f:
+                patch = f.read()
+        self.assertEqual(patch[:2], b'\x1f\x8b')
+        self.assertEqual(make_patch.apply_patch(base, patch), target)
+        self.assertIn(b'"size": %d' % len(patch), output)
+        self.assertIn(b'"path": "patches/a.bin.diff"', output)
+
+
+if __name__ == '__main__':
+    unittest.main()